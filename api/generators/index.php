@@ -273,7 +273,6 @@ foreach ($kgapi["classes"] as $class) {
                                     $pythonFriendlyArgList[] = "'".$parameter["name"]."': ' '.join(['%02X' % b for b in ".$parameter["name"]."_data])";
                                     break;
                             }
-                            $payloadLength++;
                             $pythonGUICommandFields[] = 'self.txt_'.$class["name"].'_'.$command["name"].'_'.$parameter["name"].' = wxm.TextCtrl(self, -1, "", validRequired=False, emptyInvalid=True, mask="*+", formatcodes="F")';
                             $pythonGUICommandFields[] = 'hbox_'.$class["name"].'_'.$command["name"].'.Add(self.txt_'.$class["name"].'_'.$command["name"].'_'.$parameter["name"].', 0, wx.ALIGN_CENTER_VERTICAL | wx.LEFT, 4)';
                             $pythonGUICommandButtonArgs[] = 'len(self.txt_'.$class["name"].'_'.$command["name"].'_'.$parameter["name"].'.GetValue())';
@@ -704,7 +703,8 @@ foreach ($kgapi["classes"] as $class) {
                 $arduinoCases[$class["id"]][] = 'case KG_PACKET_ID_CMD_'.strtoupper($class["name"].'_'.$command["name"]).': // '.sprintf("0x%02X", $command["id"]);
                 $arduinoCases[$class["id"]][] = '    // '.$class["name"].'_'.$command["name"].'('.join(', ', $arduinoCommandCommentArgList).')('.join(', ', $arduinoResponseCommentArgList).')';
                 $arduinoCases[$class["id"]][] = '    // parameters = '.$arduinoCommandPayloadLength.' '.($arduinoCommandPayloadLength == 1 ? 'byte' : 'bytes');
-                $arduinoCases[$class["id"]][] = '    if (rxPacket[1] '.($arduinoCommandFixedLength ? '!=' : '<').' '.$arduinoCommandPayloadLength.') {';
+                // variable-length payloads end with a uint8_t[] whose length byte must account for every byte after it
+                $arduinoCases[$class["id"]][] = '    if (rxPacket[1] '.($arduinoCommandFixedLength ? '!=' : '< '.$arduinoCommandPayloadLength.' || rxPacket[1] !=').' '.$arduinoCommandPayloadLength.($arduinoCommandFixedLength ? '' : ' + rxPacket['.($arduinoCommandPayloadLength + 3).']').') {';
                 $arduinoCases[$class["id"]][] = '        // incorrect parameter length';
                 $arduinoCases[$class["id"]][] = '        protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;';
                 $arduinoCases[$class["id"]][] = '    } else {';
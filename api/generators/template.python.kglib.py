@@ -472,6 +472,14 @@ class KGAPI(object):
     def get_last_event(self):
         return self.last_event
 
+    def unpack_motion_batch(self, payload):
+        # fire kg_evt_motion_data once per sample, so batched and unbatched streams look the same
+        if payload['count'] == 0:
+            return
+        size = len(payload['data']) // payload['count']
+        for i in range(payload['count']):
+            self.kg_evt_motion_data({ 'index': payload['index'], 'flags': payload['flags'], 'data': payload['data'][i * size:(i + 1) * size] })
+
     def parse(self, b):
         if len(self.kgapi_rx_buffer) == 0 and (b == 0xC0 or b == 0x80):
             self.kgapi_rx_buffer.append(b)
@@ -516,6 +524,8 @@ class KGAPI(object):
                         payload = { 'level': level, 'message': message }
                         self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': payload, 'raw': self.kgapi_last_rx_packet }
                         self.kg_log(payload)
+                if packet_class == 5 and packet_command == 4: # kg_evt_motion_batch
+                    self.unpack_motion_batch(self.last_event['payload'])
                 self.kg_event(self.last_event)
 
             return packet_type & 0xC0
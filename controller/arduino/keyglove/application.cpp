@@ -53,10 +53,29 @@ THE SOFTWARE.
 #include "support_touch.h"
 #include "support_bluetooth.h"
 #include "support_hid_keyboard.h"
+#include "support_touchset.h"
 #include "application.h"
 
-uint8_t touch_data_prev[KG_BASE_COMBINATION_BYTES];     ///< Container for tracking previous touch status bits
-uint8_t touch_data_xor[KG_BASE_COMBINATION_BYTES];      ///< Container for XOR'd touch status bits
+#define NC KG_TOUCHSET_CHORD_PAD
+
+/**
+ * @brief Default touchset, compiled into the sorted RAM touchset table at boot
+ *
+ * Each rule maps a chord of up to four base combinations (KGB_* indexes) in a
+ * touch mode to a single action. Several rules may share the same chord, and
+ * all of them will run in the order listed here. Touch and untouch rules
+ * follow a single combination whatever else is held, so motion can stay on
+ * under AY while DY types. If a touchset has been uploaded to EEPROM (see
+ * host/python/kgtouchset.py), it is used instead.
+ */
+const touchset_rule_t myTouchset[] PROGMEM = {
+    // mode, trigger, action, param, chord
+    { 0, KG_TOUCHSET_TRIGGER_TOUCH,   KG_TOUCHSET_ACTION_MOTION_ON,  0,      { KGB_AY, NC, NC, NC } },  // enable motion sensor 0 (default MPU-6050 on back of hand)
+    { 0, KG_TOUCHSET_TRIGGER_UNTOUCH, KG_TOUCHSET_ACTION_MOTION_OFF, 0,      { KGB_AY, NC, NC, NC } },  // disable motion sensor 0
+    { 0, KG_TOUCHSET_TRIGGER_TOUCH,   KG_TOUCHSET_ACTION_KEY_DOWN,   KEY_A,  { KGB_DY, NC, NC, NC } },  // send key-down report for 'A' key
+    { 0, KG_TOUCHSET_TRIGGER_UNTOUCH, KG_TOUCHSET_ACTION_KEY_UP,     KEY_A,  { KGB_DY, NC, NC, NC } },  // send key-up report for 'A' key
+    { 0, KG_TOUCHSET_TRIGGER_UNTOUCH, KG_TOUCHSET_ACTION_KEY_PRESS,  KEY_A,  { KGB_GY, NC, NC, NC } },  // send key down and key-up report for 'A' key
+};
 
 /**
  * @brief Indicates that Keyglove has completed the boot process
@@ -134,46 +153,6 @@ uint8_t my_kg_evt_bluetooth_ready() {
     return 0;
 }
 
-/**
- * @brief Indicates that the touch sensor status has changed
- * @param[in] status_len Length in bytes of status_data buffer
- * @param[in] status_data New touch status
- * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
- *
- * This event is triggered every time any touch status bits change. This data is
- * detected in the update_board_touch() function in the board definition file,
- * and filtered/debounced in the update_touch() function in the support_touch.h
- * file.
- */
-uint8_t my_kg_evt_touch_status(uint8_t status_len, uint8_t *status_data) {
-    // XOR current and previous to identify which bits have been changed
-    for (uint8_t i = 0; i < KG_BASE_COMBINATION_BYTES; i++) {
-        touch_data_xor[i] = touch_data_prev[i] ^ status_data[i];
-    }
-
-    // bits set in "touch_data_prev" indicate which touches are on as of last time any touches changed
-    // bits set in "touch_data_xor" indicate which touches have just flipped between on and off
-    // bits set in "status_data" indicate which touches are on right now
-
-    // check to see whether this is adding or removing
-    if (memcmp(status_data, touch_data_prev, KG_BASE_COMBINATION_BYTES) > 0) {
-        // touch added
-        if      (KGT_AY(touch_data_xor)) kg_cmd_motion_set_mode(0, true);   // enable motion sensor 0 (default MPU-6050 on back of hand)
-        else if (KGT_DY(touch_data_xor)) keyboard_key_down(KEY_A);          // send key-down report for 'A' key
-    } else {
-        // touch removed
-        if      (KGT_AY(touch_data_xor)) kg_cmd_motion_set_mode(0, false);  // disable motion sensor 0
-        else if (KGT_DY(touch_data_xor)) keyboard_key_up(KEY_A);            // send key-up report for 'A' key
-        else if (KGT_GY(touch_data_xor)) keyboard_key_press(KEY_A);         // send key down and key-up report for 'A' key
-    }
-
-    // store current touch status for comparing next time
-    memcpy(touch_data_prev, status_data, status_len);
-
-    // allow KGAPI event packet transmission
-    return 0;
-}
-
 /**
  * @brief Custom application setup routine
  *
@@ -192,5 +171,9 @@ void setup_application() {
     kg_evt_system_timer_tick = my_kg_evt_system_timer_tick;
     kg_evt_motion_data = my_kg_evt_motion_data;
     kg_evt_bluetooth_ready = my_kg_evt_bluetooth_ready;
-    kg_evt_touch_status = my_kg_evt_touch_status;
+
+    #if (KG_TOUCHSET > 0)
+        // build sorted touchset table from default rules
+        touchset_compile(myTouchset, sizeof(myTouchset) / sizeof(touchset_rule_t));
+    #endif
 }
@@ -140,6 +140,20 @@ uint8_t my_kg_evt_system_timer_tick(uint8_t handle, uint32_t seconds, uint8_t su
     return 0; // 0=send event API packet, otherwise skip sending
 }
 
+/**
+ * @brief Flight recorder data
+ * @param[in] offset Index of the first record in this event, counted from the oldest
+ * @param[in] records_len Length in bytes of records_data buffer
+ * @param[in] records_data Record data
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_system_recorder_data(uint16_t offset, uint8_t records_len, uint8_t *records_data) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
 
 //////////////////////////////// BLUETOOTH ////////////////////////////////
 
@@ -353,6 +367,46 @@ uint8_t my_kg_evt_touch_status(uint8_t status_len, uint8_t *status_data) {
     return 0; // 0=send event API packet, otherwise skip sending
 }
 
+/**
+ * @brief Indicates that a touch gesture was detected
+ * @param[in] combination Base touch combination index
+ * @param[in] gesture Type of gesture detected
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_touch_gesture(uint8_t combination, uint8_t gesture) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
+/**
+ * @brief Indicates that the ambiguous touch combinations have changed
+ * @param[in] status_len Length in bytes of status_data buffer
+ * @param[in] status_data Ambiguous touch combinations (same layout as touch status)
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_touch_ambiguous(uint8_t status_len, uint8_t *status_data) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
+/**
+ * @brief Touch usage statistics data
+ * @param[in] offset Offset of this data within the statistics block
+ * @param[in] data_len Length in bytes of data_data buffer
+ * @param[in] data_data Statistics block data
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_touch_usage(uint16_t offset, uint8_t data_len, uint8_t *data_data) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
 
 //////////////////////////////// MOTION ////////////////////////////////
 
@@ -397,5 +451,37 @@ uint8_t my_kg_evt_motion_state(uint8_t index, uint8_t state) {
     return 0; // 0=send event API packet, otherwise skip sending
 }
 
+/**
+ * @brief Several motion sensor measurements collected into one packet
+ * @param[in] index Relevant motion sensor
+ * @param[in] flags Flags indicating which measurement data is represented in each sample
+ * @param[in] count Number of samples in data_data buffer
+ * @param[in] time Tick count (10ms units) when the first sample was processed
+ * @param[in] data_len Length in bytes of data_data buffer
+ * @param[in] data_data Measurement data for all samples, in order
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_motion_batch(uint8_t index, uint8_t flags, uint8_t count, uint16_t time, uint8_t data_len, uint8_t *data_data) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
+/**
+ * @brief A stored motion gesture template matched the recent motion
+ * @param[in] index Relevant motion sensor
+ * @param[in] gesture Gesture template slot which matched
+ * @param[in] score Match distance (lower is closer)
+ * @param[in] frames Number of input frames covered by the match
+ * @return KGAPI event packet fallthrough, zero allows and non-zero prevents
+ */
+uint8_t my_kg_evt_motion_gesture(uint8_t index, uint8_t gesture, uint16_t score, uint8_t frames) {
+    // TODO: special event handler code here
+    // ...
+
+    return 0; // 0=send event API packet, otherwise skip sending
+}
+
 
 #endif // false
@@ -65,9 +65,14 @@ THE SOFTWARE.
          * @see KG_BOARD_TEENSYPP2_T37
          * @see KG_BOARD_ARDUINO_DUE
          * @see KG_BOARD_KEYGLOVE100
+         *
+         * May also be defined on the compiler command line, e.g. to build the
+         * host tests for the 37-sensor arrangement.
          */
-        #define KG_BOARD                        KG_BOARD_TEENSYPP2_T19
-        //#define KG_BOARD                        KG_BOARD_TEENSYPP2_T37
+        #ifndef KG_BOARD
+            #define KG_BOARD                        KG_BOARD_TEENSYPP2_T19
+            //#define KG_BOARD                        KG_BOARD_TEENSYPP2_T37
+        #endif
         #ifdef CORE_TEENSY_SERIAL
             /**
              * @brief Automatic USB serial host interface option based on Arduino IDE board selection
@@ -214,9 +219,65 @@ THE SOFTWARE.
  * @brief Motion sensor support selection
  * @see KG_MOTION_NONE
  * @see KG_MOTION_MPU6050_HAND
+ * @see KG_MOTION_MPU6050_INDEXTIP
+ *
+ * May also be defined on the compiler command line, e.g. to build the host
+ * tests with both sensors.
+ */
+#ifndef KG_MOTION
+    //#define KG_MOTION           KG_MOTION_NONE
+    #define KG_MOTION           KG_MOTION_MPU6050_HAND
+    //#define KG_MOTION           KG_MOTION_MPU6050_HAND | KG_MOTION_MPU6050_INDEXTIP
+#endif
+
+/**
+ * @brief I2C transfer selection
+ * @see KG_I2C_WIRE
+ * @see KG_I2C_TWI
+ *
+ * KG_I2C_TWI builds with neither I2Cdevlib nor the Wire library, since the
+ * sensor drivers only need the register map in support_motion_mpu6050.h. The
+ * exception is KG_FUSION_DMP, whose firmware loader is part of I2Cdevlib: with
+ * KG_I2C_TWI that needs I2CDEV_IMPLEMENTATION set to I2CDEV_BUILTIN_FASTWIRE in
+ * I2Cdevlib's I2Cdev.h, because the Wire library defines the same TWI
+ * interrupt handler. KG_I2C_WIRE builds with both libraries as shipped. May
+ * also be defined on the compiler command line.
  */
-//#define KG_MOTION           KG_MOTION_NONE
-#define KG_MOTION           KG_MOTION_MPU6050_HAND
+#ifndef KG_I2C
+    //#define KG_I2C              KG_I2C_WIRE
+    #define KG_I2C              KG_I2C_TWI
+#endif
+
+/**
+ * @brief Motion fusion selection
+ * @see KG_FUSION_NONE
+ * @see KG_FUSION_DMP
+ * @see KG_FUSION_MAHONY
+ *
+ * The default Mahony filter needs no extra libraries. KG_FUSION_DMP loads the
+ * MPU-6050's own fusion firmware through I2Cdevlib, so with KG_I2C_TWI it also
+ * needs I2Cdev built for Fastwire (see KG_I2C). May also be defined on the
+ * compiler command line, e.g. to build the host tests without the DMP
+ * firmware.
+ */
+#ifndef KG_FUSION
+    //#define KG_FUSION           KG_FUSION_NONE
+    //#define KG_FUSION           KG_FUSION_DMP
+    #define KG_FUSION           KG_FUSION_MAHONY
+#endif
+
+/**
+ * @brief Motion gesture recognition selection
+ * @see KG_MOTIONGESTURE_NONE
+ * @see KG_MOTIONGESTURE_DTW
+ *
+ * The DTW matcher keeps a cost row for every template slot, 430 bytes of static
+ * RAM, so it is off unless templates are going to be uploaded.
+ */
+#ifndef KG_MOTIONGESTURE
+    #define KG_MOTIONGESTURE    KG_MOTIONGESTURE_NONE
+    //#define KG_MOTIONGESTURE    KG_MOTIONGESTURE_DTW
+#endif
 
 /**
  * @brief Feedback generator selection
@@ -228,6 +289,56 @@ THE SOFTWARE.
 //#define KG_FEEDBACK         KG_FEEDBACK_BLINK
 #define KG_FEEDBACK         (KG_FEEDBACK_BLINK | KG_FEEDBACK_PIEZO | KG_FEEDBACK_VIBRATE | KG_FEEDBACK_RGB)
 
+/**
+ * @brief Touchset (on-board chord map) storage selection
+ * @see KG_TOUCHSET_NONE
+ * @see KG_TOUCHSET_RAM
+ * @see KG_TOUCHSET_EEPROM
+ *
+ * The RAM table holds the default chord map compiled in setup_application(),
+ * so it stays on. It takes 386 bytes of static RAM (KG_TOUCHSET_RAM_ENTRIES).
+ */
+#define KG_TOUCHSET         (KG_TOUCHSET_RAM | KG_TOUCHSET_EEPROM)
+
+/**
+ * @brief Touch gesture (tap/hold timing) selection
+ * @see KG_TOUCHGESTURE_NONE
+ * @see KG_TOUCHGESTURE_TIMING
+ *
+ * Needs a timer for every base combination, 350 bytes of static RAM on the T37
+ * board (5 bytes per combination, plus the timer wheel).
+ */
+#ifndef KG_TOUCHGESTURE
+    #define KG_TOUCHGESTURE     KG_TOUCHGESTURE_NONE
+    //#define KG_TOUCHGESTURE     KG_TOUCHGESTURE_TIMING
+#endif
+
+/**
+ * @brief Touch usage statistics selection
+ * @see KG_TOUCHSTATS_NONE
+ * @see KG_TOUCHSTATS_COUNTERS
+ *
+ * Counters take 627 bytes of static RAM on the T37 board (8 bytes per base
+ * combination, plus the bigram table), so they are only for tuning sessions.
+ */
+#ifndef KG_TOUCHSTATS
+    #define KG_TOUCHSTATS       KG_TOUCHSTATS_NONE
+    //#define KG_TOUCHSTATS       KG_TOUCHSTATS_COUNTERS
+#endif
+
+/**
+ * @brief Flight recorder selection
+ * @see KG_RECORDER_NONE
+ * @see KG_RECORDER_RAM
+ *
+ * The record ring takes 785 bytes of static RAM with the default
+ * KG_RECORDER_RECORDS, so the recorder is for debugging builds only.
+ */
+#ifndef KG_RECORDER
+    #define KG_RECORDER         KG_RECORDER_NONE
+    //#define KG_RECORDER         KG_RECORDER_RAM
+#endif
+
 /**
  * @brief Dual-glove support selection (NOT IMPLEMENTED YET)
  * @see KG_DUALGLOVE_NONE
@@ -109,6 +109,28 @@ THE SOFTWARE.
 
 
 
+/* I2C transfer options. (defined in KG_I2C) */
+
+#define KG_I2C_WIRE                     0x01        ///< Transfers run through I2Cdev in the main loop, which waits for each one (stock I2Cdevlib and Wire library)
+#define KG_I2C_TWI                      0x02        ///< Transfers clocked out in the background by our own TWI interrupt (no Wire library, and I2Cdevlib only for the DMP loader, built with Fastwire)
+
+
+
+/* Motion fusion options. DMP and Mahony may both be enabled, in which case Mahony is used if the DMP fails to load. (defined in KG_FUSION) */
+
+#define KG_FUSION_NONE                  0x00        ///< No orientation fusion, only raw accel/gyro data
+#define KG_FUSION_DMP                   0x01        ///< 6-axis quaternion fusion computed by the MPU-6050's on-chip DMP
+#define KG_FUSION_MAHONY                0x02        ///< 6-axis quaternion fusion computed on the MCU with a fixed-point Mahony filter
+
+
+
+/* Motion gesture recognition options. (defined in KG_MOTIONGESTURE) */
+
+#define KG_MOTIONGESTURE_NONE           0x00        ///< No on-board motion gesture recognition, raw motion data is reported via KGAPI
+#define KG_MOTIONGESTURE_DTW            0x01        ///< Streaming dynamic time warping match of hand gyro data against templates stored in EEPROM
+
+
+
 /* Sensory feedback. Multiple options may be enabled. (defined in KG_FEEDBACK) */
 
 #define KG_FEEDBACK_NONE                0x00        ///< No feedback support
@@ -119,6 +141,35 @@ THE SOFTWARE.
 
 
 
+/* Touchset (chord map) storage options. Multiple options may be enabled, EEPROM has priority when valid. (defined in KG_TOUCHSET) */
+
+#define KG_TOUCHSET_NONE                0x00        ///< No on-board chord mapping, touch status is only reported via KGAPI
+#define KG_TOUCHSET_RAM                 0x01        ///< Sorted chord map table compiled into RAM at boot or via KGAPI
+#define KG_TOUCHSET_EEPROM              0x02        ///< Compiled chord map table uploaded via KGAPI and stored in EEPROM
+
+
+
+/* Touch gesture (tap/hold timing) options. (defined in KG_TOUCHGESTURE) */
+
+#define KG_TOUCHGESTURE_NONE            0x00        ///< No gesture timing, only raw touch status is reported
+#define KG_TOUCHGESTURE_TIMING          0x01        ///< Tap, double-tap, hold, and long press detection for each base combination
+
+
+
+/* Touch usage statistics options. (defined in KG_TOUCHSTATS) */
+
+#define KG_TOUCHSTATS_NONE              0x00        ///< No usage statistics
+#define KG_TOUCHSTATS_COUNTERS          0x01        ///< Press counts, hold times, and frequent combination pairs kept in RAM
+
+
+
+/* Flight recorder options. (defined in KG_RECORDER) */
+
+#define KG_RECORDER_NONE                0x00        ///< No flight recorder
+#define KG_RECORDER_RAM                 0x01        ///< Ring of recent timestamped touch and motion samples kept in RAM
+
+
+
 /* Interface mode definitions. Multiple options may be enabled. */
 
 #define KG_INTERFACE_MODE_NONE          0x00        ///< Don't use this interface for KGAPI data
@@ -47,9 +47,32 @@ THE SOFTWARE.
 // COMMUNICATION PROTOCOL
 #include "support_protocol.h"
 
+// I2C TRANSACTION SCHEDULER
+#include "support_i2c.h"
+
+// FLIGHT RECORDER
+#if (KG_RECORDER > 0)
+    #include "support_recorder.h"
+#endif
+
 // TOUCH SENSOR DETECTION LOGIC
 #include "support_touch.h"
 
+// TOUCHSET (CHORD MAP) ENGINE
+#if (KG_TOUCHSET > 0)
+    #include "support_touchset.h"
+#endif
+
+// TOUCH GESTURE (TAP/HOLD TIMING) ENGINE
+#if (KG_TOUCHGESTURE > 0)
+    #include "support_touchgesture.h"
+#endif
+
+// TOUCH USAGE STATISTICS
+#if (KG_TOUCHSTATS > 0)
+    #include "support_touchstats.h"
+#endif
+
 // FEEDBACK
 #if (KG_FEEDBACK > 0)
     #include "support_feedback.h"
@@ -60,6 +83,11 @@ THE SOFTWARE.
     #include "support_motion.h"
 #endif
 
+// MOTION GESTURE (TEMPLATE MATCHING) ENGINE
+#if (KG_MOTIONGESTURE > 0)
+    #include "support_motiongesture.h"
+#endif
+
 // BLUETOOTH SUPPORT
 #if (KG_HOSTIF & HG_HOSTIF_BT2_SPP) || (KG_HOSTIF & KG_HOSTIF_BT2_HID) || (KG_HOSTIF & KG_HOSTIF_BT2_RAWHID) || (KG_HOSTIF & KG_HOSTIF_BT2_IAP)
     #include "support_bluetooth.h"
@@ -91,6 +119,39 @@ uint8_t keygloveSoftTimer10ms[8];           ///< Next 10ms (tick) to execute eac
 volatile uint8_t keygloveBatteryInterrupt;  ///< Flag for battery status change interrupt
 volatile uint8_t keygloveBatteryStatus;     ///< Battery status signal container for post-interrupt processing
 uint8_t keygloveBatteryLevel;               ///< Battery charge level (0-100)
+uint8_t keygloveBatteryClient;              ///< I2C scheduler client handle for MAX17048 battery gauge
+uint8_t keygloveBatteryBuffer;              ///< MAX17048 SOC register high byte (filled in the background)
+
+/**
+ * @brief Queue a read of the MAX17048 battery gauge (I2C service routine)
+ *
+ * Reads the high byte of the 0x04 SOC register, which is the whole percentage.
+ */
+void keyglove_battery_update() {
+    i2c_read(keygloveBatteryClient, 0x36, 0x04, 1, &keygloveBatteryBuffer);
+}
+
+/**
+ * @brief Process MAX17048 battery gauge reading (I2C completion routine)
+ * @param[in] status Final I2C transfer status
+ * @return Always zero, since this only takes one transaction
+ *
+ * Flags a battery status change if the percentage is different from the last
+ * reading.
+ */
+uint8_t keyglove_battery_complete(uint8_t status) {
+    uint8_t newBat;
+    if (status != KG_I2C_STATUS_DONE) return 0;
+    newBat = min(100, max(0, keygloveBatteryBuffer));
+
+    if (newBat != keygloveBatteryLevel) {
+        // percentage changed, trigger "interrupt" behavior in loop()
+        // TODO: CHANGE THIS TO USE THE /ALRT PIN ON MAX17048
+        keygloveBatteryLevel = newBat;
+        keygloveBatteryInterrupt = 1;
+    }
+    return 0;
+}
 
 /**
  * @brief Microcontroller initial setup routine
@@ -117,6 +178,20 @@ void setup() {
     // COMMUNICATION PROTOCOL
     setup_protocol();
 
+    // FLIGHT RECORDER (before anything that can trigger it)
+    #if (KG_RECORDER > 0)
+        setup_recorder();
+    #endif
+
+    // I2C TRANSACTION QUEUE
+    setup_i2c();
+    keygloveBatteryClient = i2c_register(keyglove_battery_update, keyglove_battery_complete);
+
+    // TOUCHSET (CHORD MAP) ENGINE (before application, which may compile its own touchset)
+    #if (KG_TOUCHSET > 0)
+        setup_touchset();
+    #endif
+
     // CUSTOM APPLICATION
     setup_application();
 
@@ -137,6 +212,16 @@ void setup() {
     // CORE TOUCH SENSOR LOGIC
     setup_touch();
 
+    // TOUCH GESTURE (TAP/HOLD TIMING) ENGINE
+    #if (KG_TOUCHGESTURE > 0)
+        setup_touchgesture();
+    #endif
+
+    // TOUCH USAGE STATISTICS
+    #if (KG_TOUCHSTATS > 0)
+        setup_touchstats();
+    #endif
+
     // FEEDBACK
     #if (KG_FEEDBACK & KG_FEEDBACK_BLINK)
         setup_feedback_blink();
@@ -152,8 +237,13 @@ void setup() {
     #endif
 
     // MOTION
-    #if (KG_MOTION & KG_MOTION_MPU6050_HAND)
-        setup_motion_mpu6050_hand();
+    #if (KG_MOTION > 0)
+        setup_motion();
+    #endif
+
+    // MOTION GESTURE (TEMPLATE MATCHING) ENGINE
+    #if (KG_MOTIONGESTURE > 0)
+        setup_motiongesture();
     #endif
 
     // HOST INTERFACE
@@ -196,8 +286,13 @@ void loop() {
         //keygloveTickTime += micros() - keygloveTickTime0;
         //keygloveTickTime0 = micros();
         
-        // update touch status
-        update_touch();
+        // update touch status (every tick, unless backed off while idle)
+        if (touch_scan_due(1)) update_touch();
+
+        // advance touch gesture timers
+        #if (KG_TOUCHGESTURE > 0)
+            update_touchgesture();
+        #endif
 
         // update feedback settings
         #if (KG_FEEDBACK & KG_FEEDBACK_BLINK)
@@ -220,16 +315,8 @@ void loop() {
             keygloveTick = 0;
             keygloveTock++;
 
-            // read 0x04 SOC register from MAX17048 battery gauge to check for change
-            uint8_t newBat;
-            I2Cdev::readByte(0x36, 0x04, &newBat);
-            newBat = min(100, max(0, newBat));
-            
-            if (newBat != keygloveBatteryLevel) {
-                // percentage changed, trigger "interrupt" behavior below
-                // TODO: CHANGE THIS TO USE THE /ALRT PIN ON MAX17048
-                keygloveBatteryInterrupt = 1;
-            }
+            // queue a read from MAX17048 battery gauge to check for change
+            i2c_request(keygloveBatteryClient);
         }
 
         // check for soft timer ticks
@@ -263,8 +350,8 @@ void loop() {
                 }
             }
         }
-    } else if (touchOn) {
-        // update touch status instantly for low-latency when any are active
+    } else if (touch_scan_due(0)) {
+        // update touch status between ticks at burst rate for low latency while any are active
         update_touch();
     }
 
@@ -272,9 +359,7 @@ void loop() {
     if (keygloveBatteryInterrupt) {
         keygloveBatteryInterrupt = 0;
 
-        // read 0x04 SOC register from MAX17048 battery gauge
-        I2Cdev::readByte(0x36, 0x04, &keygloveBatteryLevel);
-        keygloveBatteryLevel = min(100, max(0, keygloveBatteryLevel));
+        // (keygloveBatteryLevel is kept up to date by keyglove_battery_complete() once per second)
 
         // update battery presence bit
         //if (rawBat > 100) keygloveBatteryStatus |= 0x80;    // battery present
@@ -291,12 +376,34 @@ void loop() {
     }
     
     // MOTION
-    #if (KG_MOTION & KG_MOTION_MPU6050_HAND)
-        // check for available motion data from MPU-6050 on back of hand
-        if (mpuHandInterrupt) {
-            mpuHandInterrupt = false; // clear the flag so we don't read again until the next interrupt
-            update_motion_mpu6050_hand();
-        }
+    #if (KG_MOTION > 0)
+        // check for available motion data from all motion sensors
+        update_motion();
+    #endif
+
+    // run queued I2C transactions (motion sensors, battery gauge) in turn
+    update_i2c();
+
+    // HUMAN INPUT DEVICE
+    #if (KG_HID & KG_HID_KEYBOARD)
+        // send one keyboard report for all key changes made during this pass
+        update_hid_keyboard();
+    #endif
+    #if (KG_HID & KG_HID_MOUSE)
+        // send mouse movement left over from earlier motion samples
+        update_hid_mouse();
+    #endif
+
+    // TOUCHSET
+    #if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+        // write the next byte of an uploaded touchset into EEPROM, if the EEPROM is ready
+        update_touchset();
+    #endif
+
+    // FLIGHT RECORDER
+    #if (KG_RECORDER > 0)
+        // send the next piece of a recorder download, if one is in progress
+        update_recorder();
     #endif
     
     // send any queued packets
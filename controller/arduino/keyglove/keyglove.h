@@ -51,11 +51,16 @@ THE SOFTWARE.
 #define _KEYGLOVE_H_
 
 // UNIVERSAL INCLUDES
-#include <I2Cdev.h>
+#include <Arduino.h>
 #include "version.h"
 #include "hardware.h"
 #include "config.h"
 
+// EEPROM LAYOUT (stored touchset grows up from 0x0000, fixed-size records sit at the top)
+#define KG_EEPROM_MOTION_BIAS_ADDRESS   (E2END + 1 - 16)                ///< Stored motion sensor gyro bias (16 bytes)
+#define KG_EEPROM_MOTION_GESTURE_ADDRESS (KG_EEPROM_MOTION_BIAS_ADDRESS - 400) ///< Stored motion gesture templates (400 bytes)
+#define KG_EEPROM_RECORDS_ADDRESS       KG_EEPROM_MOTION_GESTURE_ADDRESS ///< Lowest address used by fixed-size records
+
 extern volatile uint8_t keyglove100Hz;
 extern uint8_t keygloveTick;
 extern uint32_t keygloveTock;
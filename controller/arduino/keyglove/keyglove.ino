@@ -43,8 +43,14 @@ THE SOFTWARE.
  * LIBRARY INCLUDES FOR PROPER BUILD PROCESS
 =============================================== */
 
-#include <Wire.h>       // Core Arduino I2C hardware library
-#include <I2Cdev.h>     // I2Cdevlib device wrapper library
-#include <MPU6050.h>    // MPU-6050 I2C sensor support for I2Cdevlib
+#include "keyglove.h"     // build options, which decide the I2C libraries below
+
+#if (KG_I2C == KG_I2C_WIRE)
+    #include <Wire.h>       // Core Arduino I2C hardware library (KG_I2C_TWI replaces it, see config.h)
+#endif
+#if (KG_I2C == KG_I2C_WIRE) || (KG_FUSION & KG_FUSION_DMP)
+    #include <I2Cdev.h>     // I2Cdevlib device wrapper library
+    #include <MPU6050.h>    // MPU-6050 I2C sensor support for I2Cdevlib (DMP loader)
+#endif
 #include <iWRAP.h>      // Bluegiga iWRAP parser library
 #include <EEPROM.h>     // Core Arduino EEPROM library
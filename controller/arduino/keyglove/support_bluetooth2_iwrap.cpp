@@ -445,6 +445,26 @@ uint8_t bluetooth_check_incoming_protocol_data() {
     return 0;
 }
 
+/**
+ * @brief Check whether outgoing KGAPI events currently go over a Bluetooth link
+ * @return True if any Bluetooth API interface is connected and sending
+ *
+ * Used to pick larger motion data batches automatically, since every packet
+ * sent over Bluetooth also costs an iWRAP MUX frame and radio overhead.
+ */
+bool bluetooth_api_ready() {
+    #if KG_HOSTIF & KG_HOSTIF_BT2_SERIAL
+        if (interfaceBT2SerialReady && (interfaceBT2SerialMode & KG_INTERFACE_MODE_OUTGOING_API) != 0) return true;
+    #endif
+    #if KG_HOSTIF & KG_HOSTIF_BT2_RAWHID
+        if (interfaceBT2RawHIDReady && (interfaceBT2RawHIDMode & KG_INTERFACE_MODE_OUTGOING_API) != 0) return true;
+    #endif
+    #if KG_HOSTIF & KG_HOSTIF_BT2_IAP
+        if (interfaceBT2IAPReady && (interfaceBT2IAPMode & KG_INTERFACE_MODE_OUTGOING_API) != 0) return true;
+    #endif
+    return false;
+}
+
 /**
  * @brief Send a KGAPI packet using the Bluetooth v2 (iWRAP) interface
  * @param[in] buffer Outgoing packet buffer
@@ -101,6 +101,7 @@ and so on. Start with pin 26 (B6)
 
 #include "keyglove.h"
 #include "support_board_teensypp2_t19.h"
+#include "support_touch.h"
 
 // for compiler's sake, make sure this is ACTUALLY code we need
 // (interrupt vector definition cause problems across multiple source files)
@@ -112,6 +113,22 @@ uint8_t _pind;                          ///< Container for reading Port D logic
 uint8_t _pine;                          ///< Container for reading Port E logic state
 uint8_t _pinf;                          ///< Container for reading Port F logic state
 
+/**
+ * @brief Triangles of base combinations that can produce ghost contacts
+ *
+ * When three sensors are connected in a loop, driving any one of them low
+ * pulls both others low, so two real contacts always imply the third. The
+ * last combination in each row is the one KG_TOUCH_GHOST_MODE_MASK removes
+ * when it cannot tell which side is the ghost, so it is never a fingertip to
+ * thumb (Y) combination, since those carry most chords.
+ */
+const uint8_t boardGhostTriangles[KG_GHOST_TRIANGLES][3] PROGMEM = {
+    { KGB_A1, KGB_AY, KGB_Y1 },
+    { KGB_D1, KGB_DY, KGB_Y1 },
+    { KGB_G1, KGB_GY, KGB_Y1 },
+    { KGB_J1, KGB_JY, KGB_Y1 },
+};
+
 volatile uint8_t keygloveBatteryStatus0;    ///< Variable for comparing new vs. old battery status
 
 bool interfaceUSBSerialReady = false;   ///< Status indicator for USB serial interface
@@ -293,8 +310,8 @@ void update_board_touch(uint8_t *touches) {
     // check on Y combinations (PB6)
     SET(DDRB, 6);       // set to OUTPUT
     CLR(PORTB, 6);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinb = PINB; _pinc = PINC; _pind = PIND; _pine = PINE; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pind = KG_TOUCH_READ(PIND, KG_TOUCH_PINMASK_D); _pine = KG_TOUCH_READ(PINE, KG_TOUCH_PINMASK_E); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 6);       // set to INPUT
     SET(PORTB, 6);      // pull HIGH
     if (!(_pinf & (1 << 1))) touches[0] |= 0x01;    // A (PF1)
@@ -318,8 +335,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 1 combinations (PB7)
     SET(DDRB, 7);       // set to OUTPUT
     CLR(PORTB, 7);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinc = PINC; _pine = PINE; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pine = KG_TOUCH_READ(PINE, KG_TOUCH_PINMASK_E); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 7);       // set to INPUT
     SET(PORTB, 7);      // pull HIGH
     if (!(_pinf & (1 << 1))) touches[2] |= 0x02;    // A (PF1)
@@ -330,8 +347,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 8 combinations (PB5)
     SET(DDRB, 5);       // set to OUTPUT
     CLR(PORTB, 5);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinc = PINC; _pine = PINE; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pine = KG_TOUCH_READ(PINE, KG_TOUCH_PINMASK_E); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 5);       // set to INPUT
     SET(PORTB, 5);      // pull HIGH
     if (!(_pinf & (1 << 1))) touches[2] |= 0x20;    // A (PF1)
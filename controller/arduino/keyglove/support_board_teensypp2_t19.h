@@ -74,36 +74,80 @@ THE SOFTWARE.
 // NOTE: KG_BASE_COMBINATIONS seems like it would be very high, but there are
 // physical and practical limitations that make this number much smaller
 
-#define KGT_AY(test) (test[0] & 0x01)
-#define KGT_BY(test) (test[0] & 0x02)
-#define KGT_CY(test) (test[0] & 0x04)
-#define KGT_DY(test) (test[0] & 0x08)
-#define KGT_EY(test) (test[0] & 0x10)
-#define KGT_FY(test) (test[0] & 0x20)
-#define KGT_GY(test) (test[0] & 0x40)
-#define KGT_HY(test) (test[0] & 0x80)
-#define KGT_IY(test) (test[1] & 0x01)
-#define KGT_JY(test) (test[1] & 0x02)
-#define KGT_KY(test) (test[1] & 0x04)
-#define KGT_LY(test) (test[1] & 0x08)
-#define KGT_A1(test) (test[1] & 0x10)
-#define KGT_D1(test) (test[1] & 0x20)
-#define KGT_G1(test) (test[1] & 0x40)
-#define KGT_J1(test) (test[1] & 0x80)
-#define KGT_Y4(test) (test[2] & 0x01)
-#define KGT_Y5(test) (test[2] & 0x02)
-#define KGT_Y6(test) (test[2] & 0x04)
-#define KGT_Y7(test) (test[2] & 0x08)
-#define KGT_A8(test) (test[2] & 0x10)
-#define KGT_D8(test) (test[2] & 0x20)
-#define KGT_G8(test) (test[2] & 0x40)
-#define KGT_J8(test) (test[2] & 0x80)
-#define KGT_Y1(test) (test[3] & 0x01)
-
-#define KGT_ADY (KGT_AY && KGT_DY)
-#define KGT_AJY (KGT_AY && KGT_JY)
-#define KGT_DGY (KGT_DY && KGT_GY)
-#define KGT_GJY (KGT_GY && KGT_JY)
+#ifndef KG_BOARD_TOUCH_SETTLE_US
+    #define KG_BOARD_TOUCH_SETTLE_US    3       ///< Microseconds to wait after driving a sensor low before reading connected pins
+#endif
+
+// touch sensor pins on each port (used to detect disagreement between oversampled reads)
+#define KG_TOUCH_PINMASK_B              0xE0    ///< PB7, PB6, PB5
+#define KG_TOUCH_PINMASK_C              0x8F    ///< PC7, PC3, PC2, PC1, PC0
+#define KG_TOUCH_PINMASK_D              0xA0    ///< PD7, PD5
+#define KG_TOUCH_PINMASK_E              0x03    ///< PE1, PE0
+#define KG_TOUCH_PINMASK_F              0xFE    ///< PF7, PF6, PF5, PF4, PF3, PF2, PF1
+
+// base combination bit indexes, in the order update_board_touch() fills the status bytes
+#define KGB_AY                          0
+#define KGB_BY                          1
+#define KGB_CY                          2
+#define KGB_DY                          3
+#define KGB_EY                          4
+#define KGB_FY                          5
+#define KGB_GY                          6
+#define KGB_HY                          7
+#define KGB_IY                          8
+#define KGB_JY                          9
+#define KGB_KY                          10
+#define KGB_LY                          11
+#define KGB_Y4                          12
+#define KGB_Y5                          13
+#define KGB_Y6                          14
+#define KGB_Y7                          15
+#define KGB_Y1                          16
+#define KGB_A1                          17
+#define KGB_D1                          18
+#define KGB_G1                          19
+#define KGB_J1                          20
+#define KGB_A8                          21
+#define KGB_D8                          22
+#define KGB_G8                          23
+#define KGB_J8                          24
+
+// base combination test macros, e.g. "if (KGT_AY(touches_active)) ..."
+#define KGT_BIT(test, index) (test[(index) >> 3] & (1 << ((index) & 7)))
+#define KGT_AY(test) KGT_BIT(test, KGB_AY)
+#define KGT_BY(test) KGT_BIT(test, KGB_BY)
+#define KGT_CY(test) KGT_BIT(test, KGB_CY)
+#define KGT_DY(test) KGT_BIT(test, KGB_DY)
+#define KGT_EY(test) KGT_BIT(test, KGB_EY)
+#define KGT_FY(test) KGT_BIT(test, KGB_FY)
+#define KGT_GY(test) KGT_BIT(test, KGB_GY)
+#define KGT_HY(test) KGT_BIT(test, KGB_HY)
+#define KGT_IY(test) KGT_BIT(test, KGB_IY)
+#define KGT_JY(test) KGT_BIT(test, KGB_JY)
+#define KGT_KY(test) KGT_BIT(test, KGB_KY)
+#define KGT_LY(test) KGT_BIT(test, KGB_LY)
+#define KGT_A1(test) KGT_BIT(test, KGB_A1)
+#define KGT_D1(test) KGT_BIT(test, KGB_D1)
+#define KGT_G1(test) KGT_BIT(test, KGB_G1)
+#define KGT_J1(test) KGT_BIT(test, KGB_J1)
+#define KGT_Y4(test) KGT_BIT(test, KGB_Y4)
+#define KGT_Y5(test) KGT_BIT(test, KGB_Y5)
+#define KGT_Y6(test) KGT_BIT(test, KGB_Y6)
+#define KGT_Y7(test) KGT_BIT(test, KGB_Y7)
+#define KGT_A8(test) KGT_BIT(test, KGB_A8)
+#define KGT_D8(test) KGT_BIT(test, KGB_D8)
+#define KGT_G8(test) KGT_BIT(test, KGB_G8)
+#define KGT_J8(test) KGT_BIT(test, KGB_J8)
+#define KGT_Y1(test) KGT_BIT(test, KGB_Y1)
+
+#define KGT_ADY(test) (KGT_AY(test) && KGT_DY(test))
+#define KGT_AJY(test) (KGT_AY(test) && KGT_JY(test))
+#define KGT_DGY(test) (KGT_DY(test) && KGT_GY(test))
+#define KGT_GJY(test) (KGT_GY(test) && KGT_JY(test))
+
+// combinations whose sensor pins form a closed triangle, so any two active ones electrically imply the third
+#define KG_GHOST_TRIANGLES 4
+extern const uint8_t boardGhostTriangles[KG_GHOST_TRIANGLES][3];
 
 #define CLR(x, y) (x &= (~(1 << y)))    ///< Bit-clearing macro for port/pin combination
 #define SET(x, y) (x |= (1 << y))       ///< Bit-setting macro for port/pin combination
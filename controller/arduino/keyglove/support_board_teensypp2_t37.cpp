@@ -96,6 +96,7 @@ and so on. Start with pin 26 (B6)
 
 #include "keyglove.h"
 #include "support_board_teensypp2_t37.h"
+#include "support_touch.h"
 
 // for compiler's sake, make sure this is ACTUALLY code we need
 // (interrupt vector definition cause problems across multiple source files)
@@ -108,6 +109,27 @@ uint8_t _pind;                          ///< Container for reading Port D logic
 uint8_t _pine;                          ///< Container for reading Port E logic state
 uint8_t _pinf;                          ///< Container for reading Port F logic state
 
+/**
+ * @brief Triangles of base combinations that can produce ghost contacts
+ *
+ * When three sensors are connected in a loop, driving any one of them low
+ * pulls both others low, so two real contacts always imply the third. The
+ * last combination in each row is the one KG_TOUCH_GHOST_MODE_MASK removes
+ * when it cannot tell which side is the ghost, so it is never a fingertip to
+ * thumb (Y) combination, since those carry most chords.
+ */
+const uint8_t boardGhostTriangles[KG_GHOST_TRIANGLES][3] PROGMEM = {
+    { KGB_A1, KGB_AY, KGB_Y1 },
+    { KGB_D1, KGB_DY, KGB_Y1 },
+    { KGB_G1, KGB_GY, KGB_Y1 },
+    { KGB_J1, KGB_JY, KGB_Y1 },
+    { KGB_D4, KGB_DY, KGB_Y4 },
+    { KGB_D6, KGB_DY, KGB_Y6 },
+    { KGB_D7, KGB_DY, KGB_Y7 },
+    { KGB_G7, KGB_GY, KGB_Y7 },
+    { KGB_DY, KGB_MY, KGB_DM },
+};
+
 bool interfaceUSBSerialReady = false;   ///< Status indicator for USB serial interface
 uint8_t interfaceUSBSerialMode = 0;     ///< USB serial communication mode setting @see KG_INTERFACE_MODE_NONE, @see KG_INTERFACE_MODE_OUTGOING_API, @see KG_INTERFACE_MODE_INCOMING_API
 bool interfaceUSBRawHIDReady = false;   ///< Status indicator for USB raw HID interface
@@ -218,8 +240,8 @@ void update_board_touch(uint8_t *touches) {
     // check on M combinations (PF2)
     SET(DDRF, 2);       // set to OUTPUT
     CLR(PORTF, 2);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRF, 2);       // set to INPUT
     SET(PORTF, 2);      // pull HIGH
     if (!(_pinf & (1 << 6))) touches[0] |= 0x01;    // D (PF6)
@@ -228,8 +250,8 @@ void update_board_touch(uint8_t *touches) {
     // check on Y combinations (PB6)
     SET(DDRB, 6);       // set to OUTPUT
     CLR(PORTB, 6);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinc = PINC; _pind = PIND; _pine = PINE; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pind = KG_TOUCH_READ(PIND, KG_TOUCH_PINMASK_D); _pine = KG_TOUCH_READ(PINE, KG_TOUCH_PINMASK_E); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 6);       // set to INPUT
     SET(PORTB, 6);      // pull HIGH
     if (!(_pinb & (1 << 0))) touches[0] |= 0x02;    // A (PB0)
@@ -301,8 +323,8 @@ void update_board_touch(uint8_t *touches) {
     // check on Z combinations (PB5)
     SET(DDRB, 5);       // set to OUTPUT
     CLR(PORTB, 5);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 5);       // set to INPUT
     SET(PORTB, 5);      // pull HIGH
     if (!(_pinf & (1 << 2))) touches[3] |= 0x02;    // M (PF2)
@@ -329,8 +351,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 1 combinations (PD5)
     SET(DDRD, 5);       // set to OUTPUT
     CLR(PORTD, 5);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinc = PINC; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRD, 5);       // set to INPUT
     SET(PORTD, 5);      // pull HIGH
     if (!(_pinb & (1 << 0))) touches[3] |= 0x80;    // A (PB0)
@@ -353,8 +375,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 2 combinations (PD4)
     SET(DDRD, 4);       // set to OUTPUT
     CLR(PORTD, 4);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinc = PINC; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRD, 4);       // set to INPUT
     SET(PORTD, 4);      // pull HIGH
     if (!(_pinb & (1 << 0))) touches[4] |= 0x10;    // A (PB0)
@@ -375,8 +397,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 3 combinations (PB7)
     SET(DDRB, 7);       // set to OUTPUT
     CLR(PORTB, 7);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinc = PINC; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 7);       // set to INPUT
     SET(PORTB, 7);      // pull HIGH
     if (!(_pinb & (1 << 0))) touches[5] |= 0x01;    // A (PB0)
@@ -397,8 +419,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 4 combinations (PF5)
     SET(DDRF, 5);       // set to OUTPUT
     CLR(PORTF, 5);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinb = PINB; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRF, 5);       // set to INPUT
     SET(PORTF, 5);      // pull HIGH
     if (!(_pinf & (1 << 6))) touches[5] |= 0x10;    // D (PF6)
@@ -418,8 +440,8 @@ void update_board_touch(uint8_t *touches) {
         SET(DDRA, 4);       // set to OUTPUT
         CLR(PORTA, 4);      // set to LOW
     #endif
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinb = PINB;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B);
     #ifdef KEYGLOVE_KIT_BUG_PORTA_REVERSED
         // d'oh! Teensy++ part in Eagle PA0-7 pins were backwards
         // PA0 = PA4, PA1 = PA5, PA2 = PA6, PA3 = PA7, PA4 = PA0, PA5 = PA1, PA6 = PA2, PA7 = PA3
@@ -437,8 +459,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 6 combinations (PC4)
     SET(DDRC, 4);       // set to OUTPUT
     CLR(PORTC, 4);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pinb = PINB; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRC, 4);       // set to INPUT
     SET(PORTC, 4);      // pull HIGH
     if (!(_pinf & (1 << 6))) touches[6] |= 0x02;    // D (PF6)
@@ -451,8 +473,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 7 combinations (PD7)
     SET(DDRD, 7);       // set to OUTPUT
     CLR(PORTD, 7);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRD, 7);       // set to INPUT
     SET(PORTD, 7);      // pull HIGH
     if (!(_pinf & (1 << 6))) touches[6] |= 0x10;    // D (PF6)
@@ -473,8 +495,8 @@ void update_board_touch(uint8_t *touches) {
     // check on 8 combinations (PB3)
     SET(DDRB, 3);       // set to OUTPUT
     CLR(PORTB, 3);      // set to LOW
-    delayMicroseconds(3); // give the poor receiving pins a chance to change state
-    _pina = PINA; _pinb = PINB; _pinc = PINC; _pinf = PINF;
+    delayMicroseconds(KG_BOARD_TOUCH_SETTLE_US); // give the poor receiving pins a chance to change state
+    _pina = KG_TOUCH_READ(PINA, KG_TOUCH_PINMASK_A); _pinb = KG_TOUCH_READ(PINB, KG_TOUCH_PINMASK_B); _pinc = KG_TOUCH_READ(PINC, KG_TOUCH_PINMASK_C); _pinf = KG_TOUCH_READ(PINF, KG_TOUCH_PINMASK_F);
     CLR(DDRB, 3);       // set to INPUT
     SET(PORTB, 3);      // pull HIGH
     if (!(_pinb & (1 << 0))) touches[7] |= 0x01;    // A (PB0)
@@ -67,71 +67,151 @@ THE SOFTWARE.
 // NOTE: KG_BASE_COMBINATIONS seems like it would be very high, but there are
 // physical and practical limitations that make this number much smaller
 
-#define KGT_DM(test) (test[0] & 0x01)
-#define KGT_AY(test) (test[0] & 0x02)
-#define KGT_BY(test) (test[0] & 0x04)
-#define KGT_CY(test) (test[0] & 0x08)
-#define KGT_DY(test) (test[0] & 0x10)
-#define KGT_EY(test) (test[0] & 0x20)
-#define KGT_FY(test) (test[0] & 0x40)
-#define KGT_GY(test) (test[0] & 0x80)
-#define KGT_HY(test) (test[1] & 0x01)
-#define KGT_IY(test) (test[1] & 0x02)
-#define KGT_JY(test) (test[1] & 0x04)
-#define KGT_KY(test) (test[1] & 0x08)
-#define KGT_LY(test) (test[1] & 0x10)
-#define KGT_MY(test) (test[1] & 0x20)
-#define KGT_NY(test) (test[1] & 0x40)
-#define KGT_OY(test) (test[1] & 0x80)
-#define KGT_PY(test) (test[2] & 0x01)
-#define KGT_QY(test) (test[2] & 0x02)
-#define KGT_RY(test) (test[2] & 0x04)
-#define KGT_SY(test) (test[2] & 0x08)
-#define KGT_TY(test) (test[2] & 0x10)
-#define KGT_UY(test) (test[2] & 0x20)
-#define KGT_VY(test) (test[2] & 0x40)
-#define KGT_WY(test) (test[2] & 0x80)
-#define KGT_XY(test) (test[3] & 0x01)
-#define KGT_MZ(test) (test[3] & 0x02)
-#define KGT_NZ(test) (test[3] & 0x04)
-#define KGT_OZ(test) (test[3] & 0x08)
-#define KGT_PZ(test) (test[3] & 0x10)
-#define KGT_QZ(test) (test[3] & 0x20)
-#define KGT_RZ(test) (test[3] & 0x40)
-#define KGT_A1(test) (test[3] & 0x80)
-#define KGT_D1(test) (test[4] & 0x01)
-#define KGT_G1(test) (test[4] & 0x02)
-#define KGT_J1(test) (test[4] & 0x04)
-#define KGT_Y1(test) (test[4] & 0x08)
-#define KGT_A2(test) (test[4] & 0x10)
-#define KGT_D2(test) (test[4] & 0x20)
-#define KGT_G2(test) (test[4] & 0x40)
-#define KGT_J2(test) (test[4] & 0x80)
-#define KGT_A3(test) (test[5] & 0x01)
-#define KGT_D3(test) (test[5] & 0x02)
-#define KGT_G3(test) (test[5] & 0x04)
-#define KGT_J3(test) (test[5] & 0x08)
-#define KGT_D4(test) (test[5] & 0x10)
-#define KGT_Y4(test) (test[5] & 0x20)
-#define KGT_Z4(test) (test[5] & 0x40)
-#define KGT_Y5(test) (test[5] & 0x80)
-#define KGT_Z5(test) (test[6] & 0x01)
-#define KGT_D6(test) (test[6] & 0x02)
-#define KGT_Y6(test) (test[6] & 0x04)
-#define KGT_Z6(test) (test[6] & 0x08)
-#define KGT_D7(test) (test[6] & 0x10)
-#define KGT_G7(test) (test[6] & 0x20)
-#define KGT_Y7(test) (test[6] & 0x40)
-#define KGT_Z7(test) (test[6] & 0x80)
-#define KGT_A8(test) (test[7] & 0x01)
-#define KGT_D8(test) (test[7] & 0x02)
-#define KGT_G8(test) (test[7] & 0x04)
-#define KGT_J8(test) (test[7] & 0x08)
-
-#define KGT_ADY (KGT_AY && KGT_DY)
-#define KGT_AJY (KGT_AY && KGT_JY)
-#define KGT_DGY (KGT_DY && KGT_GY)
-#define KGT_GJY (KGT_GY && KGT_JY)
+#ifndef KG_BOARD_TOUCH_SETTLE_US
+    #define KG_BOARD_TOUCH_SETTLE_US    3       ///< Microseconds to wait after driving a sensor low before reading connected pins
+#endif
+
+// touch sensor pins on each port (used to detect disagreement between oversampled reads)
+#define KG_TOUCH_PINMASK_A              0xFF    ///< PA0, PA1, PA2, PA3, PA4, PA5, PA6, PA7
+#define KG_TOUCH_PINMASK_B              0xFF    ///< PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7
+#define KG_TOUCH_PINMASK_C              0xFF    ///< PC0, PC1, PC2, PC3, PC4, PC5, PC6, PC7
+#define KG_TOUCH_PINMASK_D              0xB0    ///< PD4, PD5, PD7
+#define KG_TOUCH_PINMASK_E              0x03    ///< PE0, PE1
+#define KG_TOUCH_PINMASK_F              0xFF    ///< PF0, PF1, PF2, PF3, PF4, PF5, PF6, PF7
+
+// base combination bit indexes, in the order update_board_touch() fills the status bytes
+#define KGB_DM                          0
+#define KGB_AY                          1
+#define KGB_BY                          2
+#define KGB_CY                          3
+#define KGB_DY                          4
+#define KGB_EY                          5
+#define KGB_FY                          6
+#define KGB_GY                          7
+#define KGB_HY                          8
+#define KGB_IY                          9
+#define KGB_JY                          10
+#define KGB_KY                          11
+#define KGB_LY                          12
+#define KGB_MY                          13
+#define KGB_NY                          14
+#define KGB_OY                          15
+#define KGB_PY                          16
+#define KGB_QY                          17
+#define KGB_RY                          18
+#define KGB_SY                          19
+#define KGB_TY                          20
+#define KGB_UY                          21
+#define KGB_VY                          22
+#define KGB_WY                          23
+#define KGB_XY                          24
+#define KGB_MZ                          25
+#define KGB_NZ                          26
+#define KGB_OZ                          27
+#define KGB_PZ                          28
+#define KGB_QZ                          29
+#define KGB_RZ                          30
+#define KGB_A1                          31
+#define KGB_D1                          32
+#define KGB_G1                          33
+#define KGB_J1                          34
+#define KGB_Y1                          35
+#define KGB_A2                          36
+#define KGB_D2                          37
+#define KGB_G2                          38
+#define KGB_J2                          39
+#define KGB_A3                          40
+#define KGB_D3                          41
+#define KGB_G3                          42
+#define KGB_J3                          43
+#define KGB_D4                          44
+#define KGB_Y4                          45
+#define KGB_Z4                          46
+#define KGB_Y5                          47
+#define KGB_Z5                          48
+#define KGB_D6                          49
+#define KGB_Y6                          50
+#define KGB_Z6                          51
+#define KGB_D7                          52
+#define KGB_G7                          53
+#define KGB_Y7                          54
+#define KGB_Z7                          55
+#define KGB_A8                          56
+#define KGB_D8                          57
+#define KGB_G8                          58
+#define KGB_J8                          59
+
+// base combination test macros, e.g. "if (KGT_AY(touches_active)) ..."
+#define KGT_BIT(test, index) (test[(index) >> 3] & (1 << ((index) & 7)))
+#define KGT_DM(test) KGT_BIT(test, KGB_DM)
+#define KGT_AY(test) KGT_BIT(test, KGB_AY)
+#define KGT_BY(test) KGT_BIT(test, KGB_BY)
+#define KGT_CY(test) KGT_BIT(test, KGB_CY)
+#define KGT_DY(test) KGT_BIT(test, KGB_DY)
+#define KGT_EY(test) KGT_BIT(test, KGB_EY)
+#define KGT_FY(test) KGT_BIT(test, KGB_FY)
+#define KGT_GY(test) KGT_BIT(test, KGB_GY)
+#define KGT_HY(test) KGT_BIT(test, KGB_HY)
+#define KGT_IY(test) KGT_BIT(test, KGB_IY)
+#define KGT_JY(test) KGT_BIT(test, KGB_JY)
+#define KGT_KY(test) KGT_BIT(test, KGB_KY)
+#define KGT_LY(test) KGT_BIT(test, KGB_LY)
+#define KGT_MY(test) KGT_BIT(test, KGB_MY)
+#define KGT_NY(test) KGT_BIT(test, KGB_NY)
+#define KGT_OY(test) KGT_BIT(test, KGB_OY)
+#define KGT_PY(test) KGT_BIT(test, KGB_PY)
+#define KGT_QY(test) KGT_BIT(test, KGB_QY)
+#define KGT_RY(test) KGT_BIT(test, KGB_RY)
+#define KGT_SY(test) KGT_BIT(test, KGB_SY)
+#define KGT_TY(test) KGT_BIT(test, KGB_TY)
+#define KGT_UY(test) KGT_BIT(test, KGB_UY)
+#define KGT_VY(test) KGT_BIT(test, KGB_VY)
+#define KGT_WY(test) KGT_BIT(test, KGB_WY)
+#define KGT_XY(test) KGT_BIT(test, KGB_XY)
+#define KGT_MZ(test) KGT_BIT(test, KGB_MZ)
+#define KGT_NZ(test) KGT_BIT(test, KGB_NZ)
+#define KGT_OZ(test) KGT_BIT(test, KGB_OZ)
+#define KGT_PZ(test) KGT_BIT(test, KGB_PZ)
+#define KGT_QZ(test) KGT_BIT(test, KGB_QZ)
+#define KGT_RZ(test) KGT_BIT(test, KGB_RZ)
+#define KGT_A1(test) KGT_BIT(test, KGB_A1)
+#define KGT_D1(test) KGT_BIT(test, KGB_D1)
+#define KGT_G1(test) KGT_BIT(test, KGB_G1)
+#define KGT_J1(test) KGT_BIT(test, KGB_J1)
+#define KGT_Y1(test) KGT_BIT(test, KGB_Y1)
+#define KGT_A2(test) KGT_BIT(test, KGB_A2)
+#define KGT_D2(test) KGT_BIT(test, KGB_D2)
+#define KGT_G2(test) KGT_BIT(test, KGB_G2)
+#define KGT_J2(test) KGT_BIT(test, KGB_J2)
+#define KGT_A3(test) KGT_BIT(test, KGB_A3)
+#define KGT_D3(test) KGT_BIT(test, KGB_D3)
+#define KGT_G3(test) KGT_BIT(test, KGB_G3)
+#define KGT_J3(test) KGT_BIT(test, KGB_J3)
+#define KGT_D4(test) KGT_BIT(test, KGB_D4)
+#define KGT_Y4(test) KGT_BIT(test, KGB_Y4)
+#define KGT_Z4(test) KGT_BIT(test, KGB_Z4)
+#define KGT_Y5(test) KGT_BIT(test, KGB_Y5)
+#define KGT_Z5(test) KGT_BIT(test, KGB_Z5)
+#define KGT_D6(test) KGT_BIT(test, KGB_D6)
+#define KGT_Y6(test) KGT_BIT(test, KGB_Y6)
+#define KGT_Z6(test) KGT_BIT(test, KGB_Z6)
+#define KGT_D7(test) KGT_BIT(test, KGB_D7)
+#define KGT_G7(test) KGT_BIT(test, KGB_G7)
+#define KGT_Y7(test) KGT_BIT(test, KGB_Y7)
+#define KGT_Z7(test) KGT_BIT(test, KGB_Z7)
+#define KGT_A8(test) KGT_BIT(test, KGB_A8)
+#define KGT_D8(test) KGT_BIT(test, KGB_D8)
+#define KGT_G8(test) KGT_BIT(test, KGB_G8)
+#define KGT_J8(test) KGT_BIT(test, KGB_J8)
+
+#define KGT_ADY(test) (KGT_AY(test) && KGT_DY(test))
+#define KGT_AJY(test) (KGT_AY(test) && KGT_JY(test))
+#define KGT_DGY(test) (KGT_DY(test) && KGT_GY(test))
+#define KGT_GJY(test) (KGT_GY(test) && KGT_JY(test))
+
+// combinations whose sensor pins form a closed triangle, so any two active ones electrically imply the third
+#define KG_GHOST_TRIANGLES 9
+extern const uint8_t boardGhostTriangles[KG_GHOST_TRIANGLES][3];
 
 #define CLR(x, y) (x &= (~(1 << y)))    ///< Bit-clearing macro for port/pin combination
 #define SET(x, y) (x |= (1 << y))       ///< Bit-setting macro for port/pin combination
@@ -31,15 +31,22 @@ THE SOFTWARE.
  * @author Jeff Rowberg
  * @date 2014-11-07
  *
- * Contains quaternion implementation with floats and vector implementations
- * with both floats and 16-bit signed integers. Mainly useful in any optional
- * onboard motion computations that you want to include in your customized
- * application behavior, beyond raw accel/gyro sensor readings.
+ * Contains Q1.15 quaternion and Q16.16 vector implementations, and a Mahony
+ * orientation filter built on them, which use only integer math. The AVR has
+ * no FPU, so each float multiply or add costs 100+ cycles and each divide or
+ * square root several hundred, while a 16x16-bit integer multiply costs a few
+ * dozen cycles at most.
+ *
+ * The float quaternion and vector classes are inline in I2Cdevlib's
+ * helper_3dmath.h, which is only part of the build with KG_FUSION_DMP. In any
+ * other configuration they are implemented here.
  */
 
 #include "keyglove.h"
 #include "support_helper_3dmath.h"
 
+#if !(KG_FUSION & KG_FUSION_DMP)
+
 /**
  * @brief Initializes quaternion to known "zero" state
  */
@@ -290,3 +297,345 @@ VectorFloat VectorFloat::getRotated(Quaternion *q) {
     r.rotate(q);
     return r;
 }
+
+#endif
+
+/**
+ * @brief Multiply a 32-bit fixed-point value by a Q1.15 value
+ * @param[in] a Value to scale (|a / 32768 * b| must fit in 31 bits)
+ * @param[in] b Q1.15 scale factor
+ * @return (a * b) >> 15, without needing a 64-bit product
+ */
+int32_t fixed_mul_q15(int32_t a, int16_t b) {
+    // split a into (hi << 15) + lo, so both partial products fit in 32 bits
+    return (a >> 15) * b + (((a & 0x7FFF) * b) >> 15);
+}
+
+/**
+ * @brief Calculate the inverse square root of a sum of squares
+ * @param[in] x Sum of squares (must be nonzero)
+ * @param[out] shift Right shift to apply after multiplying by the result
+ * @return Inverse square root mantissa in Q1.15 (0.5 to 1.0)
+ *
+ * Multiplying any component v of the original vector by the result and then
+ * shifting right by "shift" gives v / sqrt(x) in Q1.15. The input is scaled by
+ * powers of 4 into [1.0, 4.0), a piecewise linear guess gets within 5%, and
+ * two Newton-Raphson steps, y = y * (3 - x * y^2) / 2, refine it to about
+ * Q1.15 precision with no division.
+ */
+uint16_t fixed_inv_sqrt(uint32_t x, uint8_t *shift) {
+    uint32_t t;
+    uint16_t y;
+    uint8_t i, k = 0;
+
+    // scale into [1.0, 4.0) in Q2.30
+    while (x < 0x40000000UL) {
+        x <<= 2;
+        k++;
+    }
+
+    // first guess from chords of 1/sqrt(x) over [1, 2) and [2, 4)
+    if (x < 0x80000000UL) {
+        y = 32768 - (uint16_t)((((x - 0x40000000UL) >> 15) * 9598UL) >> 15);
+    } else {
+        y = 23170 - (uint16_t)((((x - 0x80000000UL) >> 15) * 3394UL) >> 15);
+    }
+
+    // Newton-Raphson refinement
+    for (i = 0; i < 2; i++) {
+        t = ((((x >> 16) * y) >> 14) * y);  // x * y^2 in Q2.30
+        t = 0xC0000000UL - t;               // 3 - x * y^2 in Q2.30
+        y = ((uint32_t)y * (t >> 15)) >> 16;
+    }
+
+    *shift = 15 - k;
+    return y > 32767 ? 32767 : y;
+}
+
+/**
+ * @brief Rotate a 16-bit integer vector by a fixed-point quaternion
+ * @param[in,out] v Vector to rotate
+ * @param[in] q Quaternion to rotate vector by
+ *
+ * Uses v' = v + 2w(u x v) + 2u x (u x v), with u = (x, y, z), in 32-bit
+ * integer math. The rotated vector must still fit in 16 bits.
+ */
+void fixed_rotate_q15(VectorInt16 *v, QuaternionQ15 *q) {
+    int32_t tx, ty, tz;
+
+    // t = (u x v)
+    tx = ((int32_t)q -> y * v -> z - (int32_t)q -> z * v -> y) >> 15;
+    ty = ((int32_t)q -> z * v -> x - (int32_t)q -> x * v -> z) >> 15;
+    tz = ((int32_t)q -> x * v -> y - (int32_t)q -> y * v -> x) >> 15;
+
+    // v' = v + 2(w * t + u x t)
+    v -> x += ((int32_t)q -> w * tx + (int32_t)q -> y * tz - (int32_t)q -> z * ty) >> 14;
+    v -> y += ((int32_t)q -> w * ty + (int32_t)q -> z * tx - (int32_t)q -> x * tz) >> 14;
+    v -> z += ((int32_t)q -> w * tz + (int32_t)q -> x * ty - (int32_t)q -> y * tx) >> 14;
+}
+
+
+
+/**
+ * @brief Initializes quaternion to known "zero" state
+ */
+QuaternionQ15::QuaternionQ15() {
+    w = 32767;
+    x = 0;
+    y = 0;
+    z = 0;
+}
+
+/**
+ * @brief Initializes quaternion with provided components
+ * @param[in] nw W element
+ * @param[in] nx X element
+ * @param[in] ny Y element
+ * @param[in] nz Z element
+ */
+QuaternionQ15::QuaternionQ15(int16_t nw, int16_t nx, int16_t ny, int16_t nz) {
+    w = nw;
+    x = nx;
+    y = ny;
+    z = nz;
+}
+
+/**
+ * @brief Calculate the product of two quaternions Q1 * Q2
+ * @param[in] q Second quaternion (Q2) in calculation
+ * @return Calculated quaternion product
+ */
+QuaternionQ15 QuaternionQ15::getProduct(QuaternionQ15 q) {
+    // same terms as Quaternion::getProduct(), each 16x16-bit product in Q2.30
+    return QuaternionQ15(
+        ((int32_t)w*q.w - (int32_t)x*q.x - (int32_t)y*q.y - (int32_t)z*q.z) >> 15,   // new w
+        ((int32_t)w*q.x + (int32_t)x*q.w + (int32_t)y*q.z - (int32_t)z*q.y) >> 15,   // new x
+        ((int32_t)w*q.y - (int32_t)x*q.z + (int32_t)y*q.w + (int32_t)z*q.x) >> 15,   // new y
+        ((int32_t)w*q.z + (int32_t)x*q.y - (int32_t)y*q.x + (int32_t)z*q.w) >> 15);  // new z
+}
+
+/**
+ * @brief Calculate the conjugate of this quaternion
+ * @return Calculated quaternion conjugate
+ */
+QuaternionQ15 QuaternionQ15::getConjugate() {
+    return QuaternionQ15(w, -x, -y, -z);
+}
+
+/**
+ * @brief Normalize this quaternion (scales so magnitude = 1.0)
+ */
+void QuaternionQ15::normalize() {
+    uint32_t m2 = (int32_t)w*w + (int32_t)x*x + (int32_t)y*y + (int32_t)z*z;
+    uint16_t n;
+    uint8_t shift;
+    if (!m2) return;
+    n = fixed_inv_sqrt(m2, &shift);
+    w = constrain(((int32_t)w * n) >> shift, -32767, 32767);
+    x = constrain(((int32_t)x * n) >> shift, -32767, 32767);
+    y = constrain(((int32_t)y * n) >> shift, -32767, 32767);
+    z = constrain(((int32_t)z * n) >> shift, -32767, 32767);
+}
+
+/**
+ * @brief Create normalized copy of this quaternion
+ * @return Normalized quaternion
+ */
+QuaternionQ15 QuaternionQ15::getNormalized() {
+    QuaternionQ15 r(w, x, y, z);
+    r.normalize();
+    return r;
+}
+
+
+
+/**
+ * @brief Initializes vector to known "zero" state
+ */
+VectorQ16::VectorQ16() {
+    x = 0;
+    y = 0;
+    z = 0;
+}
+
+/**
+ * @brief Initializes vector with provided components
+ * @param[in] nx X element
+ * @param[in] ny Y element
+ * @param[in] nz Z element
+ */
+VectorQ16::VectorQ16(int32_t nx, int32_t ny, int32_t nz) {
+    x = nx;
+    y = ny;
+    z = nz;
+}
+
+/**
+ * @brief Normalize this vector (scales so magnitude = 1.0)
+ */
+void VectorQ16::normalize() {
+    int32_t ax = abs(x), ay = abs(y), az = abs(z);
+    int32_t m = max(ax, max(ay, az));
+    uint32_t m2;
+    uint16_t n;
+    uint8_t s = 0, shift;
+
+    // drop low bits until every component fits in 16 bits, so squares fit in 32
+    while (m > 32767) {
+        m >>= 1;
+        s++;
+    }
+    ax = x >> s;
+    ay = y >> s;
+    az = z >> s;
+    m2 = ax*ax + ay*ay + az*az;
+    if (!m2) return;
+    n = fixed_inv_sqrt(m2, &shift);
+
+    // Q1.15 result, then one more bit for Q16.16
+    x = ((ax * n) >> shift) << 1;
+    y = ((ay * n) >> shift) << 1;
+    z = ((az * n) >> shift) << 1;
+}
+
+/**
+ * @brief Create normalized copy of this vector
+ * @return Normalized vector
+ */
+VectorQ16 VectorQ16::getNormalized() {
+    VectorQ16 r(x, y, z);
+    r.normalize();
+    return r;
+}
+
+/**
+ * @brief Rotate this vector by a given fixed-point quaternion
+ * @param[in] q Quaternion to rotate vector by
+ */
+void VectorQ16::rotate(QuaternionQ15 *q) {
+    int32_t tx, ty, tz;
+
+    // t = (u x v), with u = (x, y, z) of the quaternion
+    tx = fixed_mul_q15(z, q -> y) - fixed_mul_q15(y, q -> z);
+    ty = fixed_mul_q15(x, q -> z) - fixed_mul_q15(z, q -> x);
+    tz = fixed_mul_q15(y, q -> x) - fixed_mul_q15(x, q -> y);
+
+    // v' = v + 2(w * t + u x t)
+    x += (fixed_mul_q15(tx, q -> w) + fixed_mul_q15(tz, q -> y) - fixed_mul_q15(ty, q -> z)) << 1;
+    y += (fixed_mul_q15(ty, q -> w) + fixed_mul_q15(tx, q -> z) - fixed_mul_q15(tz, q -> x)) << 1;
+    z += (fixed_mul_q15(tz, q -> w) + fixed_mul_q15(ty, q -> x) - fixed_mul_q15(tx, q -> y)) << 1;
+}
+
+/**
+ * @brief Create rotated copy of this vector
+ * @param[in] q Quaternion to rotate vector by
+ * @return Rotated vector
+ */
+VectorQ16 VectorQ16::getRotated(QuaternionQ15 *q) {
+    VectorQ16 r(x, y, z);
+    r.rotate(q);
+    return r;
+}
+
+
+
+/**
+ * @brief Initializes filter with update constants and "zero" orientation
+ * @param[in] nGyroStep Half-angle per update for one gyro count (see KG_MAHONY_GYRO_STEP())
+ * @param[in] nKpStep Scaled proportional gain (see KG_MAHONY_KP_STEP())
+ * @param[in] nKiStep Scaled integral gain, or 0 for none (see KG_MAHONY_KI_STEP())
+ */
+MahonyFilter::MahonyFilter(int32_t nGyroStep, uint16_t nKpStep, uint16_t nKiStep) {
+    gyroStep = nGyroStep;
+    kpStep = nKpStep;
+    kiStep = nKiStep;
+    reset();
+}
+
+/**
+ * @brief Reset orientation to "zero" state and clear integral feedback
+ */
+void MahonyFilter::reset() {
+    q[0] = 0x40000000L;
+    q[1] = q[2] = q[3] = 0;
+    integral[0] = integral[1] = integral[2] = 0;
+}
+
+/**
+ * @brief Update orientation from one accel/gyro sample
+ * @param[in] accel Raw accelerometer reading (any scale)
+ * @param[in] gyro Raw gyroscope reading (scale given by gyroStep)
+ */
+void MahonyFilter::update(VectorInt16 *accel, VectorInt16 *gyro) {
+    QuaternionQ15 c = getQuaternion();
+    int32_t hx, hy, hz, ax, ay, az, vx, vy, vz, ex, ey, ez, t;
+    uint32_t m2;
+    uint16_t n;
+    uint8_t i, shift;
+
+    // half-angle rotation measured by gyro during this update, in Q2.30
+    hx = gyro -> x * gyroStep;
+    hy = gyro -> y * gyroStep;
+    hz = gyro -> z * gyroStep;
+
+    // feedback only when there is an accelerometer reading to normalize
+    m2 = (int32_t)accel -> x * accel -> x + (int32_t)accel -> y * accel -> y + (int32_t)accel -> z * accel -> z;
+    if (m2) {
+        // measured gravity direction, Q1.15
+        n = fixed_inv_sqrt(m2, &shift);
+        ax = ((int32_t)accel -> x * n) >> shift;
+        ay = ((int32_t)accel -> y * n) >> shift;
+        az = ((int32_t)accel -> z * n) >> shift;
+
+        // estimated gravity direction from current orientation, Q1.15
+        vx = ((int32_t)c.x * c.z - (int32_t)c.w * c.y) >> 14;
+        vy = ((int32_t)c.w * c.x + (int32_t)c.y * c.z) >> 14;
+        vz = ((int32_t)c.w * c.w - (int32_t)c.x * c.x - (int32_t)c.y * c.y + (int32_t)c.z * c.z) >> 15;
+
+        // error is cross product between measured and estimated gravity, Q16.16
+        ex = (ay * vz - az * vy) >> 14;
+        ey = (az * vx - ax * vz) >> 14;
+        ez = (ax * vy - ay * vx) >> 14;
+
+        // integral feedback, Q16.16 * Q0.24 >> 10 = Q2.30 (rounded, since truncation would build up a bias)
+        if (kiStep) {
+            integral[0] += (ex * kiStep + 512) >> 10;
+            integral[1] += (ey * kiStep + 512) >> 10;
+            integral[2] += (ez * kiStep + 512) >> 10;
+        }
+
+        // proportional feedback, Q16.16 * Q0.16 >> 2 = Q2.30
+        hx += integral[0] + ((ex * kpStep) >> 2);
+        hy += integral[1] + ((ey * kpStep) >> 2);
+        hz += integral[2] + ((ez * kpStep) >> 2);
+    }
+
+    // integrate rate of change: q += q * (0, h)
+    q[0] -= fixed_mul_q15(hx, c.x) + fixed_mul_q15(hy, c.y) + fixed_mul_q15(hz, c.z);
+    q[1] += fixed_mul_q15(hx, c.w) + fixed_mul_q15(hz, c.y) - fixed_mul_q15(hy, c.z);
+    q[2] += fixed_mul_q15(hy, c.w) - fixed_mul_q15(hz, c.x) + fixed_mul_q15(hx, c.z);
+    q[3] += fixed_mul_q15(hz, c.w) + fixed_mul_q15(hy, c.x) - fixed_mul_q15(hx, c.y);
+
+    // renormalize (magnitude only needs Q1.15 precision, the Q2.30 direction is kept)
+    m2 = 0;
+    for (i = 0; i < 4; i++) {
+        t = q[i] >> 15;
+        m2 += t * t;
+    }
+    n = fixed_inv_sqrt(m2, &shift);
+    for (i = 0; i < 4; i++) {
+        q[i] = fixed_mul_q15(q[i], n) << (15 - shift);
+    }
+}
+
+/**
+ * @brief Get current orientation as a Q1.15 quaternion
+ * @return Orientation quaternion
+ */
+QuaternionQ15 MahonyFilter::getQuaternion() {
+    return QuaternionQ15(
+        constrain(q[0] >> 15, -32767, 32767),
+        constrain(q[1] >> 15, -32767, 32767),
+        constrain(q[2] >> 15, -32767, 32767),
+        constrain(q[3] >> 15, -32767, 32767));
+}
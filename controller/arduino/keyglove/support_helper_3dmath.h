@@ -30,11 +30,22 @@ THE SOFTWARE.
  * @brief 3D math helper function declarations
  * @author Jeff Rowberg
  * @date 2014-11-07
+ *
+ * With KG_FUSION_DMP, the float Quaternion, VectorInt16 and VectorFloat
+ * classes come from I2Cdevlib's helper_3dmath.h, which the MPU-6050 DMP code
+ * also includes, so there is only ever one definition of each. Otherwise
+ * I2Cdevlib is not part of the build at all (see KG_I2C), and the same classes
+ * are declared here instead. This file adds the fixed-point types and the
+ * functions that work on them.
  */
 
 #ifndef _SUPPORT_HELPER_3DMATH_H_
 #define _SUPPORT_HELPER_3DMATH_H_
 
+#if (KG_FUSION & KG_FUSION_DMP)
+    #include <helper_3dmath.h>
+#else
+
 /**
  * @brief Provides float-based quaternion representation and manipulation
  */
@@ -93,4 +104,83 @@ class VectorFloat {
         VectorFloat getRotated(Quaternion *q);
 };
 
+#endif
+
+/**
+ * @brief Provides Q1.15 fixed-point quaternion representation and manipulation
+ *
+ * Components are scaled so that 32767 = 1.0. Products assume unit quaternions.
+ */
+class QuaternionQ15 {
+    public:
+        int16_t w; ///< Vector rotation component of quaternion
+        int16_t x; ///< X-axis rotation component of quaternion
+        int16_t y; ///< Y-axis rotation component of quaternion
+        int16_t z; ///< Z-axis rotation component of quaternion
+
+        QuaternionQ15();
+        QuaternionQ15(int16_t nw, int16_t nx, int16_t ny, int16_t nz);
+
+        QuaternionQ15 getProduct(QuaternionQ15 q);
+        QuaternionQ15 getConjugate();
+        void normalize();
+        QuaternionQ15 getNormalized();
+};
+
+/**
+ * @brief Provides Q16.16 fixed-point vector representation and manipulation
+ *
+ * Components are scaled so that 65536 = 1.0, and must stay below +/-16384.0
+ * for rotation.
+ */
+class VectorQ16 {
+    public:
+        int32_t x; ///< X-axis component of vector
+        int32_t y; ///< Y-axis component of vector
+        int32_t z; ///< Z-axis component of vector
+
+        VectorQ16();
+        VectorQ16(int32_t nx, int32_t ny, int32_t nz);
+
+        void normalize();
+        VectorQ16 getNormalized();
+        void rotate(QuaternionQ15 *q);
+        VectorQ16 getRotated(QuaternionQ15 *q);
+};
+
+/**
+ * @brief Provides a fixed-point Mahony 6-axis orientation filter
+ *
+ * Integrates gyro rotation into an orientation quaternion, and corrects drift
+ * in roll and pitch by steering the estimated gravity direction toward the
+ * measured accelerometer direction. The quaternion is kept in Q2.30 so that
+ * slow rotations are not lost to rounding, and is read out in Q1.15. Use the
+ * KG_MAHONY_*_STEP() macros to build the constructor arguments.
+ */
+class MahonyFilter {
+    public:
+        int32_t q[4];           ///< Orientation quaternion (w, x, y, z) in Q2.30
+        int32_t integral[3];    ///< Integral feedback (x, y, z) as half-angle per update in Q2.30
+        int32_t gyroStep;       ///< Half-angle per update for one gyro count in Q2.30
+        uint16_t kpStep;        ///< Proportional gain times half the update period in Q0.16
+        uint16_t kiStep;        ///< Integral gain times half the squared update period in Q0.24
+
+        MahonyFilter(int32_t nGyroStep, uint16_t nKpStep, uint16_t nKiStep);
+
+        void reset();
+        void update(VectorInt16 *accel, VectorInt16 *gyro);
+        QuaternionQ15 getQuaternion();
+};
+
+/// MahonyFilter gyroStep for a gyro with lsb counts per deg/sec, updated rate times per second
+#define KG_MAHONY_GYRO_STEP(lsb, rate)  ((int32_t)(1073741824.0 * 3.14159265 / 360.0 / (lsb) / (rate) + 0.5))
+/// MahonyFilter kpStep for a proportional gain of kp (rad/sec per unit of gravity error, below 0.5 * rate)
+#define KG_MAHONY_KP_STEP(kp, rate)     ((uint16_t)(65536.0 * (kp) / 2.0 / (rate) + 0.5))
+/// MahonyFilter kiStep for an integral gain of ki (rad/sec^2 per unit of gravity error)
+#define KG_MAHONY_KI_STEP(ki, rate)     ((uint16_t)(16777216.0 * (ki) / 2.0 / (rate) / (rate) + 0.5))
+
+int32_t fixed_mul_q15(int32_t a, int16_t b);
+uint16_t fixed_inv_sqrt(uint32_t x, uint8_t *shift);
+void fixed_rotate_q15(VectorInt16 *v, QuaternionQ15 *q);
+
 #endif /* _SUPPORT_HELPER_3DMATH_H_ */
\ No newline at end of file
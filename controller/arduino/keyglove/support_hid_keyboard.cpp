@@ -45,6 +45,9 @@ THE SOFTWARE.
 
 uint8_t hidModifiersDown = 0;                   ///< Modifier keys currently down
 uint8_t hidKeysDown[] = { 0, 0, 0, 0, 0, 0 };   ///< Normal keys currently down
+uint8_t hidModifiersSent = 0;                   ///< Modifier keys in the last report sent to the host
+uint8_t hidKeysSent[] = { 0, 0, 0, 0, 0, 0 };   ///< Normal keys in the last report sent to the host
+bool hidKeyboardDirty = false;                  ///< Keys or modifiers changed since the last report
 
 /**
  * @brief Initialize HID keyboard behavior
@@ -52,154 +55,83 @@ uint8_t hidKeysDown[] = { 0, 0, 0, 0, 0, 0 };   ///< Normal keys currently down
 void setup_hid_keyboard() {
 }
 
-/*
-// "update" not necessary due to inherent functionality
-// anything that might go here is more logically handled with "update_touch()"
+/**
+ * @brief Send one keyboard report with every change since the last one, called from loop()
+ *
+ * Key and modifier changes only update the report state, so all changes made
+ * during one pass through loop() (e.g. every key in a chord) reach the host as
+ * a single report instead of one report per key.
+ */
 void update_hid_keyboard() {
+    if (!hidKeyboardDirty) return;
+    hidKeyboardDirty = false;
+    #if KG_HOSTIF & KG_HOSTIF_USB_HID
+        if (interfaceUSBHIDReady) {
+            Keyboard.set_modifier(hidModifiersDown);
+            Keyboard.set_key1(hidKeysDown[0]);
+            Keyboard.set_key2(hidKeysDown[1]);
+            Keyboard.set_key3(hidKeysDown[2]);
+            Keyboard.set_key4(hidKeysDown[3]);
+            Keyboard.set_key5(hidKeysDown[4]);
+            Keyboard.set_key6(hidKeysDown[5]);
+            Keyboard.send_now();
+        }
+    #endif /* ENABLE_USB */
+    #if KG_HOSTIF & KG_HOSTIF_BT2_HID
+        if (interfaceBT2HIDReady) {
+            BTKeyboard.set_modifier(hidModifiersDown);
+            BTKeyboard.set_key1(hidKeysDown[0]);
+            BTKeyboard.set_key2(hidKeysDown[1]);
+            BTKeyboard.set_key3(hidKeysDown[2]);
+            BTKeyboard.set_key4(hidKeysDown[3]);
+            BTKeyboard.set_key5(hidKeysDown[4]);
+            BTKeyboard.set_key6(hidKeysDown[5]);
+            BTKeyboard.send_now();
+        }
+    #endif /* ENABLE_BLUETOOTH */
+    hidModifiersSent = hidModifiersDown;
+    memcpy(hidKeysSent, hidKeysDown, sizeof(hidKeysSent));
 }
-*/
 
 /**
- * @brief Send key press (down) HID report
+ * @brief Find a key code in a 6-key report
+ * @param[in] keys Report key slots to search
+ * @param[in] code Key code to find (0 finds a free slot)
+ * @return Slot index, or 6 if not found
+ */
+uint8_t hid_keyboard_find(const uint8_t *keys, uint8_t code) {
+    uint8_t pos;
+    for (pos = 0; pos < 6 && keys[pos] != code; pos++);
+    return pos;
+}
+
+/**
+ * @brief Press (down) a key in the next HID report
  * @param[in] code Key code
  */
 void keyboard_key_down(uint8_t code) {
     #if KG_HID & KG_HID_KEYBOARD
-        uint8_t usePos = 0;
-        for (usePos = 0; usePos < 6 && hidKeysDown[usePos] != 0; usePos++);
+        uint8_t usePos = hid_keyboard_find(hidKeysDown, 0);
         if (usePos == 6) return; // out of HID keyboard buffer space, REALLY weird for the Keyglove!
+        // a release the host has not seen yet must go out first, or the key would never come up
+        if (hid_keyboard_find(hidKeysSent, code) < 6 && hid_keyboard_find(hidKeysDown, code) == 6) update_hid_keyboard();
         hidKeysDown[usePos] = code;
-        switch (usePos) {
-            case 0:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key1(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key1(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 1:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key2(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key2(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 2:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key3(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key3(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 3:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key4(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key4(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 4:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key5(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key5(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 5:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key6(code);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key6(code);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-        }
-        #if KG_HOSTIF & KG_HOSTIF_USB_HID
-            if (interfaceUSBHIDReady) {
-                Keyboard.send_now();
-            }
-        #endif /* ENABLE_USB */
-        #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-            BTKeyboard.send_now();
-        #endif /* ENABLE_BLUETOOTH */
+        hidKeyboardDirty = true;
     #endif
 }
 
 /**
- * @brief Send key release (up) HID report
+ * @brief Release (up) a key in the next HID report
  * @param[in] code Key code
  */
 void keyboard_key_up(uint8_t code) {
     #if KG_HID & KG_HID_KEYBOARD
-        uint8_t usePos = 0;
-        for (usePos = 0; usePos < 6 && hidKeysDown[usePos] != code; usePos++);
+        uint8_t usePos = hid_keyboard_find(hidKeysDown, code);
         if (usePos == 6) return; // key not currently down...oops.
+        // a press the host has not seen yet must go out first, or a quick tap would be lost
+        if (hid_keyboard_find(hidKeysSent, code) == 6) update_hid_keyboard();
         hidKeysDown[usePos] = 0;
-        switch (usePos) {
-            case 0:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key1(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key1(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 1:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key2(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key2(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 2:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key3(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key3(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 3:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key4(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key4(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 4:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key5(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key5(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-            case 5:
-                #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                    Keyboard.set_key6(0);
-                #endif /* ENABLE_USB */
-                #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-                    BTKeyboard.set_key6(0);
-                #endif /* ENABLE_BLUETOOTH */
-                break;
-        }
-        #if KG_HOSTIF & KG_HOSTIF_USB_HID
-            if (interfaceUSBHIDReady) {
-                Keyboard.send_now();
-            }
-        #endif /* ENABLE_USB */
-        #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-            if (interfaceBT2HIDReady) {
-                BTKeyboard.send_now();
-            }
-        #endif /* ENABLE_BLUETOOTH */
+        hidKeyboardDirty = true;
     #endif
 }
 
@@ -209,44 +141,36 @@ void keyboard_key_up(uint8_t code) {
  */
 void keyboard_key_press(uint8_t code) {
     keyboard_key_down(code);
+    update_hid_keyboard();
     delay(5);
     keyboard_key_up(code);
 }
 
 /**
- * @brief Send modifier press (down) HID report
+ * @brief Press (down) modifiers in the next HID report
  * @param[in] code Modifier key bitmask
  */
 void keyboard_modifier_down(uint8_t code) {
     #if KG_HID & KG_HID_KEYBOARD
+        if ((hidModifiersDown & code) == code) return;
+        // a release the host has not seen yet must go out first
+        if (hidModifiersSent & ~hidModifiersDown & code) update_hid_keyboard();
         hidModifiersDown = hidModifiersDown | code;
-        #if KG_HOSTIF & KG_HOSTIF_USB_HID
-            Keyboard.set_modifier(hidModifiersDown);
-            Keyboard.send_now();
-        #endif /* ENABLE_USB */
-        #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-            BTKeyboard.set_modifier(hidModifiersDown);
-            BTKeyboard.send_now();
-        #endif /* ENABLE_USB */
+        hidKeyboardDirty = true;
     #endif
 }
 
 /**
- * @brief Send modifier release (up) HID report
+ * @brief Release (up) modifiers in the next HID report
  * @param[in] code Modifier key bitmask
  */
 void keyboard_modifier_up(uint8_t code) {
     #if KG_HID & KG_HID_KEYBOARD
         if ((hidModifiersDown & code) > 0) {
-            hidModifiersDown -= code;
-            #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                Keyboard.set_modifier(hidModifiersDown);
-                Keyboard.send_now();
-            #endif /* ENABLE_USB */
-            #if KG_HOSTIF & KG_HOSTIF_USB_HID
-                BTKeyboard.set_modifier(hidModifiersDown);
-                BTKeyboard.send_now();
-            #endif /* ENABLE_USB */
+            // a press the host has not seen yet must go out first
+            if (hidModifiersDown & ~hidModifiersSent & code) update_hid_keyboard();
+            hidModifiersDown &= ~code;
+            hidKeyboardDirty = true;
         }
     #endif
 }
@@ -269,6 +193,7 @@ void keyboard_modifier_toggle(uint8_t code) {
  */
 void keyboard_modifier_press(uint8_t code) {
     keyboard_modifier_down(code);
+    update_hid_keyboard();
     delay(5);
     keyboard_modifier_up(code);
 }
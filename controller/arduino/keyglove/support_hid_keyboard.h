@@ -182,7 +182,7 @@ extern uint8_t hidModifiersDown;
 extern uint8_t hidKeysDown[6];
 
 void setup_hid_keyboard();
-//void update_hid_keyboard() {
+void update_hid_keyboard();
 
 void keyboard_key_down(uint8_t code);
 void keyboard_key_up(uint8_t code);
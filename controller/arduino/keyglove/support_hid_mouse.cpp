@@ -41,17 +41,26 @@ THE SOFTWARE.
 
 #include "keyglove.h"
 #include "support_board.h"
+#include "support_protocol.h"
 #include "support_hid_mouse.h"
 #include "support_motion.h"
 #include "support_bluetooth2_iwrap.h"
 
 uint8_t hidMouseDown = 0;   ///< Mouse buttons currently down
 
-int8_t hidMouseDX;          ///< Mouse cursor X axis movement delta
-int8_t hidMouseDY;          ///< Mouse cursor Y axis movement delta
-int8_t hidMouseDZ;          ///< Mouse cursor Z axis movement delta (3D-only)
-int8_t hidScrollDX;         ///< Horizontal scroll movement delta
-int8_t hidScrollDY;         ///< Vertical scroll movement delta
+int16_t hidMouseAccX;       ///< Cursor X movement not yet reported, in 1/16 counts
+int16_t hidMouseAccY;       ///< Cursor Y movement not yet reported, in 1/16 counts
+int16_t hidMouseAccWheel;   ///< Wheel movement (scroll, or Z in 3D mode) not yet reported, in 1/16 counts
+int16_t hidMouseVelX;       ///< Cursor X speed in tilt-velocity mode, in 1/16 counts per 10ms
+int16_t hidMouseVelY;       ///< Cursor Y speed in tilt-velocity mode, in 1/16 counts per 10ms
+int8_t hidMouseRestX;       ///< Cursor X movement lost to scaling to the sample period, in 1/160 counts
+int8_t hidMouseRestY;       ///< Cursor Y movement lost to scaling to the sample period, in 1/160 counts
+int8_t hidMouseRestWheel;   ///< Wheel movement lost to scaling to the sample period, in 1/160 counts
+int8_t hidMouseRestVelX;    ///< Tilt-velocity X speed change lost to scaling to the sample period, in 1/160 counts
+int8_t hidMouseRestVelY;    ///< Tilt-velocity Y speed change lost to scaling to the sample period, in 1/160 counts
+uint16_t hidMouseReportTime;    ///< Time of last movement report (low 16 bits of millis())
+hid_mouse_track_t hidMouseTrackX;   ///< Cursor predictor state for X
+hid_mouse_track_t hidMouseTrackY;   ///< Cursor predictor state for Y
 
 uint8_t opt_hid_mouse_invert_x = 0;                 ///< OPTION: Invert mouse x movements
 uint8_t opt_hid_mouse_invert_y = 1;                 ///< OPTION: Invert mouse y movements
@@ -65,54 +74,263 @@ float opt_hid_mouse_scale_mode2[] = { 1, 1 };       ///< OPTION: Speed scale [x,
 float opt_hid_mouse_scale_mode3[] = { 1, 1 };       ///< OPTION: Speed scale [x,y] for mode 3 (movement-position)
 float opt_hid_mouse_scale_mode4[] = { 1, 1, 1 };    ///< OPTION: Speed scale [x,y,z] for mode 4 (3D)
 
+hid_mouse_predictor_t opt_hid_mouse_predictor[MOUSE_MODE_MAX];  ///< OPTION: Cursor predictor settings for each mouse mode
+
+/**
+ * @brief Default cursor predictor settings, used for every mouse mode
+ *
+ * Disabled until turned on over KGAPI. The lead suits a typical Bluetooth HID
+ * link, and the gains and jerk limit were tuned with host/python/kgpredict.py.
+ */
+const hid_mouse_predictor_t hidMousePredictorDefault PROGMEM = { 0, 30, 96, 160, 16 };
+
+/**
+ * @brief Default response curves, in 1/16 counts for each 32-unit step of gyro input
+ *
+ * Cursor curve is 3 * (x / 30)^1.3 and scroll curve is sqrt(x / 30), which
+ * are the formulas these tables replaced. Input beyond the last point uses the
+ * last point's value.
+ */
+const uint16_t hidMouseCurveDefault[KG_HID_MOUSE_CURVE_COUNT][KG_HID_MOUSE_CURVE_POINTS] PROGMEM = {
+    { 0, 52, 129, 218, 316, 423, 536, 655, 779, 908, 1042, 1179, 1320, 1465, 1613, 1764, 1919 },
+    { 0, 17, 23, 29, 33, 37, 40, 44, 47, 50, 52, 55, 57, 60, 62, 64, 66 }
+};
+
+uint16_t hidMouseCurve[KG_HID_MOUSE_CURVE_COUNT][KG_HID_MOUSE_CURVE_POINTS];  ///< Active response curves (copied from defaults, may be replaced via KGAPI)
+
 /**
  * @brief Initialize HID mouse behavior
  */
 void setup_hid_mouse() {
     // zero all relative movements
-    hidMouseDX = hidMouseDY = hidMouseDZ = 0;
-    hidScrollDX = hidScrollDY = 0;
+    hid_mouse_clear();
+    hidMouseReportTime = millis() - KG_HID_MOUSE_REPORT_INTERVAL;
+
+    // load default response curves
+    hid_mouse_reset_curve(KG_HID_CURVE_CURSOR);
+    hid_mouse_reset_curve(KG_HID_CURVE_SCROLL);
+
+    // load default predictor settings
+    hid_mouse_reset_predictor();
 }
 
 /**
- * @brief Update mouse movements if necessary, called at 100Hz from loop()
+ * @brief Restore cursor predictor settings for all mouse modes to the built-in default
  */
-void update_hid_mouse() {
+void hid_mouse_reset_predictor() {
+    for (uint8_t i = 0; i < MOUSE_MODE_MAX; i++) {
+        memcpy_P(&opt_hid_mouse_predictor[i], &hidMousePredictorDefault, sizeof(hid_mouse_predictor_t));
+    }
+}
+
+/**
+ * @brief Restore a response curve to its built-in default
+ * @param[in] curve Response curve index
+ */
+void hid_mouse_reset_curve(uint8_t curve) {
+    memcpy_P(hidMouseCurve[curve], hidMouseCurveDefault[curve], sizeof(hidMouseCurve[curve]));
+}
+
+/**
+ * @brief Look up signed input on a response curve with linear interpolation
+ * @param[in] curve Response curve index
+ * @param[in] value Input value (e.g. filtered gyro axis)
+ * @return Output in 1/16 counts, with the same sign as the input
+ */
+int16_t hid_mouse_curve(uint8_t curve, int16_t value) {
+    uint16_t *points = hidMouseCurve[curve];
+    uint16_t magnitude = value < 0 ? -(uint16_t)value : value;
+    uint16_t segment = magnitude >> KG_HID_MOUSE_CURVE_SHIFT;
+    int16_t result;
+    if (segment >= KG_HID_MOUSE_CURVE_POINTS - 1) {
+        result = points[KG_HID_MOUSE_CURVE_POINTS - 1];
+    } else {
+        result = points[segment] + (int16_t)((((int32_t)points[segment + 1] - points[segment]) * (magnitude & ((1 << KG_HID_MOUSE_CURVE_SHIFT) - 1))) >> KG_HID_MOUSE_CURVE_SHIFT);
+    }
+    return value < 0 ? -result : result;
+}
+
+/**
+ * @brief Discard any unreported movement and tilt-velocity speed
+ */
+void hid_mouse_clear() {
+    hidMouseAccX = hidMouseAccY = hidMouseAccWheel = 0;
+    hidMouseVelX = hidMouseVelY = 0;
+    hidMouseRestX = hidMouseRestY = hidMouseRestWheel = hidMouseRestVelX = hidMouseRestVelY = 0;
+    memset(&hidMouseTrackX, 0, sizeof(hid_mouse_track_t));
+    memset(&hidMouseTrackY, 0, sizeof(hid_mouse_track_t));
+}
+
+/**
+ * @brief Add movement to a 16-bit accumulator, saturating instead of wrapping
+ * @param[in,out] acc Accumulator to add to
+ * @param[in] delta Movement to add, in 1/16 counts
+ * @param[in] limit Largest accumulator value either way, in 1/16 counts
+ */
+void hid_mouse_add(int16_t *acc, int32_t delta, int16_t limit) {
+    delta += *acc;
+    *acc = constrain(delta, -limit, limit);
+}
+
+/**
+ * @brief Add one sample's movement to the unreported backlog, keeping its direction
+ * @param[in] dx Cursor X movement, in 1/16 counts
+ * @param[in] dy Cursor Y movement, in 1/16 counts
+ * @param[in] dz Wheel movement, in 1/16 counts
+ *
+ * No axis may hold more than KG_HID_MOUSE_BACKLOG_MAX counts. If the sample
+ * would take any axis past that, the whole movement is shortened until the
+ * tightest axis just fits, so a capped diagonal move still goes the way the
+ * hand went instead of sliding along whichever axis had room left.
+ */
+void hid_mouse_queue(int16_t dx, int16_t dy, int16_t dz) {
+    int16_t *acc[3] = { &hidMouseAccX, &hidMouseAccY, &hidMouseAccWheel };
+    int16_t delta[3] = { dx, dy, dz };
+    int32_t room, num = 1, den = 1;
+    uint8_t i;
+
+    // find the smallest share of its movement that any axis has room for (num / den, at most 1)
+    for (i = 0; i < 3; i++) {
+        if (delta[i] == 0) continue;
+        room = (int32_t)KG_HID_MOUSE_BACKLOG_MAX * 16 + 15 - (delta[i] > 0 ? *acc[i] : -*acc[i]);
+        if (room * den < (int32_t)abs(delta[i]) * num) {
+            num = room;
+            den = abs(delta[i]);
+        }
+    }
+    for (i = 0; i < 3; i++) *acc[i] += num == den ? delta[i] : (int32_t)delta[i] * num / den;
+}
+
+/**
+ * @brief Take whole counts out of an accumulator for one report
+ * @param[in,out] acc Accumulator to take from (keeps the fractional remainder)
+ * @return Whole counts for the report, limited to what fits in one report
+ */
+int8_t hid_mouse_take(int16_t *acc) {
+    int16_t counts = *acc < 0 ? -((-*acc) >> 4) : (*acc >> 4);
+    counts = constrain(counts, -127, 127);
+    *acc -= counts * 16;
+    return counts;
+}
+
+/**
+ * @brief Scale per-sample movement to the sample period
+ * @param[in] value Movement for a 10ms sample period, in 1/16 counts
+ * @param[in] period Sample period in milliseconds
+ * @param[in,out] rest Part of a 1/16 count left over from the last call, in 1/160 counts (NULL to drop it)
+ * @return Movement for the actual sample period, in 1/16 counts
+ *
+ * Response curves are defined per 10ms, so pointer speed does not change with
+ * the motion sample rate. At the default 100Hz this costs nothing. At faster
+ * rates each sample is only a few 1/16 counts, so the part dropped by the
+ * division is carried into the next sample instead of being lost every time.
+ */
+int16_t hid_mouse_scale(int16_t value, uint8_t period, int8_t *rest) {
+    if (period == 10) return value;
+    int32_t total = (int32_t)value * period + (rest ? *rest : 0);
+    int32_t scaled = total / 10;
+    if (rest) *rest = total - scaled * 10;
+    return constrain(scaled, -32767, 32767);
+}
+
+/**
+ * @brief Move one cursor axis ahead of the measured position to hide link latency
+ * @param[in,out] track Predictor state for this axis
+ * @param[in] predictor Predictor settings for the current mouse mode
+ * @param[in] delta Measured movement for this sample, in 1/16 counts
+ * @param[in] period Sample period in milliseconds
+ * @return Movement to report for this sample, in 1/16 counts
+ *
+ * An alpha-beta filter tracks position and speed from the measured movement,
+ * and the cursor is placed where that estimate says it will be after the lead
+ * time. The lead never uses more speed than this sample actually measured, so
+ * it shrinks as soon as the hand slows down, and it may only grow by the jerk
+ * limit each 10ms, so noise and sudden starts do not throw the cursor ahead.
+ * Over time the reported movement always adds up to the measured movement.
+ */
+int16_t hid_mouse_predict(hid_mouse_track_t *track, const hid_mouse_predictor_t *predictor, int16_t delta, uint8_t period) {
+    // alpha-beta update, with speed in 1/4096 counts per sample
+    int32_t residual = (int32_t)track -> error + delta - (track -> velocity >> 8);
+    residual = constrain(residual, -32767, 32767);
+    track -> error = residual - ((residual * predictor -> alpha) >> 8);
+    track -> velocity = constrain(track -> velocity + residual * predictor -> beta, -8388352L, 8388352L);
+
+    // lead with the estimated speed, limited to the speed measured right now
+    int16_t speed = track -> velocity >> 8;
+    if ((speed ^ delta) < 0) speed = 0;
+    else if (abs(speed) > abs(delta)) speed = delta;
+    int32_t target = ((int32_t)speed * (((uint16_t)predictor -> lead << 4) / period)) >> 4;
+    target = constrain(target, -KG_HID_MOUSE_PREDICT_LEAD_MAX * 16, KG_HID_MOUSE_PREDICT_LEAD_MAX * 16) - track -> error;
+    target = constrain(target, -32767, 32767);
+
+    // growing the lead is limited by the jerk limit, pulling it back is not
+    int32_t step = target - track -> offset;
+    if (predictor -> jerk) {
+        int16_t limit = hid_mouse_scale(predictor -> jerk * 16, period, NULL);
+        int16_t back = max(limit, abs(track -> offset));
+        step = constrain(step, track -> offset > 0 ? -back : -limit, track -> offset < 0 ? back : limit);
+    }
+    track -> offset += step;
+    return constrain(delta + step, -32767, 32767);
+}
+
+/**
+ * @brief Feed one new motion sample into the mouse pipeline
+ * @param[in] period Milliseconds since the previous sample
+ *
+ * This is called for every hand motion sample, so the pointer is never more
+ * than one sample behind. Movement goes into 16-bit accumulators in 1/16
+ * counts, and the fraction left over after each report is carried into the
+ * next one, so slow movement is never lost to rounding. Reports can only
+ * carry 127 counts per KG_HID_MOUSE_REPORT_INTERVAL, so movement waiting for
+ * later reports is held to KG_HID_MOUSE_BACKLOG_MAX (see hid_mouse_queue()),
+ * and the cursor stops within a couple of reports of the hand stopping
+ * instead of draining a backlog for seconds.
+ */
+void hid_mouse_sample(uint8_t period) {
     #if KG_MOTION > 0
+        int16_t dx = 0, dy = 0, dz = 0;
         switch (opt_hid_mouse_mode) {
             case MOUSE_MODE_OFF:
             case MOUSE_MODE_MAX:
                 // do nothing for these values (explicit case avoids compiler warning)
                 break;
             case MOUSE_MODE_TILT_VELOCITY:
-                hidMouseDX += ((gv.y < 0) ? -pow(-(float)gv.y/30, 1.3)*3 : pow((float)gv.y/30, 1.3)*3) - ((gv.z < 0) ? -pow(-(float)gv.z/30, 1.3)*3 : pow((float)gv.z/30, 1.3)*3);
-                hidMouseDY += (gv.x < 0) ? -pow(-(float)gv.x/30, 1.3)*3 : pow((float)gv.x/30, 1.3)*3;
+                // rotation changes cursor speed, so holding a tilt keeps it moving
+                hid_mouse_add(&hidMouseVelX, hid_mouse_scale(hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.y) - hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.z), period, &hidMouseRestVelX), 32767);
+                hid_mouse_add(&hidMouseVelY, hid_mouse_scale(hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.x), period, &hidMouseRestVelY), 32767);
+                dx = hidMouseVelX;
+                dy = hidMouseVelY;
                 break;
             case MOUSE_MODE_TILT_POSITION:
-                hidMouseDX = ((gv.y < 0) ? -pow(-(float)gv.y/30, 1.3)*3 : pow((float)gv.y/30, 1.3)*3) - ((gv.z < 0) ? -pow(-(float)gv.z/30, 1.3)*3 : pow((float)gv.z/30, 1.3)*3);
-                hidMouseDY = (gv.x < 0) ? -pow(-(float)gv.x/30, 1.3)*3 : pow((float)gv.x/30, 1.3)*3;
+                // rotation moves the cursor, so it follows the tilt angle
+                dx = hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.y) - hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.z);
+                dy = hid_mouse_curve(KG_HID_CURVE_CURSOR, gv.x);
                 break;
             case MOUSE_MODE_MOVEMENT_POSITION:
                 #if (KG_FUSION > 0)
-                    hidMouseDX = apFrame.x * opt_hid_mouse_scale_mode4[0];
-                    hidMouseDY = apFrame.y * opt_hid_mouse_scale_mode4[1];
+                    dx = constrain(apFrame.x * opt_hid_mouse_scale_mode4[0] * 16, -32767, 32767);
+                    dy = constrain(apFrame.y * opt_hid_mouse_scale_mode4[1] * 16, -32767, 32767);
                 #else
-                    hidMouseDX = aa.x * opt_hid_mouse_scale_mode4[0];
-                    hidMouseDY = aa.y * opt_hid_mouse_scale_mode4[1];
+                    dx = constrain(aa.x * opt_hid_mouse_scale_mode4[0] * 16, -32767, 32767);
+                    dy = constrain(aa.y * opt_hid_mouse_scale_mode4[1] * 16, -32767, 32767);
                 #endif
                 break;
             case MOUSE_MODE_3D:
                 #if (KG_FUSION > 0)
-                    hidMouseDX = apFrame.x * opt_hid_mouse_scale_mode4[0];
-                    hidMouseDY = apFrame.y * opt_hid_mouse_scale_mode4[1];
-                    hidMouseDZ = apFrame.z * opt_hid_mouse_scale_mode4[2];
+                    dx = constrain(apFrame.x * opt_hid_mouse_scale_mode4[0] * 16, -32767, 32767);
+                    dy = constrain(apFrame.y * opt_hid_mouse_scale_mode4[1] * 16, -32767, 32767);
+                    dz = constrain(apFrame.z * opt_hid_mouse_scale_mode4[2] * 16, -32767, 32767);
                 #else
-                    hidMouseDX = aa.x * opt_hid_mouse_scale_mode4[0];
-                    hidMouseDY = aa.y * opt_hid_mouse_scale_mode4[1];
-                    hidMouseDZ = aa.z * opt_hid_mouse_scale_mode4[2];
+                    dx = constrain(aa.x * opt_hid_mouse_scale_mode4[0] * 16, -32767, 32767);
+                    dy = constrain(aa.y * opt_hid_mouse_scale_mode4[1] * 16, -32767, 32767);
+                    dz = constrain(aa.z * opt_hid_mouse_scale_mode4[2] * 16, -32767, 32767);
                 #endif
                 break;
         }
+        if (opt_hid_mouse_invert_x == 1) dx = -dx;
+        if (opt_hid_mouse_invert_y == 1) dy = -dy;
+        if (opt_hid_mouse_invert_z == 1) dz = -dz;
         switch (opt_hid_scroll_mode) {
             case SCROLL_MODE_OFF:
             case SCROLL_MODE_MAX:
@@ -121,42 +339,60 @@ void update_hid_mouse() {
             case SCROLL_MODE_TILT_VELOCITY: // gyro
                 break;
             case SCROLL_MODE_TILT_POSITION: // gyro
-                hidScrollDY -= ((float)gv.y < 0) ? -sqrt(-(float)gv.y / 30) : sqrt((float)gv.y / 30);
+                dz -= hid_mouse_curve(KG_HID_CURVE_SCROLL, gv.y);
                 break;
             case SCROLL_MODE_MOVEMENT_POSITION: // accel
                 break;
         }
+        dx = hid_mouse_scale(dx, period, &hidMouseRestX);
+        dy = hid_mouse_scale(dy, period, &hidMouseRestY);
+        if (opt_hid_mouse_mode < MOUSE_MODE_MAX && opt_hid_mouse_predictor[opt_hid_mouse_mode].enabled) {
+            dx = hid_mouse_predict(&hidMouseTrackX, &opt_hid_mouse_predictor[opt_hid_mouse_mode], dx, period);
+            dy = hid_mouse_predict(&hidMouseTrackY, &opt_hid_mouse_predictor[opt_hid_mouse_mode], dy, period);
+        }
+        hid_mouse_queue(dx, dy, hid_mouse_scale(dz, period, &hidMouseRestWheel));
     #endif
 
-    if (opt_hid_mouse_mode > 0 && (hidMouseDX != 0 || hidMouseDY != 0 || hidMouseDZ != 0)) {
-        if (opt_hid_mouse_invert_x == 1) hidMouseDX = -hidMouseDX;
-        if (opt_hid_mouse_invert_y == 1) hidMouseDY = -hidMouseDY;
-        if (opt_hid_mouse_invert_z == 1) hidMouseDZ = -hidMouseDZ;
-        #if KG_HOSTIF & KG_HOSTIF_USB_HID
-            if (hidMouseDZ > 0) Mouse.move(hidMouseDX, hidMouseDY, hidMouseDZ);
-            else Mouse.move(hidMouseDX, hidMouseDY);
-        #endif /* KG_HOSTIF_USB_HID */
-        #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-            if (hidMouseDZ > 0) BTMouse.move(hidMouseDX, hidMouseDY, hidMouseDZ, 0);
-            else BTMouse.move(hidMouseDX, hidMouseDY);
-        #endif /* KG_HOSTIF_BT2_HID */
-        #if KG_HOSTIF & KG_HOSTIF_R400_HID
-            if (hidMouseDZ > 0) RX400.move(hidMouseDX, hidMouseDY, hidMouseDZ);
-            else RX400.move(hidMouseDX, hidMouseDY);
-        #endif /* KG_HOSTIF_R400_HID */
-    }
-    if (opt_hid_scroll_mode > 0 && hidScrollDY != 0) {
-        if (opt_hid_mouse_invert_y == 1) hidMouseDY = -hidMouseDY;
-        #if KG_HOSTIF & KG_HOSTIF_USB_HID
-            Mouse.scroll(hidScrollDY);
-        #endif /* KG_HOSTIF_USB_HID */
-        #if KG_HOSTIF & KG_HOSTIF_BT2_HID
-            BTMouse.scroll(hidScrollDY, 0);
-        #endif /* KG_HOSTIF_BT2_HID */
-        #if KG_HOSTIF & KG_HOSTIF_R400_HID
-            RX400.scroll(hidScrollDY);
-        #endif /* KG_HOSTIF_R400_HID */
-    }
+    hid_mouse_report();
+}
+
+/**
+ * @brief Send one movement report, if the report interval has passed and there is anything to send
+ *
+ * Each report carries at most 127 counts per axis. Anything beyond that stays
+ * in the accumulators and goes out in following reports, so fast movement is
+ * split across reports instead of being clipped or wrapping around.
+ */
+void hid_mouse_report() {
+    uint16_t now = millis();
+    if ((uint16_t)(now - hidMouseReportTime) < KG_HID_MOUSE_REPORT_INTERVAL) return;
+
+    int8_t x = hid_mouse_take(&hidMouseAccX);
+    int8_t y = hid_mouse_take(&hidMouseAccY);
+    int8_t wheel = hid_mouse_take(&hidMouseAccWheel);
+    if (x == 0 && y == 0 && wheel == 0) return;
+    hidMouseReportTime = now;
+
+    #if KG_HOSTIF & KG_HOSTIF_USB_HID
+        Mouse.move(x, y, wheel);
+    #endif /* KG_HOSTIF_USB_HID */
+    #if KG_HOSTIF & KG_HOSTIF_BT2_HID
+        BTMouse.move(x, y, wheel, 0);
+    #endif /* KG_HOSTIF_BT2_HID */
+    #if KG_HOSTIF & KG_HOSTIF_R400_HID
+        RX400.move(x, y, wheel);
+    #endif /* KG_HOSTIF_R400_HID */
+}
+
+/**
+ * @brief Send movement still waiting from earlier samples, called from loop()
+ *
+ * New movement is reported directly from hid_mouse_sample(). This only sends
+ * what is left when a sample arrived before the report interval was up, or
+ * when fast movement needed more than one report.
+ */
+void update_hid_mouse() {
+    if (hidMouseAccX || hidMouseAccY || hidMouseAccWheel) hid_mouse_report();
 }
 
 /**
@@ -172,6 +408,7 @@ void mouse_on(uint8_t mode) {
         } else if (mode == MOUSE_ACTION_SCROLL) {
             opt_hid_scroll_mode = SCROLL_MODE_TILT_POSITION;
         }
+        hid_mouse_clear();
         #ifdef ENABLE_ACCELEROMETER
             if (!activeAccelerometer) enable_motion_accelerometer();
         #endif
@@ -197,6 +434,7 @@ void mouse_off(uint8_t mode) {
         } else if (mode == MOUSE_ACTION_SCROLL) {
             opt_hid_scroll_mode = SCROLL_MODE_OFF;
         }
+        hid_mouse_clear();
         #ifdef ENABLE_ACCELEROMETER
             if (activeAccelerometer) disable_motion_accelerometer();
         #endif
@@ -49,6 +49,22 @@ THE SOFTWARE.
 #define MOUSE_ACTION_MOVE               1   ///< Mouse cursor movement action
 #define MOUSE_ACTION_SCROLL             2   ///< Scrolling movement action
 
+#define KG_HID_MOUSE_CURVE_POINTS       17  ///< Points in each response curve (16 linear segments)
+#define KG_HID_MOUSE_CURVE_SHIFT        5   ///< Input units per curve segment, as a power of 2 (32)
+#define KG_HID_MOUSE_CURVE_COUNT        2   ///< Number of response curves (see KG_HID_CURVE_* values)
+
+#ifndef KG_HID_MOUSE_REPORT_INTERVAL
+    #define KG_HID_MOUSE_REPORT_INTERVAL    8   ///< Minimum milliseconds between movement reports (host poll interval)
+#endif
+
+#ifndef KG_HID_MOUSE_BACKLOG_MAX
+    #define KG_HID_MOUSE_BACKLOG_MAX        254 ///< Most movement left waiting for later reports on each axis, in counts (a sample that would pass it is shortened as a whole)
+#endif
+
+#ifndef KG_HID_MOUSE_PREDICT_LEAD_MAX
+    #define KG_HID_MOUSE_PREDICT_LEAD_MAX   256 ///< Largest distance the predictor may move the cursor ahead, in counts
+#endif
+
 /**
  * @brief List of possible values for cursor movement mode
  */
@@ -72,8 +88,37 @@ typedef enum {
     SCROLL_MODE_MAX
 } scroll_movement_mode_t;
 
+/**
+ * @brief Cursor predictor settings for one mouse movement mode
+ */
+typedef struct {
+    uint8_t enabled;                ///< Predictor enabled (1) or disabled (0)
+    uint8_t lead;                   ///< Time to move the cursor ahead, in ms (match measured link latency)
+    uint8_t alpha;                  ///< Position correction gain, in 1/256
+    uint8_t beta;                   ///< Velocity correction gain, in 1/256
+    uint8_t jerk;                   ///< Largest growth in lead distance per 10ms, in counts (0 = no limit)
+} hid_mouse_predictor_t;
+
+/**
+ * @brief Cursor predictor state for one axis
+ */
+typedef struct {
+    int16_t error;                  ///< Measured minus estimated position, in 1/16 counts
+    int32_t velocity;               ///< Estimated speed, in 1/4096 counts per sample
+    int16_t offset;                 ///< Reported minus measured position, in 1/16 counts
+} hid_mouse_track_t;
+
+extern hid_mouse_predictor_t opt_hid_mouse_predictor[MOUSE_MODE_MAX];
+extern uint16_t hidMouseCurve[KG_HID_MOUSE_CURVE_COUNT][KG_HID_MOUSE_CURVE_POINTS];
+
 void setup_hid_mouse();
 void update_hid_mouse();
+void hid_mouse_sample(uint8_t period);
+void hid_mouse_report();
+void hid_mouse_clear();
+void hid_mouse_reset_curve(uint8_t curve);
+int16_t hid_mouse_curve(uint8_t curve, int16_t value);
+void hid_mouse_reset_predictor();
 
 void mouse_on(uint8_t mode);
 void mouse_off(uint8_t mode);
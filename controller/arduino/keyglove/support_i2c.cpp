@@ -0,0 +1,399 @@
+// Keyglove controller source code - Interrupt-driven I2C transaction queue implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_i2c.cpp
+ * @brief Interrupt-driven I2C transaction queue implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Every device on the I2C bus (motion sensors, battery gauge) registers a
+ * service routine and a completion routine here instead of reading the bus
+ * directly from the main loop. Interrupt flags and timers only request
+ * service, and update_i2c() then lets each pending client queue one transfer
+ * per pass in round-robin order. A long FIFO drain from one motion sensor is
+ * therefore split into bursts with the other sensors' reads interleaved,
+ * rather than making them wait for the whole thing.
+ *
+ * Each client owns one slot in a static transfer pool, and one more slot is
+ * kept for the blocking i2c_read_bytes()/i2c_write_bytes() calls used for
+ * occasional configuration writes. Completion routines run later from
+ * update_i2c() in the main loop, never from an interrupt. How transfers get
+ * onto the wire depends on KG_I2C:
+ *
+ * - KG_I2C_WIRE: each transfer runs through I2Cdev as soon as it is queued,
+ *   and the main loop waits for it. This works with I2Cdevlib and the Wire
+ *   library as shipped.
+ * - KG_I2C_TWI: transfers are clocked out by the TWI interrupt here, one byte
+ *   per interrupt, so touch scanning and protocol handling carry on while
+ *   bytes are on the wire. Blocking calls queue behind any transfer already
+ *   waiting and then spin until their own one is finished. If the bus stops
+ *   making progress for KG_I2C_TIMEOUT milliseconds (e.g. a device holding SDA
+ *   low), the TWI module is reset and the active transfer fails with
+ *   KG_I2C_STATUS_BUS_ERROR. This replaces the Wire library, which uses the
+ *   same interrupt vector, and is the default. Nothing else in the firmware
+ *   uses I2Cdevlib then, so neither it nor Wire is built. The one exception is
+ *   the MPU-6050 DMP loader (KG_FUSION_DMP), which goes through I2Cdev at
+ *   boot, so I2Cdev must then use its polled Fastwire implementation, which
+ *   only touches the TWI registers while one of its own calls is running.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_i2c.h"
+
+#if (KG_I2C == KG_I2C_WIRE) && (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
+    #include <Wire.h>
+#endif
+
+#define KG_I2C_TWCR_GO          ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))  ///< Clear interrupt flag and continue
+
+i2c_service_t i2cService[KG_I2C_CLIENT_MAX];    ///< Registered client service routines
+i2c_complete_t i2cComplete[KG_I2C_CLIENT_MAX];  ///< Registered client completion routines
+uint8_t i2cClients;                             ///< Number of registered clients
+uint8_t i2cPending;                             ///< Bitmask of clients waiting for service
+uint8_t i2cNext;                                ///< Client served first on the next pass
+
+i2c_transfer_t i2cTransfer[KG_I2C_TRANSFER_MAX];        ///< Transfer pool (index = client, last = blocking calls)
+
+#if (KG_I2C == KG_I2C_TWI)
+
+volatile uint8_t i2cQueue[KG_I2C_TRANSFER_MAX];         ///< Ring of queued transfer indexes
+volatile uint8_t i2cQueueHead;                          ///< Next queued transfer to start
+volatile uint8_t i2cQueueTail;                          ///< Where the next queued transfer goes
+volatile uint8_t i2cActive = KG_I2C_TRANSFER_NONE;      ///< Transfer on the wire now
+volatile uint8_t i2cIndex;                              ///< Data bytes sent or received so far in active transfer
+volatile uint8_t i2cProgress;                           ///< Incremented by every TWI interrupt, for the timeout check
+uint8_t i2cWatchProgress;                               ///< Value of i2cProgress at the last timeout check
+uint32_t i2cWatchTime;                                  ///< When i2cProgress last changed
+
+/**
+ * @brief Finish active transfer, then start the next one or release the bus
+ * @param[in] status Final status for active transfer
+ *
+ * Only called with interrupts disabled (from the TWI interrupt or with them
+ * turned off in the main loop).
+ */
+void i2c_finish(uint8_t status) {
+    i2cTransfer[i2cActive].status = status;
+    if (i2cQueueHead != i2cQueueTail) {
+        // STOP followed by START for the next queued transfer
+        i2cActive = i2cQueue[i2cQueueHead];
+        if (++i2cQueueHead >= KG_I2C_TRANSFER_MAX) i2cQueueHead = 0;
+        i2cTransfer[i2cActive].status = KG_I2C_STATUS_ACTIVE;
+        TWCR = KG_I2C_TWCR_GO | (1 << TWSTO) | (1 << TWSTA);
+    } else {
+        i2cActive = KG_I2C_TRANSFER_NONE;
+        TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+    }
+}
+
+/**
+ * @brief TWI interrupt, advances the active transfer by one bus event
+ *
+ * Status codes are from the "Two-wire Serial Interface" chapter of the
+ * AT90USB1286 datasheet (master transmitter and master receiver modes).
+ */
+ISR(TWI_vect) {
+    // nothing to advance (e.g. a late flag after a timeout reset), so stop interrupting until the next transfer starts
+    if (i2cActive == KG_I2C_TRANSFER_NONE) {
+        TWCR = (1 << TWEN);
+        return;
+    }
+
+    i2c_transfer_t *transfer = &i2cTransfer[i2cActive];
+    i2cProgress++;
+    switch (TWSR & 0xF8) {
+        case 0x08: // START sent
+            TWDR = transfer -> address << 1;
+            TWCR = KG_I2C_TWCR_GO;
+            break;
+        case 0x10: // repeated START sent
+            TWDR = (transfer -> address << 1) | 1;
+            TWCR = KG_I2C_TWCR_GO;
+            break;
+        case 0x18: // SLA+W sent, ACK received
+            TWDR = transfer -> reg;
+            i2cIndex = 0;
+            TWCR = KG_I2C_TWCR_GO;
+            break;
+        case 0x28: // data (or register address) sent, ACK received
+            if (!transfer -> write) {
+                TWCR = KG_I2C_TWCR_GO | (1 << TWSTA);
+            } else if (i2cIndex < transfer -> length) {
+                TWDR = transfer -> data[i2cIndex++];
+                TWCR = KG_I2C_TWCR_GO;
+            } else {
+                i2c_finish(KG_I2C_STATUS_DONE);
+            }
+            break;
+        case 0x40: // SLA+R sent, ACK received (ACK the next byte unless it is the last)
+            TWCR = KG_I2C_TWCR_GO | (transfer -> length > 1 ? (1 << TWEA) : 0);
+            break;
+        case 0x50: // data received, ACK sent
+            transfer -> data[i2cIndex++] = TWDR;
+            TWCR = KG_I2C_TWCR_GO | (i2cIndex + 1 < transfer -> length ? (1 << TWEA) : 0);
+            break;
+        case 0x58: // last data byte received, NACK sent
+            transfer -> data[i2cIndex] = TWDR;
+            i2c_finish(KG_I2C_STATUS_DONE);
+            break;
+        case 0x20: // SLA+W sent, NACK received
+        case 0x30: // data sent, NACK received
+        case 0x48: // SLA+R sent, NACK received
+            i2c_finish(KG_I2C_STATUS_NACK);
+            break;
+        default: // arbitration lost, bus error, or anything unexpected
+            i2c_finish(KG_I2C_STATUS_BUS_ERROR);
+            break;
+    }
+}
+
+#endif
+
+/**
+ * @brief Initialize TWI module for master transfers
+ */
+void setup_i2c() {
+    #if (KG_I2C == KG_I2C_WIRE) && (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
+        Wire.begin();
+    #elif defined(I2CDEV_IMPLEMENTATION) && (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE)
+        Fastwire::setup(KG_I2C_CLOCK / 1000, true);
+    #endif
+
+    // internal pull-ups on SDA and SCL (external ones are still recommended at 400kHz)
+    digitalWrite(SDA, HIGH);
+    digitalWrite(SCL, HIGH);
+
+    // bit rate = F_CPU / (16 + 2 * TWBR * prescaler), with prescaler = 1
+    TWSR = 0;
+    TWBR = ((F_CPU / KG_I2C_CLOCK) - 16) / 2;
+    #if (KG_I2C == KG_I2C_TWI)
+        TWCR = (1 << TWEN);
+    #endif
+}
+
+/**
+ * @brief Register a new I2C client
+ * @param[in] service Client service routine
+ * @param[in] complete Client completion routine
+ * @return Client handle for i2c_request(), i2c_read(), and i2c_write(), or KG_I2C_CLIENT_NONE if all KG_I2C_CLIENT_MAX are taken
+ */
+uint8_t i2c_register(i2c_service_t service, i2c_complete_t complete) {
+    if (i2cClients >= KG_I2C_CLIENT_MAX) return KG_I2C_CLIENT_NONE;
+    i2cService[i2cClients] = service;
+    i2cComplete[i2cClients] = complete;
+    return i2cClients++;
+}
+
+/**
+ * @brief Request service for an I2C client
+ * @param[in] client Client handle from i2c_register()
+ *
+ * A handle of KG_I2C_CLIENT_NONE (registration failed) is ignored. This is
+ * only safe to call from the main loop, not from interrupt handlers.
+ */
+void i2c_request(uint8_t client) {
+    if (client < i2cClients) i2cPending |= (1 << client);
+}
+
+/**
+ * @brief Add a transfer to the queue, and start it if the bus is free
+ * @param[in] slot Transfer pool index
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] write Nonzero to write data, zero to read it
+ * @param[in] length Number of data bytes
+ * @param[in] data Data buffer
+ */
+void i2c_queue(uint8_t slot, uint8_t address, uint8_t reg, uint8_t write, uint8_t length, uint8_t *data) {
+    i2c_transfer_t *transfer = &i2cTransfer[slot];
+    transfer -> address = address;
+    transfer -> reg = reg;
+    transfer -> write = write;
+    transfer -> length = length;
+    transfer -> data = data;
+
+    #if (KG_I2C == KG_I2C_WIRE)
+        // I2Cdev waits for the whole transfer, so it is finished by the time this returns
+        bool ok;
+        if (write) ok = I2Cdev::writeBytes(address, reg, length, data);
+        else ok = I2Cdev::readBytes(address, reg, length, data, KG_I2C_TIMEOUT) == length;
+        transfer -> status = ok ? KG_I2C_STATUS_DONE : KG_I2C_STATUS_NACK;
+    #else
+        uint8_t sreg = SREG;
+        cli();
+        if (i2cActive == KG_I2C_TRANSFER_NONE) {
+            i2cActive = slot;
+            i2cProgress++;  // timeout counts from now, not from the last check (the bus may have been idle for a while)
+            transfer -> status = KG_I2C_STATUS_ACTIVE;
+            TWCR = KG_I2C_TWCR_GO | (1 << TWSTA);
+        } else {
+            transfer -> status = KG_I2C_STATUS_QUEUED;
+            i2cQueue[i2cQueueTail] = slot;
+            if (++i2cQueueTail >= KG_I2C_TRANSFER_MAX) i2cQueueTail = 0;
+        }
+        SREG = sreg;
+    #endif
+}
+
+/**
+ * @brief Queue a register read for an I2C client
+ * @param[in] client Client handle from i2c_register()
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] length Number of bytes to read
+ * @param[out] data Buffer for data (must stay valid until completion)
+ *
+ * Only call this from the client's service routine.
+ */
+void i2c_read(uint8_t client, uint8_t address, uint8_t reg, uint8_t length, uint8_t *data) {
+    i2c_queue(client, address, reg, 0, length, data);
+}
+
+/**
+ * @brief Queue a register write for an I2C client
+ * @param[in] client Client handle from i2c_register()
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] length Number of bytes to write
+ * @param[in] data Data to write (must stay valid until completion)
+ *
+ * Only call this from the client's service routine.
+ */
+void i2c_write(uint8_t client, uint8_t address, uint8_t reg, uint8_t length, uint8_t *data) {
+    i2c_queue(client, address, reg, 1, length, data);
+}
+
+/**
+ * @brief Reset the TWI module if the bus has stopped making progress
+ *
+ * With KG_I2C_WIRE, I2Cdev handles its own timeouts, so there is nothing to do.
+ */
+void i2c_check_timeout() {
+    #if (KG_I2C == KG_I2C_TWI)
+        uint32_t now = millis();
+        if (i2cActive == KG_I2C_TRANSFER_NONE || i2cProgress != i2cWatchProgress) {
+            i2cWatchProgress = i2cProgress;
+            i2cWatchTime = now;
+        } else if (now - i2cWatchTime > KG_I2C_TIMEOUT) {
+            uint8_t sreg = SREG;
+            cli();
+            TWCR = 0;
+            TWCR = (1 << TWEN);
+            i2c_finish(KG_I2C_STATUS_BUS_ERROR);
+            SREG = sreg;
+            i2cWatchTime = now;
+        }
+    #endif
+}
+
+/**
+ * @brief Run one transfer and wait for it to finish
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] write Nonzero to write data, zero to read it
+ * @param[in] length Number of data bytes
+ * @param[in] data Data buffer
+ * @return Final transfer status (KG_I2C_STATUS_DONE on success)
+ */
+uint8_t i2c_transfer_blocking(uint8_t address, uint8_t reg, uint8_t write, uint8_t length, uint8_t *data) {
+    i2c_transfer_t *transfer = &i2cTransfer[KG_I2C_TRANSFER_MAX - 1];
+    i2c_queue(KG_I2C_TRANSFER_MAX - 1, address, reg, write, length, data);
+    while (transfer -> status == KG_I2C_STATUS_QUEUED || transfer -> status == KG_I2C_STATUS_ACTIVE) i2c_check_timeout();
+    return transfer -> status;
+}
+
+/**
+ * @brief Read registers, waiting for any queued transfers and then this one
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] length Number of bytes to read
+ * @param[out] data Buffer for data
+ * @return Final transfer status (KG_I2C_STATUS_DONE on success)
+ */
+uint8_t i2c_read_bytes(uint8_t address, uint8_t reg, uint8_t length, uint8_t *data) {
+    return i2c_transfer_blocking(address, reg, 0, length, data);
+}
+
+/**
+ * @brief Write registers, waiting for any queued transfers and then this one
+ * @param[in] address 7-bit device address
+ * @param[in] reg First register address
+ * @param[in] length Number of bytes to write
+ * @param[in] data Data to write
+ * @return Final transfer status (KG_I2C_STATUS_DONE on success)
+ */
+uint8_t i2c_write_bytes(uint8_t address, uint8_t reg, uint8_t length, uint8_t *data) {
+    return i2c_transfer_blocking(address, reg, 1, length, data);
+}
+
+/**
+ * @brief Write a single register, waiting for any queued transfers and then this one
+ * @param[in] address 7-bit device address
+ * @param[in] reg Register address
+ * @param[in] value Value to write
+ * @return Final transfer status (KG_I2C_STATUS_DONE on success)
+ */
+uint8_t i2c_write_byte(uint8_t address, uint8_t reg, uint8_t value) {
+    return i2c_transfer_blocking(address, reg, 1, 1, &value);
+}
+
+/**
+ * @brief Hand finished transfers to their clients, then let each pending client queue one
+ *
+ * The first client served moves along by one on every pass, so no device is
+ * always first in line. A client is requested again whenever its completion
+ * routine reports that more transactions are waiting, and one requested while
+ * its transfer is still outstanding waits until that has been handled.
+ */
+void update_i2c() {
+    uint8_t i, client, status;
+
+    i2c_check_timeout();
+
+    // completion routines for finished transfers
+    for (client = 0; client < i2cClients; client++) {
+        status = i2cTransfer[client].status;
+        if (status < KG_I2C_STATUS_DONE) continue;
+        i2cTransfer[client].status = KG_I2C_STATUS_IDLE;
+        if (i2cComplete[client](status)) i2cPending |= (1 << client);
+    }
+
+    // service routines for pending clients with nothing on the bus
+    if (!i2cPending) return;
+    client = i2cNext;
+    if (++i2cNext >= i2cClients) i2cNext = 0;
+    for (i = 0; i < i2cClients; i++) {
+        if ((i2cPending & (1 << client)) && i2cTransfer[client].status == KG_I2C_STATUS_IDLE) {
+            i2cPending &= ~(1 << client);
+            i2cService[client]();
+        }
+        if (++client >= i2cClients) client = 0;
+    }
+}
@@ -0,0 +1,116 @@
+// Keyglove controller source code - Interrupt-driven I2C transaction queue declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_i2c.h
+ * @brief Interrupt-driven I2C transaction queue declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#ifndef _SUPPORT_I2C_H_
+#define _SUPPORT_I2C_H_
+
+#if (KG_I2C == KG_I2C_WIRE) || (KG_FUSION & KG_FUSION_DMP)
+    #include <I2Cdev.h>
+#endif
+
+#ifndef KG_I2C_CLOCK
+    #define KG_I2C_CLOCK        400000  ///< I2C bus clock in Hz
+#endif
+
+#ifndef KG_I2C_TIMEOUT
+    #define KG_I2C_TIMEOUT      10      ///< Milliseconds without progress before the bus is reset
+#endif
+
+#define KG_I2C_CLIENT_MAX       8       ///< Maximum number of scheduled I2C clients (one bit each in i2cPending)
+#define KG_I2C_CLIENT_NONE      0xFF    ///< Returned by i2c_register() when every client slot is taken
+#define KG_I2C_TRANSFER_MAX     (KG_I2C_CLIENT_MAX + 1)     ///< Transfer pool size (one per client, plus one for blocking calls)
+#define KG_I2C_TRANSFER_NONE    0xFF    ///< No transfer active
+
+#define KG_I2C_STATUS_IDLE      0x00    ///< Transfer slot is free
+#define KG_I2C_STATUS_QUEUED    0x01    ///< Waiting for the bus
+#define KG_I2C_STATUS_ACTIVE    0x02    ///< On the wire now
+#define KG_I2C_STATUS_DONE      0x03    ///< Finished successfully, completion not yet handled
+#define KG_I2C_STATUS_NACK      0x04    ///< Device did not acknowledge its address or a data byte (or I2Cdev reported a failure, with KG_I2C_WIRE)
+#define KG_I2C_STATUS_BUS_ERROR 0x05    ///< Arbitration lost, illegal bus state, or timeout
+
+#if (KG_I2C == KG_I2C_TWI) && (KG_FUSION & KG_FUSION_DMP) && (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
+    #error KG_I2C_TWI replaces the Wire library, so the DMP loader needs I2Cdev built with I2CDEV_IMPLEMENTATION = I2CDEV_BUILTIN_FASTWIRE (see config.h)
+#endif
+
+/**
+ * @brief Queued register read or write (7 bytes)
+ *
+ * Every transfer starts by writing the register address. A read follows that
+ * with a repeated start and reads the data bytes, and a write sends the data
+ * bytes right after the register address.
+ */
+typedef struct {
+    uint8_t address;                ///< 7-bit device address
+    uint8_t reg;                    ///< First register address
+    uint8_t write;                  ///< Nonzero to write data, zero to read it
+    uint8_t length;                 ///< Number of data bytes (at least 1)
+    uint8_t *data;                  ///< Data buffer (must stay valid until the transfer finishes)
+    volatile uint8_t status;        ///< Transfer status
+} i2c_transfer_t;
+
+/**
+ * @brief I2C client service routine
+ *
+ * Called from update_i2c() when the client has been requested and has no
+ * transfer outstanding. It should queue at most one bounded transfer (e.g. one
+ * FIFO burst) with i2c_read() or i2c_write(), so that other devices on the bus
+ * get their turn in between, or none if there is nothing to do after all.
+ */
+typedef void (*i2c_service_t)();
+
+/**
+ * @brief I2C client completion routine
+ * @param[in] status Final transfer status (KG_I2C_STATUS_DONE on success)
+ * @return Nonzero if more transactions are waiting, zero when finished
+ *
+ * Called from update_i2c() in the main loop, never from the interrupt, so it
+ * is safe to process data and send packets here.
+ */
+typedef uint8_t (*i2c_complete_t)(uint8_t status);
+
+extern uint8_t i2cPending;
+
+void setup_i2c();
+uint8_t i2c_register(i2c_service_t service, i2c_complete_t complete);
+void i2c_request(uint8_t client);
+void i2c_read(uint8_t client, uint8_t address, uint8_t reg, uint8_t length, uint8_t *data);
+void i2c_write(uint8_t client, uint8_t address, uint8_t reg, uint8_t length, uint8_t *data);
+uint8_t i2c_read_bytes(uint8_t address, uint8_t reg, uint8_t length, uint8_t *data);
+uint8_t i2c_write_bytes(uint8_t address, uint8_t reg, uint8_t length, uint8_t *data);
+uint8_t i2c_write_byte(uint8_t address, uint8_t reg, uint8_t value);
+void update_i2c();
+
+#endif // _SUPPORT_I2C_H_
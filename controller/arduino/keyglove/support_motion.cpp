@@ -39,6 +39,60 @@ THE SOFTWARE.
 
 #include "keyglove.h"
 #include "support_protocol.h"
+#include "support_i2c.h"
 #include "support_motion.h"
 
 motion_mode_t motionMode[KG_MOTION_SENSOR_COUNT];   ///< Motion sensor modes
+uint8_t motionI2CClient[KG_MOTION_SENSOR_COUNT];    ///< I2C scheduler client handle for each sensor
+
+/**
+ * @brief Drivers for all enabled motion sensors, in motion sensor index order
+ */
+const motion_driver_t motionDriver[KG_MOTION_SENSOR_COUNT] = {
+    #if (KG_MOTION & KG_MOTION_MPU6050_HAND)
+        { setup_motion_mpu6050_hand, motion_set_mpu6050_hand_mode, update_motion_mpu6050_hand, motion_mpu6050_hand_complete, &mpuHandInterrupt },
+    #endif
+    #if (KG_MOTION & KG_MOTION_MPU6050_INDEXTIP)
+        { setup_motion_mpu6050_indextip, motion_set_mpu6050_indextip_mode, update_motion_mpu6050_indextip, motion_mpu6050_indextip_complete, &mpuIndexTipInterrupt },
+    #endif
+};
+
+/**
+ * @brief Set a motion sensor's mode
+ * @param[in] index Motion sensor index
+ * @param[in] mode New mode
+ */
+void motion_set_mode(uint8_t index, motion_mode_t mode) {
+    motionMode[index] = mode;
+    motionDriver[index].set_mode(mode);
+}
+
+/**
+ * @brief Initialize all motion sensors and register them with the I2C scheduler
+ */
+void setup_motion() {
+    for (uint8_t i = 0; i < KG_MOTION_SENSOR_COUNT; i++) {
+        motionI2CClient[i] = i2c_register(motionDriver[i].update, motionDriver[i].complete);
+        motionDriver[i].setup();
+    }
+}
+
+/**
+ * @brief Request I2C service for every motion sensor with data waiting
+ *
+ * The actual reads happen in update_i2c(), interleaved with other devices.
+ * EEPROM writes queued by a sensor driver also continue here, one byte per
+ * pass.
+ */
+void update_motion() {
+    for (uint8_t i = 0; i < KG_MOTION_SENSOR_COUNT; i++) {
+        if (*motionDriver[i].interrupt) {
+            *motionDriver[i].interrupt = false; // clear the flag so we don't read again until the next interrupt
+            i2c_request(motionI2CClient[i]);
+        }
+    }
+    #if (KG_MOTION & KG_MOTION_MPU6050_HAND)
+        // write the next byte of a stored gyro bias update, if the EEPROM is ready
+        update_motion_mpu6050_hand_bias();
+    #endif
+}
@@ -44,12 +44,22 @@ THE SOFTWARE.
 #define _SUPPORT_MOTION_H_
 
 #if (KG_MOTION & KG_MOTION_MPU6050_HAND)
-     #include "support_motion_mpu6050_hand.h"
-    #define KG_MOTION_SENSOR_COUNT  1
+    #include "support_motion_mpu6050_hand.h"
+    #define KG_MOTION_MPU6050_HAND_INDEX        0   ///< Motion sensor index of hand-mounted MPU-6050
+    #define KG_MOTION_HAND_COUNT                1
 #else
-    #define KG_MOTION_SENSOR_COUNT  0           ///< Number of motion sensors incorporated in design
+    #define KG_MOTION_HAND_COUNT                0
+#endif
+#if (KG_MOTION & KG_MOTION_MPU6050_INDEXTIP)
+    #include "support_motion_mpu6050_indextip.h"
+    #define KG_MOTION_MPU6050_INDEXTIP_INDEX    KG_MOTION_HAND_COUNT    ///< Motion sensor index of index fingertip MPU-6050
+    #define KG_MOTION_INDEXTIP_COUNT            1
+#else
+    #define KG_MOTION_INDEXTIP_COUNT            0
 #endif
 
+#define KG_MOTION_SENSOR_COUNT  (KG_MOTION_HAND_COUNT + KG_MOTION_INDEXTIP_COUNT)   ///< Number of motion sensors incorporated in design
+
 /**
  * @brief List of possible values for motion sensor mode
  */
@@ -59,6 +69,28 @@ typedef enum {
     KG_MOTION_MODE_MAX
 } motion_mode_t;
 
+/**
+ * @brief Common motion sensor driver interface
+ *
+ * Each sensor module provides one of these, in motion sensor index order. The
+ * update and complete routines are registered as an I2C client, so they must
+ * follow the i2c_service_t and i2c_complete_t rules (one bounded transfer
+ * queued per call, data processed once it has arrived).
+ */
+typedef struct {
+    void (*setup)();                        ///< Initialize sensor (once at boot)
+    void (*set_mode)(uint8_t mode);         ///< Enable or disable sensor
+    void (*update)();                       ///< Queue the next read of waiting data
+    uint8_t (*complete)(uint8_t status);    ///< Process finished read, return nonzero if more is waiting
+    bool *interrupt;                        ///< Data-ready flag set by the sensor's interrupt handler
+} motion_driver_t;
+
 extern motion_mode_t motionMode[KG_MOTION_SENSOR_COUNT];
+extern const motion_driver_t motionDriver[KG_MOTION_SENSOR_COUNT];
+extern uint8_t motionI2CClient[KG_MOTION_SENSOR_COUNT];
+
+void motion_set_mode(uint8_t index, motion_mode_t mode);
+void setup_motion();
+void update_motion();
 
 #endif // _SUPPORT_MOTION_H_
@@ -32,21 +32,88 @@ THE SOFTWARE.
  * @date 2015-07-03
  *
  * This file provides a communications layer and capture interface for using the
- * InvenSense MPU-6050 motions sensor, mounted on the back of the hand. Only the
- * raw sensor data is currently used from this chip; the DMP is not used for on-
- * module motion fusion.
+ * InvenSense MPU-6050 motions sensor, mounted on the back of the hand. With
+ * KG_FUSION_DMP, the on-chip DMP computes a 6-axis orientation quaternion, and
+ * only the gravity removal (one fixed-point rotation) is done here. With
+ * KG_FUSION_MAHONY, raw samples are fused here by a fixed-point Mahony filter
+ * instead, or only when the DMP fails to load if both are enabled. Otherwise,
+ * only the raw sensor data is used from this chip.
+ *
+ * Raw accel/gyro samples are collected in the MPU-6050's FIFO and read out in
+ * bursts. The chip has no FIFO watermark interrupt, so the interrupt handler
+ * counts data-ready pulses instead and only flags the main loop once
+ * KG_MPU6050_HAND_FIFO_WATERMARK samples are waiting. The FIFO holds 85
+ * samples (850ms at 100Hz), so a stalled loop does not lose data. Bursts are
+ * read into mpuHandBuffer by the interrupt-driven I2C queue while the main
+ * loop carries on, and processed once they have arrived.
+ *
+ * After KG_MPU6050_HAND_STILL_TIME samples with no significant change, the
+ * sensor drops into low-power accel-only cycle mode with only the motion
+ * interrupt enabled, and no data is streamed. The first motion interrupt
+ * restores full-rate sampling. Both transitions send a motion state event.
+ *
+ * Samples may be batched into motion batch events to save per-packet overhead,
+ * especially over Bluetooth, where each packet is also wrapped in a MUX frame.
+ * The batch size is either fixed with opt_motion_hand_batch, or chosen from the
+ * active link type.
+ *
+ * Gyro bias is estimated in the background whenever the hand is resting, and
+ * removed from every raw sample before filtering or fusion. The estimate is
+ * saved to EEPROM on the way into low-power mode and loaded again at boot, so
+ * it is valid from the first sample.
  *
  * Normally it is not necessary to edit this file.
  */
 
+#include <avr/eeprom.h>
+
 #include "keyglove.h"
 #include "support_board.h"
 #include "support_protocol.h"
+#include "support_i2c.h"
 #include "support_motion.h"
 #include "support_motion_mpu6050_hand.h"
+#include "support_recorder.h"
+#include "support_hid_mouse.h"
+
+#if (KG_MOTIONGESTURE > 0)
+    #include "support_motiongesture.h"
+#endif
+
+#if (KG_FUSION & KG_FUSION_DMP)
+    // DMP firmware and packet helpers from I2Cdevlib (header-only, so this must be the only file including it)
+    #include <MPU6050_6Axis_MotionApps20.h>
+
+MPU6050 mpuHand = MPU6050(0x68);        ///< MPU-6050 motion sensor I2Cdevlib object (DMP loading and packet parsing only)
+#endif
 
-MPU6050 mpuHand = MPU6050(0x68);        ///< MPU-6050 motion sensor I2Cdevlib object
 bool mpuHandInterrupt;                  ///< Interrupt flag for motion data availability
+volatile uint8_t mpuHandPending;        ///< Data-ready interrupts since FIFO was last read
+uint16_t mpuHandFifoCount;              ///< Whole samples known to be waiting in FIFO
+uint8_t mpuHandBurst;                   ///< Samples being read in current burst (0 = reading FIFO byte count)
+bool mpuHandDiscard;                    ///< FIFO was reset or sensor disabled while a read was outstanding
+#if (KG_FUSION & KG_FUSION_DMP)
+    uint8_t mpuHandBuffer[KG_MPU6050_HAND_FIFO_BURST * KG_MPU6050_DMP_PACKET_SIZE];     ///< I2C read buffer (filled in the background)
+#else
+    uint8_t mpuHandBuffer[KG_MPU6050_HAND_FIFO_BURST * KG_MPU6050_FIFO_SAMPLE_SIZE];    ///< I2C read buffer (filled in the background)
+#endif
+uint8_t mpuHandState;                   ///< Current motion state (moving or still/low-power)
+uint16_t mpuHandStillCount;             ///< Consecutive samples without significant motion
+VectorInt16 mpuHandStillAccel;          ///< Raw accel reading at start of current still period
+VectorInt16 mpuHandStillGyro;           ///< Raw gyro reading at start of current still period
+uint8_t mpuHandWakeConfig[3];           ///< INT_ENABLE, FIFO_EN, and ACCEL_CONFIG values to restore on wake
+
+bool mpuHandBiasStill;                  ///< Last complete bias window was still
+bool mpuHandBiasValid;                  ///< Gyro bias has been estimated or loaded from EEPROM
+int32_t mpuHandBias[3];                 ///< Gyro X/Y/Z bias (1/256 counts at 2000 deg/sec)
+int32_t mpuHandBiasSaved[3];            ///< Gyro bias last written to EEPROM
+mpu6050_bias_record_t mpuHandBiasRecord; ///< Gyro bias record waiting to be written into EEPROM
+uint8_t mpuHandBiasWriteLength;         ///< Number of record bytes to write
+uint8_t mpuHandBiasWritePos;            ///< Number of record bytes already written
+uint8_t mpuHandBiasCount;               ///< Samples in current bias window
+int16_t mpuHandBiasFirst[6];            ///< First raw accel X/Y/Z and gyro X/Y/Z sample in current bias window
+int32_t mpuHandBiasSum[6];              ///< Sum of deviations from first sample in current bias window
+uint32_t mpuHandBiasSumSq[6];           ///< Sum of squared deviations from first sample in current bias window
 
 VectorInt16 aaRaw;                      ///< Raw linear acceleration
 VectorInt16 aa;                         ///< Filtered linear acceleration
@@ -55,12 +122,73 @@ VectorInt16 gvRaw;                      ///< Raw rotational velocity
 VectorInt16 gv;                         ///< Filtered rotational velocity
 VectorInt16 gv0;                        ///< Last-iteration filtered rotational velocity
 
+uint8_t opt_motion_hand_filter[6] = { 2, 2, 2, 2, 2, 2 };   ///< OPTION: Smoothing filter for accel X/Y/Z and gyro X/Y/Z (0 = none, 2 = 1/4, ... 8 = 1/256, or biquad)
+int32_t mpuHandFilter[6];               ///< Smoothing filter state for accel X/Y/Z and gyro X/Y/Z (8 fractional bits, or biquad rounding residue)
+int16_t mpuHandBiquad[6][4];            ///< Biquad filter history for accel X/Y/Z and gyro X/Y/Z (last two inputs, last two outputs)
+
+/**
+ * @brief Butterworth (Q = 0.707) low-pass biquad coefficients b0, b1, a1, a2 with 16384 = 1.0
+ *
+ * One row per cutoff setting, from 5% to 25% of the sample rate (5-25Hz at
+ * 100Hz), worked out with the usual bilinear transform formulas. b2 is the
+ * same as b0, and b1 is rounded so that b0 + b1 + b2 = 1 + a1 + a2 exactly,
+ * which keeps the DC gain at exactly 1 despite coefficient rounding. Lower
+ * cutoffs would need more coefficient bits and could overflow the 32-bit
+ * accumulator, so use the shift filter for heavier smoothing.
+ */
+const int16_t mpu6050BiquadCoefficients[KG_MPU6050_FILTER_BIQUAD_COUNT][4] PROGMEM = {
+    {  329,  658, -25576, 10508 },  // 5%
+    { 1105, 2210, -18727,  6763 },  // 10%
+    { 2148, 4296, -12252,  4460 },  // 15%
+    { 3384, 6770,  -6054,  3208 },  // 20%
+    { 4799, 9597,      0,  2811 },  // 25%
+};
+
+uint8_t opt_motion_hand_rate_div = 9;       ///< OPTION: Sample rate divider (1kHz / (1 + div), 9 = 100Hz)
+uint8_t opt_motion_hand_dlpf = 3;           ///< OPTION: Digital low-pass filter setting (1-6 = 188Hz to 5Hz, 3 = 42Hz)
+uint8_t opt_motion_hand_gyro_range = 3;     ///< OPTION: Gyro full-scale range (0-3 = 250 to 2000 deg/sec)
+uint8_t opt_motion_hand_accel_range = 0;    ///< OPTION: Accel full-scale range (0-3 = 2g to 16g)
+uint8_t opt_motion_hand_decimation = 1;     ///< OPTION: Samples per motion data event
+uint8_t mpuHandDecimationCount;             ///< Samples since last motion data event
+uint16_t mpuHandStillLimit;                 ///< Still samples needed to enter low-power mode at current rate
+uint8_t opt_motion_hand_batch = 0;          ///< OPTION: Samples per motion batch event (0 = automatic by link type, 1 = separate motion data events)
+uint8_t mpuHandBatch[KG_MPU6050_BATCH_SIZE_MAX];    ///< Motion batch event payload being collected
+uint8_t mpuHandBatchCount;                  ///< Samples in mpuHandBatch
+
+#if (KG_FUSION > 0)
+    bool mpuHandFused;                  ///< Orientation and world-frame acceleration are available
+    int16_t mpuHandQuat[4];             ///< Latest orientation quaternion (w, x, y, z), 16384 = 1.0
+    VectorInt16 apFrame;                ///< World-frame linear acceleration (gravity removed), 8192 = 1g
+#endif
+#if (KG_FUSION & KG_FUSION_DMP)
+    bool mpuHandDMPReady;               ///< DMP firmware loaded and running
+#endif
+#if (KG_FUSION & KG_FUSION_MAHONY)
+    /// Orientation filter for raw samples (update constants are set by motion_mpu6050_hand_configure())
+    MahonyFilter mpuHandMahony(0, 0, 0);
+#endif
+
 /**
  * @brief Interrupt handler for INT pin from MPU-6050
  * @see mpuHandInterrupt
  */
 void motion_mpu6050_hand_interrupt() {
-    mpuHandInterrupt = true;
+    if (mpuHandPending < 255) mpuHandPending++;
+    if (mpuHandPending >= KG_MPU6050_HAND_FIFO_WATERMARK || mpuHandState == KG_MOTION_STATE_STILL) mpuHandInterrupt = true;
+}
+
+/**
+ * @brief Discard FIFO contents and restart sample collection
+ */
+void motion_mpu6050_hand_fifo_reset() {
+    #if (KG_FUSION & KG_FUSION_DMP)
+        i2c_write_byte(0x68, MPU6050_RA_USER_CTRL, mpuHandDMPReady ? 0xC4 : 0x44); // (DMP_EN) | FIFO_EN | FIFO_RESET
+    #else
+        i2c_write_byte(0x68, MPU6050_RA_USER_CTRL, 0x44); // FIFO_EN | FIFO_RESET
+    #endif
+    mpuHandPending = 0;
+    mpuHandFifoCount = 0;
+    mpuHandDiscard = true;
 }
 
 /**
@@ -69,25 +197,225 @@ void motion_mpu6050_hand_interrupt() {
  */
 void motion_set_mpu6050_hand_mode(uint8_t mode) {
     if (mode) {
+        if (mpuHandState == KG_MOTION_STATE_STILL) motion_mpu6050_hand_wake();
+        mpuHandState = KG_MOTION_STATE_MOVING;
+        mpuHandStillCount = 0;
+        mpuHandBiasCount = 0;
         aa.x = aa.y = aa.z = 0;
         gv.x = gv.y = gv.z = 0;
-        mpuHandInterrupt = true;
+        motion_mpu6050_hand_filter_reset();
+        #if (KG_FUSION & KG_FUSION_MAHONY)
+            mpuHandMahony.reset();
+        #endif
+        motion_mpu6050_hand_fifo_reset();
+        mpuHandInterrupt = false;
         attachInterrupt(KG_INTERRUPT_NUM_MPU6050_HAND, motion_mpu6050_hand_interrupt, FALLING);
         //mpuHand.setSleepEnabled(false);
         //I2Cdev::writeByte(0x68, MPU6050_RA_PWR_MGMT_1, 0x01);
     } else {
+        motion_mpu6050_hand_batch_flush();
+        mpuHandDiscard = true;
         //mpuHand.setSleepEnabled(true);
         //I2Cdev::writeByte(0x68, MPU6050_RA_PWR_MGMT_1, 0x41);
         detachInterrupt(KG_INTERRUPT_NUM_MPU6050_HAND);
     }
 }
 
+/**
+ * @brief Apply sample rate, DLPF, and full-scale range options
+ *
+ * SMPLRT_DIV, CONFIG, GYRO_CONFIG, and ACCEL_CONFIG are consecutive registers,
+ * so they are all rewritten in a single burst I2C write. Everything derived
+ * from the sample rate or gyro range (still timeout, Mahony constants) is
+ * recalculated as well. This is not used while the DMP is running, since its
+ * firmware depends on the configuration it loaded.
+ *
+ * @see opt_motion_hand_rate_div
+ * @see opt_motion_hand_dlpf
+ * @see opt_motion_hand_gyro_range
+ * @see opt_motion_hand_accel_range
+ */
+void motion_mpu6050_hand_configure() {
+    uint8_t config[4];
+    config[0] = opt_motion_hand_rate_div;           // SMPLRT_DIV
+    config[1] = opt_motion_hand_dlpf;               // CONFIG (DLPF_CFG)
+    config[2] = opt_motion_hand_gyro_range << 3;    // GYRO_CONFIG (FS_SEL)
+    config[3] = opt_motion_hand_accel_range << 3;   // ACCEL_CONFIG (AFS_SEL)
+
+    // in low-power mode, keep the motion detection high-pass filter until wake-up
+    mpuHandWakeConfig[2] = config[3];
+    if (mpuHandState == KG_MOTION_STATE_STILL) config[3] |= 0x01;
+    i2c_write_bytes(0x68, MPU6050_RA_SMPLRT_DIV, 4, config);
+
+    mpuHandStillLimit = KG_MPU6050_HAND_STILL_TIME / (opt_motion_hand_rate_div + 1);
+    mpuHandDecimationCount = 0;
+    mpuHandBiasCount = 0;
+    motion_mpu6050_hand_batch_flush();
+
+    // discard samples taken with the old settings
+    if (mpuHandState != KG_MOTION_STATE_STILL) motion_mpu6050_hand_fifo_reset();
+
+    #if (KG_FUSION & KG_FUSION_MAHONY)
+        // constants for 131 counts per deg/sec (250 deg/sec) at 1Hz, scaled to range and rate,
+        // and gains scaled up by 64 at 1kHz so they keep their precision at any rate
+        mpuHandMahony.gyroStep = ((int32_t)KG_MAHONY_GYRO_STEP(131, 1) << opt_motion_hand_gyro_range) * (opt_motion_hand_rate_div + 1) / 1000;
+        mpuHandMahony.kpStep = ((uint32_t)KG_MAHONY_KP_STEP(KG_MPU6050_HAND_MAHONY_KP * 64, 1000) * (opt_motion_hand_rate_div + 1)) >> 6;
+        mpuHandMahony.kiStep = ((uint32_t)KG_MAHONY_KI_STEP(KG_MPU6050_HAND_MAHONY_KI * 64, 1000) * (opt_motion_hand_rate_div + 1) * (opt_motion_hand_rate_div + 1)) >> 6;
+    #endif
+}
+
+/**
+ * @brief Load stored gyro bias from EEPROM, if there is one
+ */
+void motion_mpu6050_hand_bias_load() {
+    mpu6050_bias_record_t record;
+    eeprom_read_block(&record, (void *)KG_EEPROM_MOTION_BIAS_ADDRESS, sizeof(record));
+    if (record.magic != KG_MPU6050_BIAS_EEPROM_MAGIC) return;
+    memcpy(mpuHandBias, record.bias, sizeof(mpuHandBias));
+    memcpy(mpuHandBiasSaved, record.bias, sizeof(mpuHandBiasSaved));
+    mpuHandBiasValid = true;
+}
+
+/**
+ * @brief Queue gyro bias for writing into EEPROM if it has moved far enough since the last write
+ *
+ * This is only called on the way into low-power mode, from the I2C completion
+ * routine, so nothing is written here. update_motion_mpu6050_hand_bias()
+ * writes the record from the main loop one byte at a time, skipping unchanged
+ * bytes, so EEPROM wear stays negligible and touch scanning never waits for
+ * it while the hand is still.
+ */
+void motion_mpu6050_hand_bias_save() {
+    mpu6050_bias_record_t record;
+    uint8_t i;
+    if (!mpuHandBiasValid) return;
+    for (i = 0; i < 3; i++) {
+        if (abs(mpuHandBias[i] - mpuHandBiasSaved[i]) > KG_MPU6050_HAND_BIAS_SAVE_DELTA) break;
+    }
+    if (i == 3) return;
+    record.magic = KG_MPU6050_BIAS_EEPROM_MAGIC;
+    memcpy(record.bias, mpuHandBias, sizeof(record.bias));
+    memcpy(mpuHandBiasSaved, mpuHandBias, sizeof(mpuHandBiasSaved));
+    mpuHandBiasRecord = record;
+    mpuHandBiasWriteLength = sizeof(record);
+    mpuHandBiasWritePos = 0;
+}
+
+/**
+ * @brief Write queued gyro bias record into EEPROM in the background
+ *
+ * Called from the main loop. Bytes which already hold the right value are
+ * skipped, and this returns as soon as one byte write has been started, so a
+ * single pass never waits for the EEPROM.
+ */
+void update_motion_mpu6050_hand_bias() {
+    uint8_t *address;
+    while (mpuHandBiasWritePos < mpuHandBiasWriteLength && eeprom_is_ready()) {
+        address = (uint8_t *)KG_EEPROM_MOTION_BIAS_ADDRESS + mpuHandBiasWritePos;
+        if (eeprom_read_byte(address) != ((uint8_t *)&mpuHandBiasRecord)[mpuHandBiasWritePos]) {
+            eeprom_write_byte(address, ((uint8_t *)&mpuHandBiasRecord)[mpuHandBiasWritePos++]);
+            return;
+        }
+        mpuHandBiasWritePos++;
+    }
+}
+
+/**
+ * @brief Forget gyro bias estimate and erase stored copy
+ */
+void motion_mpu6050_hand_bias_reset() {
+    memset(mpuHandBias, 0, sizeof(mpuHandBias));
+    memset(mpuHandBiasSaved, 0, sizeof(mpuHandBiasSaved));
+    mpuHandBiasValid = false;
+    mpuHandBiasStill = false;
+    mpuHandBiasCount = 0;
+
+    // clearing the magic number replaces any record still being written
+    mpuHandBiasRecord.magic = 0xFFFF;
+    mpuHandBiasWriteLength = sizeof(mpuHandBiasRecord.magic);
+    mpuHandBiasWritePos = 0;
+}
+
+/**
+ * @brief Get gyro bias for one axis in raw counts at the current gyro range
+ * @param[in] axis Gyro axis (0-2 = X/Y/Z)
+ * @return Bias to subtract from raw gyro readings
+ */
+int16_t motion_mpu6050_hand_bias_counts(uint8_t axis) {
+    return (mpuHandBias[axis] * (1 << (3 - opt_motion_hand_gyro_range)) + 128) >> 8;
+}
+
+/**
+ * @brief Update gyro bias estimate and remove bias from the latest raw sample
+ *
+ * Raw samples are collected in windows of 2^KG_MPU6050_HAND_BIAS_WINDOW,
+ * keeping the sum and sum of squares of each axis's deviation from the first
+ * sample in the window. These are small numbers while the hand rests, so the
+ * 32-bit sums cannot overflow, and any larger deviation restarts the window
+ * right away. When a window completes with every accel and gyro variance under
+ * its noise limit, the window's mean gyro reading is blended into the bias.
+ *
+ * The bias is kept in 1/256 counts at 2000 deg/sec, so changing the gyro range
+ * does not invalidate it.
+ */
+void motion_mpu6050_hand_bias() {
+    int16_t raw[6] = { aaRaw.x, aaRaw.y, aaRaw.z, gvRaw.x, gvRaw.y, gvRaw.z };
+    uint8_t i;
+    int32_t d, mean;
+    uint32_t s, limit;
+
+    if (mpuHandBiasCount == 0) {
+        memcpy(mpuHandBiasFirst, raw, sizeof(mpuHandBiasFirst));
+        memset(mpuHandBiasSum, 0, sizeof(mpuHandBiasSum));
+        memset(mpuHandBiasSumSq, 0, sizeof(mpuHandBiasSumSq));
+    }
+    for (i = 0; i < 6; i++) {
+        d = (int32_t)raw[i] - mpuHandBiasFirst[i];
+        if (d > KG_MPU6050_BIAS_DEVIATION_MAX || d < -KG_MPU6050_BIAS_DEVIATION_MAX) break;
+        mpuHandBiasSum[i] += d;
+        mpuHandBiasSumSq[i] += (uint32_t)(d * d);
+    }
+
+    if (i < 6) {
+        // obviously moving, start a new window from this sample
+        mpuHandBiasStill = false;
+        mpuHandBiasCount = 0;
+    } else if (++mpuHandBiasCount == (1 << KG_MPU6050_HAND_BIAS_WINDOW)) {
+        // window complete, compare N * variance (sum of squares - sum^2 / N) against N * RMS^2
+        mpuHandBiasCount = 0;
+        for (i = 0; i < 6; i++) {
+            s = abs(mpuHandBiasSum[i]);
+            if (i < 3) limit = KG_MPU6050_HAND_BIAS_ACCEL_RMS >> opt_motion_hand_accel_range;
+            else limit = KG_MPU6050_HAND_BIAS_GYRO_RMS << (3 - opt_motion_hand_gyro_range);
+            if (mpuHandBiasSumSq[i] - ((s * s) >> KG_MPU6050_HAND_BIAS_WINDOW) > (limit * limit) << KG_MPU6050_HAND_BIAS_WINDOW) break;
+        }
+        mpuHandBiasStill = (i == 6);
+        if (mpuHandBiasStill) {
+            for (i = 0; i < 3; i++) {
+                // window mean with 8 fractional bits, scaled to 2000 deg/sec
+                mean = (((int32_t)mpuHandBiasFirst[i + 3] << 8) + mpuHandBiasSum[i + 3] * (256 >> KG_MPU6050_HAND_BIAS_WINDOW)) >> (3 - opt_motion_hand_gyro_range);
+                if (mpuHandBiasValid) mpuHandBias[i] += (mean - mpuHandBias[i]) >> KG_MPU6050_HAND_BIAS_SHIFT;
+                else mpuHandBias[i] = mean;
+            }
+            mpuHandBiasValid = true;
+        }
+    }
+
+    // remove bias before any filtering or fusion
+    gvRaw.x -= motion_mpu6050_hand_bias_counts(0);
+    gvRaw.y -= motion_mpu6050_hand_bias_counts(1);
+    gvRaw.z -= motion_mpu6050_hand_bias_counts(2);
+}
+
 /**
  * @brief Initialize MPU-6050 communications and interrupt handler
  *
  * This function sets the MPU-6050 to 100Hz output, 2000 deg/sec resolution for
- * the gyroscope, and enables a latching active-low interrupt on DRDY (raw data
- * ready), MOT (motion detected), and ZMOT (zero motion detected).
+ * the gyroscope (or whatever the rate and range options are set to, see
+ * motion_mpu6050_hand_configure()), enables an active-low pulse interrupt on DRDY (raw data ready),
+ * and routes accel and gyro samples into the FIFO. With KG_FUSION_DMP, the DMP
+ * firmware is loaded instead, and it writes one packet to the FIFO and pulses
+ * the interrupt pin at 100Hz. If the DMP cannot be loaded, the raw setup is used.
  */
 void setup_motion_mpu6050_hand() {
     // set INT4 pin (Arduino Pin 36) to INPUT/HIGH so MPU can drive interrupt pin as active-low
@@ -96,6 +424,20 @@ void setup_motion_mpu6050_hand() {
 
     // setup MPU-6050
     mpuHandInterrupt = false;
+    motion_mpu6050_hand_bias_load();
+
+    #if (KG_FUSION & KG_FUSION_DMP)
+        // load DMP firmware and configuration (this resets the MPU-6050, so it comes first)
+        mpuHandDMPReady = (mpuHand.dmpInitialize() == 0);
+        if (mpuHandDMPReady) {
+            i2c_write_byte(0x68, MPU6050_RA_INT_PIN_CFG, 0xD0);
+            mpuHandStillLimit = KG_MPU6050_HAND_STILL_TIME / 10;    // DMP output is fixed at 100Hz
+            mpuHand.setDMPEnabled(true);
+            motion_mpu6050_hand_fifo_reset();
+            return;
+        }
+        send_keyglove_log(KG_LOG_LEVEL_NORMAL, 15, F("DMP INIT FAILED"));
+    #endif
 
     /*
     // initialization with friendly function names
@@ -117,78 +459,527 @@ void setup_motion_mpu6050_hand() {
 
     // initialization with manual register writes (faster than above, fewer transactions)
     // NOTE: InvenSense docs state Mot/ZMot interrupts no longer supported (?!)
+    // (zero-motion is gone, but motion detection still works in cycle mode, see motion_mpu6050_hand_sleep())
     //I2Cdev::writeByte(0x68, MPU6050_RA_MOT_THR, 0x14);
     //I2Cdev::writeByte(0x68, MPU6050_RA_MOT_DUR, 0x32);
     //I2Cdev::writeByte(0x68, MPU6050_RA_ZRMOT_THR, 0x14);
     //I2Cdev::writeByte(0x68, MPU6050_RA_ZRMOT_DUR, 0x2D);
-    I2Cdev::writeByte(0x68, MPU6050_RA_INT_PIN_CFG, 0xD0);
+    i2c_write_byte(0x68, MPU6050_RA_INT_PIN_CFG, 0xD0);
     //I2Cdev::writeByte(0x68, MPU6050_RA_INT_ENABLE, 0x61);
-    I2Cdev::writeByte(0x68, MPU6050_RA_INT_ENABLE, 0x01);
-    I2Cdev::writeByte(0x68, MPU6050_RA_ACCEL_CONFIG, 0x00);
-    I2Cdev::writeByte(0x68, MPU6050_RA_GYRO_CONFIG, 0x18);
-    I2Cdev::writeByte(0x68, MPU6050_RA_CONFIG, 0x03);
-    I2Cdev::writeByte(0x68, MPU6050_RA_SMPLRT_DIV, 0x09);
-    I2Cdev::writeByte(0x68, MPU6050_RA_PWR_MGMT_1, 0x01);
+    i2c_write_byte(0x68, MPU6050_RA_INT_ENABLE, 0x01);
+    motion_mpu6050_hand_configure();
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_1, 0x01);
+    i2c_write_byte(0x68, MPU6050_RA_FIFO_EN, 0x78);      // XG, YG, ZG, ACCEL
+    motion_mpu6050_hand_fifo_reset();
 
     // test motion sensor
     //motion_set_mpu6050_hand_mode(1); // enable motion detection
 }
 
 /**
- * @brief Update motion data from MPU-6050
+ * @brief Check whether a smoothing filter setting is valid
+ * @param[in] setting Shift (0 to KG_MPU6050_FILTER_SHIFT_MAX), or biquad setting
+ * @return True if the setting can be used
+ */
+bool motion_mpu6050_hand_filter_valid(uint8_t setting) {
+    return setting <= KG_MPU6050_FILTER_SHIFT_MAX || (setting >= KG_MPU6050_FILTER_BIQUAD && setting < KG_MPU6050_FILTER_BIQUAD + KG_MPU6050_FILTER_BIQUAD_COUNT);
+}
+
+/**
+ * @brief Clear smoothing filter state for all axes
  *
- * This function is called whenever the motion interrupt occurs and the flag is
- * set by the interrupt handler, and then detected as such from inside the main
- * loop() function. All six axes of raw data are read, then filtered and stored.
+ * Needed whenever a filter setting changes, since the shift and biquad
+ * filters keep different things in the same state.
+ */
+void motion_mpu6050_hand_filter_reset() {
+    memset(mpuHandFilter, 0, sizeof(mpuHandFilter));
+    memset(mpuHandBiquad, 0, sizeof(mpuHandBiquad));
+}
+
+/**
+ * @brief Apply one step of the smoothing filter selected for an axis
+ * @param[in] axis Filter axis (0-2 = accel X/Y/Z, 3-5 = gyro X/Y/Z)
+ * @param[in] raw New raw value
+ * @return Filtered value
  *
- * @see API event: kg_evt_motion_data()
+ * Settings up to KG_MPU6050_FILTER_SHIFT_MAX select shift-based exponential
+ * smoothing, equivalent to filtered += (raw - filtered) / 2^shift, but with
+ * 8 extra fractional bits of state and rounded steps, so that it settles
+ * exactly on a constant input at any shift. Settings from KG_MPU6050_FILTER_BIQUAD select a second-order
+ * Butterworth low-pass, which falls off twice as steeply above its cutoff, so
+ * hand motion passes almost untouched while faster noise and tremor are
+ * removed. It runs in direct form I with 16-bit coefficients and a 32-bit
+ * accumulator. The part of each output rounded away is carried into
+ * the next step (first-order error feedback), so a constant input comes out
+ * exactly, and rounding noise stays within about one count.
+ */
+int16_t motion_mpu6050_hand_filter(uint8_t axis, int16_t raw) {
+    uint8_t setting = opt_motion_hand_filter[axis];
+    if (setting <= KG_MPU6050_FILTER_SHIFT_MAX) {
+        mpuHandFilter[axis] += ((int32_t)raw * 256 - mpuHandFilter[axis] + ((1 << setting) >> 1)) >> setting;
+        return (mpuHandFilter[axis] + 127) >> 8;
+    }
+
+    const int16_t *c = mpu6050BiquadCoefficients[setting - KG_MPU6050_FILTER_BIQUAD];
+    int16_t *h = mpuHandBiquad[axis];
+    int32_t acc = mpuHandFilter[axis], out;
+    acc += (int32_t)(int16_t)pgm_read_word(&c[0]) * ((int32_t)raw + h[1])
+         + (int32_t)(int16_t)pgm_read_word(&c[1]) * h[0]
+         - (int32_t)(int16_t)pgm_read_word(&c[2]) * h[2]
+         - (int32_t)(int16_t)pgm_read_word(&c[3]) * h[3];
+    out = acc >> 14;
+    mpuHandFilter[axis] = acc - out * 16384;
+    if (out > 32767 || out < -32768) {
+        out = out > 0 ? 32767 : -32768;
+        mpuHandFilter[axis] = 0;
+    }
+    h[1] = h[0];
+    h[0] = raw;
+    h[3] = h[2];
+    h[2] = out;
+    return out;
+}
+
+/**
+ * @brief Get number of samples to collect in each motion batch event
+ * @return Batch size, or 1 for separate motion data events
+ *
+ * Limited so that a full batch fits in one KGAPI packet (9 samples with
+ * fusion data, 20 without).
+ */
+uint8_t motion_mpu6050_hand_batch_size() {
+    uint8_t batch = opt_motion_hand_batch, size = 12;
+    #if (KG_FUSION > 0)
+        if (mpuHandFused) size = 26;
+    #endif
+    if (!batch) {
+        batch = KG_MPU6050_HAND_BATCH_USB;
+        #if (KG_HOSTIF & HG_HOSTIF_BT2_SPP) || (KG_HOSTIF & KG_HOSTIF_BT2_HID) || (KG_HOSTIF & KG_HOSTIF_BT2_RAWHID) || (KG_HOSTIF & KG_HOSTIF_BT2_IAP)
+            if (bluetooth_api_ready()) batch = KG_MPU6050_HAND_BATCH_BT2;
+        #endif
+    }
+    return min(batch, (KG_MPU6050_BATCH_SIZE_MAX - KG_MPU6050_BATCH_HEADER_SIZE) / size);
+}
+
+/**
+ * @brief Send collected samples as a motion batch event, if there are any
+ * @see API event: kg_evt_motion_batch()
+ */
+void motion_mpu6050_hand_batch_flush() {
+    if (!mpuHandBatchCount) return;
+    mpuHandBatch[2] = mpuHandBatchCount;
+    skipPacket = 0;
+    if (kg_evt_motion_batch) skipPacket = kg_evt_motion_batch(mpuHandBatch[0], mpuHandBatch[1], mpuHandBatch[2], mpuHandBatch[3] | (mpuHandBatch[4] << 8), mpuHandBatch[5], mpuHandBatch + KG_MPU6050_BATCH_HEADER_SIZE);
+    if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, KG_MPU6050_BATCH_HEADER_SIZE + mpuHandBatch[5], KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_BATCH, mpuHandBatch);
+    mpuHandBatchCount = 0;
+}
+
+/**
+ * @brief Add one sample to the current motion batch, sending it when full
+ * @param[in] payload Motion data event payload (index, flags, data length, data)
+ */
+void motion_mpu6050_hand_batch_add(uint8_t *payload) {
+    uint8_t batch = motion_mpu6050_hand_batch_size();
+    uint16_t time;
+
+    // sample format changed (e.g. fusion just started), so send what we have first
+    if (mpuHandBatchCount && mpuHandBatch[1] != payload[1]) motion_mpu6050_hand_batch_flush();
+
+    if (!mpuHandBatchCount) {
+        // timestamp of first sample in batch, in 10ms ticks
+        time = keygloveTock * 100 + keygloveTick;
+        mpuHandBatch[0] = payload[0];
+        mpuHandBatch[1] = payload[1];
+        mpuHandBatch[3] = time & 0xFF;
+        mpuHandBatch[4] = time >> 8;
+        mpuHandBatch[5] = 0;
+    }
+    memcpy(mpuHandBatch + KG_MPU6050_BATCH_HEADER_SIZE + mpuHandBatch[5], payload + 3, payload[2]);
+    mpuHandBatch[5] += payload[2];
+    if (++mpuHandBatchCount >= batch) motion_mpu6050_hand_batch_flush();
+}
+
+/**
+ * @brief Filter one raw sample and send it as a motion data event
+ *
+ * The kg_evt_motion_data() callback sees every sample either way, but if
+ * batching is active, the sample is added to a motion batch event instead of
+ * being sent by itself.
+ */
+void motion_mpu6050_hand_sample() {
+    // store previous accel/gyro values
+    aa0.x = aa.x;
+    aa0.y = aa.y;
+    aa0.z = aa.z;
+    gv0.x = gv.x;
+    gv0.y = gv.y;
+    gv0.z = gv.z;
+
+    // simple smoothing filter
+    aa.x = motion_mpu6050_hand_filter(0, aaRaw.x);
+    aa.y = motion_mpu6050_hand_filter(1, aaRaw.y);
+    aa.z = motion_mpu6050_hand_filter(2, aaRaw.z);
+    gv.x = motion_mpu6050_hand_filter(3, gvRaw.x);
+    gv.y = motion_mpu6050_hand_filter(4, gvRaw.y);
+    gv.z = motion_mpu6050_hand_filter(5, gvRaw.z);
+
+    // count samples without significant change since the last movement
+    if (abs((int32_t)aaRaw.x - mpuHandStillAccel.x) > KG_MPU6050_HAND_STILL_ACCEL ||
+        abs((int32_t)aaRaw.y - mpuHandStillAccel.y) > KG_MPU6050_HAND_STILL_ACCEL ||
+        abs((int32_t)aaRaw.z - mpuHandStillAccel.z) > KG_MPU6050_HAND_STILL_ACCEL ||
+        abs((int32_t)gvRaw.x - mpuHandStillGyro.x) > KG_MPU6050_HAND_STILL_GYRO ||
+        abs((int32_t)gvRaw.y - mpuHandStillGyro.y) > KG_MPU6050_HAND_STILL_GYRO ||
+        abs((int32_t)gvRaw.z - mpuHandStillGyro.z) > KG_MPU6050_HAND_STILL_GYRO) {
+        mpuHandStillAccel = aaRaw;
+        mpuHandStillGyro = gvRaw;
+        mpuHandStillCount = 0;
+    } else if (mpuHandStillCount < 65535) {
+        mpuHandStillCount++;
+    }
+
+    // flight recorder keeps raw gyro data, so the filter can be replayed offline
+    #if (KG_RECORDER > 0)
+        recorder_motion(KG_MOTION_MPU6050_HAND_INDEX, gvRaw.x, gvRaw.y, gvRaw.z);
+    #endif
+
+    // mouse pipeline runs on every sample, so the pointer is at most one sample behind
+    #if (KG_HID & KG_HID_MOUSE)
+        hid_mouse_sample(opt_motion_hand_rate_div + 1);
+    #endif
+
+    // gesture engine averages its own frames, so it sees every sample too
+    #if (KG_MOTIONGESTURE > 0)
+        motiongesture_process(gv.x, gv.y, gv.z, opt_motion_hand_gyro_range);
+    #endif
+
+    // only send every Nth sample (filters and still detection above still see them all)
+    if (++mpuHandDecimationCount < opt_motion_hand_decimation) return;
+    mpuHandDecimationCount = 0;
+
+    // build and send kg_evt_motion_data packet
+    uint8_t payload[29];
+    payload[0] = KG_MOTION_MPU6050_HAND_INDEX;
+    payload[1] = 0x03;  // 1=accel, 2=gyro, 1|2 = 0x03
+    payload[2] = 0x0C;  // 12 bytes of motion data (6 axes, 2 bytes each)
+    payload[3] = aa.x & 0xFF;
+    payload[4] = aa.x >> 8;
+    payload[5] = aa.y & 0xFF;
+    payload[6] = aa.y >> 8;
+    payload[7] = aa.z & 0xFF;
+    payload[8] = aa.z >> 8;
+    payload[9] = gv.x & 0xFF;
+    payload[10] = gv.x >> 8;
+    payload[11] = gv.y & 0xFF;
+    payload[12] = gv.y >> 8;
+    payload[13] = gv.z & 0xFF;
+    payload[14] = gv.z >> 8;
+    #if (KG_FUSION > 0)
+        if (mpuHandFused) {
+            payload[1] = 0x0F;  // 4=quaternion, 8=world-frame linear accel, 1|2|4|8 = 0x0F
+            payload[2] = 0x1A;  // 26 bytes of motion data (6 axes, 4 quaternion components, 3 world axes, 2 bytes each)
+            payload[15] = mpuHandQuat[0] & 0xFF;
+            payload[16] = mpuHandQuat[0] >> 8;
+            payload[17] = mpuHandQuat[1] & 0xFF;
+            payload[18] = mpuHandQuat[1] >> 8;
+            payload[19] = mpuHandQuat[2] & 0xFF;
+            payload[20] = mpuHandQuat[2] >> 8;
+            payload[21] = mpuHandQuat[3] & 0xFF;
+            payload[22] = mpuHandQuat[3] >> 8;
+            payload[23] = apFrame.x & 0xFF;
+            payload[24] = apFrame.x >> 8;
+            payload[25] = apFrame.y & 0xFF;
+            payload[26] = apFrame.y >> 8;
+            payload[27] = apFrame.z & 0xFF;
+            payload[28] = apFrame.z >> 8;
+        }
+    #endif
+    skipPacket = 0;
+    if (kg_evt_motion_data) skipPacket = kg_evt_motion_data(payload[0], payload[1], payload[2], payload + 3);
+    if (skipPacket) return;
+    if (mpuHandBatchCount || motion_mpu6050_hand_batch_size() > 1) {
+        motion_mpu6050_hand_batch_add(payload);
+    } else {
+        send_keyglove_packet(KG_PACKET_TYPE_EVENT, 3 + payload[2], KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_DATA, payload);
+    }
+}
+
+#if (KG_FUSION > 0)
+
+/**
+ * @brief Get latest orientation as a float quaternion
+ * @param[out] q Quaternion to fill in
+ *
+ * Orientation is kept in mpuHandQuat as 16384 = 1.0 fixed point, which is
+ * what motion data events carry and what the gravity removal uses. Float
+ * math on the AVR is done in software, so this conversion is only done here,
+ * for code that wants a float quaternion, and not on every sample.
+ */
+void motion_mpu6050_hand_get_quaternion(Quaternion *q) {
+    q -> w = mpuHandQuat[0] * (1.0f / 16384.0f);
+    q -> x = mpuHandQuat[1] * (1.0f / 16384.0f);
+    q -> y = mpuHandQuat[2] * (1.0f / 16384.0f);
+    q -> z = mpuHandQuat[3] * (1.0f / 16384.0f);
+}
+
+#endif
+
+#if (KG_FUSION & KG_FUSION_DMP)
+
+/**
+ * @brief Unpack one DMP packet and compute world-frame linear acceleration
+ * @param[in] packet DMP FIFO packet (KG_MPU6050_DMP_PACKET_SIZE bytes)
+ *
+ * The accel vector is rotated by the DMP quaternion (v' = v + 2w(u x v) +
+ * 2u x (u x v), with u = (x, y, z)) entirely in 32-bit integer math, then 1g
+ * is subtracted from the world Z axis. This costs a dozen integer multiplies
+ * instead of the two float quaternion products used by VectorInt16::rotate().
+ */
+void motion_mpu6050_hand_fusion(uint8_t *packet) {
+    int32_t tx, ty, tz;
+    int16_t *q = mpuHandQuat;
+
+    // orientation, gyro, and accel as computed/captured by the DMP
+    mpuHand.dmpGetQuaternion(q, packet);
+    mpuHand.dmpGetGyro(&gvRaw, packet);
+    mpuHand.dmpGetAccel(&aaRaw, packet);
+    mpuHandFused = true;
+
+    // t = (u x v), in accel units
+    tx = ((int32_t)q[2] * aaRaw.z - (int32_t)q[3] * aaRaw.y) >> 14;
+    ty = ((int32_t)q[3] * aaRaw.x - (int32_t)q[1] * aaRaw.z) >> 14;
+    tz = ((int32_t)q[1] * aaRaw.y - (int32_t)q[2] * aaRaw.x) >> 14;
+
+    // v' = v + 2(w * t + u x t), then remove gravity
+    apFrame.x = aaRaw.x + (((int32_t)q[0] * tx + (int32_t)q[2] * tz - (int32_t)q[3] * ty) >> 13);
+    apFrame.y = aaRaw.y + (((int32_t)q[0] * ty + (int32_t)q[3] * tx - (int32_t)q[1] * tz) >> 13);
+    apFrame.z = aaRaw.z + (((int32_t)q[0] * tz + (int32_t)q[1] * ty - (int32_t)q[2] * tx) >> 13) - KG_MPU6050_DMP_ACCEL_1G;
+}
+
+#endif
+
+#if (KG_FUSION & KG_FUSION_MAHONY)
+
+/**
+ * @brief Run the Mahony orientation filter on the latest raw sample
+ *
+ * This is used when the DMP is not enabled or failed to load. The quaternion
+ * and world-frame linear acceleration are scaled to match the DMP output, so
+ * motion data events look the same either way.
+ */
+void motion_mpu6050_hand_mahony() {
+    QuaternionQ15 q;
+    VectorInt16 ap(aaRaw.x >> 1, aaRaw.y >> 1, aaRaw.z >> 1); // 16384 = 1g (raw) to 8192 = 1g (DMP)
+
+    mpuHandMahony.update(&aaRaw, &gvRaw);
+    q = mpuHandMahony.getQuaternion();
+    mpuHandQuat[0] = q.w >> 1;
+    mpuHandQuat[1] = q.x >> 1;
+    mpuHandQuat[2] = q.y >> 1;
+    mpuHandQuat[3] = q.z >> 1;
+
+    // rotate into world frame, then remove gravity
+    fixed_rotate_q15(&ap, &q);
+    apFrame.x = ap.x;
+    apFrame.y = ap.y;
+    apFrame.z = ap.z - KG_MPU6050_DMP_ACCEL_1G;
+    mpuHandFused = true;
+}
+
+#endif
+
+/**
+ * @brief Send motion state event for the hand sensor
+ * @param[in] state New motion state
+ * @see API event: kg_evt_motion_state()
+ */
+void motion_mpu6050_hand_state_event(uint8_t state) {
+    uint8_t payload[2] = { KG_MOTION_MPU6050_HAND_INDEX, state };
+    skipPacket = 0;
+    if (kg_evt_motion_state) skipPacket = kg_evt_motion_state(payload[0], state);
+    if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 2, KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_STATE, payload);
+}
+
+/**
+ * @brief Enter low-power accel-only cycle mode with wake-on-motion
+ *
+ * The gyros are put in standby, the accelerometer wakes up only at
+ * KG_MPU6050_HAND_WAKE_RATE, and the only enabled interrupt is motion
+ * detection, which compares high-pass filtered accel samples against
+ * KG_MPU6050_HAND_WAKE_THRESHOLD. The FIFO (and DMP) are stopped so that no
+ * partial samples are left behind for update_motion_mpu6050_hand().
+ */
+void motion_mpu6050_hand_sleep() {
+    motion_mpu6050_hand_batch_flush();
+    motion_mpu6050_hand_bias_save();
+    #if (KG_MOTIONGESTURE > 0)
+        motiongesture_reset();
+    #endif
+
+    // remember interrupt, FIFO, and accel setup for wake-up (differs between raw and DMP modes)
+    i2c_read_bytes(0x68, MPU6050_RA_INT_ENABLE, 1, mpuHandWakeConfig);
+    i2c_read_bytes(0x68, MPU6050_RA_FIFO_EN, 1, mpuHandWakeConfig + 1);
+    i2c_read_bytes(0x68, MPU6050_RA_ACCEL_CONFIG, 1, mpuHandWakeConfig + 2);
+
+    i2c_write_byte(0x68, MPU6050_RA_FIFO_EN, 0x00);
+    i2c_write_byte(0x68, MPU6050_RA_USER_CTRL, 0x00);            // FIFO (and DMP) off
+    i2c_write_byte(0x68, MPU6050_RA_MOT_THR, KG_MPU6050_HAND_WAKE_THRESHOLD);
+    i2c_write_byte(0x68, MPU6050_RA_MOT_DUR, 0x01);              // one sample over threshold
+    i2c_write_byte(0x68, MPU6050_RA_ACCEL_CONFIG, (mpuHandWakeConfig[2] & 0xF8) | 0x01);  // 5Hz high-pass
+    i2c_write_byte(0x68, MPU6050_RA_INT_ENABLE, 0x40);           // MOT_EN
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_2, (KG_MPU6050_HAND_WAKE_RATE << 6) | 0x07);   // LP_WAKE_CTRL, gyros in standby
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_1, 0x28);           // CYCLE | TEMP_DIS, internal oscillator
+
+    mpuHandPending = 0;
+    mpuHandInterrupt = false;
+    mpuHandState = KG_MOTION_STATE_STILL;
+}
+
+/**
+ * @brief Leave low-power mode and restore full-rate sampling
+ */
+void motion_mpu6050_hand_wake() {
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_1, 0x01);           // cycle off, PLL with X gyro reference
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_2, 0x00);
+    i2c_write_byte(0x68, MPU6050_RA_ACCEL_CONFIG, mpuHandWakeConfig[2]);
+    i2c_write_byte(0x68, MPU6050_RA_INT_ENABLE, mpuHandWakeConfig[0]);
+    i2c_write_byte(0x68, MPU6050_RA_FIFO_EN, mpuHandWakeConfig[1]);
+    motion_mpu6050_hand_fifo_reset();
+
+    mpuHandStillCount = 0;
+    mpuHandState = KG_MOTION_STATE_MOVING;
+}
+
+/**
+ * @brief Queue the next read of motion data from MPU-6050
+ *
+ * This is the sensor's I2C service routine, run once the interrupt handler has
+ * counted enough data-ready pulses and set the flag. Each call queues a single
+ * I2C transfer: the first reads the FIFO byte count, and each following one
+ * reads a burst of up to KG_MPU6050_HAND_FIFO_BURST samples into
+ * mpuHandBuffer. The data is processed in motion_mpu6050_hand_complete() once
+ * it has arrived, and other devices on the bus get their turn between bursts.
+ *
+ * In low-power mode, the only interrupt source is motion detection, so this
+ * wakes the sensor instead.
+ *
+ * @see update_i2c()
+ * @see API event: kg_evt_motion_state()
  */
 void update_motion_mpu6050_hand() {
-    uint8_t mpuInt = mpuHand.getIntStatus();
-    if (mpuInt & 0x01) {
-        // read raw motion data
-        mpuHand.getMotion6(&aaRaw.x, &aaRaw.y, &aaRaw.z, &gvRaw.x, &gvRaw.y, &gvRaw.z);
-
-        // store previous accel/gyro values
-        aa0.x = aa.x;
-        aa0.y = aa.y;
-        aa0.z = aa.z;
-        gv0.x = gv.x;
-        gv0.y = gv.y;
-        gv0.z = gv.z;
-
-        // simple smoothing filter
-        aa.x = aa0.x + (0.25 * (aaRaw.x - aa0.x));
-        aa.y = aa0.y + (0.25 * (aaRaw.y - aa0.y));
-        aa.z = aa0.z + (0.25 * (aaRaw.z - aa0.z));
-        gv.x = gv0.x + (0.25 * (gvRaw.x - gv0.x));
-        gv.y = gv0.y + (0.25 * (gvRaw.y - gv0.y));
-        gv.z = gv0.z + (0.25 * (gvRaw.z - gv0.z));
-
-        // build and send kg_evt_motion_data packet
-        uint8_t payload[15];
-        payload[0] = 0x00;  // sensor 0
-        payload[1] = 0x03;  // 1=accel, 2=gyro, 1|2 = 0x03
-        payload[2] = 0x0C;  // 12 bytes of motion data (6 axes, 2 bytes each)
-        payload[3] = aa.x & 0xFF;
-        payload[4] = aa.x >> 8;
-        payload[5] = aa.y & 0xFF;
-        payload[6] = aa.y >> 8;
-        payload[7] = aa.z & 0xFF;
-        payload[8] = aa.z >> 8;
-        payload[9] = gv.x & 0xFF;
-        payload[10] = gv.x >> 8;
-        payload[11] = gv.y & 0xFF;
-        payload[12] = gv.y >> 8;
-        payload[13] = gv.z & 0xFF;
-        payload[14] = gv.z >> 8;
-        skipPacket = 0;
-        if (kg_evt_motion_data) skipPacket = kg_evt_motion_data(payload[0], payload[1], payload[2], payload + 3);
-        if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, sizeof(payload), KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_DATA, payload);
-    }
-    if (mpuInt & 0x20) {
-        send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 10, F("MOTION INT"));
-    } else if (mpuInt & 0x40) {
-        send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 10, F("ZEROMO INT"));
+    #if (KG_FUSION & KG_FUSION_DMP)
+        uint8_t size = mpuHandDMPReady ? KG_MPU6050_DMP_PACKET_SIZE : KG_MPU6050_FIFO_SAMPLE_SIZE;
+    #else
+        uint8_t size = KG_MPU6050_FIFO_SAMPLE_SIZE;
+    #endif
+
+    // motion interrupt while still
+    if (mpuHandState == KG_MOTION_STATE_STILL) {
+        motion_mpu6050_hand_wake();
+        motion_mpu6050_hand_state_event(KG_MOTION_STATE_MOVING);
+        return;
+    }
+
+    if (!mpuHandFifoCount) {
+        // find out how many bytes are waiting
+        mpuHandPending = 0;
+        mpuHandBurst = 0;
+        mpuHandDiscard = false;
+        i2c_read(motionI2CClient[KG_MOTION_MPU6050_HAND_INDEX], 0x68, MPU6050_RA_FIFO_COUNTH, 2, mpuHandBuffer);
+        return;
+    }
+
+    // read as many whole samples as fit in one burst
+    mpuHandBurst = min(mpuHandFifoCount, KG_MPU6050_HAND_FIFO_BURST);
+    mpuHandDiscard = false;
+    i2c_read(motionI2CClient[KG_MOTION_MPU6050_HAND_INDEX], 0x68, MPU6050_RA_FIFO_R_W, mpuHandBurst * size, mpuHandBuffer);
+}
+
+/**
+ * @brief Process motion data read from MPU-6050
+ * @param[in] status Final I2C transfer status
+ * @return Nonzero if more samples are waiting in the FIFO
+ *
+ * This is the sensor's I2C completion routine. After a FIFO byte count, it
+ * only works out how many samples to read. After a burst, the samples are
+ * filtered and stored in order, and once the FIFO is empty and enough still
+ * samples have been processed, this puts the sensor into low-power mode.
+ *
+ * @see update_i2c()
+ * @see API event: kg_evt_motion_data()
+ * @see API event: kg_evt_motion_state()
+ */
+uint8_t motion_mpu6050_hand_complete(uint8_t status) {
+    #if (KG_FUSION & KG_FUSION_DMP)
+        uint8_t size = mpuHandDMPReady ? KG_MPU6050_DMP_PACKET_SIZE : KG_MPU6050_FIFO_SAMPLE_SIZE;
+    #else
+        uint8_t size = KG_MPU6050_FIFO_SAMPLE_SIZE;
+    #endif
+    uint16_t count;
+    uint8_t i;
+
+    // data from before a FIFO reset is stale, and the count would be wrong
+    if (mpuHandDiscard) return 0;
+
+    if (status != KG_I2C_STATUS_DONE) {
+        // samples may have been lost or split, so start over
+        motion_mpu6050_hand_fifo_reset();
+        send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 11, F("MOTION I2C!"));
+        #if (KG_RECORDER > 0)
+            recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_MOTION_ERROR);
+        #endif
+        return 0;
+    }
+
+    if (!mpuHandBurst) {
+        count = ((uint16_t)mpuHandBuffer[0] << 8) | mpuHandBuffer[1];
+
+        if (count > KG_MPU6050_FIFO_SIZE - size) {
+            // FIFO overflowed and sample boundaries are lost, so start over
+            motion_mpu6050_hand_fifo_reset();
+            send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 11, F("MOTION OFLO"));
+            #if (KG_RECORDER > 0)
+                recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_MOTION_ERROR);
+            #endif
+            return 0;
+        }
+
+        // read the samples on the following turns
+        mpuHandFifoCount = count / size;
+        return mpuHandFifoCount > 0;
+    }
+
+    mpuHandFifoCount -= mpuHandBurst;
+
+    // process batch
+    for (i = 0; i < mpuHandBurst * size; i += size) {
+        #if (KG_FUSION & KG_FUSION_DMP)
+            if (mpuHandDMPReady) {
+                motion_mpu6050_hand_fusion(mpuHandBuffer + i);
+                motion_mpu6050_hand_bias();
+                motion_mpu6050_hand_sample();
+                continue;
+            }
+        #endif
+
+        // big-endian accel X/Y/Z then gyro X/Y/Z
+        aaRaw.x = ((int16_t)mpuHandBuffer[i + 0] << 8) | mpuHandBuffer[i + 1];
+        aaRaw.y = ((int16_t)mpuHandBuffer[i + 2] << 8) | mpuHandBuffer[i + 3];
+        aaRaw.z = ((int16_t)mpuHandBuffer[i + 4] << 8) | mpuHandBuffer[i + 5];
+        gvRaw.x = ((int16_t)mpuHandBuffer[i + 6] << 8) | mpuHandBuffer[i + 7];
+        gvRaw.y = ((int16_t)mpuHandBuffer[i + 8] << 8) | mpuHandBuffer[i + 9];
+        gvRaw.z = ((int16_t)mpuHandBuffer[i + 10] << 8) | mpuHandBuffer[i + 11];
+        motion_mpu6050_hand_bias();
+        #if (KG_FUSION & KG_FUSION_MAHONY)
+            motion_mpu6050_hand_mahony();
+        #endif
+        motion_mpu6050_hand_sample();
+    }
+    if (mpuHandFifoCount) return 1;
+
+    // stop streaming if the hand has been still long enough
+    if (KG_MPU6050_HAND_STILL_TIME && mpuHandStillCount >= mpuHandStillLimit) {
+        motion_mpu6050_hand_sleep();
+        motion_mpu6050_hand_state_event(KG_MOTION_STATE_STILL);
     }
+    return 0;
 }
@@ -35,19 +35,141 @@ THE SOFTWARE.
 #ifndef _SUPPORT_MOTION_MPU6050_HAND_H_
 #define _SUPPORT_MOTION_MPU6050_HAND_H_
 
-#include <I2Cdev.h>
-#include <MPU6050.h>
+#include "support_helper_3dmath.h"      // before MPU6050.h, whose DMP members use the 3D math classes
+#include "support_motion_mpu6050.h"
+#if (KG_FUSION & KG_FUSION_DMP)
+    // DMP member functions change the MPU6050 class layout, so every file must see them
+    #define MPU6050_INCLUDE_DMP_MOTIONAPPS20
+    #include <I2Cdev.h>
+    #include <MPU6050.h>
+#endif
 
-#include "support_helper_3dmath.h"
+#ifndef KG_MPU6050_HAND_FIFO_WATERMARK
+    #define KG_MPU6050_HAND_FIFO_WATERMARK  4       ///< Samples to collect in FIFO before reading them in one burst
+#endif
+#ifndef KG_MPU6050_HAND_FIFO_BURST
+    #if (KG_FUSION & KG_FUSION_DMP)
+        #define KG_MPU6050_HAND_FIFO_BURST  4       ///< Maximum samples read from FIFO in a single I2C transaction
+    #else
+        #define KG_MPU6050_HAND_FIFO_BURST  8       ///< Maximum samples read from FIFO in a single I2C transaction
+    #endif
+#endif
+
+#ifndef KG_MPU6050_HAND_STILL_TIME
+    #define KG_MPU6050_HAND_STILL_TIME      5000    ///< Milliseconds without motion before entering low-power mode (0 = never)
+#endif
+#ifndef KG_MPU6050_HAND_STILL_ACCEL
+    #define KG_MPU6050_HAND_STILL_ACCEL     400     ///< Largest raw accel change that still counts as no motion (~25mg at 16384/g)
+#endif
+#ifndef KG_MPU6050_HAND_STILL_GYRO
+    #define KG_MPU6050_HAND_STILL_GYRO      82      ///< Largest raw gyro change that still counts as no motion (~5 deg/sec at 16.4/deg/sec)
+#endif
+#ifndef KG_MPU6050_HAND_WAKE_THRESHOLD
+    #define KG_MPU6050_HAND_WAKE_THRESHOLD  20      ///< Motion interrupt threshold in low-power mode (2mg per count)
+#endif
+#ifndef KG_MPU6050_HAND_WAKE_RATE
+    #define KG_MPU6050_HAND_WAKE_RATE       1       ///< Accel sample rate in low-power mode (0=1.25Hz, 1=5Hz, 2=20Hz, 3=40Hz)
+#endif
+
+#ifndef KG_MPU6050_HAND_BIAS_WINDOW
+    #define KG_MPU6050_HAND_BIAS_WINDOW     6       ///< Gyro bias estimation window as a power of two (6 = 64 samples, also the maximum)
+#endif
+#ifndef KG_MPU6050_HAND_BIAS_ACCEL_RMS
+    #define KG_MPU6050_HAND_BIAS_ACCEL_RMS  96      ///< Largest accel noise (RMS) in a still window (~6mg at 16384/g, scaled with range)
+#endif
+#ifndef KG_MPU6050_HAND_BIAS_GYRO_RMS
+    #define KG_MPU6050_HAND_BIAS_GYRO_RMS   4       ///< Largest gyro noise (RMS) in a still window (~0.25 deg/sec at 16.4/deg/sec, scaled with range)
+#endif
+#ifndef KG_MPU6050_HAND_BIAS_SHIFT
+    #define KG_MPU6050_HAND_BIAS_SHIFT      2       ///< Smoothing shift for each new still-window gyro mean (2 = 1/4)
+#endif
+#ifndef KG_MPU6050_HAND_BIAS_SAVE_DELTA
+    #define KG_MPU6050_HAND_BIAS_SAVE_DELTA 64      ///< Smallest bias change worth an EEPROM write (1/256 counts at 2000 deg/sec, 64 = 1/4 count)
+#endif
+
+#ifndef KG_MPU6050_HAND_BATCH_USB
+    #define KG_MPU6050_HAND_BATCH_USB       1       ///< Automatic samples per motion batch over USB (1 = separate motion data events)
+#endif
+#ifndef KG_MPU6050_HAND_BATCH_BT2
+    #define KG_MPU6050_HAND_BATCH_BT2       5       ///< Automatic samples per motion batch while a Bluetooth API link is up
+#endif
+
+#ifndef KG_MPU6050_HAND_MAHONY_KP
+    #define KG_MPU6050_HAND_MAHONY_KP       0.5     ///< Mahony filter proportional gain (rad/sec per unit of gravity error)
+#endif
+#ifndef KG_MPU6050_HAND_MAHONY_KI
+    #define KG_MPU6050_HAND_MAHONY_KI       0.0     ///< Mahony filter integral gain (rad/sec^2 per unit of gravity error)
+#endif
+
+#define KG_MPU6050_FIFO_SIZE                1024    ///< MPU-6050 FIFO buffer size in bytes
+#define KG_MPU6050_FIFO_SAMPLE_SIZE         12      ///< Bytes per raw FIFO sample (accel X/Y/Z, gyro X/Y/Z)
+#define KG_MPU6050_DMP_PACKET_SIZE          42      ///< Bytes per DMP FIFO packet (quaternion, gyro, accel)
+#define KG_MPU6050_DMP_ACCEL_1G             8192    ///< DMP accelerometer output for 1g
+#define KG_MPU6050_FILTER_SHIFT_MAX         8       ///< Largest smoothing shift (1/256 of each new sample)
+#define KG_MPU6050_FILTER_BIQUAD            16      ///< First filter setting for a Butterworth biquad low-pass (cutoff at 5% of sample rate)
+#define KG_MPU6050_FILTER_BIQUAD_COUNT      5       ///< Biquad cutoff settings (5%, 10%, 15%, 20%, 25% of sample rate)
+#define KG_MPU6050_RATE_MIN                 4       ///< Lowest sample rate in Hz (1kHz / 256, rounded up)
+#define KG_MPU6050_RATE_MAX                 1000    ///< Highest sample rate in Hz (DLPF enabled)
+#define KG_MPU6050_BATCH_HEADER_SIZE        6       ///< Motion batch event bytes before sample data (index, flags, count, time, data length)
+#define KG_MPU6050_BATCH_SIZE_MAX           250     ///< Largest motion batch event payload
+#define KG_MPU6050_BIAS_DEVIATION_MAX       1023    ///< Largest deviation from the first sample of a bias window that can still be still
+#define KG_MPU6050_BIAS_EEPROM_MAGIC        0x424B  ///< Stored gyro bias magic number ("KB")
+
+/**
+ * @brief Stored EEPROM gyro bias record (14 bytes) at KG_EEPROM_MOTION_BIAS_ADDRESS
+ */
+typedef struct {
+    uint16_t magic;                         ///< KG_MPU6050_BIAS_EEPROM_MAGIC if stored bias is valid
+    int32_t bias[3];                        ///< Gyro X/Y/Z bias (1/256 counts at 2000 deg/sec)
+} mpu6050_bias_record_t;
 
 extern bool mpuHandInterrupt;
+extern volatile uint8_t mpuHandPending;
+extern uint8_t mpuHandState;
+extern bool mpuHandBiasStill;
+extern int32_t mpuHandBias[3];
 
 extern VectorInt16 aa;
 extern VectorInt16 gv;
 
+extern uint8_t opt_motion_hand_filter[6];
+extern uint8_t opt_motion_hand_rate_div;
+extern uint8_t opt_motion_hand_dlpf;
+extern uint8_t opt_motion_hand_gyro_range;
+extern uint8_t opt_motion_hand_accel_range;
+extern uint8_t opt_motion_hand_decimation;
+extern uint8_t opt_motion_hand_batch;
+
+#if (KG_FUSION > 0)
+    extern bool mpuHandFused;
+    extern int16_t mpuHandQuat[4];
+    extern VectorInt16 apFrame;
+#endif
+#if (KG_FUSION & KG_FUSION_DMP)
+    extern bool mpuHandDMPReady;
+#endif
+#if (KG_FUSION & KG_FUSION_MAHONY)
+    extern MahonyFilter mpuHandMahony;
+#endif
+
 void motion_mpu6050_hand_interrupt();
 void motion_set_mpu6050_hand_mode(uint8_t mode);
+void motion_mpu6050_hand_configure();
 void setup_motion_mpu6050_hand();
 void update_motion_mpu6050_hand();
+void update_motion_mpu6050_hand_bias();
+uint8_t motion_mpu6050_hand_complete(uint8_t status);
+void motion_mpu6050_hand_sleep();
+void motion_mpu6050_hand_wake();
+uint8_t motion_mpu6050_hand_batch_size();
+void motion_mpu6050_hand_batch_flush();
+int16_t motion_mpu6050_hand_bias_counts(uint8_t axis);
+void motion_mpu6050_hand_bias_reset();
+bool motion_mpu6050_hand_filter_valid(uint8_t setting);
+void motion_mpu6050_hand_filter_reset();
+int16_t motion_mpu6050_hand_filter(uint8_t axis, int16_t raw);
+#if (KG_FUSION > 0)
+    void motion_mpu6050_hand_get_quaternion(Quaternion *q);
+#endif
 
 #endif // _SUPPORT_MOTION_MPU6050_HAND_H_
@@ -0,0 +1,241 @@
+// Keyglove controller source code - Motion support implementations for index fingertip MPU-6050 sensor
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_motion_mpu6050_indextip.cpp
+ * @brief Motion support implementations for index fingertip MPU-6050 sensor
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * This file provides a communications layer and capture interface for a second
+ * InvenSense MPU-6050 motion sensor on the tip of the index finger, with its
+ * AD0 pin pulled high so it answers at 0x69 next to the hand sensor at 0x68.
+ * Only raw accel/gyro data is used from this chip; there is no fusion, bias
+ * estimation, or low-power mode as with the hand sensor.
+ *
+ * Samples are collected in the FIFO and read out in bursts by the
+ * interrupt-driven I2C queue, interleaved with the hand sensor and battery
+ * gauge, the same way as in support_motion_mpu6050_hand.cpp.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+#include "support_motion_mpu6050_indextip.h"
+#include "support_recorder.h"
+
+// only built when enabled, since most boards have no interrupt pin assigned for this sensor
+#if (KG_MOTION & KG_MOTION_MPU6050_INDEXTIP)
+
+#ifndef KG_INTERRUPT_NUM_MPU6050_INDEXTIP
+    #error Selected board does not define KG_INTERRUPT_PIN_MPU6050_INDEXTIP/KG_INTERRUPT_NUM_MPU6050_INDEXTIP
+#endif
+
+bool mpuIndexTipInterrupt;                  ///< Interrupt flag for motion data availability
+volatile uint8_t mpuIndexTipPending;        ///< Data-ready interrupts since FIFO was last read
+uint16_t mpuIndexTipFifoCount;              ///< Whole samples known to be waiting in FIFO
+uint8_t mpuIndexTipBurst;                   ///< Samples being read in current burst (0 = reading FIFO byte count)
+bool mpuIndexTipDiscard;                    ///< FIFO was reset or sensor disabled while a read was outstanding
+uint8_t mpuIndexTipBuffer[KG_MPU6050_INDEXTIP_FIFO_BURST * KG_MPU6050_FIFO_SAMPLE_SIZE];  ///< I2C read buffer (filled in the background)
+
+VectorInt16 aaIndexTip;                     ///< Raw linear acceleration
+VectorInt16 gvIndexTip;                     ///< Raw rotational velocity
+
+uint8_t opt_motion_indextip_rate_div = 9;   ///< OPTION: Sample rate divider (1kHz / (1 + div), 9 = 100Hz)
+
+/**
+ * @brief Interrupt handler for INT pin from MPU-6050
+ * @see mpuIndexTipInterrupt
+ */
+void motion_mpu6050_indextip_interrupt() {
+    if (mpuIndexTipPending < 255) mpuIndexTipPending++;
+    if (mpuIndexTipPending >= KG_MPU6050_INDEXTIP_FIFO_WATERMARK) mpuIndexTipInterrupt = true;
+}
+
+/**
+ * @brief Discard FIFO contents and restart sample collection
+ */
+void motion_mpu6050_indextip_fifo_reset() {
+    i2c_write_byte(0x69, MPU6050_RA_USER_CTRL, 0x44); // FIFO_EN | FIFO_RESET
+    mpuIndexTipPending = 0;
+    mpuIndexTipFifoCount = 0;
+    mpuIndexTipDiscard = true;
+}
+
+/**
+ * @brief Sets the MPU-6050 sensor mode
+ * @param[in] mode Sensor mode (0=disabled, 1=enabled)
+ */
+void motion_set_mpu6050_indextip_mode(uint8_t mode) {
+    if (mode) {
+        motion_mpu6050_indextip_fifo_reset();
+        mpuIndexTipInterrupt = false;
+        attachInterrupt(KG_INTERRUPT_NUM_MPU6050_INDEXTIP, motion_mpu6050_indextip_interrupt, FALLING);
+    } else {
+        mpuIndexTipDiscard = true;
+        detachInterrupt(KG_INTERRUPT_NUM_MPU6050_INDEXTIP);
+    }
+}
+
+/**
+ * @brief Initialize MPU-6050 communications and interrupt handler
+ *
+ * This sets the same 42Hz DLPF and 2000 deg/sec gyro range as the default hand
+ * sensor setup, at opt_motion_indextip_rate_div, with an active-low pulse
+ * interrupt on DRDY and accel and gyro samples routed into the FIFO.
+ */
+void setup_motion_mpu6050_indextip() {
+    uint8_t config[4] = { opt_motion_indextip_rate_div, 0x03, 0x18, 0x00 };   // SMPLRT_DIV, 42Hz DLPF, 2000 deg/sec, 2g
+
+    // set interrupt pin to INPUT/HIGH so MPU can drive interrupt pin as active-low
+    pinMode(KG_INTERRUPT_PIN_MPU6050_INDEXTIP, INPUT);
+    digitalWrite(KG_INTERRUPT_PIN_MPU6050_INDEXTIP, HIGH);
+
+    mpuIndexTipInterrupt = false;
+    i2c_write_byte(0x69, MPU6050_RA_INT_PIN_CFG, 0xD0);
+    i2c_write_byte(0x69, MPU6050_RA_INT_ENABLE, 0x01);
+    i2c_write_bytes(0x69, MPU6050_RA_SMPLRT_DIV, 4, config);
+    i2c_write_byte(0x69, MPU6050_RA_PWR_MGMT_1, 0x01);
+    i2c_write_byte(0x69, MPU6050_RA_FIFO_EN, 0x78);      // XG, YG, ZG, ACCEL
+    motion_mpu6050_indextip_fifo_reset();
+}
+
+/**
+ * @brief Queue the next read of motion data from MPU-6050
+ *
+ * Like update_motion_mpu6050_hand(), this is an I2C service routine that
+ * queues one transfer per call: a FIFO byte count, then one burst of samples
+ * at a time.
+ *
+ * @see update_i2c()
+ */
+void update_motion_mpu6050_indextip() {
+    if (!mpuIndexTipFifoCount) {
+        // find out how many bytes are waiting
+        mpuIndexTipPending = 0;
+        mpuIndexTipBurst = 0;
+        mpuIndexTipDiscard = false;
+        i2c_read(motionI2CClient[KG_MOTION_MPU6050_INDEXTIP_INDEX], 0x69, MPU6050_RA_FIFO_COUNTH, 2, mpuIndexTipBuffer);
+        return;
+    }
+
+    // read as many whole samples as fit in one burst
+    mpuIndexTipBurst = min(mpuIndexTipFifoCount, KG_MPU6050_INDEXTIP_FIFO_BURST);
+    mpuIndexTipDiscard = false;
+    i2c_read(motionI2CClient[KG_MOTION_MPU6050_INDEXTIP_INDEX], 0x69, MPU6050_RA_FIFO_R_W, mpuIndexTipBurst * KG_MPU6050_FIFO_SAMPLE_SIZE, mpuIndexTipBuffer);
+}
+
+/**
+ * @brief Process motion data read from MPU-6050
+ * @param[in] status Final I2C transfer status
+ * @return Nonzero if more samples are waiting in the FIFO
+ *
+ * Each sample from a burst is sent as a motion data event.
+ *
+ * @see update_i2c()
+ * @see API event: kg_evt_motion_data()
+ */
+uint8_t motion_mpu6050_indextip_complete(uint8_t status) {
+    uint8_t payload[15];
+    uint16_t count;
+    uint8_t i;
+
+    // data from before a FIFO reset is stale, and the count would be wrong
+    if (mpuIndexTipDiscard) return 0;
+
+    if (status != KG_I2C_STATUS_DONE) {
+        // samples may have been lost or split, so start over
+        motion_mpu6050_indextip_fifo_reset();
+        send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 11, F("MOTION I2C!"));
+        #if (KG_RECORDER > 0)
+            recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_MOTION_ERROR);
+        #endif
+        return 0;
+    }
+
+    if (!mpuIndexTipBurst) {
+        count = ((uint16_t)mpuIndexTipBuffer[0] << 8) | mpuIndexTipBuffer[1];
+
+        if (count > KG_MPU6050_FIFO_SIZE - KG_MPU6050_FIFO_SAMPLE_SIZE) {
+            // FIFO overflowed and sample boundaries are lost, so start over
+            motion_mpu6050_indextip_fifo_reset();
+            send_keyglove_log(KG_LOG_LEVEL_VERBOSE, 11, F("MOTION OFLO"));
+            #if (KG_RECORDER > 0)
+                recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_MOTION_ERROR);
+            #endif
+            return 0;
+        }
+
+        // read the samples on the following turns
+        mpuIndexTipFifoCount = count / KG_MPU6050_FIFO_SAMPLE_SIZE;
+        return mpuIndexTipFifoCount > 0;
+    }
+
+    mpuIndexTipFifoCount -= mpuIndexTipBurst;
+
+    // process batch
+    for (i = 0; i < mpuIndexTipBurst * KG_MPU6050_FIFO_SAMPLE_SIZE; i += KG_MPU6050_FIFO_SAMPLE_SIZE) {
+        // big-endian accel X/Y/Z then gyro X/Y/Z
+        aaIndexTip.x = ((int16_t)mpuIndexTipBuffer[i + 0] << 8) | mpuIndexTipBuffer[i + 1];
+        aaIndexTip.y = ((int16_t)mpuIndexTipBuffer[i + 2] << 8) | mpuIndexTipBuffer[i + 3];
+        aaIndexTip.z = ((int16_t)mpuIndexTipBuffer[i + 4] << 8) | mpuIndexTipBuffer[i + 5];
+        gvIndexTip.x = ((int16_t)mpuIndexTipBuffer[i + 6] << 8) | mpuIndexTipBuffer[i + 7];
+        gvIndexTip.y = ((int16_t)mpuIndexTipBuffer[i + 8] << 8) | mpuIndexTipBuffer[i + 9];
+        gvIndexTip.z = ((int16_t)mpuIndexTipBuffer[i + 10] << 8) | mpuIndexTipBuffer[i + 11];
+
+        #if (KG_RECORDER > 0)
+            recorder_motion(KG_MOTION_MPU6050_INDEXTIP_INDEX, gvIndexTip.x, gvIndexTip.y, gvIndexTip.z);
+        #endif
+
+        // build and send kg_evt_motion_data packet
+        payload[0] = KG_MOTION_MPU6050_INDEXTIP_INDEX;
+        payload[1] = 0x03;  // 1=accel, 2=gyro, 1|2 = 0x03
+        payload[2] = 0x0C;  // 12 bytes of motion data (6 axes, 2 bytes each)
+        payload[3] = aaIndexTip.x & 0xFF;
+        payload[4] = aaIndexTip.x >> 8;
+        payload[5] = aaIndexTip.y & 0xFF;
+        payload[6] = aaIndexTip.y >> 8;
+        payload[7] = aaIndexTip.z & 0xFF;
+        payload[8] = aaIndexTip.z >> 8;
+        payload[9] = gvIndexTip.x & 0xFF;
+        payload[10] = gvIndexTip.x >> 8;
+        payload[11] = gvIndexTip.y & 0xFF;
+        payload[12] = gvIndexTip.y >> 8;
+        payload[13] = gvIndexTip.z & 0xFF;
+        payload[14] = gvIndexTip.z >> 8;
+        skipPacket = 0;
+        if (kg_evt_motion_data) skipPacket = kg_evt_motion_data(payload[0], payload[1], payload[2], payload + 3);
+        if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 15, KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_DATA, payload);
+    }
+    return mpuIndexTipFifoCount > 0;
+}
+
+#endif // KG_MOTION & KG_MOTION_MPU6050_INDEXTIP
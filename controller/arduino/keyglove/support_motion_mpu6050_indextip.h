@@ -0,0 +1,71 @@
+// Keyglove controller source code - Motion support declarations for index fingertip MPU-6050 sensor
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_motion_mpu6050_indextip.h
+ * @brief Motion support declarations for index fingertip MPU-6050 sensor
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ */
+
+#ifndef _SUPPORT_MOTION_MPU6050_INDEXTIP_H_
+#define _SUPPORT_MOTION_MPU6050_INDEXTIP_H_
+
+#include "support_helper_3dmath.h"      // before MPU6050.h, whose DMP members use the 3D math classes
+#include "support_motion_mpu6050.h"
+#if (KG_FUSION & KG_FUSION_DMP)
+    // must match the hand sensor's view of the MPU6050 class layout
+    #define MPU6050_INCLUDE_DMP_MOTIONAPPS20
+    #include <I2Cdev.h>
+    #include <MPU6050.h>
+#endif
+
+#ifndef KG_MPU6050_INDEXTIP_FIFO_WATERMARK
+    #define KG_MPU6050_INDEXTIP_FIFO_WATERMARK  4   ///< Samples to collect in FIFO before reading them in one burst
+#endif
+#ifndef KG_MPU6050_INDEXTIP_FIFO_BURST
+    #define KG_MPU6050_INDEXTIP_FIFO_BURST      8   ///< Maximum samples read from FIFO in a single I2C transaction
+#endif
+
+#define KG_MPU6050_FIFO_SIZE                    1024    ///< MPU-6050 FIFO buffer size in bytes
+#define KG_MPU6050_FIFO_SAMPLE_SIZE             12      ///< Bytes per raw FIFO sample (accel X/Y/Z, gyro X/Y/Z)
+
+extern bool mpuIndexTipInterrupt;
+extern volatile uint8_t mpuIndexTipPending;
+
+extern VectorInt16 aaIndexTip;
+extern VectorInt16 gvIndexTip;
+
+extern uint8_t opt_motion_indextip_rate_div;
+
+void motion_mpu6050_indextip_interrupt();
+void motion_set_mpu6050_indextip_mode(uint8_t mode);
+void setup_motion_mpu6050_indextip();
+void update_motion_mpu6050_indextip();
+uint8_t motion_mpu6050_indextip_complete(uint8_t status);
+
+#endif // _SUPPORT_MOTION_MPU6050_INDEXTIP_H_
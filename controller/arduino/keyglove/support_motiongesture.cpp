@@ -0,0 +1,259 @@
+// Keyglove controller source code - Motion gesture (template matching) engine implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_motiongesture.cpp
+ * @brief Motion gesture (template matching) engine implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Each template slot runs the SPRING subsequence DTW algorithm (Sakurai et
+ * al., 2007): one column of cumulative distances and path start frames is
+ * updated in place for every new frame, so memory and time per frame are
+ * linear in the template length, and matches are found without buffering the
+ * input. A candidate match is held until no path still in progress could
+ * replace it with a better one that overlaps it, then reported once.
+ *
+ * Frame building and matching are spread across samples: every sample adds to
+ * the frame being averaged, and sample N after a frame completes advances
+ * template slot N against it. Each sample therefore costs at most one
+ * template column (32 cells of 3-axis L1 distance with template bytes read
+ * straight from EEPROM), which keeps worst-case work per 10ms sample small
+ * and constant however many slots are in use.
+ *
+ * Distances saturate at KG_MOTIONGESTURE_SCORE_NONE, and start frames are
+ * kept as 8-bit frame counters, so a path longer than 127 frames (about 5
+ * seconds at the default rate) may be reported with the wrong length. Such a
+ * path would normally be well over any useful threshold anyway.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include <avr/eeprom.h>
+
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_motion.h"
+#include "support_motiongesture.h"
+
+uint8_t motiongestureLength[KG_MOTIONGESTURE_SLOTS];                                ///< Template length for each slot (0 = empty)
+uint16_t motiongestureThreshold[KG_MOTIONGESTURE_SLOTS];                            ///< Match threshold for each slot
+uint16_t motiongestureCost[KG_MOTIONGESTURE_SLOTS][KG_MOTIONGESTURE_FRAMES_MAX];    ///< Cumulative distance to each template frame
+uint8_t motiongestureStart[KG_MOTIONGESTURE_SLOTS][KG_MOTIONGESTURE_FRAMES_MAX];    ///< Input frame where each path began
+uint16_t motiongestureBest[KG_MOTIONGESTURE_SLOTS];                                 ///< Score of candidate match waiting to be reported
+uint8_t motiongestureBestStart[KG_MOTIONGESTURE_SLOTS];                             ///< First input frame of candidate match
+uint8_t motiongestureBestEnd[KG_MOTIONGESTURE_SLOTS];                               ///< Last input frame of candidate match
+
+int32_t motiongestureSum[3];            ///< Gyro X/Y/Z sums for frame being averaged
+uint8_t motiongestureCount;             ///< Samples added to frame being averaged
+int8_t motiongestureFrame[3];           ///< Most recent complete frame
+uint8_t motiongestureTime;              ///< Number of most recent complete frame (wraps at 256)
+bool motiongestureFrameValid;           ///< Whether motiongestureFrame holds a real frame yet
+
+/**
+ * @brief Get EEPROM address of a stored template
+ * @param[in] slot Template slot
+ * @return EEPROM address
+ */
+motiongesture_template_t *motiongesture_eeprom(uint8_t slot) {
+    return (motiongesture_template_t *)(KG_EEPROM_MOTION_GESTURE_ADDRESS + slot * sizeof(motiongesture_template_t));
+}
+
+/**
+ * @brief Forget all paths and any unreported candidate for one slot
+ * @param[in] slot Template slot
+ */
+void motiongesture_reset_slot(uint8_t slot) {
+    uint8_t i;
+    for (i = 0; i < KG_MOTIONGESTURE_FRAMES_MAX; i++) motiongestureCost[slot][i] = KG_MOTIONGESTURE_SCORE_NONE;
+    motiongestureBest[slot] = KG_MOTIONGESTURE_SCORE_NONE;
+}
+
+/**
+ * @brief Initialize motion gesture engine and load template headers from EEPROM
+ */
+void setup_motiongesture() {
+    uint8_t i;
+    for (i = 0; i < KG_MOTIONGESTURE_SLOTS; i++) {
+        motiongestureLength[i] = eeprom_read_byte(&motiongesture_eeprom(i) -> length);
+        if (motiongestureLength[i] > KG_MOTIONGESTURE_FRAMES_MAX) motiongestureLength[i] = 0;
+        motiongestureThreshold[i] = eeprom_read_word(&motiongesture_eeprom(i) -> threshold);
+    }
+    motiongesture_reset();
+}
+
+/**
+ * @brief Discard partial frame and all paths, e.g. after a gap in the sample stream
+ */
+void motiongesture_reset() {
+    uint8_t i;
+    for (i = 0; i < KG_MOTIONGESTURE_SLOTS; i++) motiongesture_reset_slot(i);
+    memset(motiongestureSum, 0, sizeof(motiongestureSum));
+    motiongestureCount = 0;
+    motiongestureFrameValid = false;
+}
+
+/**
+ * @brief Send motion gesture event
+ * @param[in] slot Template slot which matched
+ */
+void motiongesture_send(uint8_t slot) {
+    // send kg_evt_motion_gesture(uint8_t index, uint8_t gesture, uint16_t score, uint8_t frames)
+    uint8_t frames = motiongestureBestEnd[slot] - motiongestureBestStart[slot] + 1;
+    uint8_t payload[5] = { KG_MOTION_MPU6050_HAND_INDEX, slot, (uint8_t)(motiongestureBest[slot] & 0xFF), (uint8_t)(motiongestureBest[slot] >> 8), frames };
+    skipPacket = 0;
+    if (kg_evt_motion_gesture) skipPacket = kg_evt_motion_gesture(payload[0], slot, motiongestureBest[slot], frames);
+    if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 5, KG_PACKET_CLASS_MOTION, KG_PACKET_ID_EVT_MOTION_GESTURE, payload);
+}
+
+/**
+ * @brief Advance one template slot by the most recent frame
+ * @param[in] slot Template slot
+ */
+void motiongesture_step(uint8_t slot) {
+    uint8_t length = motiongestureLength[slot];
+    if (!length) return;
+
+    uint16_t *cost = motiongestureCost[slot];
+    uint8_t *start = motiongestureStart[slot];
+    const int8_t *y = motiongesture_eeprom(slot) -> frame[0];
+    uint16_t best = motiongestureBest[slot];
+    uint8_t bestEnd = motiongestureBestEnd[slot];
+    uint8_t t = motiongestureTime;
+    uint16_t left = 0, diag = 0, up, d;
+    uint8_t leftStart = t, diagStart = t, upStart, s;
+    bool blocked = false;
+    uint8_t i;
+
+    for (i = 0; i < length; i++) {
+        // L1 distance between input frame and template frame i
+        d = abs(motiongestureFrame[0] - (int8_t)eeprom_read_byte((const uint8_t *)y++));
+        d += abs(motiongestureFrame[1] - (int8_t)eeprom_read_byte((const uint8_t *)y++));
+        d += abs(motiongestureFrame[2] - (int8_t)eeprom_read_byte((const uint8_t *)y++));
+
+        // cheapest of (t, i-1), (t-1, i), (t-1, i-1); template frame 0 may start a new path at any time
+        up = cost[i];
+        upStart = start[i];
+        if (i == 0) {
+            s = t;
+        } else {
+            s = leftStart;
+            if (up < left) { left = up; s = upStart; }
+            if (diag < left) { left = diag; s = diagStart; }
+            d = (left > KG_MOTIONGESTURE_SCORE_NONE - d) ? KG_MOTIONGESTURE_SCORE_NONE : left + d;
+        }
+        diag = up;
+        diagStart = upStart;
+        cost[i] = left = d;
+        start[i] = leftStart = s;
+
+        // a cheaper path which overlaps the candidate might still replace it
+        if (d < best && (int8_t)(s - bestEnd) <= 0) blocked = true;
+    }
+
+    // report candidate once nothing can beat it, then drop paths which overlap it
+    if (best != KG_MOTIONGESTURE_SCORE_NONE && !blocked) {
+        motiongesture_send(slot);
+        for (i = 0; i < length; i++) {
+            if ((int8_t)(start[i] - bestEnd) <= 0) cost[i] = KG_MOTIONGESTURE_SCORE_NONE;
+        }
+        motiongestureBest[slot] = best = KG_MOTIONGESTURE_SCORE_NONE;
+    }
+
+    // new or better candidate ending at this frame
+    d = cost[length - 1];
+    if (d <= motiongestureThreshold[slot] && d < best) {
+        motiongestureBest[slot] = d;
+        motiongestureBestStart[slot] = start[length - 1];
+        motiongestureBestEnd[slot] = t;
+    }
+}
+
+/**
+ * @brief Add one gyro sample to the gesture engine
+ * @param[in] x Filtered gyro X value
+ * @param[in] y Filtered gyro Y value
+ * @param[in] z Filtered gyro Z value
+ * @param[in] range Gyro full-scale range in effect (0-3 = 250 to 2000 deg/sec)
+ *
+ * Called for every motion sample from the hand sensor, before decimation.
+ */
+void motiongesture_process(int16_t x, int16_t y, int16_t z, uint8_t range) {
+    int32_t value;
+    uint8_t i;
+
+    motiongestureSum[0] += x;
+    motiongestureSum[1] += y;
+    motiongestureSum[2] += z;
+    motiongestureCount++;
+
+    // advance one template against the last complete frame
+    if (motiongestureFrameValid && motiongestureCount <= KG_MOTIONGESTURE_SLOTS) motiongesture_step(motiongestureCount - 1);
+
+    if (motiongestureCount < KG_MOTIONGESTURE_DECIMATION) return;
+
+    // finish frame: average, scale to 1024 counts at 250 deg/sec, and clip to 8 bits
+    for (i = 0; i < 3; i++) {
+        value = (motiongestureSum[i] / KG_MOTIONGESTURE_DECIMATION) >> (10 - range);
+        motiongestureFrame[i] = value > 127 ? 127 : (value < -127 ? -127 : value);
+        motiongestureSum[i] = 0;
+    }
+    motiongestureCount = 0;
+    motiongestureTime++;
+    motiongestureFrameValid = true;
+}
+
+/**
+ * @brief Get length and threshold of a stored template
+ * @param[in] slot Template slot
+ * @param[out] threshold Highest score reported as a match
+ * @return Template length in frames (0 = empty slot)
+ */
+uint8_t motiongesture_get_template(uint8_t slot, uint16_t *threshold) {
+    *threshold = motiongestureThreshold[slot];
+    return motiongestureLength[slot];
+}
+
+/**
+ * @brief Store a template in EEPROM, or clear a slot
+ * @param[in] slot Template slot
+ * @param[in] threshold Highest score reported as a match
+ * @param[in] length Template length in frames (0 clears slot)
+ * @param[in] frames Gyro X/Y/Z frames, 3 bytes each
+ */
+void motiongesture_set_template(uint8_t slot, uint16_t threshold, uint8_t length, const int8_t *frames) {
+    motiongesture_template_t *stored = motiongesture_eeprom(slot);
+    motiongestureLength[slot] = 0;
+    motiongesture_reset_slot(slot);
+    if (length) eeprom_update_block(frames, stored -> frame, length * 3);
+    eeprom_update_word(&stored -> threshold, threshold);
+    eeprom_update_byte(&stored -> reserved, 0);
+    eeprom_update_byte(&stored -> length, length);
+    motiongestureThreshold[slot] = threshold;
+    motiongestureLength[slot] = length;
+}
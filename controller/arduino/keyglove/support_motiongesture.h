@@ -0,0 +1,79 @@
+// Keyglove controller source code - Motion gesture (template matching) engine declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file support_motiongesture.h
+ * @brief Motion gesture (template matching) engine declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * The gesture engine compares the hand sensor's gyro stream against a few
+ * short templates uploaded via KGAPI and stored in EEPROM, and reports each
+ * match with the kg_evt_motion_gesture() event. Matching uses streaming
+ * dynamic time warping, so a gesture is found wherever it starts and at any
+ * reasonable speed, without a separate "start gesture" trigger.
+ *
+ * Templates are sequences of gyro frames, each the average of
+ * KG_MOTIONGESTURE_DECIMATION samples, in units of 1024 counts at the 250
+ * deg/sec range (about 7.8 deg/sec), so they do not depend on the configured
+ * gyro range. Scores are the sum of L1 frame distances along the best path.
+ */
+
+#ifndef _SUPPORT_MOTIONGESTURE_H_
+#define _SUPPORT_MOTIONGESTURE_H_
+
+#include "support_board.h"
+
+#ifndef KG_MOTIONGESTURE_DECIMATION
+    #define KG_MOTIONGESTURE_DECIMATION     4       ///< Motion samples averaged into each gesture frame (at least KG_MOTIONGESTURE_SLOTS)
+#endif
+
+#define KG_MOTIONGESTURE_SLOTS          4           ///< Number of stored gesture templates
+#define KG_MOTIONGESTURE_FRAMES_MAX     32          ///< Maximum frames in one gesture template
+#define KG_MOTIONGESTURE_SCORE_NONE     0xFFFF      ///< Cumulative distance which cannot lead to a match
+
+#if KG_MOTIONGESTURE_DECIMATION < KG_MOTIONGESTURE_SLOTS
+    #error KG_MOTIONGESTURE_DECIMATION must be at least KG_MOTIONGESTURE_SLOTS (one template is updated per sample)
+#endif
+
+/**
+ * @brief Stored gesture template (100 bytes, one per slot in EEPROM)
+ */
+typedef struct {
+    uint8_t length;                                         ///< Number of frames (0 or 0xFF = empty slot)
+    uint8_t reserved;                                       ///< Unused, written as 0
+    uint16_t threshold;                                     ///< Highest score reported as a match
+    int8_t frame[KG_MOTIONGESTURE_FRAMES_MAX][3];           ///< Gyro X/Y/Z frames
+} motiongesture_template_t;
+
+void setup_motiongesture();
+void motiongesture_reset();
+void motiongesture_process(int16_t x, int16_t y, int16_t z, uint8_t range);
+uint8_t motiongesture_get_template(uint8_t slot, uint16_t *threshold);
+void motiongesture_set_template(uint8_t slot, uint16_t threshold, uint8_t length, const int8_t *frames);
+
+#endif // _SUPPORT_MOTIONGESTURE_H_
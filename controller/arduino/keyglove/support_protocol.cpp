@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "keyglove.h"
 #include "support_board.h"
 #include "support_protocol.h"
+#include "support_recorder.h"
  
 #if KG_HOSTIF & KG_HOSTIF_USB_RAWHID
     uint8_t rxRawHIDPacket[USB_RAWHID_RX_SIZE];     ///< Outgoing raw HID report buffer
@@ -176,6 +177,12 @@ void protocol_parse(uint8_t inputByte) {
                             break;
                     #endif
     
+                    #if KG_HID > 0
+                        case KG_PACKET_CLASS_HID:
+                            protocol_error = process_protocol_command_hid(rxPacket);
+                            break;
+                    #endif
+    
                     #if (KG_HOSTIF & HG_HOSTIF_BT2_SPP) || (KG_HOSTIF & KG_HOSTIF_BT2_RAWHID) || (KG_HOSTIF & KG_HOSTIF_BT2_IAP)
                         case KG_PACKET_CLASS_BLUETOOTH:
                             protocol_error = process_protocol_command_bluetooth(rxPacket);
@@ -325,6 +332,13 @@ uint8_t queue_keyglove_packet(uint8_t packetType, uint8_t payloadLength, uint8_t
  * @return Result, zero for success or non-zero for error
  */
 uint8_t send_keyglove_packet(uint8_t packetType, uint8_t payloadLength, uint8_t packetClass, uint8_t packetId, uint8_t *payload) {
+    #if (KG_RECORDER > 0)
+        // every protocol error event comes through here, whichever interface it came from
+        if (packetType == KG_PACKET_TYPE_EVENT && packetClass == KG_PACKET_CLASS_PROTOCOL && packetId == KG_PACKET_ID_EVT_PROTOCOL_ERROR) {
+            recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_PROTOCOL_ERROR);
+        }
+    #endif
+
     // validate payload length
     if ((payload == NULL && payloadLength > 0) || payloadLength > 250) {
         // payload specified but not provided, or too long
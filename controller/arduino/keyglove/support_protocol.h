@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "support_protocol_flex.h"
 #include "support_protocol_pressure.h"
 #include "support_protocol_touchset.h"
+#include "support_protocol_hid.h"
 #include "custom_protocol.h"
 
 #define KG_PROTOCOL_RX_TIMEOUT                  500     ///< Number of milliseconds before KGAPI parser will timeout after an incomplete packet
@@ -59,6 +60,7 @@ THE SOFTWARE.
 #define KG_PACKET_CLASS_FLEX                    0x06
 #define KG_PACKET_CLASS_PRESSURE                0x07
 #define KG_PACKET_CLASS_TOUCHSET                0x08
+#define KG_PACKET_CLASS_HID                     0x09
 
 #define KG_LOG_LEVEL_PANIC                      0       ///< Log level for "What a Terrible Failure" problems that will lock the MCU
 #define KG_LOG_LEVEL_CRITICAL                   1       ///< Log level for critical issues that will break core functionality
@@ -88,6 +90,7 @@ THE SOFTWARE.
 #define KG_PROTOCOL_ERROR_PARAMETER_LENGTH                  0x0004
 #define KG_PROTOCOL_ERROR_PARAMETER_RANGE                   0x0005
 #define KG_PROTOCOL_ERROR_NOT_IMPLEMENTED                   0x0006
+#define KG_PROTOCOL_ERROR_BUSY                              0x0007
 #define KG_PROTOCOL_ERROR_NULL_POINTER                      0xADDE
 
 // ------------------------------------------------------------------
@@ -113,6 +116,7 @@ uint8_t queue_keyglove_packet(uint8_t packetType, uint8_t payloadLength, uint8_t
     // see "support_bluetooth*.h" file(s) for implementation
     uint8_t bluetooth_check_incoming_protocol_data();
     uint8_t bluetooth_send_keyglove_packet_buffer(uint8_t *buffer, uint8_t length, uint8_t specificInterface);
+    bool bluetooth_api_ready();
 #endif
 
 extern bool inBinPacket;
@@ -0,0 +1,283 @@
+// Keyglove controller source code - KGAPI "hid" protocol command parser implementation
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/*
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+*/
+
+/**
+ * @file support_protocol_hid.cpp
+ * @brief KGAPI "hid" protocol command parser implementation
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * This file implements subsystem-specific command processing functions for the
+ * "hid" part of the KGAPI protocol.
+ *
+ * This file is autogenerated. Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_hid_mouse.h"
+#include "support_protocol.h"
+#include "support_protocol_hid.h"
+
+/**
+ * @brief Command processing routine for "hid" packet class
+ * @param[in] rxPacket Incoming KGAPI packet buffer
+ * @return Protocol error, if any (0 for success)
+ * @see protocol_parse()
+ * @see KGAPI command: kg_cmd_hid_get_curve_point()
+ * @see KGAPI command: kg_cmd_hid_set_curve()
+ * @see KGAPI command: kg_cmd_hid_reset_curve()
+ * @see KGAPI command: kg_cmd_hid_get_predictor()
+ * @see KGAPI command: kg_cmd_hid_set_predictor()
+ */
+uint8_t process_protocol_command_hid(uint8_t *rxPacket) {
+    // check for valid command IDs
+    uint8_t protocol_error = 0;
+    switch (rxPacket[3]) {
+        #if KG_HID & KG_HID_MOUSE
+        case KG_PACKET_ID_CMD_HID_GET_CURVE_POINT: // 0x01
+            // hid_get_curve_point(uint8_t curve, uint8_t index)(uint16_t value)
+            // parameters = 2 bytes
+            if (rxPacket[1] != 2) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t value = 0;
+                /*uint16_t result =*/ kg_cmd_hid_get_curve_point(rxPacket[4], rxPacket[5], &value);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_HID & KG_HID_MOUSE
+        
+        #if KG_HID & KG_HID_MOUSE
+        case KG_PACKET_ID_CMD_HID_SET_CURVE: // 0x02
+            // hid_set_curve(uint8_t curve, uint8_t[] points)(uint16_t result)
+            // parameters = 2 bytes
+            if (rxPacket[1] < 2 || rxPacket[1] != 2 + rxPacket[5]) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_hid_set_curve(rxPacket[4], rxPacket[5], rxPacket + 6);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_HID & KG_HID_MOUSE
+        
+        #if KG_HID & KG_HID_MOUSE
+        case KG_PACKET_ID_CMD_HID_RESET_CURVE: // 0x03
+            // hid_reset_curve(uint8_t curve)(uint16_t result)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_hid_reset_curve(rxPacket[4]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_HID & KG_HID_MOUSE
+        
+        #if KG_HID & KG_HID_MOUSE
+        case KG_PACKET_ID_CMD_HID_GET_PREDICTOR: // 0x04
+            // hid_get_predictor(uint8_t mode)(uint8_t enabled, uint8_t lead, uint8_t alpha, uint8_t beta, uint8_t jerk)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t enabled = 0;
+                uint8_t lead = 0;
+                uint8_t alpha = 0;
+                uint8_t beta = 0;
+                uint8_t jerk = 0;
+                /*uint16_t result =*/ kg_cmd_hid_get_predictor(rxPacket[4], &enabled, &lead, &alpha, &beta, &jerk);
+        
+                // build response
+                uint8_t payload[5] = { enabled, lead, alpha, beta, jerk };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 5, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_HID & KG_HID_MOUSE
+        
+        #if KG_HID & KG_HID_MOUSE
+        case KG_PACKET_ID_CMD_HID_SET_PREDICTOR: // 0x05
+            // hid_set_predictor(uint8_t mode, uint8_t enabled, uint8_t lead, uint8_t alpha, uint8_t beta, uint8_t jerk)(uint16_t result)
+            // parameters = 6 bytes
+            if (rxPacket[1] != 6) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_hid_set_predictor(rxPacket[4], rxPacket[5], rxPacket[6], rxPacket[7], rxPacket[8], rxPacket[9]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_HID & KG_HID_MOUSE
+        
+        default:
+            protocol_error = KG_PROTOCOL_ERROR_INVALID_COMMAND;
+    }
+    return protocol_error;
+}
+
+/* ============================= */
+/* KGAPI COMMAND IMPLEMENTATIONS */
+/* ============================= */
+
+#if KG_HID & KG_HID_MOUSE
+/**
+ * @brief Get one point of a mouse response curve
+ * @param[in] curve Response curve to read
+ * @param[in] index Point index within the curve
+ * @param[out] value Output at this point, in 1/16 counts
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_hid_get_curve_point(uint8_t curve, uint8_t index, uint16_t *value) {
+    if (curve >= KG_HID_MOUSE_CURVE_COUNT || index >= KG_HID_MOUSE_CURVE_POINTS) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    } else {
+        *value = hidMouseCurve[curve][index];
+    }
+    return 0; // success
+}
+#endif // KG_HID & KG_HID_MOUSE
+
+#if KG_HID & KG_HID_MOUSE
+/**
+ * @brief Replace all points of a mouse response curve
+ * @param[in] curve Response curve to replace
+ * @param[in] points_len Length in bytes of points_data buffer
+ * @param[in] points_data New curve points as little-endian uint16_t values
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_hid_set_curve(uint8_t curve, uint8_t points_len, uint8_t *points_data) {
+    if (curve >= KG_HID_MOUSE_CURVE_COUNT || points_len != KG_HID_MOUSE_CURVE_POINTS * 2) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    for (uint8_t i = 0; i < KG_HID_MOUSE_CURVE_POINTS; i++) {
+        hidMouseCurve[curve][i] = points_data[i * 2] | (points_data[i * 2 + 1] << 8);
+    }
+    return 0; // success
+}
+#endif // KG_HID & KG_HID_MOUSE
+
+#if KG_HID & KG_HID_MOUSE
+/**
+ * @brief Restore a mouse response curve to its built-in default
+ * @param[in] curve Response curve to restore
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_hid_reset_curve(uint8_t curve) {
+    if (curve >= KG_HID_MOUSE_CURVE_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    hid_mouse_reset_curve(curve);
+    return 0; // success
+}
+#endif // KG_HID & KG_HID_MOUSE
+
+#if KG_HID & KG_HID_MOUSE
+/**
+ * @brief Get cursor predictor settings for one mouse movement mode
+ * @param[in] mode Mouse movement mode to read
+ * @param[out] enabled Predictor enabled (1) or disabled (0)
+ * @param[out] lead Time to move the cursor ahead, in ms
+ * @param[out] alpha Position correction gain, in 1/256
+ * @param[out] beta Velocity correction gain, in 1/256
+ * @param[out] jerk Largest growth in lead distance per 10ms, in counts (0 = no limit)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_hid_get_predictor(uint8_t mode, uint8_t *enabled, uint8_t *lead, uint8_t *alpha, uint8_t *beta, uint8_t *jerk) {
+    if (mode == MOUSE_MODE_OFF || mode >= MOUSE_MODE_MAX) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    *enabled = opt_hid_mouse_predictor[mode].enabled;
+    *lead = opt_hid_mouse_predictor[mode].lead;
+    *alpha = opt_hid_mouse_predictor[mode].alpha;
+    *beta = opt_hid_mouse_predictor[mode].beta;
+    *jerk = opt_hid_mouse_predictor[mode].jerk;
+    return 0; // success
+}
+#endif // KG_HID & KG_HID_MOUSE
+
+#if KG_HID & KG_HID_MOUSE
+/**
+ * @brief Change cursor predictor settings for one mouse movement mode
+ * @param[in] mode Mouse movement mode to change
+ * @param[in] enabled Predictor enabled (1) or disabled (0)
+ * @param[in] lead Time to move the cursor ahead, in ms
+ * @param[in] alpha Position correction gain, in 1/256 (1-255)
+ * @param[in] beta Velocity correction gain, in 1/256
+ * @param[in] jerk Largest growth in lead distance per 10ms, in counts (0 = no limit)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_hid_set_predictor(uint8_t mode, uint8_t enabled, uint8_t lead, uint8_t alpha, uint8_t beta, uint8_t jerk) {
+    if (mode == MOUSE_MODE_OFF || mode >= MOUSE_MODE_MAX || enabled > 1 || alpha == 0) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    opt_hid_mouse_predictor[mode].enabled = enabled;
+    opt_hid_mouse_predictor[mode].lead = lead;
+    opt_hid_mouse_predictor[mode].alpha = alpha;
+    opt_hid_mouse_predictor[mode].beta = beta;
+    opt_hid_mouse_predictor[mode].jerk = jerk;
+
+    // start tracking from rest, in case this mode is active right now
+    hid_mouse_clear();
+    return 0; // success
+}
+#endif // KG_HID & KG_HID_MOUSE
+
+/* ==================== */
+/* KGAPI EVENT POINTERS */
+/* ==================== */
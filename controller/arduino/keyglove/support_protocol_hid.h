@@ -0,0 +1,89 @@
+// Keyglove controller source code - KGAPI "hid" protocol command parser declarations
+// 2014-12-07 by Jeff Rowberg <jeff@rowberg.net>
+
+/*
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2014 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+*/
+
+/**
+ * @file support_protocol_hid.h
+ * @brief KGAPI "hid" protocol command parser declarations
+ * @author Jeff Rowberg
+ * @date 2014-12-07
+ *
+ * This file implements subsystem-specific command processing functions for the
+ * "hid" part of the KGAPI protocol.
+ *
+ * This file is autogenerated. Normally it is not necessary to edit this file.
+ */
+
+#ifndef _SUPPORT_PROTOCOL_HID_H_
+#define _SUPPORT_PROTOCOL_HID_H_
+
+/* =========================== */
+/* KGAPI CONSTANT DECLARATIONS */
+/* =========================== */
+
+#define KG_PACKET_ID_CMD_HID_GET_CURVE_POINT                0x01
+#define KG_PACKET_ID_CMD_HID_SET_CURVE                      0x02
+#define KG_PACKET_ID_CMD_HID_RESET_CURVE                    0x03
+#define KG_PACKET_ID_CMD_HID_GET_PREDICTOR                  0x04
+#define KG_PACKET_ID_CMD_HID_SET_PREDICTOR                  0x05
+// -- command/event split --
+
+
+/* ================================ */
+/* KGAPI COMMAND/EVENT DECLARATIONS */
+/* ================================ */
+
+#if KG_HID & KG_HID_MOUSE
+/* 0x01 */ uint16_t kg_cmd_hid_get_curve_point(uint8_t curve, uint8_t index, uint16_t *value);
+#endif // KG_HID & KG_HID_MOUSE
+#if KG_HID & KG_HID_MOUSE
+/* 0x02 */ uint16_t kg_cmd_hid_set_curve(uint8_t curve, uint8_t points_len, uint8_t *points_data);
+#endif // KG_HID & KG_HID_MOUSE
+#if KG_HID & KG_HID_MOUSE
+/* 0x03 */ uint16_t kg_cmd_hid_reset_curve(uint8_t curve);
+#endif // KG_HID & KG_HID_MOUSE
+#if KG_HID & KG_HID_MOUSE
+/* 0x04 */ uint16_t kg_cmd_hid_get_predictor(uint8_t mode, uint8_t *enabled, uint8_t *lead, uint8_t *alpha, uint8_t *beta, uint8_t *jerk);
+#endif // KG_HID & KG_HID_MOUSE
+#if KG_HID & KG_HID_MOUSE
+/* 0x05 */ uint16_t kg_cmd_hid_set_predictor(uint8_t mode, uint8_t enabled, uint8_t lead, uint8_t alpha, uint8_t beta, uint8_t jerk);
+#endif // KG_HID & KG_HID_MOUSE
+// -- command/event split --
+
+
+#define KG_HID_CURVE_CURSOR                                 0x00    ///< Mouse cursor movement response curve
+#define KG_HID_CURVE_SCROLL                                 0x01    ///< Scroll movement response curve
+
+#define KG_HID_MOUSE_MODE_TILT_VELOCITY                     0x01    ///< Cursor speed follows tilt (rotational)
+#define KG_HID_MOUSE_MODE_TILT_POSITION                     0x02    ///< Cursor position follows tilt (rotational)
+#define KG_HID_MOUSE_MODE_MOVEMENT_POSITION                 0x03    ///< Cursor position follows movement (2D linear)
+#define KG_HID_MOUSE_MODE_3D                                0x04    ///< Cursor position follows movement (3D linear)
+
+uint8_t process_protocol_command_hid(uint8_t *rxPacket);
+
+#endif // _SUPPORT_PROTOCOL_HID_H_
@@ -41,6 +41,7 @@ THE SOFTWARE.
 
 #include "keyglove.h"
 #include "support_motion.h"
+#include "support_motiongesture.h"
 #include "support_protocol.h"
 #include "support_protocol_motion.h"
 
@@ -51,6 +52,16 @@ THE SOFTWARE.
  * @see protocol_parse()
  * @see KGAPI command: kg_cmd_motion_get_mode()
  * @see KGAPI command: kg_cmd_motion_set_mode()
+ * @see KGAPI command: kg_cmd_motion_get_filter()
+ * @see KGAPI command: kg_cmd_motion_set_filter()
+ * @see KGAPI command: kg_cmd_motion_get_config()
+ * @see KGAPI command: kg_cmd_motion_set_config()
+ * @see KGAPI command: kg_cmd_motion_get_bias()
+ * @see KGAPI command: kg_cmd_motion_reset_bias()
+ * @see KGAPI command: kg_cmd_motion_get_batch()
+ * @see KGAPI command: kg_cmd_motion_set_batch()
+ * @see KGAPI command: kg_cmd_motion_get_gesture()
+ * @see KGAPI command: kg_cmd_motion_set_gesture()
  */
 uint8_t process_protocol_command_motion(uint8_t *rxPacket) {
     // check for valid command IDs
@@ -93,6 +104,209 @@ uint8_t process_protocol_command_motion(uint8_t *rxPacket) {
             }
             break;
         
+        case KG_PACKET_ID_CMD_MOTION_GET_FILTER: // 0x03
+            // motion_get_filter(uint8_t index)(uint8_t accel_x, uint8_t accel_y, uint8_t accel_z, uint8_t gyro_x, uint8_t gyro_y, uint8_t gyro_z)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t accel_x = 0;
+                uint8_t accel_y = 0;
+                uint8_t accel_z = 0;
+                uint8_t gyro_x = 0;
+                uint8_t gyro_y = 0;
+                uint8_t gyro_z = 0;
+                /*uint16_t result =*/ kg_cmd_motion_get_filter(rxPacket[4], &accel_x, &accel_y, &accel_z, &gyro_x, &gyro_y, &gyro_z);
+        
+                // build response
+                uint8_t payload[6] = { accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 6, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_SET_FILTER: // 0x04
+            // motion_set_filter(uint8_t index, uint8_t accel_x, uint8_t accel_y, uint8_t accel_z, uint8_t gyro_x, uint8_t gyro_y, uint8_t gyro_z)(uint16_t result)
+            // parameters = 7 bytes
+            if (rxPacket[1] != 7) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_motion_set_filter(rxPacket[4], rxPacket[5], rxPacket[6], rxPacket[7], rxPacket[8], rxPacket[9], rxPacket[10]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_GET_CONFIG: // 0x05
+            // motion_get_config(uint8_t index)(uint16_t rate, uint8_t dlpf, uint8_t gyro_range, uint8_t accel_range, uint8_t decimation)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t rate = 0;
+                uint8_t dlpf = 0;
+                uint8_t gyro_range = 0;
+                uint8_t accel_range = 0;
+                uint8_t decimation = 0;
+                /*uint16_t result =*/ kg_cmd_motion_get_config(rxPacket[4], &rate, &dlpf, &gyro_range, &accel_range, &decimation);
+        
+                // build response
+                uint8_t payload[6] = { (uint8_t)(rate & 0xFF), (uint8_t)((rate >> 8) & 0xFF), dlpf, gyro_range, accel_range, decimation };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 6, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_SET_CONFIG: // 0x06
+            // motion_set_config(uint8_t index, uint16_t rate, uint8_t dlpf, uint8_t gyro_range, uint8_t accel_range, uint8_t decimation)(uint16_t result)
+            // parameters = 7 bytes
+            if (rxPacket[1] != 7) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_motion_set_config(rxPacket[4], rxPacket[5] | (rxPacket[6] << 8), rxPacket[7], rxPacket[8], rxPacket[9], rxPacket[10]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_GET_BIAS: // 0x07
+            // motion_get_bias(uint8_t index)(uint16_t x, uint16_t y, uint16_t z, uint8_t still)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t x = 0;
+                uint16_t y = 0;
+                uint16_t z = 0;
+                uint8_t still = 0;
+                /*uint16_t result =*/ kg_cmd_motion_get_bias(rxPacket[4], &x, &y, &z, &still);
+        
+                // build response
+                uint8_t payload[7] = { (uint8_t)(x & 0xFF), (uint8_t)((x >> 8) & 0xFF), (uint8_t)(y & 0xFF), (uint8_t)((y >> 8) & 0xFF), (uint8_t)(z & 0xFF), (uint8_t)((z >> 8) & 0xFF), still };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 7, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_RESET_BIAS: // 0x08
+            // motion_reset_bias(uint8_t index)(uint16_t result)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_motion_reset_bias(rxPacket[4]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_GET_BATCH: // 0x09
+            // motion_get_batch(uint8_t index)(uint8_t batch, uint8_t current)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t batch = 0;
+                uint8_t current = 0;
+                /*uint16_t result =*/ kg_cmd_motion_get_batch(rxPacket[4], &batch, &current);
+        
+                // build response
+                uint8_t payload[2] = { batch, current };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_MOTION_SET_BATCH: // 0x0A
+            // motion_set_batch(uint8_t index, uint8_t batch)(uint16_t result)
+            // parameters = 2 bytes
+            if (rxPacket[1] != 2) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_motion_set_batch(rxPacket[4], rxPacket[5]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        #if KG_MOTIONGESTURE > 0
+        case KG_PACKET_ID_CMD_MOTION_GET_GESTURE: // 0x0B
+            // motion_get_gesture(uint8_t gesture)(uint8_t frames, uint16_t threshold)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t frames = 0;
+                uint16_t threshold = 0;
+                /*uint16_t result =*/ kg_cmd_motion_get_gesture(rxPacket[4], &frames, &threshold);
+        
+                // build response
+                uint8_t payload[3] = { frames, (uint8_t)(threshold & 0xFF), (uint8_t)((threshold >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 3, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_MOTIONGESTURE > 0
+        
+        #if KG_MOTIONGESTURE > 0
+        case KG_PACKET_ID_CMD_MOTION_SET_GESTURE: // 0x0C
+            // motion_set_gesture(uint8_t gesture, uint16_t threshold, uint8_t[] frames)(uint16_t result)
+            // parameters = 4 bytes
+            if (rxPacket[1] < 4 || rxPacket[1] != 4 + rxPacket[7]) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_motion_set_gesture(rxPacket[4], rxPacket[5] | (rxPacket[6] << 8), rxPacket[7], rxPacket + 8);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_MOTIONGESTURE > 0
+        
         default:
             protocol_error = KG_PROTOCOL_ERROR_INVALID_COMMAND;
     }
@@ -128,12 +342,7 @@ uint16_t kg_cmd_motion_set_mode(uint8_t index, uint8_t mode) {
     if (index >= KG_MOTION_SENSOR_COUNT || mode >= KG_MOTION_MODE_MAX) {
         return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
     } else {
-        //motion_set_mode((motion_mode_t)mode);
-        #if KG_MOTION & KG_MOTION_MPU6050_HAND
-            if (index == 0) {
-                motion_set_mpu6050_hand_mode(mode);
-            }
-        #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+        motion_set_mode(index, (motion_mode_t)mode);
 
         // send kg_evt_feedback_vibrate_mode packet (if we aren't setting it from an API command)
         if (!inBinPacket) {
@@ -146,6 +355,244 @@ uint16_t kg_cmd_motion_set_mode(uint8_t index, uint8_t mode) {
     return 0; // success
 }
 
+/**
+ * @brief Get smoothing filter settings for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[out] accel_x Smoothing filter for accel X
+ * @param[out] accel_y Smoothing filter for accel Y
+ * @param[out] accel_z Smoothing filter for accel Z
+ * @param[out] gyro_x Smoothing filter for gyro X
+ * @param[out] gyro_y Smoothing filter for gyro Y
+ * @param[out] gyro_z Smoothing filter for gyro Z
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_get_filter(uint8_t index, uint8_t *accel_x, uint8_t *accel_y, uint8_t *accel_z, uint8_t *gyro_x, uint8_t *gyro_y, uint8_t *gyro_z) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            *accel_x = opt_motion_hand_filter[0];
+            *accel_y = opt_motion_hand_filter[1];
+            *accel_z = opt_motion_hand_filter[2];
+            *gyro_x = opt_motion_hand_filter[3];
+            *gyro_y = opt_motion_hand_filter[4];
+            *gyro_z = opt_motion_hand_filter[5];
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Set smoothing filter settings for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[in] accel_x Smoothing filter for accel X
+ * @param[in] accel_y Smoothing filter for accel Y
+ * @param[in] accel_z Smoothing filter for accel Z
+ * @param[in] gyro_x Smoothing filter for gyro X
+ * @param[in] gyro_y Smoothing filter for gyro Y
+ * @param[in] gyro_z Smoothing filter for gyro Z
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_set_filter(uint8_t index, uint8_t accel_x, uint8_t accel_y, uint8_t accel_z, uint8_t gyro_x, uint8_t gyro_y, uint8_t gyro_z) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            if (!motion_mpu6050_hand_filter_valid(accel_x) || !motion_mpu6050_hand_filter_valid(accel_y) || !motion_mpu6050_hand_filter_valid(accel_z) ||
+                !motion_mpu6050_hand_filter_valid(gyro_x) || !motion_mpu6050_hand_filter_valid(gyro_y) || !motion_mpu6050_hand_filter_valid(gyro_z)) {
+                return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+            }
+            opt_motion_hand_filter[0] = accel_x;
+            opt_motion_hand_filter[1] = accel_y;
+            opt_motion_hand_filter[2] = accel_z;
+            opt_motion_hand_filter[3] = gyro_x;
+            opt_motion_hand_filter[4] = gyro_y;
+            opt_motion_hand_filter[5] = gyro_z;
+            motion_mpu6050_hand_filter_reset();
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Get sampling configuration for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[out] rate Sample rate in Hz
+ * @param[out] dlpf Digital low-pass filter setting
+ * @param[out] gyro_range Gyroscope full-scale range
+ * @param[out] accel_range Accelerometer full-scale range
+ * @param[out] decimation Samples per motion data event
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_get_config(uint8_t index, uint16_t *rate, uint8_t *dlpf, uint8_t *gyro_range, uint8_t *accel_range, uint8_t *decimation) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            *rate = 1000 / (opt_motion_hand_rate_div + 1);
+            *dlpf = opt_motion_hand_dlpf;
+            *gyro_range = opt_motion_hand_gyro_range;
+            *accel_range = opt_motion_hand_accel_range;
+            *decimation = opt_motion_hand_decimation;
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Set sampling configuration for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[in] rate Sample rate in Hz (4-1000, rounded to 1kHz / n)
+ * @param[in] dlpf Digital low-pass filter setting
+ * @param[in] gyro_range Gyroscope full-scale range
+ * @param[in] accel_range Accelerometer full-scale range
+ * @param[in] decimation Samples per motion data event (1 or more)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_set_config(uint8_t index, uint16_t rate, uint8_t dlpf, uint8_t gyro_range, uint8_t accel_range, uint8_t decimation) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            if (rate < KG_MPU6050_RATE_MIN || rate > KG_MPU6050_RATE_MAX ||
+                dlpf < KG_MOTION_DLPF_188HZ || dlpf > KG_MOTION_DLPF_5HZ ||
+                gyro_range > KG_MOTION_GYRO_RANGE_2000 || accel_range > KG_MOTION_ACCEL_RANGE_16G || !decimation) {
+                return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+            }
+            #if (KG_FUSION & KG_FUSION_DMP)
+                // DMP firmware depends on the rate and ranges it was loaded with
+                if (mpuHandDMPReady) return KG_PROTOCOL_ERROR_NOT_IMPLEMENTED;
+            #endif
+            opt_motion_hand_rate_div = 1000 / rate - 1;
+            opt_motion_hand_dlpf = dlpf;
+            opt_motion_hand_gyro_range = gyro_range;
+            opt_motion_hand_accel_range = accel_range;
+            opt_motion_hand_decimation = decimation;
+            motion_mpu6050_hand_configure();
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Get estimated gyro bias and stillness for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[out] x Gyro X bias (signed, raw counts at current gyro range)
+ * @param[out] y Gyro Y bias (signed, raw counts at current gyro range)
+ * @param[out] z Gyro Z bias (signed, raw counts at current gyro range)
+ * @param[out] still Sensor was resting during the last bias estimation window
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_get_bias(uint8_t index, uint16_t *x, uint16_t *y, uint16_t *z, uint8_t *still) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            *x = motion_mpu6050_hand_bias_counts(0);
+            *y = motion_mpu6050_hand_bias_counts(1);
+            *z = motion_mpu6050_hand_bias_counts(2);
+            *still = mpuHandBiasStill;
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Discard estimated gyro bias (including stored copy) for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_reset_bias(uint8_t index) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            motion_mpu6050_hand_bias_reset();
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Get motion batch size for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[out] batch Configured samples per motion batch event (0 = automatic by link type)
+ * @param[out] current Samples per motion batch event in effect right now (1 = separate motion data events)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_get_batch(uint8_t index, uint8_t *batch, uint8_t *current) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            *batch = opt_motion_hand_batch;
+            *current = motion_mpu6050_hand_batch_size();
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+/**
+ * @brief Set motion batch size for specified motion sensor
+ * @param[in] index Index of motion sensor
+ * @param[in] batch Samples per motion batch event (0 = automatic by link type, 1 = separate motion data events)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_set_batch(uint8_t index, uint8_t batch) {
+    if (index >= KG_MOTION_SENSOR_COUNT) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    #if KG_MOTION & KG_MOTION_MPU6050_HAND
+        if (index == KG_MOTION_MPU6050_HAND_INDEX) {
+            motion_mpu6050_hand_batch_flush();
+            opt_motion_hand_batch = batch;
+        }
+    #endif // KG_MOTION & KG_MOTION_MPU6050_HAND
+    return 0; // success
+}
+
+#if KG_MOTIONGESTURE > 0
+/**
+ * @brief Get length and match threshold of a stored motion gesture template
+ * @param[in] gesture Gesture template slot
+ * @param[out] frames Number of frames in template (0 = empty slot)
+ * @param[out] threshold Highest score reported as a match
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_get_gesture(uint8_t gesture, uint8_t *frames, uint16_t *threshold) {
+    if (gesture >= KG_MOTIONGESTURE_SLOTS) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    *frames = motiongesture_get_template(gesture, threshold);
+    return 0; // success
+}
+#endif // KG_MOTIONGESTURE > 0
+
+#if KG_MOTIONGESTURE > 0
+/**
+ * @brief Store a motion gesture template in EEPROM, or clear a template slot
+ * @param[in] gesture Gesture template slot
+ * @param[in] threshold Highest score reported as a match
+ * @param[in] frames_len Length in bytes of frames_data buffer (3 bytes per frame, 0 clears slot)
+ * @param[in] frames_data Signed gyro X/Y/Z frames
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_motion_set_gesture(uint8_t gesture, uint16_t threshold, uint8_t frames_len, uint8_t *frames_data) {
+    if (gesture >= KG_MOTIONGESTURE_SLOTS || frames_len % 3 || frames_len > KG_MOTIONGESTURE_FRAMES_MAX * 3) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    motiongesture_set_template(gesture, threshold, frames_len / 3, (int8_t *)frames_data);
+    return 0; // success
+}
+#endif // KG_MOTIONGESTURE > 0
+
 /* ==================== */
 /* KGAPI EVENT POINTERS */
 /* ==================== */
@@ -153,3 +600,5 @@ uint16_t kg_cmd_motion_set_mode(uint8_t index, uint8_t mode) {
 /* 0x01 */ uint8_t (*kg_evt_motion_mode)(uint8_t index, uint8_t mode);
 /* 0x02 */ uint8_t (*kg_evt_motion_data)(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data);
 /* 0x03 */ uint8_t (*kg_evt_motion_state)(uint8_t index, uint8_t state);
+/* 0x04 */ uint8_t (*kg_evt_motion_batch)(uint8_t index, uint8_t flags, uint8_t count, uint16_t time, uint8_t data_len, uint8_t *data_data);
+/* 0x05 */ uint8_t (*kg_evt_motion_gesture)(uint8_t index, uint8_t gesture, uint16_t score, uint8_t frames);
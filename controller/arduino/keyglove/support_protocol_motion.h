@@ -48,10 +48,22 @@ THE SOFTWARE.
 
 #define KG_PACKET_ID_CMD_MOTION_GET_MODE                    0x01
 #define KG_PACKET_ID_CMD_MOTION_SET_MODE                    0x02
+#define KG_PACKET_ID_CMD_MOTION_GET_FILTER                  0x03
+#define KG_PACKET_ID_CMD_MOTION_SET_FILTER                  0x04
+#define KG_PACKET_ID_CMD_MOTION_GET_CONFIG                  0x05
+#define KG_PACKET_ID_CMD_MOTION_SET_CONFIG                  0x06
+#define KG_PACKET_ID_CMD_MOTION_GET_BIAS                    0x07
+#define KG_PACKET_ID_CMD_MOTION_RESET_BIAS                  0x08
+#define KG_PACKET_ID_CMD_MOTION_GET_BATCH                   0x09
+#define KG_PACKET_ID_CMD_MOTION_SET_BATCH                   0x0A
+#define KG_PACKET_ID_CMD_MOTION_GET_GESTURE                 0x0B
+#define KG_PACKET_ID_CMD_MOTION_SET_GESTURE                 0x0C
 // -- command/event split --
 #define KG_PACKET_ID_EVT_MOTION_MODE                        0x01
 #define KG_PACKET_ID_EVT_MOTION_DATA                        0x02
 #define KG_PACKET_ID_EVT_MOTION_STATE                       0x03
+#define KG_PACKET_ID_EVT_MOTION_BATCH                       0x04
+#define KG_PACKET_ID_EVT_MOTION_GESTURE                     0x05
 
 /* ================================ */
 /* KGAPI COMMAND/EVENT DECLARATIONS */
@@ -59,10 +71,46 @@ THE SOFTWARE.
 
 /* 0x01 */ uint16_t kg_cmd_motion_get_mode(uint8_t index, uint8_t *mode);
 /* 0x02 */ uint16_t kg_cmd_motion_set_mode(uint8_t index, uint8_t mode);
+/* 0x03 */ uint16_t kg_cmd_motion_get_filter(uint8_t index, uint8_t *accel_x, uint8_t *accel_y, uint8_t *accel_z, uint8_t *gyro_x, uint8_t *gyro_y, uint8_t *gyro_z);
+/* 0x04 */ uint16_t kg_cmd_motion_set_filter(uint8_t index, uint8_t accel_x, uint8_t accel_y, uint8_t accel_z, uint8_t gyro_x, uint8_t gyro_y, uint8_t gyro_z);
+/* 0x05 */ uint16_t kg_cmd_motion_get_config(uint8_t index, uint16_t *rate, uint8_t *dlpf, uint8_t *gyro_range, uint8_t *accel_range, uint8_t *decimation);
+/* 0x06 */ uint16_t kg_cmd_motion_set_config(uint8_t index, uint16_t rate, uint8_t dlpf, uint8_t gyro_range, uint8_t accel_range, uint8_t decimation);
+/* 0x07 */ uint16_t kg_cmd_motion_get_bias(uint8_t index, uint16_t *x, uint16_t *y, uint16_t *z, uint8_t *still);
+/* 0x08 */ uint16_t kg_cmd_motion_reset_bias(uint8_t index);
+/* 0x09 */ uint16_t kg_cmd_motion_get_batch(uint8_t index, uint8_t *batch, uint8_t *current);
+/* 0x0A */ uint16_t kg_cmd_motion_set_batch(uint8_t index, uint8_t batch);
+#if KG_MOTIONGESTURE > 0
+/* 0x0B */ uint16_t kg_cmd_motion_get_gesture(uint8_t gesture, uint8_t *frames, uint16_t *threshold);
+#endif // KG_MOTIONGESTURE > 0
+#if KG_MOTIONGESTURE > 0
+/* 0x0C */ uint16_t kg_cmd_motion_set_gesture(uint8_t gesture, uint16_t threshold, uint8_t frames_len, uint8_t *frames_data);
+#endif // KG_MOTIONGESTURE > 0
 // -- command/event split --
 /* 0x01 */ extern uint8_t (*kg_evt_motion_mode)(uint8_t index, uint8_t mode);
 /* 0x02 */ extern uint8_t (*kg_evt_motion_data)(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data);
 /* 0x03 */ extern uint8_t (*kg_evt_motion_state)(uint8_t index, uint8_t state);
+/* 0x04 */ extern uint8_t (*kg_evt_motion_batch)(uint8_t index, uint8_t flags, uint8_t count, uint16_t time, uint8_t data_len, uint8_t *data_data);
+/* 0x05 */ extern uint8_t (*kg_evt_motion_gesture)(uint8_t index, uint8_t gesture, uint16_t score, uint8_t frames);
+
+#define KG_MOTION_STATE_MOVING                              0x01    ///< Sensor is sampling and streaming at full rate
+#define KG_MOTION_STATE_STILL                               0x02    ///< No motion detected for a while, sensor is in low-power mode and not streaming
+
+#define KG_MOTION_DLPF_188HZ                                0x01    ///< 188Hz accel/gyro bandwidth
+#define KG_MOTION_DLPF_98HZ                                 0x02    ///< 98Hz accel/gyro bandwidth
+#define KG_MOTION_DLPF_42HZ                                 0x03    ///< 42Hz accel/gyro bandwidth
+#define KG_MOTION_DLPF_20HZ                                 0x04    ///< 20Hz accel/gyro bandwidth
+#define KG_MOTION_DLPF_10HZ                                 0x05    ///< 10Hz accel/gyro bandwidth
+#define KG_MOTION_DLPF_5HZ                                  0x06    ///< 5Hz accel/gyro bandwidth
+
+#define KG_MOTION_GYRO_RANGE_250                            0x00    ///< +/-250 deg/sec (131 counts per deg/sec)
+#define KG_MOTION_GYRO_RANGE_500                            0x01    ///< +/-500 deg/sec (65.5 counts per deg/sec)
+#define KG_MOTION_GYRO_RANGE_1000                           0x02    ///< +/-1000 deg/sec (32.8 counts per deg/sec)
+#define KG_MOTION_GYRO_RANGE_2000                           0x03    ///< +/-2000 deg/sec (16.4 counts per deg/sec)
+
+#define KG_MOTION_ACCEL_RANGE_2G                            0x00    ///< +/-2g (16384 counts per g)
+#define KG_MOTION_ACCEL_RANGE_4G                            0x01    ///< +/-4g (8192 counts per g)
+#define KG_MOTION_ACCEL_RANGE_8G                            0x02    ///< +/-8g (4096 counts per g)
+#define KG_MOTION_ACCEL_RANGE_16G                           0x03    ///< +/-16g (2048 counts per g)
 
 uint8_t process_protocol_command_motion(uint8_t *rxPacket);
 
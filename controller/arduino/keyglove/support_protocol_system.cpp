@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "keyglove.h"
 #include "support_board.h"
 #include "support_touch.h"
+#include "support_recorder.h"
 #include "support_protocol.h"
 #include "support_protocol_system.h"
 
@@ -57,6 +58,10 @@ THE SOFTWARE.
  * @see KGAPI command: kg_cmd_system_get_memory()
  * @see KGAPI command: kg_cmd_system_get_battery_status()
  * @see KGAPI command: kg_cmd_system_set_timer()
+ * @see KGAPI command: kg_cmd_system_get_recorder()
+ * @see KGAPI command: kg_cmd_system_set_recorder()
+ * @see KGAPI command: kg_cmd_system_trigger_recorder()
+ * @see KGAPI command: kg_cmd_system_read_recorder()
  */
 uint8_t process_protocol_command_system(uint8_t *rxPacket) {
     // check for valid command IDs
@@ -202,6 +207,93 @@ uint8_t process_protocol_command_system(uint8_t *rxPacket) {
             }
             break;
         
+        #if KG_RECORDER > 0
+        case KG_PACKET_ID_CMD_SYSTEM_GET_RECORDER: // 0x08
+            // system_get_recorder()(uint8_t mode, uint8_t state, uint8_t trigger, uint16_t count, uint16_t post)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t mode;
+                uint8_t state;
+                uint8_t trigger;
+                uint16_t count;
+                uint16_t post;
+                /*uint16_t result =*/ kg_cmd_system_get_recorder(&mode, &state, &trigger, &count, &post);
+        
+                // build response
+                uint8_t payload[7] = { mode, state, trigger, (uint8_t)(count & 0xFF), (uint8_t)((count >> 8) & 0xFF), (uint8_t)(post & 0xFF), (uint8_t)((post >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 7, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_RECORDER > 0
+        
+        #if KG_RECORDER > 0
+        case KG_PACKET_ID_CMD_SYSTEM_SET_RECORDER: // 0x09
+            // system_set_recorder(uint8_t mode, uint16_t post)(uint16_t result)
+            // parameters = 3 bytes
+            if (rxPacket[1] != 3) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_system_set_recorder(rxPacket[4], rxPacket[5] | (rxPacket[6] << 8));
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_RECORDER > 0
+        
+        #if KG_RECORDER > 0
+        case KG_PACKET_ID_CMD_SYSTEM_TRIGGER_RECORDER: // 0x0A
+            // system_trigger_recorder()(uint16_t result)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_system_trigger_recorder();
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_RECORDER > 0
+        
+        #if KG_RECORDER > 0
+        case KG_PACKET_ID_CMD_SYSTEM_READ_RECORDER: // 0x0B
+            // system_read_recorder()(uint16_t count, uint32_t timestamp)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t count;
+                uint32_t timestamp;
+                /*uint16_t result =*/ kg_cmd_system_read_recorder(&count, &timestamp);
+        
+                // build response
+                uint8_t payload[6] = { (uint8_t)(count & 0xFF), (uint8_t)((count >> 8) & 0xFF), (uint8_t)(timestamp & 0xFF), (uint8_t)((timestamp >> 8) & 0xFF), (uint8_t)((timestamp >> 16) & 0xFF), (uint8_t)((timestamp >> 24) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 6, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_RECORDER > 0
+        
         default:
             protocol_error = KG_PROTOCOL_ERROR_INVALID_COMMAND;
     }
@@ -470,6 +562,63 @@ uint16_t kg_cmd_system_set_timer(uint8_t handle, uint16_t interval, uint8_t ones
     return 0; // success
 }
 
+#if KG_RECORDER > 0
+
+/**
+ * @brief Get flight recorder status
+ * @param[out] mode Recorder mode
+ * @param[out] state Recorder state
+ * @param[out] trigger Source of the trigger which stopped recording, if any
+ * @param[out] count Number of records held
+ * @param[out] post Number of records kept after a trigger
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_system_get_recorder(uint8_t *mode, uint8_t *state, uint8_t *trigger, uint16_t *count, uint16_t *post) {
+    *mode = recorderMode;
+    *state = recorderState;
+    *trigger = recorderTrigger;
+    *count = recorderCount;
+    *post = recorderPost;
+    return 0; // success
+}
+
+/**
+ * @brief Clear and restart flight recorder
+ * @param[in] mode Recorder mode
+ * @param[in] post Number of records to keep after a trigger
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_system_set_recorder(uint8_t mode, uint16_t post) {
+    if (mode > KG_SYSTEM_RECORDER_MODE_TRIGGERED || post > KG_RECORDER_RECORDS) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    recorder_start(mode, post);
+    return 0; // success
+}
+
+/**
+ * @brief Trigger flight recorder
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_system_trigger_recorder() {
+    recorder_trigger(KG_SYSTEM_RECORDER_TRIGGER_COMMAND);
+    return 0; // success
+}
+
+/**
+ * @brief Stop and download flight recorder
+ * @param[out] count Number of records to expect
+ * @param[out] timestamp Full millisecond timestamp of the newest record
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_system_read_recorder(uint16_t *count, uint32_t *timestamp) {
+    // records follow as kg_evt_system_recorder_data() events from update_recorder()
+    *count = recorder_read(timestamp);
+    return 0; // success
+}
+
+#endif // KG_RECORDER > 0
+
 /* ==================== */
 /* KGAPI EVENT POINTERS */
 /* ==================== */
@@ -480,3 +629,6 @@ uint16_t kg_cmd_system_set_timer(uint8_t handle, uint16_t interval, uint8_t ones
 /* 0x04 */ uint8_t (*kg_evt_system_capability)(uint8_t category, uint8_t record_len, uint8_t *record_data);
 /* 0x05 */ uint8_t (*kg_evt_system_battery_status)(uint8_t status, uint8_t level);
 /* 0x06 */ uint8_t (*kg_evt_system_timer_tick)(uint8_t handle, uint32_t seconds, uint8_t subticks);
+#if KG_RECORDER > 0
+/* 0x07 */ uint8_t (*kg_evt_system_recorder_data)(uint16_t offset, uint8_t records_len, uint8_t *records_data);
+#endif // KG_RECORDER > 0
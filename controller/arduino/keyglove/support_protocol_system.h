@@ -53,6 +53,10 @@ THE SOFTWARE.
 #define KG_PACKET_ID_CMD_SYSTEM_GET_MEMORY                  0x05
 #define KG_PACKET_ID_CMD_SYSTEM_GET_BATTERY_STATUS          0x06
 #define KG_PACKET_ID_CMD_SYSTEM_SET_TIMER                   0x07
+#define KG_PACKET_ID_CMD_SYSTEM_GET_RECORDER                0x08
+#define KG_PACKET_ID_CMD_SYSTEM_SET_RECORDER                0x09
+#define KG_PACKET_ID_CMD_SYSTEM_TRIGGER_RECORDER            0x0A
+#define KG_PACKET_ID_CMD_SYSTEM_READ_RECORDER               0x0B
 // -- command/event split --
 #define KG_PACKET_ID_EVT_SYSTEM_BOOT                        0x01
 #define KG_PACKET_ID_EVT_SYSTEM_READY                       0x02
@@ -60,6 +64,7 @@ THE SOFTWARE.
 #define KG_PACKET_ID_EVT_SYSTEM_CAPABILITY                  0x04
 #define KG_PACKET_ID_EVT_SYSTEM_BATTERY_STATUS              0x05
 #define KG_PACKET_ID_EVT_SYSTEM_TIMER_TICK                  0x06
+#define KG_PACKET_ID_EVT_SYSTEM_RECORDER_DATA               0x07
 
 /* ================================ */
 /* KGAPI COMMAND/EVENT DECLARATIONS */
@@ -72,6 +77,18 @@ THE SOFTWARE.
 /* 0x05 */ uint16_t kg_cmd_system_get_memory(uint32_t *free_ram, uint32_t *total_ram);
 /* 0x06 */ uint16_t kg_cmd_system_get_battery_status(uint8_t *status, uint8_t *level);
 /* 0x07 */ uint16_t kg_cmd_system_set_timer(uint8_t handle, uint16_t interval, uint8_t oneshot);
+#if KG_RECORDER > 0
+/* 0x08 */ uint16_t kg_cmd_system_get_recorder(uint8_t *mode, uint8_t *state, uint8_t *trigger, uint16_t *count, uint16_t *post);
+#endif // KG_RECORDER > 0
+#if KG_RECORDER > 0
+/* 0x09 */ uint16_t kg_cmd_system_set_recorder(uint8_t mode, uint16_t post);
+#endif // KG_RECORDER > 0
+#if KG_RECORDER > 0
+/* 0x0A */ uint16_t kg_cmd_system_trigger_recorder();
+#endif // KG_RECORDER > 0
+#if KG_RECORDER > 0
+/* 0x0B */ uint16_t kg_cmd_system_read_recorder(uint16_t *count, uint32_t *timestamp);
+#endif // KG_RECORDER > 0
 // -- command/event split --
 /* 0x01 */ extern uint8_t (*kg_evt_system_boot)(uint16_t major, uint16_t minor, uint16_t patch, uint16_t protocol, uint32_t timestamp);
 /* 0x02 */ extern uint8_t (*kg_evt_system_ready)();
@@ -79,10 +96,30 @@ THE SOFTWARE.
 /* 0x04 */ extern uint8_t (*kg_evt_system_capability)(uint8_t category, uint8_t record_len, uint8_t *record_data);
 /* 0x05 */ extern uint8_t (*kg_evt_system_battery_status)(uint8_t status, uint8_t level);
 /* 0x06 */ extern uint8_t (*kg_evt_system_timer_tick)(uint8_t handle, uint32_t seconds, uint8_t subticks);
+#if KG_RECORDER > 0
+/* 0x07 */ extern uint8_t (*kg_evt_system_recorder_data)(uint16_t offset, uint8_t records_len, uint8_t *records_data);
+#endif // KG_RECORDER > 0
 
 #define KG_SYSTEM_RESET_MODE_NORMAL                         0x01    ///< Reset all components (e.g. core, motion, Bluetooth)
 #define KG_SYSTEM_RESET_MODE_KGONLY                         0x02    ///< Reset only core Keyglove board
 
+#define KG_SYSTEM_RECORDER_MODE_OFF                         0x00    ///< Not recording
+#define KG_SYSTEM_RECORDER_MODE_CONTINUOUS                  0x01    ///< Record until the trigger_recorder command
+#define KG_SYSTEM_RECORDER_MODE_TRIGGERED                   0x02    ///< Record until the trigger_recorder command or an error event
+
+#define KG_SYSTEM_RECORDER_STATE_IDLE                       0x00    ///< Recorder is off
+#define KG_SYSTEM_RECORDER_STATE_RECORDING                  0x01    ///< Recording, waiting for a trigger
+#define KG_SYSTEM_RECORDER_STATE_TRIGGERED                  0x02    ///< Triggered, recording the remaining post-trigger records
+#define KG_SYSTEM_RECORDER_STATE_STOPPED                    0x03    ///< Stopped, contents held for download
+
+#define KG_SYSTEM_RECORDER_TRIGGER_NONE                     0x00    ///< Not triggered
+#define KG_SYSTEM_RECORDER_TRIGGER_COMMAND                  0x01    ///< trigger_recorder command
+#define KG_SYSTEM_RECORDER_TRIGGER_PROTOCOL_ERROR           0x02    ///< Protocol error event
+#define KG_SYSTEM_RECORDER_TRIGGER_MOTION_ERROR             0x03    ///< Motion sensor bus error or FIFO overflow
+
+#define KG_SYSTEM_RECORDER_TYPE_TOUCH                       0x01    ///< Registered touch status change
+#define KG_SYSTEM_RECORDER_TYPE_MOTION                      0x02    ///< Raw gyro sample
+
 #define KG_CAPABILITY_CATEGORY_PLATFORM                     0x01    ///< Platform information (controller board)
 #define KG_CAPABILITY_CATEGORY_HOSTIF                       0x02    ///< Host interface information (USB, Bluetooth, etc.)
 #define KG_CAPABILITY_CATEGORY_FEEDBACK                     0x03    ///< Feedback subsystem informaiton
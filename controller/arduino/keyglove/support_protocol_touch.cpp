@@ -41,6 +41,8 @@ THE SOFTWARE.
 
 #include "keyglove.h"
 #include "support_touch.h"
+#include "support_touchgesture.h"
+#include "support_touchstats.h"
 #include "support_protocol.h"
 #include "support_protocol_touch.h"
 
@@ -51,6 +53,17 @@ THE SOFTWARE.
  * @see protocol_parse()
  * @see KGAPI command: kg_cmd_touch_get_mode()
  * @see KGAPI command: kg_cmd_touch_set_mode()
+ * @see KGAPI command: kg_cmd_touch_get_gesture_timing()
+ * @see KGAPI command: kg_cmd_touch_set_gesture_timing()
+ * @see KGAPI command: kg_cmd_touch_get_oversampling()
+ * @see KGAPI command: kg_cmd_touch_set_oversampling()
+ * @see KGAPI command: kg_cmd_touch_get_scan_config()
+ * @see KGAPI command: kg_cmd_touch_set_scan_config()
+ * @see KGAPI command: kg_cmd_touch_get_scan_stats()
+ * @see KGAPI command: kg_cmd_touch_get_ghost_mode()
+ * @see KGAPI command: kg_cmd_touch_set_ghost_mode()
+ * @see KGAPI command: kg_cmd_touch_get_usage()
+ * @see KGAPI command: kg_cmd_touch_reset_usage()
  */
 uint8_t process_protocol_command_touch(uint8_t *rxPacket) {
     // check for valid command IDs
@@ -93,6 +106,226 @@ uint8_t process_protocol_command_touch(uint8_t *rxPacket) {
             }
             break;
         
+        #if KG_TOUCHGESTURE > 0
+        case KG_PACKET_ID_CMD_TOUCH_GET_GESTURE_TIMING: // 0x03
+            // touch_get_gesture_timing()(uint16_t tap, uint16_t hold, uint16_t long_press, uint16_t multi_tap)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t tap;
+                uint16_t hold;
+                uint16_t long_press;
+                uint16_t multi_tap;
+                /*uint16_t result =*/ kg_cmd_touch_get_gesture_timing(&tap, &hold, &long_press, &multi_tap);
+        
+                // build response
+                uint8_t payload[8] = { (uint8_t)(tap & 0xFF), (uint8_t)((tap >> 8) & 0xFF), (uint8_t)(hold & 0xFF), (uint8_t)((hold >> 8) & 0xFF), (uint8_t)(long_press & 0xFF), (uint8_t)((long_press >> 8) & 0xFF), (uint8_t)(multi_tap & 0xFF), (uint8_t)((multi_tap >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 8, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHGESTURE > 0
+        
+        #if KG_TOUCHGESTURE > 0
+        case KG_PACKET_ID_CMD_TOUCH_SET_GESTURE_TIMING: // 0x04
+            // touch_set_gesture_timing(uint16_t tap, uint16_t hold, uint16_t long_press, uint16_t multi_tap)(uint16_t result)
+            // parameters = 8 bytes
+            if (rxPacket[1] != 8) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touch_set_gesture_timing(rxPacket[4] | (rxPacket[5] << 8), rxPacket[6] | (rxPacket[7] << 8), rxPacket[8] | (rxPacket[9] << 8), rxPacket[10] | (rxPacket[11] << 8));
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHGESTURE > 0
+        
+        case KG_PACKET_ID_CMD_TOUCH_GET_OVERSAMPLING: // 0x05
+            // touch_get_oversampling()(uint8_t samples)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t samples;
+                /*uint16_t result =*/ kg_cmd_touch_get_oversampling(&samples);
+        
+                // build response
+                uint8_t payload[1] = { samples };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 1, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_SET_OVERSAMPLING: // 0x06
+            // touch_set_oversampling(uint8_t samples)(uint16_t result)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touch_set_oversampling(rxPacket[4]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_GET_SCAN_CONFIG: // 0x07
+            // touch_get_scan_config()(uint16_t idle_timeout, uint8_t idle_interval, uint16_t burst_interval, uint16_t burst_timeout)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t idle_timeout;
+                uint8_t idle_interval;
+                uint16_t burst_interval;
+                uint16_t burst_timeout;
+                /*uint16_t result =*/ kg_cmd_touch_get_scan_config(&idle_timeout, &idle_interval, &burst_interval, &burst_timeout);
+        
+                // build response
+                uint8_t payload[7] = { (uint8_t)(idle_timeout & 0xFF), (uint8_t)((idle_timeout >> 8) & 0xFF), idle_interval, (uint8_t)(burst_interval & 0xFF), (uint8_t)((burst_interval >> 8) & 0xFF), (uint8_t)(burst_timeout & 0xFF), (uint8_t)((burst_timeout >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 7, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_SET_SCAN_CONFIG: // 0x08
+            // touch_set_scan_config(uint16_t idle_timeout, uint8_t idle_interval, uint16_t burst_interval, uint16_t burst_timeout)(uint16_t result)
+            // parameters = 7 bytes
+            if (rxPacket[1] != 7) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touch_set_scan_config(rxPacket[4] | (rxPacket[5] << 8), rxPacket[6], rxPacket[7] | (rxPacket[8] << 8), rxPacket[9] | (rxPacket[10] << 8));
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_GET_SCAN_STATS: // 0x09
+            // touch_get_scan_stats(uint8_t rate)(uint8_t current, uint32_t scans, uint32_t duration)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t current = 0;
+                uint32_t scans = 0;
+                uint32_t duration = 0;
+                /*uint16_t result =*/ kg_cmd_touch_get_scan_stats(rxPacket[4], &current, &scans, &duration);
+        
+                // build response
+                uint8_t payload[9] = { current, (uint8_t)(scans & 0xFF), (uint8_t)((scans >> 8) & 0xFF), (uint8_t)((scans >> 16) & 0xFF), (uint8_t)((scans >> 24) & 0xFF), (uint8_t)(duration & 0xFF), (uint8_t)((duration >> 8) & 0xFF), (uint8_t)((duration >> 16) & 0xFF), (uint8_t)((duration >> 24) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 9, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_GET_GHOST_MODE: // 0x0A
+            // touch_get_ghost_mode()(uint8_t mode)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint8_t mode;
+                /*uint16_t result =*/ kg_cmd_touch_get_ghost_mode(&mode);
+        
+                // build response
+                uint8_t payload[1] = { mode };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 1, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCH_SET_GHOST_MODE: // 0x0B
+            // touch_set_ghost_mode(uint8_t mode)(uint16_t result)
+            // parameters = 1 byte
+            if (rxPacket[1] != 1) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touch_set_ghost_mode(rxPacket[4]);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        #if KG_TOUCHSTATS > 0
+        case KG_PACKET_ID_CMD_TOUCH_GET_USAGE: // 0x0C
+            // touch_get_usage()(uint16_t count)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t count;
+                /*uint16_t result =*/ kg_cmd_touch_get_usage(&count);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(count & 0xFF), (uint8_t)((count >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSTATS > 0
+        
+        #if KG_TOUCHSTATS > 0
+        case KG_PACKET_ID_CMD_TOUCH_RESET_USAGE: // 0x0D
+            // touch_reset_usage()(uint16_t result)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touch_reset_usage();
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSTATS > 0
+        
         default:
             protocol_error = KG_PROTOCOL_ERROR_INVALID_COMMAND;
     }
@@ -123,9 +356,200 @@ uint16_t kg_cmd_touch_set_mode(uint8_t mode) {
     return 0; // success
 }
 
+#if KG_TOUCHGESTURE > 0
+/**
+ * @brief Get touch gesture timing thresholds
+ * @param[out] tap Maximum press duration for a tap
+ * @param[out] hold Press duration before a hold is reported
+ * @param[out] long_press Press duration before a long press is reported
+ * @param[out] multi_tap Maximum gap between taps for a double-tap
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_gesture_timing(uint16_t *tap, uint16_t *hold, uint16_t *long_press, uint16_t *multi_tap) {
+    *tap = opt_touch_tap_time;
+    *hold = opt_touch_hold_time;
+    *long_press = opt_touch_long_press_time;
+    *multi_tap = opt_touch_multi_tap_time;
+    return 0; // success
+}
+#endif // KG_TOUCHGESTURE > 0
+
+#if KG_TOUCHGESTURE > 0
+/**
+ * @brief Set touch gesture timing thresholds
+ * @param[in] tap Maximum press duration for a tap
+ * @param[in] hold Press duration before a hold is reported (must not be less than tap)
+ * @param[in] long_press Press duration before a long press is reported (must not be less than hold)
+ * @param[in] multi_tap Maximum gap between taps for a double-tap (0 to disable)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_set_gesture_timing(uint16_t tap, uint16_t hold, uint16_t long_press, uint16_t multi_tap) {
+    if (hold < tap || long_press < hold) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    opt_touch_tap_time = tap;
+    opt_touch_hold_time = hold;
+    opt_touch_long_press_time = long_press;
+    opt_touch_multi_tap_time = multi_tap;
+    return 0; // success
+}
+#endif // KG_TOUCHGESTURE > 0
+
+/**
+ * @brief Get touch scan oversampling setting
+ * @param[out] samples Reads per port for majority-vote oversampling (1 if disabled)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_oversampling(uint8_t *samples) {
+    *samples = opt_touch_samples;
+    return 0; // success
+}
+
+/**
+ * @brief Set touch scan oversampling setting
+ * @param[in] samples Reads per port for majority-vote oversampling (1, 3, 5, or 7; 1 disables)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_set_oversampling(uint8_t samples) {
+    if (samples > 7 || !(samples & 1)) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    opt_touch_samples = samples;
+    return 0; // success
+}
+
+/**
+ * @brief Get adaptive touch scan rate settings
+ * @param[out] idle_timeout Time without contact before dropping to idle scan rate (0 never idles)
+ * @param[out] idle_interval Ticks (10ms units) between scans at idle scan rate
+ * @param[out] burst_interval Time between scans at burst scan rate
+ * @param[out] burst_timeout Time after last contact before dropping from burst to normal scan rate
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_scan_config(uint16_t *idle_timeout, uint8_t *idle_interval, uint16_t *burst_interval, uint16_t *burst_timeout) {
+    *idle_timeout = opt_touch_idle_timeout;
+    *idle_interval = opt_touch_idle_interval;
+    *burst_interval = opt_touch_burst_interval;
+    *burst_timeout = opt_touch_burst_timeout;
+    return 0; // success
+}
+
+/**
+ * @brief Set adaptive touch scan rate settings
+ * @param[in] idle_timeout Time without contact before dropping to idle scan rate (0 never idles)
+ * @param[in] idle_interval Ticks (10ms units) between scans at idle scan rate
+ * @param[in] burst_interval Time between scans at burst scan rate (0 scans continuously)
+ * @param[in] burst_timeout Time after last contact before dropping from burst to normal scan rate
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_set_scan_config(uint16_t idle_timeout, uint8_t idle_interval, uint16_t burst_interval, uint16_t burst_timeout) {
+    if (idle_interval == 0) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    opt_touch_idle_timeout = idle_timeout;
+    opt_touch_idle_interval = idle_interval;
+    opt_touch_burst_interval = burst_interval;
+    opt_touch_burst_timeout = burst_timeout;
+    return 0; // success
+}
+
+/**
+ * @brief Get adaptive touch scan rate statistics
+ * @param[in] rate Scan rate to report
+ * @param[out] current Current scan rate
+ * @param[out] scans Total number of scans at requested rate
+ * @param[out] duration Total time spent at requested rate
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_scan_stats(uint8_t rate, uint8_t *current, uint32_t *scans, uint32_t *duration) {
+    if (rate > KG_TOUCH_SCAN_RATE_BURST) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    *current = touchScanRate;
+    touch_get_scan_stats(rate, scans, duration);
+    return 0; // success
+}
+
+/**
+ * @brief Get ghost combination handling mode
+ * @param[out] mode Ghost combination handling mode
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_ghost_mode(uint8_t *mode) {
+    *mode = opt_touch_ghost_mode;
+    return 0; // success
+}
+
+/**
+ * @brief Set ghost combination handling mode
+ * @param[in] mode Ghost combination handling mode
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_set_ghost_mode(uint8_t mode) {
+    if (mode > KG_TOUCH_GHOST_MODE_MASK) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    opt_touch_ghost_mode = mode;
+    return 0; // success
+}
+
+#if KG_TOUCHSTATS > 0
+
+/**
+ * @brief Get touch usage statistics
+ * @param[out] count Number of usage data reports to expect
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_get_usage(uint16_t *count) {
+    uint8_t *data = (uint8_t *)&touchstats;
+    uint16_t offset;
+    uint8_t length;
+    uint8_t payload[3 + KG_TOUCHSTATS_CHUNK];
+
+    // freeze elapsed time so the block is consistent
+    touchstats.elapsed = millis() - touchstatsResetTime;
+
+    *count = 0;
+    for (offset = 0; offset < sizeof(touchstats); offset += length) {
+        length = min(KG_TOUCHSTATS_CHUNK, sizeof(touchstats) - offset);
+
+        // increment expected report count
+        (*count)++;
+
+        payload[0] = offset & 0xFF;
+        payload[1] = (offset >> 8) & 0xFF;
+        payload[2] = length;
+        memcpy(payload + 3, data + offset, length);
+
+        // queue event
+        skipPacket = 0;
+        if (kg_evt_touch_usage) skipPacket = kg_evt_touch_usage(offset, payload[2], payload + 3);
+        if (!skipPacket) queue_keyglove_packet(KG_PACKET_TYPE_EVENT, 3 + length, KG_PACKET_CLASS_TOUCH, KG_PACKET_ID_EVT_TOUCH_USAGE, payload);
+    }
+    return 0; // success
+}
+
+/**
+ * @brief Clear touch usage statistics
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touch_reset_usage() {
+    touchstats_reset();
+    return 0; // success
+}
+
+#endif // KG_TOUCHSTATS > 0
+
 /* ==================== */
 /* KGAPI EVENT POINTERS */
 /* ==================== */
 
 /* 0x01 */ uint8_t (*kg_evt_touch_mode)(uint8_t mode);
 /* 0x02 */ uint8_t (*kg_evt_touch_status)(uint8_t status_len, uint8_t *status_data);
+#if KG_TOUCHGESTURE > 0
+/* 0x03 */ uint8_t (*kg_evt_touch_gesture)(uint8_t combination, uint8_t gesture);
+#endif // KG_TOUCHGESTURE > 0
+/* 0x04 */ uint8_t (*kg_evt_touch_ambiguous)(uint8_t status_len, uint8_t *status_data);
+#if KG_TOUCHSTATS > 0
+/* 0x05 */ uint8_t (*kg_evt_touch_usage)(uint16_t offset, uint8_t data_len, uint8_t *data_data);
+#endif // KG_TOUCHSTATS > 0
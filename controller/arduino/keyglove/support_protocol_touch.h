@@ -48,9 +48,23 @@ THE SOFTWARE.
 
 #define KG_PACKET_ID_CMD_TOUCH_GET_MODE                     0x01
 #define KG_PACKET_ID_CMD_TOUCH_SET_MODE                     0x02
+#define KG_PACKET_ID_CMD_TOUCH_GET_GESTURE_TIMING           0x03
+#define KG_PACKET_ID_CMD_TOUCH_SET_GESTURE_TIMING           0x04
+#define KG_PACKET_ID_CMD_TOUCH_GET_OVERSAMPLING             0x05
+#define KG_PACKET_ID_CMD_TOUCH_SET_OVERSAMPLING             0x06
+#define KG_PACKET_ID_CMD_TOUCH_GET_SCAN_CONFIG              0x07
+#define KG_PACKET_ID_CMD_TOUCH_SET_SCAN_CONFIG              0x08
+#define KG_PACKET_ID_CMD_TOUCH_GET_SCAN_STATS               0x09
+#define KG_PACKET_ID_CMD_TOUCH_GET_GHOST_MODE               0x0A
+#define KG_PACKET_ID_CMD_TOUCH_SET_GHOST_MODE               0x0B
+#define KG_PACKET_ID_CMD_TOUCH_GET_USAGE                    0x0C
+#define KG_PACKET_ID_CMD_TOUCH_RESET_USAGE                  0x0D
 // -- command/event split --
 #define KG_PACKET_ID_EVT_TOUCH_MODE                         0x01
 #define KG_PACKET_ID_EVT_TOUCH_STATUS                       0x02
+#define KG_PACKET_ID_EVT_TOUCH_GESTURE                      0x03
+#define KG_PACKET_ID_EVT_TOUCH_AMBIGUOUS                    0x04
+#define KG_PACKET_ID_EVT_TOUCH_USAGE                        0x05
 
 /* ================================ */
 /* KGAPI COMMAND/EVENT DECLARATIONS */
@@ -58,9 +72,48 @@ THE SOFTWARE.
 
 /* 0x01 */ uint16_t kg_cmd_touch_get_mode(uint8_t *mode);
 /* 0x02 */ uint16_t kg_cmd_touch_set_mode(uint8_t mode);
+#if KG_TOUCHGESTURE > 0
+/* 0x03 */ uint16_t kg_cmd_touch_get_gesture_timing(uint16_t *tap, uint16_t *hold, uint16_t *long_press, uint16_t *multi_tap);
+#endif // KG_TOUCHGESTURE > 0
+#if KG_TOUCHGESTURE > 0
+/* 0x04 */ uint16_t kg_cmd_touch_set_gesture_timing(uint16_t tap, uint16_t hold, uint16_t long_press, uint16_t multi_tap);
+#endif // KG_TOUCHGESTURE > 0
+/* 0x05 */ uint16_t kg_cmd_touch_get_oversampling(uint8_t *samples);
+/* 0x06 */ uint16_t kg_cmd_touch_set_oversampling(uint8_t samples);
+/* 0x07 */ uint16_t kg_cmd_touch_get_scan_config(uint16_t *idle_timeout, uint8_t *idle_interval, uint16_t *burst_interval, uint16_t *burst_timeout);
+/* 0x08 */ uint16_t kg_cmd_touch_set_scan_config(uint16_t idle_timeout, uint8_t idle_interval, uint16_t burst_interval, uint16_t burst_timeout);
+/* 0x09 */ uint16_t kg_cmd_touch_get_scan_stats(uint8_t rate, uint8_t *current, uint32_t *scans, uint32_t *duration);
+/* 0x0A */ uint16_t kg_cmd_touch_get_ghost_mode(uint8_t *mode);
+/* 0x0B */ uint16_t kg_cmd_touch_set_ghost_mode(uint8_t mode);
+#if KG_TOUCHSTATS > 0
+/* 0x0C */ uint16_t kg_cmd_touch_get_usage(uint16_t *count);
+#endif // KG_TOUCHSTATS > 0
+#if KG_TOUCHSTATS > 0
+/* 0x0D */ uint16_t kg_cmd_touch_reset_usage();
+#endif // KG_TOUCHSTATS > 0
 // -- command/event split --
 /* 0x01 */ extern uint8_t (*kg_evt_touch_mode)(uint8_t mode);
 /* 0x02 */ extern uint8_t (*kg_evt_touch_status)(uint8_t status_len, uint8_t *status_data);
+#if KG_TOUCHGESTURE > 0
+/* 0x03 */ extern uint8_t (*kg_evt_touch_gesture)(uint8_t combination, uint8_t gesture);
+#endif // KG_TOUCHGESTURE > 0
+/* 0x04 */ extern uint8_t (*kg_evt_touch_ambiguous)(uint8_t status_len, uint8_t *status_data);
+#if KG_TOUCHSTATS > 0
+/* 0x05 */ extern uint8_t (*kg_evt_touch_usage)(uint16_t offset, uint8_t data_len, uint8_t *data_data);
+#endif // KG_TOUCHSTATS > 0
+
+#define KG_TOUCH_GESTURE_TAP                                0x01    ///< Short press and release, with no second press within the multi-tap gap
+#define KG_TOUCH_GESTURE_DOUBLE_TAP                         0x02    ///< Two taps on the same combination within the multi-tap gap
+#define KG_TOUCH_GESTURE_HOLD                               0x03    ///< Press held past the hold threshold (still active)
+#define KG_TOUCH_GESTURE_LONG_PRESS                         0x04    ///< Press held past the long press threshold (still active)
+
+#define KG_TOUCH_SCAN_RATE_IDLE                             0x00    ///< No recent contact, scanning every idle interval
+#define KG_TOUCH_SCAN_RATE_NORMAL                           0x01    ///< Scanning every 100Hz tick
+#define KG_TOUCH_SCAN_RATE_BURST                            0x02    ///< Contact active or recently released, scanning every burst interval
+
+#define KG_TOUCH_GHOST_MODE_OFF                             0x00    ///< No ghost detection
+#define KG_TOUCH_GHOST_MODE_REPORT                          0x01    ///< Report possible ghosts with the ambiguous event
+#define KG_TOUCH_GHOST_MODE_MASK                            0x02    ///< Remove the side of each triangle most likely to be a ghost, and report triangles where that side was already registered
 
 uint8_t process_protocol_command_touch(uint8_t *rxPacket);
 
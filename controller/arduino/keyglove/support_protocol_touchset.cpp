@@ -40,6 +40,7 @@ THE SOFTWARE.
  */
 
 #include "keyglove.h"
+#include "support_touchset.h"
 #include "support_protocol.h"
 #include "support_protocol_touchset.h"
 
@@ -48,11 +49,154 @@ THE SOFTWARE.
  * @param[in] rxPacket Incoming KGAPI packet buffer
  * @return Protocol error, if any (0 for success)
  * @see protocol_parse()
+ * @see KGAPI command: kg_cmd_touchset_get_info()
+ * @see KGAPI command: kg_cmd_touchset_clear()
+ * @see KGAPI command: kg_cmd_touchset_add_entry()
+ * @see KGAPI command: kg_cmd_touchset_write_begin()
+ * @see KGAPI command: kg_cmd_touchset_write_data()
+ * @see KGAPI command: kg_cmd_touchset_write_end()
+ * @see KGAPI command: kg_cmd_touchset_erase()
  */
 uint8_t process_protocol_command_touchset(uint8_t *rxPacket) {
     // check for valid command IDs
     uint8_t protocol_error = 0;
     switch (rxPacket[3]) {
+        case KG_PACKET_ID_CMD_TOUCHSET_GET_INFO: // 0x01
+            // touchset_get_info()(uint16_t count, uint16_t capacity, uint8_t source)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t count;
+                uint16_t capacity;
+                uint8_t source;
+                /*uint16_t result =*/ kg_cmd_touchset_get_info(&count, &capacity, &source);
+        
+                // build response
+                uint8_t payload[5] = { (uint8_t)(count & 0xFF), (uint8_t)((count >> 8) & 0xFF), (uint8_t)(capacity & 0xFF), (uint8_t)((capacity >> 8) & 0xFF), source };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 5, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCHSET_CLEAR: // 0x02
+            // touchset_clear()(uint16_t result)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_clear();
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        case KG_PACKET_ID_CMD_TOUCHSET_ADD_ENTRY: // 0x03
+            // touchset_add_entry(uint8_t mode, uint8_t action, uint8_t param, uint8_t[] chord)(uint16_t result)
+            // parameters = 4 bytes
+            if (rxPacket[1] < 4 || rxPacket[1] != 4 + rxPacket[7]) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_add_entry(rxPacket[4], rxPacket[5], rxPacket[6], rxPacket[7], rxPacket + 8);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        
+        #if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        case KG_PACKET_ID_CMD_TOUCHSET_WRITE_BEGIN: // 0x04
+            // touchset_write_begin(uint16_t count)(uint16_t result)
+            // parameters = 2 bytes
+            if (rxPacket[1] != 2) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_write_begin(rxPacket[4] | (rxPacket[5] << 8));
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        
+        #if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        case KG_PACKET_ID_CMD_TOUCHSET_WRITE_DATA: // 0x05
+            // touchset_write_data(uint16_t offset, uint8_t[] data)(uint16_t result)
+            // parameters = 3 bytes
+            if (rxPacket[1] < 3 || rxPacket[1] != 3 + rxPacket[6]) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_write_data(rxPacket[4] | (rxPacket[5] << 8), rxPacket[6], rxPacket + 7);
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        
+        #if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        case KG_PACKET_ID_CMD_TOUCHSET_WRITE_END: // 0x06
+            // touchset_write_end(uint16_t crc)(uint16_t result)
+            // parameters = 2 bytes
+            if (rxPacket[1] != 2) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_write_end(rxPacket[4] | (rxPacket[5] << 8));
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        
+        #if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+        case KG_PACKET_ID_CMD_TOUCHSET_ERASE: // 0x07
+            // touchset_erase()(uint16_t result)
+            // parameters = 0 bytes
+            if (rxPacket[1] != 0) {
+                // incorrect parameter length
+                protocol_error = KG_PROTOCOL_ERROR_PARAMETER_LENGTH;
+            } else {
+                // run command
+                uint16_t result = kg_cmd_touchset_erase();
+        
+                // build response
+                uint8_t payload[2] = { (uint8_t)(result & 0xFF), (uint8_t)((result >> 8) & 0xFF) };
+        
+                // send response
+                send_keyglove_packet(KG_PACKET_TYPE_COMMAND, 2, rxPacket[2], rxPacket[3], payload);
+            }
+            break;
+        #endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
         
         default:
             protocol_error = KG_PROTOCOL_ERROR_INVALID_COMMAND;
@@ -64,6 +208,111 @@ uint8_t process_protocol_command_touchset(uint8_t *rxPacket) {
 /* KGAPI COMMAND IMPLEMENTATIONS */
 /* ============================= */
 
+/**
+ * @brief Get touchset table size information
+ * @param[out] count Number of entries in touchset table
+ * @param[out] capacity Maximum number of entries in touchset table
+ * @param[out] source Active touchset table source (0=none, 1=RAM, 2=EEPROM)
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_get_info(uint16_t *count, uint16_t *capacity, uint8_t *source) {
+    *count = touchsetCount;
+    *capacity = touchset_capacity();
+    *source = touchsetSource;
+    return 0; // success
+}
+
+/**
+ * @brief Remove all entries from the RAM touchset table
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_clear() {
+    touchset_clear();
+    return 0; // success
+}
+
+/**
+ * @brief Add a new entry to the touchset table
+ * @param[in] mode Touch mode in which the entry is active
+ * @param[in] action Trigger (bits 7-6) and action code (bits 5-0)
+ * @param[in] param Action parameter
+ * @param[in] chord_len Length in bytes of chord_data buffer
+ * @param[in] chord_data Base touch combination indexes making up the chord
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_add_entry(uint8_t mode, uint8_t action, uint8_t param, uint8_t chord_len, uint8_t *chord_data) {
+    if (chord_len > KG_TOUCHSET_CHORD_MAX || touchset_add_entry(mode, action, param, chord_len, chord_data)) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    return 0; // success
+}
+
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/**
+ * @brief Start uploading a compiled touchset into EEPROM
+ * @param[in] count Number of entries which will be uploaded
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_write_begin(uint16_t count) {
+    uint8_t result = touchset_write_begin(count);
+    if (result == KG_TOUCHSET_WRITE_BUSY) {
+        return KG_PROTOCOL_ERROR_BUSY;
+    } else if (result) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    return 0; // success
+}
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/**
+ * @brief Write a chunk of compiled touchset entry data into EEPROM
+ * @param[in] offset Byte offset into entry data
+ * @param[in] data_len Length in bytes of data_data buffer
+ * @param[in] data_data Compiled entry data
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_write_data(uint16_t offset, uint8_t data_len, uint8_t *data_data) {
+    uint8_t result = touchset_write_data(offset, data_len, data_data);
+    if (result == KG_TOUCHSET_WRITE_BUSY) {
+        return KG_PROTOCOL_ERROR_BUSY;
+    } else if (result) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    return 0; // success
+}
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/**
+ * @brief Finish uploading a compiled touchset into EEPROM
+ * @param[in] crc CRC16 (XMODEM) of all entry data
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_write_end(uint16_t crc) {
+    uint8_t result = touchset_write_end(crc);
+    if (result == KG_TOUCHSET_WRITE_BUSY) {
+        return KG_PROTOCOL_ERROR_BUSY;
+    } else if (result) {
+        return KG_PROTOCOL_ERROR_PARAMETER_RANGE;
+    }
+    return 0; // success
+}
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/**
+ * @brief Invalidate the touchset stored in EEPROM
+ * @return Result code (0=success)
+ */
+uint16_t kg_cmd_touchset_erase() {
+    if (touchset_erase()) {
+        return KG_PROTOCOL_ERROR_BUSY;
+    }
+    return 0; // success
+}
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+
 /* ==================== */
 /* KGAPI EVENT POINTERS */
 /* ==================== */
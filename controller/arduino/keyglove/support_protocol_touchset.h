@@ -46,7 +46,13 @@ THE SOFTWARE.
 /* KGAPI CONSTANT DECLARATIONS */
 /* =========================== */
 
-
+#define KG_PACKET_ID_CMD_TOUCHSET_GET_INFO                  0x01
+#define KG_PACKET_ID_CMD_TOUCHSET_CLEAR                     0x02
+#define KG_PACKET_ID_CMD_TOUCHSET_ADD_ENTRY                 0x03
+#define KG_PACKET_ID_CMD_TOUCHSET_WRITE_BEGIN               0x04
+#define KG_PACKET_ID_CMD_TOUCHSET_WRITE_DATA                0x05
+#define KG_PACKET_ID_CMD_TOUCHSET_WRITE_END                 0x06
+#define KG_PACKET_ID_CMD_TOUCHSET_ERASE                     0x07
 // -- command/event split --
 
 
@@ -54,7 +60,21 @@ THE SOFTWARE.
 /* KGAPI COMMAND/EVENT DECLARATIONS */
 /* ================================ */
 
-
+/* 0x01 */ uint16_t kg_cmd_touchset_get_info(uint16_t *count, uint16_t *capacity, uint8_t *source);
+/* 0x02 */ uint16_t kg_cmd_touchset_clear();
+/* 0x03 */ uint16_t kg_cmd_touchset_add_entry(uint8_t mode, uint8_t action, uint8_t param, uint8_t chord_len, uint8_t *chord_data);
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/* 0x04 */ uint16_t kg_cmd_touchset_write_begin(uint16_t count);
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/* 0x05 */ uint16_t kg_cmd_touchset_write_data(uint16_t offset, uint8_t data_len, uint8_t *data_data);
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/* 0x06 */ uint16_t kg_cmd_touchset_write_end(uint16_t crc);
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
+#if KG_TOUCHSET & KG_TOUCHSET_EEPROM
+/* 0x07 */ uint16_t kg_cmd_touchset_erase();
+#endif // KG_TOUCHSET & KG_TOUCHSET_EEPROM
 // -- command/event split --
 
 
@@ -0,0 +1,190 @@
+// Keyglove controller source code - Flight recorder implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_recorder.cpp
+ * @brief Flight recorder implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Recording a sample claims the next slot in the ring and copies a fixed
+ * number of bytes into it, with no loops or branches that depend on the data,
+ * so the cost per sample is constant (roughly 100 cycles, including the call
+ * to millis()). Nothing is ever written to EEPROM here, since every EEPROM
+ * byte takes milliseconds to write.
+ *
+ * A download is sent one kg_evt_system_recorder_data() event per pass through
+ * the main loop, straight from the ring, so it does not need a second copy of
+ * the records in the TX queue.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_recorder.h"
+
+// only built when enabled, since the download event is only declared then
+#if (KG_RECORDER > 0)
+
+recorder_record_t recorder[KG_RECORDER_RECORDS];   ///< Ring of recorded samples
+uint8_t recorderHead;           ///< Index of the next record to write
+uint16_t recorderCount;         ///< Number of valid records in the ring
+uint8_t recorderMode;           ///< Recorder mode (off, continuous, triggered)
+uint8_t recorderState;          ///< Recorder state (idle, recording, triggered, stopped)
+uint8_t recorderTrigger;        ///< Source of the trigger which stopped recording
+uint16_t recorderPost;          ///< Records to keep after a trigger
+uint16_t recorderRemaining;     ///< Records left before stopping, once triggered
+uint32_t recorderTime;          ///< Full millis() timestamp of the newest record
+uint16_t recorderSent;          ///< Records already sent in the current download
+bool recorderDownload;          ///< Whether a download is in progress
+
+/**
+ * @brief Initialize flight recorder
+ */
+void setup_recorder() {
+    recorder_start(KG_RECORDER_BOOT_MODE, KG_RECORDER_BOOT_POST);
+}
+
+/**
+ * @brief Clear the flight recorder and start it in a new mode
+ * @param[in] mode Recorder mode
+ * @param[in] post Number of records to keep after a trigger
+ */
+void recorder_start(uint8_t mode, uint16_t post) {
+    recorderMode = mode;
+    recorderPost = post;
+    recorderHead = 0;
+    recorderCount = 0;
+    recorderTrigger = KG_SYSTEM_RECORDER_TRIGGER_NONE;
+    recorderDownload = false;
+    recorderState = (mode == KG_SYSTEM_RECORDER_MODE_OFF) ? KG_SYSTEM_RECORDER_STATE_IDLE : KG_SYSTEM_RECORDER_STATE_RECORDING;
+}
+
+/**
+ * @brief Trigger the flight recorder, so it stops after the post-trigger records
+ * @param[in] source What caused the trigger
+ *
+ * In continuous mode, only the trigger_recorder command has any effect.
+ */
+void recorder_trigger(uint8_t source) {
+    if (recorderState != KG_SYSTEM_RECORDER_STATE_RECORDING) return;
+    if (recorderMode == KG_SYSTEM_RECORDER_MODE_CONTINUOUS && source != KG_SYSTEM_RECORDER_TRIGGER_COMMAND) return;
+    recorderTrigger = source;
+    recorderRemaining = recorderPost;
+    recorderState = recorderPost ? KG_SYSTEM_RECORDER_STATE_TRIGGERED : KG_SYSTEM_RECORDER_STATE_STOPPED;
+}
+
+/**
+ * @brief Claim the next record in the ring
+ * @param[in] type Record type
+ * @param[in] aux Touch mode or motion sensor index
+ * @return Record to fill in, or 0 if not recording
+ */
+static inline recorder_record_t *recorder_next(uint8_t type, uint8_t aux) {
+    if (recorderState != KG_SYSTEM_RECORDER_STATE_RECORDING && recorderState != KG_SYSTEM_RECORDER_STATE_TRIGGERED) return 0;
+    recorder_record_t *record = recorder + recorderHead;
+    recorderHead = (recorderHead + 1) & (KG_RECORDER_RECORDS - 1);
+    if (recorderCount < KG_RECORDER_RECORDS) recorderCount++;
+    if (recorderState == KG_SYSTEM_RECORDER_STATE_TRIGGERED && --recorderRemaining == 0) recorderState = KG_SYSTEM_RECORDER_STATE_STOPPED;
+    recorderTime = millis();
+    record -> time = recorderTime;
+    record -> type = type;
+    record -> aux = aux;
+    return record;
+}
+
+/**
+ * @brief Record a registered touch status change
+ * @param[in] mode Current touch mode
+ * @param[in] touches Registered touch status bits
+ */
+void recorder_touch(uint8_t mode, const uint8_t *touches) {
+    recorder_record_t *record = recorder_next(KG_SYSTEM_RECORDER_TYPE_TOUCH, mode);
+    if (record) memcpy(record -> data, touches, KG_BASE_COMBINATION_BYTES);
+}
+
+/**
+ * @brief Record one raw gyro sample
+ * @param[in] index Motion sensor index
+ * @param[in] x Raw gyro X value
+ * @param[in] y Raw gyro Y value
+ * @param[in] z Raw gyro Z value
+ */
+void recorder_motion(uint8_t index, int16_t x, int16_t y, int16_t z) {
+    recorder_record_t *record = recorder_next(KG_SYSTEM_RECORDER_TYPE_MOTION, index);
+    if (!record) return;
+    record -> data[0] = x & 0xFF;
+    record -> data[1] = x >> 8;
+    record -> data[2] = y & 0xFF;
+    record -> data[3] = y >> 8;
+    record -> data[4] = z & 0xFF;
+    record -> data[5] = z >> 8;
+    record -> data[6] = 0;
+    record -> data[7] = 0;
+}
+
+/**
+ * @brief Stop recording and start sending the recorded data
+ * @param[out] timestamp Full millis() timestamp of the newest record
+ * @return Number of records which will be sent
+ */
+uint16_t recorder_read(uint32_t *timestamp) {
+    if (recorderState != KG_SYSTEM_RECORDER_STATE_IDLE) recorderState = KG_SYSTEM_RECORDER_STATE_STOPPED;
+    recorderSent = 0;
+    recorderDownload = (recorderCount > 0);
+    *timestamp = recorderTime;
+    return recorderCount;
+}
+
+/**
+ * @brief Send the next piece of a download in progress, if any
+ */
+void update_recorder() {
+    if (!recorderDownload) return;
+
+    uint8_t payload[3 + (KG_RECORDER_CHUNK * sizeof(recorder_record_t))];
+    uint8_t oldest = (recorderHead - recorderCount) & (KG_RECORDER_RECORDS - 1);
+    uint8_t i, records = min(KG_RECORDER_CHUNK, (uint16_t)(recorderCount - recorderSent));
+    for (i = 0; i < records; i++) {
+        memcpy(payload + 3 + (i * sizeof(recorder_record_t)), recorder + ((oldest + recorderSent + i) & (KG_RECORDER_RECORDS - 1)), sizeof(recorder_record_t));
+    }
+    payload[0] = recorderSent & 0xFF;
+    payload[1] = (recorderSent >> 8) & 0xFF;
+    payload[2] = records * sizeof(recorder_record_t);
+
+    skipPacket = 0;
+    if (kg_evt_system_recorder_data) skipPacket = kg_evt_system_recorder_data(recorderSent, payload[2], payload + 3);
+    if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 3 + payload[2], KG_PACKET_CLASS_SYSTEM, KG_PACKET_ID_EVT_SYSTEM_RECORDER_DATA, payload);
+
+    recorderSent += records;
+    if (recorderSent >= recorderCount) recorderDownload = false;
+}
+
+#endif // KG_RECORDER > 0
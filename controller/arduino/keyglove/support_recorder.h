@@ -0,0 +1,93 @@
+// Keyglove controller source code - Flight recorder declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_recorder.h
+ * @brief Flight recorder declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * The flight recorder keeps the most recent touch status changes and raw gyro
+ * samples in a ring of fixed-size timestamped records in RAM, so there is
+ * something to look at when the glove misbehaves and no host was logging at
+ * the time. In triggered mode, a protocol error or motion sensor error stops
+ * recording a short while later, holding the lead-up to the problem until it
+ * is downloaded with the kg_cmd_system_read_recorder() command.
+ */
+
+#ifndef _SUPPORT_RECORDER_H_
+#define _SUPPORT_RECORDER_H_
+
+#include "support_board.h"
+
+#ifndef KG_RECORDER_RECORDS
+    #define KG_RECORDER_RECORDS         64          ///< Number of records kept in RAM (power of 2, 256 or less)
+#endif
+
+#ifndef KG_RECORDER_BOOT_MODE
+    #define KG_RECORDER_BOOT_MODE       KG_SYSTEM_RECORDER_MODE_TRIGGERED   ///< Recorder mode at power-up
+#endif
+
+#ifndef KG_RECORDER_BOOT_POST
+    #define KG_RECORDER_BOOT_POST       16          ///< Records kept after a trigger, at power-up
+#endif
+
+#define KG_RECORDER_DATA_SIZE           8           ///< Bytes of touch or motion data in each record
+
+#if (KG_RECORDER_RECORDS & (KG_RECORDER_RECORDS - 1)) || KG_RECORDER_RECORDS > 256
+    #error KG_RECORDER_RECORDS must be a power of 2 and no larger than 256
+#endif
+
+#if KG_BASE_COMBINATION_BYTES > KG_RECORDER_DATA_SIZE
+    #error Touch status does not fit in a flight recorder record
+#endif
+
+typedef struct {
+    uint16_t time;                          ///< Low 16 bits of millis() when recorded
+    uint8_t type;                           ///< Record type (touch or motion)
+    uint8_t aux;                            ///< Touch mode, or motion sensor index
+    uint8_t data[KG_RECORDER_DATA_SIZE];    ///< Touch status bits, or raw gyro X/Y/Z (int16 each)
+} recorder_record_t;
+
+#define KG_RECORDER_CHUNK               (247 / sizeof(recorder_record_t))  ///< Records in each kg_evt_system_recorder_data() event (fills a 250-byte payload)
+
+extern uint8_t recorderMode;
+extern uint8_t recorderState;
+extern uint8_t recorderTrigger;
+extern uint16_t recorderCount;
+extern uint16_t recorderPost;
+
+void setup_recorder();
+void recorder_start(uint8_t mode, uint16_t post);
+void recorder_trigger(uint8_t source);
+void recorder_touch(uint8_t mode, const uint8_t *touches);
+void recorder_motion(uint8_t index, int16_t x, int16_t y, int16_t z);
+uint16_t recorder_read(uint32_t *timestamp);
+void update_recorder();
+
+#endif // _SUPPORT_RECORDER_H_
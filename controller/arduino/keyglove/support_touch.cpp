@@ -41,6 +41,10 @@ THE SOFTWARE.
 #include "support_board.h"
 #include "support_protocol.h"
 #include "support_touch.h"
+#include "support_touchset.h"
+#include "support_touchgesture.h"
+#include "support_touchstats.h"
+#include "support_recorder.h"
 
 uint8_t touchMode;          ///< Touch mode
 //uint32_t touchBench;        ///< Touch benchmark reference end
@@ -49,12 +53,29 @@ uint8_t touchTick;          ///< Touch tick reference
 uint8_t touchOn;            ///< Indicates whether any touches are active
 
 uint16_t opt_touch_detect_threshold = 10;   ///< OPTION: Milliseconds required for a touch to register as legitimate
+uint8_t opt_touch_samples = 1;              ///< OPTION: Reads per port for majority-vote oversampling (1, 3, 5, or 7; 1 disables)
+uint16_t opt_touch_idle_timeout = 5;        ///< OPTION: Seconds without contact before dropping to idle scan rate (0 never idles)
+uint8_t opt_touch_idle_interval = 10;       ///< OPTION: 10ms ticks between scans at idle scan rate
+uint16_t opt_touch_burst_interval = 1000;   ///< OPTION: Microseconds between scans at burst scan rate
+uint16_t opt_touch_burst_timeout = 500;     ///< OPTION: Milliseconds after last contact before dropping from burst to normal scan rate
+uint8_t opt_touch_ghost_mode = KG_TOUCH_GHOST_MODE_REPORT;  ///< OPTION: Ghost combination handling (off, report, or mask)
 
 uint32_t touchTime;                         ///< Touch detection reference timestamp
+uint8_t touchNoise;                         ///< Sensor pins which disagreed between oversampled reads during the current scan
+
+uint8_t touchScanRate;                      ///< Current adaptive scan rate
+uint8_t touchScanIdleTicks;                 ///< 10ms ticks since last scan at idle scan rate
+uint32_t touchScanTime;                     ///< Start of last scan (microseconds)
+uint32_t touchScanActivityTime;             ///< Last scan with any contact (milliseconds)
+uint32_t touchScanRateTime;                 ///< Time when current scan rate started (milliseconds)
+uint32_t touchScanCount[3];                 ///< Total number of scans at each scan rate
+uint32_t touchScanDuration[3];              ///< Total time spent at each scan rate, not including current period (milliseconds)
 
 uint8_t touches_now[KG_BASE_COMBINATION_BYTES];     ///< Immediate status of all touch combinations
 uint8_t touches_verify[KG_BASE_COMBINATION_BYTES];  ///< Previous status of all touch combinations (debouncing in progress)
 uint8_t touches_active[KG_BASE_COMBINATION_BYTES];  ///< Registered (debounced) status of all touch combinations
+uint8_t touches_ghost[KG_BASE_COMBINATION_BYTES];   ///< Immediate ambiguous (possible ghost) combinations
+uint8_t touches_ambiguous[KG_BASE_COMBINATION_BYTES];   ///< Registered ambiguous (possible ghost) combinations
 
 uint8_t touchModeStack[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };    ///< Stackable touch mode tracking info
 uint8_t touchModeStackPos = 0;                                  ///< Current position in mode stack
@@ -65,26 +86,100 @@ uint8_t touchModeStackPos = 0;                                  ///< Current pos
 void setup_touch() {
     touchMode = 0; // set to base mode, no alternates
     touch_set_mode(0); // default touchset mode is always 0
+
+    // start at normal scan rate, idle timeout counts from boot
+    touchScanRate = KG_TOUCH_SCAN_RATE_NORMAL;
+    touchScanActivityTime = touchScanRateTime = millis();
+}
+
+/**
+ * @brief Check whether a touch scan is due at the current adaptive scan rate, called from loop()
+ * @param[in] tick Non-zero if called for a 100Hz tick, zero if called between ticks
+ * @return Non-zero if update_touch() should be called now
+ */
+uint8_t touch_scan_due(uint8_t tick) {
+    if (touchScanRate == KG_TOUCH_SCAN_RATE_BURST) {
+        return (uint32_t)(micros() - touchScanTime) >= opt_touch_burst_interval;
+    } else if (!tick) {
+        return 0;
+    } else if (touchScanRate == KG_TOUCH_SCAN_RATE_IDLE && ++touchScanIdleTicks < opt_touch_idle_interval) {
+        return 0;
+    }
+    touchScanIdleTicks = 0;
+    return 1;
+}
+
+/**
+ * @brief Switch to a new adaptive scan rate
+ * @param[in] rate New scan rate
+ */
+void touch_set_scan_rate(uint8_t rate) {
+    uint32_t now = millis();
+    touchScanDuration[touchScanRate] += now - touchScanRateTime;
+    touchScanRateTime = now;
+    touchScanRate = rate;
+    touchScanIdleTicks = 0;
+}
+
+/**
+ * @brief Get scan count and total time for one adaptive scan rate
+ * @param[in] rate Scan rate to report
+ * @param[out] scans Total number of scans at this rate
+ * @param[out] duration Total time spent at this rate, including current period (milliseconds)
+ */
+void touch_get_scan_stats(uint8_t rate, uint32_t *scans, uint32_t *duration) {
+    *scans = touchScanCount[rate];
+    *duration = touchScanDuration[rate];
+    if (rate == touchScanRate) *duration += millis() - touchScanRateTime;
 }
 
 /**
- * @brief Update status of touch system, called at 100Hz (or constantly while touches active) from loop()
+ * @brief Update status of touch system, called from loop() whenever touch_scan_due() allows
+ *
+ * The scan rate adapts to activity. Any contact, even before debouncing,
+ * switches to the burst rate (opt_touch_burst_interval). Once all contacts
+ * are released for opt_touch_burst_timeout, scanning drops back to the
+ * normal 100Hz tick, and after opt_touch_idle_timeout with no contact it
+ * backs off to once every opt_touch_idle_interval ticks.
  */
 void update_touch() {
     //touchBench0 = micros();
 
-    uint8_t i;
+    uint8_t i, clean, contact;
     memset(touches_now, 0x00, KG_BASE_COMBINATION_BYTES);
+    touchNoise = 0;
+    touchScanTime = micros();
+    touchScanCount[touchScanRate]++;
 
     // loop through every registered 1-to-1 sensor combination and record levels
     // (moved to hardware-specific code for efficiency, improved iteration time from 2ms to 40us SERIOUSLY OMG)
     update_board_touch(touches_now);
 
+    // detect combinations that may only be implied by other contacts
+    if (opt_touch_ghost_mode != KG_TOUCH_GHOST_MODE_OFF) touch_resolve_ghosts(touches_now, touches_ghost);
+
+    // adjust scan rate based on raw contact state
+    contact = 0;
+    for (i = 0; i < KG_BASE_COMBINATION_BYTES && !contact; i++) contact |= touches_now[i];
+    if (contact) {
+        touchScanActivityTime = millis();
+        if (touchScanRate != KG_TOUCH_SCAN_RATE_BURST) touch_set_scan_rate(KG_TOUCH_SCAN_RATE_BURST);
+    } else if (touchScanRate == KG_TOUCH_SCAN_RATE_BURST && millis() - touchScanActivityTime >= opt_touch_burst_timeout) {
+        touch_set_scan_rate(KG_TOUCH_SCAN_RATE_NORMAL);
+    } else if (touchScanRate == KG_TOUCH_SCAN_RATE_NORMAL && opt_touch_idle_timeout && millis() - touchScanActivityTime >= (uint32_t)opt_touch_idle_timeout * 1000) {
+        touch_set_scan_rate(KG_TOUCH_SCAN_RATE_IDLE);
+    }
+
+    // oversampled scan where every read agreed on every sensor pin doesn't need to wait out the
+    // threshold, but still has to match the scan before it so that one glitch or bounce caught
+    // by a single scan isn't registered (the next scan is only a burst interval away)
+    clean = (opt_touch_samples > 1 && !touchNoise);
+
     // check to see if we need to reset detection threshold
     if (memcmp(touches_now, touches_verify, KG_BASE_COMBINATION_BYTES) != 0) {
         // current sensors different from last detection, so reset threshold
         touchTime = millis();
-    } else if (memcmp(touches_verify, touches_active, KG_BASE_COMBINATION_BYTES) != 0 && millis() - touchTime >= opt_touch_detect_threshold) {
+    } else if (memcmp(touches_verify, touches_active, KG_BASE_COMBINATION_BYTES) != 0 && (clean || millis() - touchTime >= opt_touch_detect_threshold)) {
         // detection is over threshold and current readings are different from previous readings
 
         // set official sensor readings to current readings
@@ -94,6 +189,26 @@ void update_touch() {
         touchOn = 0;
         for (i = 0; i < KG_BASE_COMBINATION_BYTES && !touchOn; i++) touchOn |= touches_active[i];
 
+        #if (KG_TOUCHSET > 0)
+            // run any touchset actions for the new chord
+            touchset_process(touches_active);
+        #endif
+
+        #if (KG_TOUCHGESTURE > 0)
+            // start or stop gesture timers for changed combinations
+            touchgesture_process(touches_active);
+        #endif
+
+        #if (KG_TOUCHSTATS > 0)
+            // count presses, hold time, and pairs for changed combinations
+            touchstats_process(touches_active);
+        #endif
+
+        #if (KG_RECORDER > 0)
+            // keep the new status in the flight recorder
+            recorder_touch(touchMode, touches_active);
+        #endif
+
         // build event (uint8_t index, uint8_t[] touches)
         uint8_t payload[KG_BASE_COMBINATION_BYTES + 1];
         payload[0] = KG_BASE_COMBINATION_BYTES;
@@ -103,6 +218,15 @@ void update_touch() {
         skipPacket = 0;
         if (kg_evt_touch_status) skipPacket = kg_evt_touch_status(payload[0], payload + 1);
         if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, sizeof(payload), KG_PACKET_CLASS_TOUCH, KG_PACKET_ID_EVT_TOUCH_STATUS, payload);
+
+        // report change in ambiguous combinations, if any
+        if (opt_touch_ghost_mode != KG_TOUCH_GHOST_MODE_OFF && memcmp(touches_ghost, touches_ambiguous, KG_BASE_COMBINATION_BYTES) != 0) {
+            memcpy(touches_ambiguous, touches_ghost, KG_BASE_COMBINATION_BYTES);
+            memcpy(payload + 1, touches_ambiguous, KG_BASE_COMBINATION_BYTES);
+            skipPacket = 0;
+            if (kg_evt_touch_ambiguous) skipPacket = kg_evt_touch_ambiguous(payload[0], payload + 1);
+            if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, sizeof(payload), KG_PACKET_CLASS_TOUCH, KG_PACKET_ID_EVT_TOUCH_AMBIGUOUS, payload);
+        }
     }
 
     // set "verify" readings to match "now" readings (debouncing)
@@ -120,6 +244,75 @@ void update_touch() {
     }*/
 }
 
+/**
+ * @brief Find combinations that may be ghosts of other contacts
+ * @param[in,out] touches Touch status bits from the latest scan
+ * @param[out] ghosts Combinations which cannot be told apart from ghosts
+ *
+ * Checks each board-specific triangle of combinations (see
+ * boardGhostTriangles). When all three are active, one of them may be a
+ * ghost, but it is not possible to tell which from the scan: closing the
+ * second real contact always brings the ghost along in the same scan, so
+ * there is no order to go by either. In KG_TOUCH_GHOST_MODE_REPORT, all
+ * three are reported as ambiguous. In KG_TOUCH_GHOST_MODE_MASK, the side
+ * that is not registered yet is removed if the other two are, and otherwise
+ * the last side in the board's table (the one least likely to be pressed on
+ * purpose) is removed, unless it was already registered by itself, in which
+ * case the triangle is reported as ambiguous instead.
+ */
+void touch_resolve_ghosts(uint8_t *touches, uint8_t *ghosts) {
+    uint8_t i, j, index[3], present, known;
+    memset(ghosts, 0x00, KG_BASE_COMBINATION_BYTES);
+    for (i = 0; i < KG_GHOST_TRIANGLES; i++) {
+        present = known = 0;
+        for (j = 0; j < 3; j++) {
+            index[j] = pgm_read_byte(&boardGhostTriangles[i][j]);
+            if (KGT_BIT(touches, index[j])) present++;
+            if (KGT_BIT(touches_active, index[j])) known++;
+        }
+        if (present < 3) continue;
+        if (opt_touch_ghost_mode == KG_TOUCH_GHOST_MODE_MASK && (known == 2 || !KGT_BIT(touches_active, index[2]))) {
+            // drop the unregistered side if there is only one, or else the board's preferred ghost
+            j = 2;
+            if (known == 2) for (j = 0; KGT_BIT(touches_active, index[j]); j++);
+            touches[index[j] >> 3] &= ~(1 << (index[j] & 7));
+            continue;
+        }
+        for (j = 0; j < 3; j++) ghosts[index[j] >> 3] |= (1 << (index[j] & 7));
+    }
+}
+
+/**
+ * @brief Read a touch sensor port several times and take the bitwise majority
+ * @param[in] port Port input register
+ * @param[in] mask Touch sensor pins on this port
+ * @return Majority logic state of each pin
+ *
+ * Each read is added into a 3-bit counter per pin, stored as three bit-sliced
+ * bytes, so all eight pins are counted in parallel without branching. Pins
+ * within the mask that did not read the same every time are recorded in
+ * touchNoise.
+ */
+uint8_t touch_sample_port(volatile uint8_t *port, uint8_t mask) {
+    uint8_t i, x, carry;
+    uint8_t c0 = 0, c1 = 0, c2 = 0, any = 0x00, all = 0xFF;
+    for (i = opt_touch_samples; i; i--) {
+        x = *port;
+        any |= x;
+        all &= x;
+        carry = c0 & x;
+        c0 ^= x;
+        c2 |= c1 & carry;
+        c1 ^= carry;
+    }
+    touchNoise |= (any ^ all) & mask;
+
+    // count >= (samples + 1) / 2
+    if (opt_touch_samples == 3) return c2 | c1;
+    if (opt_touch_samples == 5) return c2 | (c1 & c0);
+    return c2;
+}
+
 // declare these here so touch_set_mode() etc. have some context
 //void activate_mode(uint8_t mode) { }
 //void deactivate_mode(uint8_t mode) { }
@@ -136,6 +329,32 @@ uint8_t touch_check_mode(uint8_t mode, uint8_t pos) {
     return touchModeStack[touchModeStackPos - pos] == mode;
 }
 
+/**
+ * @brief Update touch mode after any change to the mode stack
+ *
+ * Tracks the topmost stack entry as the current touch mode, marks the touchset
+ * lookup table for rebuild, and sends kg_evt_touch_mode() if the mode changed.
+ */
+void touch_mode_changed() {
+    uint8_t mode = touchModeStack[touchModeStackPos - 1];
+
+    #if (KG_TOUCHSET > 0)
+        // touchset engine flattens stacked modes, so it needs to know
+        touchset_invalidate();
+    #endif
+
+    if (mode != touchMode) {
+        touchMode = mode;
+
+        // send kg_evt_touch_mode(uint8_t mode)
+        if (!inBinPacket) {
+            skipPacket = 0;
+            if (kg_evt_touch_mode) skipPacket = kg_evt_touch_mode(touchMode);
+            if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 1, KG_PACKET_CLASS_TOUCH, KG_PACKET_ID_EVT_TOUCH_MODE, &touchMode);
+        }
+    }
+}
+
 /**
  * @brief Set new active touch mode (replaces everything in mode stack)
  * @param[in] mode New mode to set
@@ -145,6 +364,7 @@ void touch_set_mode(uint8_t mode) {
     touchModeStackPos = 1;
     touchModeStack[0] = mode;
     //activate_mode(mode);
+    touch_mode_changed();
 }
 
 /**
@@ -156,6 +376,7 @@ void touch_push_mode(uint8_t mode) {
         touchModeStack[touchModeStackPos] = mode;
         touchModeStackPos++;
         //activate_mode(mode);
+        touch_mode_changed();
     }
 }
 
@@ -166,6 +387,7 @@ void touch_pop_mode() {
     if (touchModeStackPos > 0) touchModeStackPos--; //deactivate_mode(touchModeStack[--touchModeStackPos]);
     if (touchModeStackPos == 0) touchModeStack[touchModeStackPos++] = 0;
     //activate_mode(touchModeStack[touchModeStackPos - 1]);
+    touch_mode_changed();
 }
 
 /**
@@ -181,6 +403,8 @@ void touch_toggle_mode(uint8_t mode) {
         //deactivate_mode(mode);
         for (i++; i < touchModeStackPos; i++) touchModeStack[i - 1] = touchModeStack[i];
         touchModeStackPos--;
+        if (touchModeStackPos == 0) touchModeStack[touchModeStackPos++] = 0;
+        touch_mode_changed();
     } else {
         // not enabled, so turn it on
         touch_push_mode(mode);
@@ -37,6 +37,13 @@ THE SOFTWARE.
 
 #include "support_board.h"
 
+/**
+ * @brief Read touch sensor port, with majority-vote oversampling if enabled
+ * @param[in] port Port input register (e.g. PINB)
+ * @param[in] mask Touch sensor pins on this port
+ */
+#define KG_TOUCH_READ(port, mask) (opt_touch_samples > 1 ? touch_sample_port(&(port), mask) : (port))
+
 void touch_set_mode(uint8_t mode);
 
 extern uint8_t touchMode;
@@ -44,14 +51,35 @@ extern uint8_t touchTick;
 extern uint8_t touchOn;
 
 extern uint32_t touchTime;
+extern uint8_t touchNoise;
+
+extern uint8_t opt_touch_samples;
+extern uint16_t opt_touch_idle_timeout;
+extern uint8_t opt_touch_idle_interval;
+extern uint16_t opt_touch_burst_interval;
+extern uint16_t opt_touch_burst_timeout;
+extern uint8_t opt_touch_ghost_mode;
+
+extern uint8_t touchScanRate;
 
 extern uint8_t touches_now[KG_BASE_COMBINATION_BYTES];
 extern uint8_t touches_verify[KG_BASE_COMBINATION_BYTES];
 extern uint8_t touches_active[KG_BASE_COMBINATION_BYTES];
+extern uint8_t touches_ghost[KG_BASE_COMBINATION_BYTES];
+extern uint8_t touches_ambiguous[KG_BASE_COMBINATION_BYTES];
+
+extern uint8_t touchModeStack[10];
+extern uint8_t touchModeStackPos;
 
 void setup_touch();
 void update_touch();
+uint8_t touch_scan_due(uint8_t tick);
+void touch_set_scan_rate(uint8_t rate);
+void touch_get_scan_stats(uint8_t rate, uint32_t *scans, uint32_t *duration);
+uint8_t touch_sample_port(volatile uint8_t *port, uint8_t mask);
+void touch_resolve_ghosts(uint8_t *touches, uint8_t *ghosts);
 uint8_t touch_check_mode(uint8_t mode, uint8_t pos);
+void touch_mode_changed();
 void touch_set_mode(uint8_t mode);
 void touch_push_mode(uint8_t mode);
 void touch_pop_mode();
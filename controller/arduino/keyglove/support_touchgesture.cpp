@@ -0,0 +1,225 @@
+// Keyglove controller source code - Touch gesture (tap/hold timing) engine implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file support_touchgesture.cpp
+ * @brief Touch gesture (tap/hold timing) engine implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Each base combination has a small state machine with at most one pending
+ * timer. Pending timers live in a hashed timer wheel with one slot per 10ms
+ * tick, linked through the per-combination timer array, so each tick only
+ * visits timers in a single slot instead of polling every combination.
+ * Starting and cancelling a timer are constant-time list operations.
+ *
+ * A tap is reported only after the multi-tap gap passes with no second press,
+ * so set opt_touch_multi_tap_time to 0 to report taps immediately on release
+ * if double-taps are not needed.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touchgesture.h"
+
+// only built when enabled, since the gesture event is only declared then
+#if (KG_TOUCHGESTURE > 0)
+
+uint16_t opt_touch_tap_time = 200;          ///< OPTION: Maximum press duration in milliseconds for a tap
+uint16_t opt_touch_hold_time = 500;         ///< OPTION: Press duration in milliseconds before a hold is reported
+uint16_t opt_touch_long_press_time = 1500;  ///< OPTION: Press duration in milliseconds before a long press is reported
+uint16_t opt_touch_multi_tap_time = 250;    ///< OPTION: Maximum gap in milliseconds between taps for a double-tap
+
+uint16_t touchgestureTick;                                              ///< Current timer wheel tick (10ms each)
+uint8_t touchgestureWheel[KG_TOUCHGESTURE_WHEEL_SLOTS];                 ///< First combination in each timer wheel slot
+touchgesture_timer_t touchgestureTimer[KG_BASE_COMBINATIONS];           ///< Gesture timer and state for each base combination
+uint8_t touchgesturePrev[KG_BASE_COMBINATION_BYTES];                    ///< Touch status bits from the previous call to touchgesture_process()
+
+/**
+ * @brief Initialize touch gesture engine
+ */
+void setup_touchgesture() {
+    uint8_t i;
+    touchgestureTick = 0;
+    memset(touchgestureWheel, KG_TOUCHGESTURE_TIMER_NONE, KG_TOUCHGESTURE_WHEEL_SLOTS);
+    for (i = 0; i < KG_BASE_COMBINATIONS; i++) touchgestureTimer[i].state = KG_TOUCHGESTURE_STATE_IDLE;
+    memset(touchgesturePrev, 0, KG_BASE_COMBINATION_BYTES);
+}
+
+/**
+ * @brief Convert a millisecond threshold into a number of timer wheel ticks
+ * @param[in] ms Threshold in milliseconds
+ * @return Number of ticks (at least 1)
+ */
+uint16_t touchgesture_ticks(uint16_t ms) {
+    ms = (ms + 5) / 10;
+    return ms ? ms : 1;
+}
+
+/**
+ * @brief Start timer for a combination (must not already be running)
+ * @param[in] index Base combination index
+ * @param[in] ticks Number of ticks until timer expires
+ */
+void touchgesture_start(uint8_t index, uint16_t ticks) {
+    uint8_t slot;
+    touchgestureTimer[index].deadline = touchgestureTick + ticks;
+    slot = touchgestureTimer[index].deadline & (KG_TOUCHGESTURE_WHEEL_SLOTS - 1);
+    touchgestureTimer[index].prev = KG_TOUCHGESTURE_TIMER_NONE;
+    touchgestureTimer[index].next = touchgestureWheel[slot];
+    if (touchgestureWheel[slot] != KG_TOUCHGESTURE_TIMER_NONE) touchgestureTimer[touchgestureWheel[slot]].prev = index;
+    touchgestureWheel[slot] = index;
+}
+
+/**
+ * @brief Stop timer for a combination (must be running)
+ * @param[in] index Base combination index
+ */
+void touchgesture_stop(uint8_t index) {
+    touchgesture_timer_t *timer = &touchgestureTimer[index];
+    if (timer -> prev == KG_TOUCHGESTURE_TIMER_NONE) {
+        touchgestureWheel[timer -> deadline & (KG_TOUCHGESTURE_WHEEL_SLOTS - 1)] = timer -> next;
+    } else {
+        touchgestureTimer[timer -> prev].next = timer -> next;
+    }
+    if (timer -> next != KG_TOUCHGESTURE_TIMER_NONE) touchgestureTimer[timer -> next].prev = timer -> prev;
+}
+
+/**
+ * @brief Send touch gesture event
+ * @param[in] index Base combination index
+ * @param[in] gesture Gesture type
+ */
+void touchgesture_send(uint8_t index, uint8_t gesture) {
+    // send kg_evt_touch_gesture(uint8_t combination, uint8_t gesture)
+    uint8_t payload[2] = { index, gesture };
+    skipPacket = 0;
+    if (kg_evt_touch_gesture) skipPacket = kg_evt_touch_gesture(index, gesture);
+    if (!skipPacket) send_keyglove_packet(KG_PACKET_TYPE_EVENT, 2, KG_PACKET_CLASS_TOUCH, KG_PACKET_ID_EVT_TOUCH_GESTURE, payload);
+}
+
+/**
+ * @brief Handle expired timer for a combination
+ * @param[in] index Base combination index
+ */
+void touchgesture_expire(uint8_t index) {
+    touchgesture_timer_t *timer = &touchgestureTimer[index];
+    switch (timer -> state) {
+        case KG_TOUCHGESTURE_STATE_SECOND:
+            // second press held too long for a double-tap, so first one was a plain tap
+            touchgesture_send(index, KG_TOUCH_GESTURE_TAP);
+            // fall through, second press continues as a normal press
+        case KG_TOUCHGESTURE_STATE_PRESSED:
+            timer -> state = KG_TOUCHGESTURE_STATE_PRESSING;
+            touchgesture_start(index, opt_touch_hold_time > opt_touch_tap_time ? touchgesture_ticks(opt_touch_hold_time - opt_touch_tap_time) : 1);
+            break;
+        case KG_TOUCHGESTURE_STATE_PRESSING:
+            timer -> state = KG_TOUCHGESTURE_STATE_HELD;
+            touchgesture_send(index, KG_TOUCH_GESTURE_HOLD);
+            touchgesture_start(index, opt_touch_long_press_time > opt_touch_hold_time ? touchgesture_ticks(opt_touch_long_press_time - opt_touch_hold_time) : 1);
+            break;
+        case KG_TOUCHGESTURE_STATE_HELD:
+            timer -> state = KG_TOUCHGESTURE_STATE_LONG;
+            touchgesture_send(index, KG_TOUCH_GESTURE_LONG_PRESS);
+            break;
+        case KG_TOUCHGESTURE_STATE_TAP_WAIT:
+            timer -> state = KG_TOUCHGESTURE_STATE_IDLE;
+            touchgesture_send(index, KG_TOUCH_GESTURE_TAP);
+            break;
+    }
+}
+
+/**
+ * @brief Advance timer wheel by one tick, called at 100Hz from loop()
+ *
+ * Only timers linked into the current slot are visited. Timers which are a
+ * whole wheel revolution or more away stay in place until their tick comes.
+ */
+void update_touchgesture() {
+    uint8_t index, next;
+    touchgestureTick++;
+    for (index = touchgestureWheel[touchgestureTick & (KG_TOUCHGESTURE_WHEEL_SLOTS - 1)]; index != KG_TOUCHGESTURE_TIMER_NONE; index = next) {
+        next = touchgestureTimer[index].next;
+        if (touchgestureTimer[index].deadline == touchgestureTick) {
+            touchgesture_stop(index);
+            touchgesture_expire(index);
+        }
+    }
+}
+
+/**
+ * @brief Process a change in debounced touch status
+ * @param[in] touches New touch status bits
+ *
+ * Called from update_touch() whenever the registered touch status changes.
+ * Only bits which differ from the previous status are examined.
+ */
+void touchgesture_process(const uint8_t *touches) {
+    uint8_t i, j, index, diff;
+    touchgesture_timer_t *timer;
+
+    for (i = 0; i < KG_BASE_COMBINATION_BYTES; i++) {
+        diff = touchgesturePrev[i] ^ touches[i];
+        if (!diff) continue;
+        for (j = 0; j < 8; j++) {
+            if (!(diff & (1 << j))) continue;
+            index = (i << 3) + j;
+            timer = &touchgestureTimer[index];
+            if (touches[i] & (1 << j)) {
+                // press
+                if (timer -> state == KG_TOUCHGESTURE_STATE_TAP_WAIT) {
+                    touchgesture_stop(index);
+                    timer -> state = KG_TOUCHGESTURE_STATE_SECOND;
+                } else {
+                    timer -> state = KG_TOUCHGESTURE_STATE_PRESSED;
+                }
+                touchgesture_start(index, touchgesture_ticks(opt_touch_tap_time));
+            } else {
+                // release
+                if (timer -> state != KG_TOUCHGESTURE_STATE_LONG) touchgesture_stop(index);
+                if (timer -> state == KG_TOUCHGESTURE_STATE_SECOND) {
+                    touchgesture_send(index, KG_TOUCH_GESTURE_DOUBLE_TAP);
+                    timer -> state = KG_TOUCHGESTURE_STATE_IDLE;
+                } else if (timer -> state == KG_TOUCHGESTURE_STATE_PRESSED && opt_touch_multi_tap_time) {
+                    timer -> state = KG_TOUCHGESTURE_STATE_TAP_WAIT;
+                    touchgesture_start(index, touchgesture_ticks(opt_touch_multi_tap_time));
+                } else {
+                    if (timer -> state == KG_TOUCHGESTURE_STATE_PRESSED) touchgesture_send(index, KG_TOUCH_GESTURE_TAP);
+                    timer -> state = KG_TOUCHGESTURE_STATE_IDLE;
+                }
+            }
+        }
+        touchgesturePrev[i] = touches[i];
+    }
+}
+
+#endif // KG_TOUCHGESTURE > 0
@@ -0,0 +1,81 @@
+// Keyglove controller source code - Touch gesture (tap/hold timing) engine declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_touchgesture.h
+ * @brief Touch gesture (tap/hold timing) engine declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * The gesture engine timestamps the press and release of each base touch
+ * combination and classifies it as a tap, double-tap, hold, or long press,
+ * reported with the kg_evt_touch_gesture() event. Thresholds are set in
+ * milliseconds and rounded to 10ms ticks.
+ */
+
+#ifndef _SUPPORT_TOUCHGESTURE_H_
+#define _SUPPORT_TOUCHGESTURE_H_
+
+#include "support_board.h"
+
+#define KG_TOUCHGESTURE_WHEEL_SLOTS     32          ///< Timer wheel slots, one per 10ms tick (power of 2)
+#define KG_TOUCHGESTURE_TIMER_NONE      0xFF        ///< Empty timer wheel link
+
+/**
+ * @brief List of possible per-combination gesture states
+ */
+typedef enum {
+    KG_TOUCHGESTURE_STATE_IDLE = 0,         ///< (0) Not active, no timer
+    KG_TOUCHGESTURE_STATE_PRESSED,          ///< (1) Active for less than tap threshold, timer = tap
+    KG_TOUCHGESTURE_STATE_PRESSING,         ///< (2) Active past tap threshold, timer = hold
+    KG_TOUCHGESTURE_STATE_HELD,             ///< (3) Hold reported, timer = long press
+    KG_TOUCHGESTURE_STATE_LONG,             ///< (4) Long press reported, no timer
+    KG_TOUCHGESTURE_STATE_TAP_WAIT,         ///< (5) Released after a tap, timer = multi-tap gap
+    KG_TOUCHGESTURE_STATE_SECOND,           ///< (6) Pressed again within multi-tap gap, timer = tap
+} touchgesture_state_t;
+
+/**
+ * @brief Per-combination gesture timer (5 bytes)
+ */
+typedef struct {
+    uint16_t deadline;                      ///< Tick at which the timer expires
+    uint8_t next;                           ///< Next combination in same wheel slot (or KG_TOUCHGESTURE_TIMER_NONE)
+    uint8_t prev;                           ///< Previous combination in same wheel slot (or KG_TOUCHGESTURE_TIMER_NONE if first)
+    uint8_t state;                          ///< Current gesture state
+} touchgesture_timer_t;
+
+extern uint16_t opt_touch_tap_time;
+extern uint16_t opt_touch_hold_time;
+extern uint16_t opt_touch_long_press_time;
+extern uint16_t opt_touch_multi_tap_time;
+
+void setup_touchgesture();
+void update_touchgesture();
+void touchgesture_process(const uint8_t *touches);
+
+#endif // _SUPPORT_TOUCHGESTURE_H_
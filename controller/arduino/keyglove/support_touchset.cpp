@@ -0,0 +1,719 @@
+// Keyglove controller source code - Touchset (chord map) engine implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_touchset.cpp
+ * @brief Touchset (chord map) engine implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * The engine keeps the currently active chord as a sorted list of base
+ * combination indexes, updated only for the bits that changed since the last
+ * debounced touch status. Each change releases the previous chord and presses
+ * the new one. The topmost mode on the touch mode stack that defines a chord
+ * owns it until it is released, so a chord that pushes a new mode still runs
+ * its release actions from the mode that handled the press.
+ *
+ * Chord ownership is resolved through a small set-associative cache, which
+ * is emptied whenever the stack or the table changes. The first time a chord
+ * is looked up, each mode on the stack is searched from the top, and the
+ * result (including "no mode defines it") is cached, so later lookups cost
+ * one hash probe no matter how many modes are stacked. The cache only holds
+ * chords which are actually played, so its size does not limit the layout.
+ *
+ * The active table is either a RAM table, compiled at boot by the application
+ * or built with KGAPI commands, or a compiled touchset uploaded over KGAPI and
+ * stored in EEPROM. A valid stored touchset takes priority, and is read in
+ * place so it costs no RAM and no boot-time parsing.
+ *
+ * Normally it is not necessary to edit this file. Define your own touchset in
+ * the setup_application() function using touchset_compile(), or upload one
+ * with the "kgtouchset.py" host tool.
+ */
+
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touch.h"
+#include "support_touchset.h"
+#if (KG_FEEDBACK > 0)
+    #include "support_feedback.h"
+#endif
+#if (KG_MOTION > 0)
+    #include "support_motion.h"
+#endif
+#if (KG_HID & KG_HID_KEYBOARD)
+    #include "support_hid_keyboard.h"
+#endif
+#if (KG_HID & KG_HID_MOUSE)
+    #include "support_hid_mouse.h"
+#endif
+
+#if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+    touchset_entry_t touchsetTable[KG_TOUCHSET_RAM_ENTRIES];   ///< Sorted RAM touchset entry table
+    uint16_t touchsetRamCount;                              ///< Number of entries in RAM touchset table
+#endif
+
+#if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+    touchset_header_t touchsetHeader;                       ///< Copy of stored EEPROM touchset header (valid if magic matches)
+    uint8_t touchsetUploading;                              ///< EEPROM touchset upload state (KG_TOUCHSET_UPLOAD_*)
+    uint16_t touchsetUploadCount;                           ///< Number of entries expected in current EEPROM upload
+    uint16_t touchsetUploadOffset;                          ///< Byte offset of next expected chunk in current EEPROM upload
+    uint16_t touchsetUploadCrc;                             ///< Running CRC16 (XMODEM) of received entry data
+    uint8_t touchsetUploadError;                            ///< Indicates that received entry data is invalid or out of order
+    touchset_entry_t touchsetUploadEntry;                   ///< Entry being assembled from received data
+    uint8_t touchsetUploadPrev[4];                          ///< Sort key of last complete received entry
+
+    uint8_t touchsetWriteBuffer[KG_TOUCHSET_WRITE_BUFFER];  ///< Data waiting to be written into EEPROM
+    uint8_t *touchsetWriteAddress;                          ///< EEPROM address of first buffered byte
+    uint8_t touchsetWriteLength;                            ///< Number of bytes in write buffer
+    uint8_t touchsetWritePos;                               ///< Number of buffered bytes already written
+#endif
+
+uint8_t touchsetSource;                                     ///< Active touchset table source (KG_TOUCHSET_NONE, _RAM, or _EEPROM)
+uint16_t touchsetCount;                                     ///< Number of entries in active touchset table
+uint8_t touchsetChordMode;                                  ///< Mode which owns the active chord (or KG_TOUCHSET_MODE_NONE)
+uint16_t touchsetChordIndex;                                ///< Table index of first entry for the active chord in its owning mode
+
+touchset_effective_t touchsetEffective[KG_TOUCHSET_EFFECTIVE_SLOTS];    ///< Chord lookup cache for the current mode stack
+uint8_t touchsetEffectiveDirty;                             ///< Indicates that the chord lookup cache must be emptied
+uint8_t touchsetEffectiveNext;                              ///< Way to replace next when a chord lookup cache set is full
+
+uint8_t opt_touchset_feedback_duration = 10;                ///< OPTION: Duration in 10ms units of piezo/vibrate actions (0 to run forever)
+
+uint8_t touchsetPrev[KG_BASE_COMBINATION_BYTES];            ///< Touch status from last processed change
+uint8_t touchsetChord[KG_TOUCHSET_CHORD_MAX];               ///< Sorted list of active base combination indexes
+uint8_t touchsetChordSize;                                  ///< Number of valid indexes in touchsetChord
+uint8_t touchsetActiveCount;                                ///< Total number of active base combinations (may exceed chord size)
+
+/**
+ * @brief Initialize touchset engine
+ *
+ * If a valid touchset is stored in EEPROM, it is used directly without being
+ * copied or parsed beyond the header check (the CRC and sort order are
+ * verified once, while the upload arrives). Otherwise, the RAM table starts
+ * empty and may be filled by the application.
+ */
+void setup_touchset() {
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        touchsetRamCount = 0;
+    #endif
+    #if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+        touchsetUploading = KG_TOUCHSET_UPLOAD_IDLE;
+        touchsetWriteLength = touchsetWritePos = 0;
+        eeprom_read_block(&touchsetHeader, (const void *)KG_TOUCHSET_EEPROM_ADDRESS, sizeof(touchset_header_t));
+        if (touchsetHeader.version != KG_TOUCHSET_EEPROM_VERSION
+            || touchsetHeader.entry_size != sizeof(touchset_entry_t)
+            || touchsetHeader.count > KG_TOUCHSET_EEPROM_ENTRIES) {
+            touchsetHeader.magic = 0xFFFF;
+        }
+    #endif
+    touchset_select_source();
+    memset(touchsetPrev, 0, KG_BASE_COMBINATION_BYTES);
+    touchsetChordSize = 0;
+    touchsetActiveCount = 0;
+}
+
+/**
+ * @brief Run release entries for the active chord and forget which mode owns it
+ *
+ * Called before any change to table contents, while the saved entry index
+ * still points into the table which ran the press, so a key sent down by a
+ * press entry is not left stuck on the host when the table changes under a
+ * held chord. The chord stays unowned until the touch status changes again.
+ */
+void touchset_release_chord() {
+    uint8_t key[4];
+    if (touchsetChordMode == KG_TOUCHSET_MODE_NONE) return;
+    key[0] = touchsetChordMode;
+    touchsetChordMode = KG_TOUCHSET_MODE_NONE;
+    if (!touchset_chord_key(key)) touchset_run_key(touchsetChordIndex, key, KG_TOUCHSET_TRIGGER_RELEASE);
+}
+
+/**
+ * @brief Choose active touchset table (stored EEPROM touchset has priority over RAM)
+ *
+ * Called after any change to table contents. Call touchset_release_chord()
+ * before making the change.
+ */
+void touchset_select_source() {
+    // table contents may have changed, so old indexes are no longer usable
+    touchsetChordMode = KG_TOUCHSET_MODE_NONE;
+    touchset_invalidate();
+
+    #if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+        if (touchsetHeader.magic == KG_TOUCHSET_EEPROM_MAGIC) {
+            touchsetSource = KG_TOUCHSET_EEPROM;
+            touchsetCount = touchsetHeader.count;
+            return;
+        }
+    #endif
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        touchsetSource = KG_TOUCHSET_RAM;
+        touchsetCount = touchsetRamCount;
+    #else
+        touchsetSource = KG_TOUCHSET_NONE;
+        touchsetCount = 0;
+    #endif
+}
+
+/**
+ * @brief Remove all entries from RAM touchset table
+ *
+ * A stored EEPROM touchset is left alone and stays active; use
+ * touchset_erase() to remove it.
+ */
+void touchset_clear() {
+    touchset_release_chord();
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        touchsetRamCount = 0;
+    #endif
+    touchset_select_source();
+}
+
+/**
+ * @brief Get the maximum number of entries the active touchset table can hold
+ * @return Table capacity in entries
+ */
+uint16_t touchset_capacity() {
+    #if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+        if (touchsetSource == KG_TOUCHSET_EEPROM) return KG_TOUCHSET_EEPROM_ENTRIES;
+    #endif
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        return KG_TOUCHSET_RAM_ENTRIES;
+    #else
+        return 0;
+    #endif
+}
+
+/**
+ * @brief Read a single entry from the active touchset table
+ * @param[in] index Entry index in sorted table
+ * @param[out] entry Entry data
+ * @return Zero for success, non-zero if index is out of range
+ */
+uint8_t touchset_read_entry(uint16_t index, touchset_entry_t *entry) {
+    if (index >= touchsetCount) return 1;
+    #if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+        if (touchsetSource == KG_TOUCHSET_EEPROM) {
+            eeprom_read_block(entry, (const void *)(KG_TOUCHSET_EEPROM_ADDRESS + sizeof(touchset_header_t) + index * sizeof(touchset_entry_t)), sizeof(touchset_entry_t));
+            return 0;
+        }
+    #endif
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        *entry = touchsetTable[index];
+    #endif
+    return 0;
+}
+
+/**
+ * @brief Check whether an entry's mode, action and trigger fields are valid
+ * @param[in] entry Entry to check
+ * @return Zero if valid, non-zero otherwise
+ */
+uint8_t touchset_check_entry(const touchset_entry_t *entry) {
+    if (entry -> mode == KG_TOUCHSET_MODE_NONE) return 1;
+    if ((entry -> action & 0x3F) >= KG_TOUCHSET_ACTION_MAX) return 1;
+
+    // touch and untouch entries follow one combination, so the last three chord slots must be padding
+    if ((entry -> action >> 6) >= KG_TOUCHSET_TRIGGER_TOUCH
+        && ((entry -> chord[0] & 0x03) != 0x03 || entry -> chord[1] != 0xFF || entry -> chord[2] != 0xFF)) return 1;
+    return 0;
+}
+
+/**
+ * @brief Pack a list of base combination indexes into a 3-byte chord key
+ * @param[out] packed Packed chord buffer (3 bytes)
+ * @param[in] combos_len Number of base combination indexes
+ * @param[in] combos Base combination indexes (any order)
+ * @return Zero for success, non-zero if the list is empty, too long, out of range, or has duplicates
+ */
+uint8_t touchset_pack_chord(uint8_t *packed, uint8_t combos_len, const uint8_t *combos) {
+    uint8_t sorted[KG_TOUCHSET_CHORD_MAX];
+    uint8_t i, j, c;
+
+    // skip any padding so fixed-size rule arrays can be passed directly
+    for (i = 0, j = 0; i < combos_len; i++) {
+        c = combos[i];
+        if (c == KG_TOUCHSET_CHORD_PAD) continue;
+        if (c >= KG_BASE_COMBINATIONS || j >= KG_TOUCHSET_CHORD_MAX) return 1;
+
+        // insertion sort (4 elements max)
+        uint8_t k = j++;
+        for (; k > 0 && sorted[k - 1] > c; k--) sorted[k] = sorted[k - 1];
+        if (k > 0 && sorted[k - 1] == c) return 1;
+        sorted[k] = c;
+    }
+    if (j == 0) return 1;
+
+    uint32_t key = 0;
+    for (i = 0; i < KG_TOUCHSET_CHORD_MAX; i++) key = (key << 6) | (i < j ? sorted[i] : KG_TOUCHSET_CHORD_PAD);
+    packed[0] = (uint8_t)((key >> 16) & 0xFF);
+    packed[1] = (uint8_t)((key >> 8) & 0xFF);
+    packed[2] = (uint8_t)(key & 0xFF);
+    return 0;
+}
+
+/**
+ * @brief Find the first table index with a key equal to or greater than the given key
+ * @param[in] key Mode byte followed by 3-byte packed chord
+ * @return Index of first matching or greater entry (touchsetCount if none)
+ */
+uint16_t touchset_lower_bound(const uint8_t *key) {
+    touchset_entry_t entry;
+    uint16_t lo = 0, hi = touchsetCount, mid;
+    while (lo < hi) {
+        mid = (lo + hi) >> 1;
+        touchset_read_entry(mid, &entry);
+        if (memcmp(&entry, key, 4) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Add a new entry to the touchset table, maintaining sort order
+ * @param[in] mode Touch mode in which the entry is active
+ * @param[in] action Packed trigger and action code
+ * @param[in] param Action parameter
+ * @param[in] combos_len Number of base combination indexes
+ * @param[in] combos Base combination indexes making up the chord
+ * @return Zero for success, non-zero if the chord/action is invalid or the table is full
+ * @see KG_TOUCHSET_ACTION()
+ *
+ * Entries with identical keys keep the order in which they were added, and all
+ * of them run when the chord is matched.
+ */
+uint8_t touchset_add_entry(uint8_t mode, uint8_t action, uint8_t param, uint8_t combos_len, const uint8_t *combos) {
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        touchset_entry_t entry;
+        if (touchsetRamCount >= KG_TOUCHSET_RAM_ENTRIES) return 1;
+        if (touchset_pack_chord(entry.chord, combos_len, combos)) return 1;
+        entry.mode = mode;
+        entry.action = action;
+        entry.param = param;
+        if (touchset_check_entry(&entry)) return 1;
+
+        // insert after any existing entries with the same key
+        uint16_t i;
+        touchset_release_chord();
+        for (i = touchsetRamCount; i > 0 && memcmp(&touchsetTable[i - 1], &entry, 4) > 0; i--);
+        memmove(touchsetTable + i + 1, touchsetTable + i, (touchsetRamCount - i) * sizeof(touchset_entry_t));
+        touchsetTable[i] = entry;
+        touchsetRamCount++;
+        touchset_select_source();
+        return 0;
+    #else
+        return 1;
+    #endif
+}
+
+#if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+    /**
+     * @brief Queue data for writing into EEPROM by update_touchset()
+     * @param[in] address EEPROM address
+     * @param[in] length Number of bytes (up to KG_TOUCHSET_WRITE_BUFFER)
+     * @param[in] data Data to write
+     * @return Zero for success, KG_TOUCHSET_WRITE_BUSY if earlier data is still being written
+     */
+    uint8_t touchset_queue_write(uint8_t *address, uint8_t length, const uint8_t *data) {
+        if (touchsetWritePos < touchsetWriteLength) return KG_TOUCHSET_WRITE_BUSY;
+        memcpy(touchsetWriteBuffer, data, length);
+        touchsetWriteAddress = address;
+        touchsetWriteLength = length;
+        touchsetWritePos = 0;
+        return 0;
+    }
+
+    /**
+     * @brief Mark stored EEPROM touchset as invalid and stop using it
+     * @return Zero for success, KG_TOUCHSET_WRITE_BUSY if earlier data is still being written
+     *
+     * Any upload in progress is abandoned. The magic number is cleared in the
+     * background, but the stored touchset is not used again from now on.
+     */
+    uint8_t touchset_erase() {
+        uint16_t magic = 0xFFFF;
+        if (touchset_queue_write((uint8_t *)KG_TOUCHSET_EEPROM_ADDRESS, 2, (uint8_t *)&magic)) return KG_TOUCHSET_WRITE_BUSY;
+        touchset_release_chord();
+        touchsetUploading = KG_TOUCHSET_UPLOAD_IDLE;
+        touchsetHeader.magic = 0xFFFF;
+        touchset_select_source();
+        return 0;
+    }
+
+    /**
+     * @brief Start uploading a new compiled touchset into EEPROM
+     * @param[in] count Number of entries which will be uploaded
+     * @return Zero for success, KG_TOUCHSET_WRITE_BUSY if earlier data is still being written, other non-zero if the touchset will not fit
+     *
+     * The stored touchset is invalidated immediately, so the RAM table (if
+     * any) is used until the upload finishes successfully.
+     */
+    uint8_t touchset_write_begin(uint16_t count) {
+        uint8_t result;
+        if (count > KG_TOUCHSET_EEPROM_ENTRIES) return 1;
+        if ((result = touchset_erase()) != 0) return result;
+        touchsetUploadCount = count;
+        touchsetUploadOffset = 0;
+        touchsetUploadCrc = 0;
+        touchsetUploadError = 0;
+        touchsetUploading = KG_TOUCHSET_UPLOAD_DATA;
+        return 0;
+    }
+
+    /**
+     * @brief Queue the next chunk of compiled touchset entry data for writing into EEPROM
+     * @param[in] offset Byte offset into entry data (must follow the previous chunk)
+     * @param[in] data_len Length in bytes of data buffer
+     * @param[in] data Compiled entry data
+     * @return Zero for success, KG_TOUCHSET_WRITE_BUSY if the previous chunk is still being written, other non-zero if no upload is in progress or the chunk is invalid
+     *
+     * The CRC, sort order and entry contents are checked as data arrives, so
+     * finishing the upload does not need to read it all back from EEPROM.
+     */
+    uint8_t touchset_write_data(uint16_t offset, uint8_t data_len, const uint8_t *data) {
+        uint8_t i, pos;
+        if (touchsetUploading != KG_TOUCHSET_UPLOAD_DATA || offset != touchsetUploadOffset || data_len > KG_TOUCHSET_WRITE_BUFFER
+            || (uint32_t)offset + data_len > (uint32_t)touchsetUploadCount * sizeof(touchset_entry_t)) return 1;
+        if (touchset_queue_write((uint8_t *)(KG_TOUCHSET_EEPROM_ADDRESS + sizeof(touchset_header_t) + offset), data_len, data)) return KG_TOUCHSET_WRITE_BUSY;
+
+        for (i = 0; i < data_len; i++, offset++) {
+            touchsetUploadCrc = _crc_xmodem_update(touchsetUploadCrc, data[i]);
+            pos = offset % sizeof(touchset_entry_t);
+            ((uint8_t *)&touchsetUploadEntry)[pos] = data[i];
+            if (pos < sizeof(touchset_entry_t) - 1) continue;
+            if (touchset_check_entry(&touchsetUploadEntry)
+                || (offset >= sizeof(touchset_entry_t) && memcmp(touchsetUploadPrev, &touchsetUploadEntry, 4) > 0)) touchsetUploadError = 1;
+            memcpy(touchsetUploadPrev, &touchsetUploadEntry, 4);
+        }
+        touchsetUploadOffset = offset;
+        return touchsetUploadError;
+    }
+
+    /**
+     * @brief Finish EEPROM touchset upload and activate it if valid
+     * @param[in] crc CRC16 (XMODEM) of all entry data computed by the host
+     * @return Zero for success, KG_TOUCHSET_WRITE_BUSY if the last chunk is still being written, other non-zero if data is missing or the CRC, sort order, or any entry is invalid
+     *
+     * The header is written in the background after this returns, and the new
+     * touchset becomes active once its magic number is written last. Check
+     * the "source" field of kg_cmd_touchset_get_info() to see when it is.
+     */
+    uint8_t touchset_write_end(uint16_t crc) {
+        if (touchsetUploading != KG_TOUCHSET_UPLOAD_DATA) return 1;
+        if (touchsetUploadOffset != touchsetUploadCount * sizeof(touchset_entry_t) || touchsetUploadError || touchsetUploadCrc != crc) {
+            touchsetUploading = KG_TOUCHSET_UPLOAD_IDLE;
+            return 1;
+        }
+
+        // write header first with blank magic number, so an interrupted write stays invalid
+        touchsetHeader.magic = 0xFFFF;
+        touchsetHeader.version = KG_TOUCHSET_EEPROM_VERSION;
+        touchsetHeader.entry_size = sizeof(touchset_entry_t);
+        touchsetHeader.count = touchsetUploadCount;
+        touchsetHeader.crc = crc;
+        if (touchset_queue_write((uint8_t *)KG_TOUCHSET_EEPROM_ADDRESS, sizeof(touchset_header_t), (uint8_t *)&touchsetHeader)) return KG_TOUCHSET_WRITE_BUSY;
+        touchsetUploading = KG_TOUCHSET_UPLOAD_HEADER;
+        return 0;
+    }
+
+    /**
+     * @brief Write buffered touchset data into EEPROM in the background
+     *
+     * Called from the main loop. Bytes which already hold the right value are
+     * skipped, and this returns as soon as one byte write has been started,
+     * so a single pass never waits for the EEPROM.
+     */
+    void update_touchset() {
+        uint8_t *address;
+        while (touchsetWritePos < touchsetWriteLength && eeprom_is_ready()) {
+            address = touchsetWriteAddress + touchsetWritePos;
+            if (eeprom_read_byte(address) != touchsetWriteBuffer[touchsetWritePos]) {
+                eeprom_write_byte(address, touchsetWriteBuffer[touchsetWritePos++]);
+                return;
+            }
+            touchsetWritePos++;
+        }
+        if (touchsetWritePos < touchsetWriteLength) return;
+
+        if (touchsetUploading == KG_TOUCHSET_UPLOAD_HEADER) {
+            // header is written, so finish with the magic number
+            uint16_t magic = KG_TOUCHSET_EEPROM_MAGIC;
+            touchset_queue_write((uint8_t *)KG_TOUCHSET_EEPROM_ADDRESS, 2, (uint8_t *)&magic);
+            touchsetUploading = KG_TOUCHSET_UPLOAD_MAGIC;
+        } else if (touchsetUploading == KG_TOUCHSET_UPLOAD_MAGIC && eeprom_is_ready()) {
+            touchset_release_chord();
+            touchsetUploading = KG_TOUCHSET_UPLOAD_IDLE;
+            touchsetHeader.magic = KG_TOUCHSET_EEPROM_MAGIC;
+            touchset_select_source();
+        }
+    }
+#endif
+
+/**
+ * @brief Replace RAM touchset table with a list of rules stored in flash (PROGMEM)
+ * @param[in] rules Rule list in program memory
+ * @param[in] count Number of rules in list
+ * @return Zero for success, non-zero if any rule could not be added
+ */
+uint8_t touchset_compile(const touchset_rule_t *rules, uint16_t count) {
+    touchset_rule_t rule;
+    uint8_t result = 0;
+    touchset_release_chord();
+    #if (KG_TOUCHSET & KG_TOUCHSET_RAM)
+        touchsetRamCount = 0;
+    #endif
+    for (uint16_t i = 0; i < count; i++) {
+        memcpy_P(&rule, rules + i, sizeof(touchset_rule_t));
+        if (touchset_add_entry(rule.mode, KG_TOUCHSET_ACTION(rule.trigger, rule.action), rule.param, KG_TOUCHSET_CHORD_MAX, rule.combos)) result = 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Run a single touchset action
+ * @param[in] action Action code (without trigger bits)
+ * @param[in] param Action parameter
+ */
+void touchset_run_action(uint8_t action, uint8_t param) {
+    switch (action) {
+        #if (KG_HID & KG_HID_KEYBOARD)
+            case KG_TOUCHSET_ACTION_KEY_DOWN: keyboard_key_down(param); break;
+            case KG_TOUCHSET_ACTION_KEY_UP: keyboard_key_up(param); break;
+            case KG_TOUCHSET_ACTION_KEY_PRESS: keyboard_key_press(param); break;
+            case KG_TOUCHSET_ACTION_MODIFIER_DOWN: keyboard_modifier_down(param); break;
+            case KG_TOUCHSET_ACTION_MODIFIER_UP: keyboard_modifier_up(param); break;
+            case KG_TOUCHSET_ACTION_MODIFIER_TOGGLE: keyboard_modifier_toggle(param); break;
+            case KG_TOUCHSET_ACTION_MODIFIER_PRESS: keyboard_modifier_press(param); break;
+        #endif
+        #if (KG_HID & KG_HID_MOUSE)
+            case KG_TOUCHSET_ACTION_MOUSE_DOWN: mouse_down(param); break;
+            case KG_TOUCHSET_ACTION_MOUSE_UP: mouse_up(param); break;
+            case KG_TOUCHSET_ACTION_MOUSE_CLICK: mouse_click(param); break;
+            case KG_TOUCHSET_ACTION_MOUSE_ON: mouse_on(param); break;
+            case KG_TOUCHSET_ACTION_MOUSE_OFF: mouse_off(param); break;
+        #endif
+        case KG_TOUCHSET_ACTION_MODE_SET: touch_set_mode(param); break;
+        case KG_TOUCHSET_ACTION_MODE_PUSH: touch_push_mode(param); break;
+        case KG_TOUCHSET_ACTION_MODE_POP: touch_pop_mode(); break;
+        case KG_TOUCHSET_ACTION_MODE_TOGGLE: touch_toggle_mode(param); break;
+        #if (KG_FEEDBACK & KG_FEEDBACK_BLINK)
+            case KG_TOUCHSET_ACTION_BLINK: kg_cmd_feedback_set_blink_mode(param); break;
+        #endif
+        #if (KG_FEEDBACK & KG_FEEDBACK_PIEZO)
+            case KG_TOUCHSET_ACTION_PIEZO: kg_cmd_feedback_set_piezo_mode(0, param, opt_touchset_feedback_duration, KG_PIEZO_DEFAULT_FREQ); break;
+        #endif
+        #if (KG_FEEDBACK & KG_FEEDBACK_VIBRATE)
+            case KG_TOUCHSET_ACTION_VIBRATE: kg_cmd_feedback_set_vibrate_mode(0, param, opt_touchset_feedback_duration); break;
+        #endif
+        #if (KG_MOTION > 0)
+            case KG_TOUCHSET_ACTION_MOTION_ON: kg_cmd_motion_set_mode(param, KG_MOTION_MODE_ON); break;
+            case KG_TOUCHSET_ACTION_MOTION_OFF: kg_cmd_motion_set_mode(param, KG_MOTION_MODE_OFF); break;
+        #endif
+    }
+}
+
+/**
+ * @brief Run all entries for a chord starting at a known table index
+ * @param[in] index Index of first entry for this key
+ * @param[in] key Mode byte followed by 3-byte packed chord
+ * @param[in] trigger Trigger condition to match
+ */
+void touchset_run_key(uint16_t index, const uint8_t *key, uint8_t trigger) {
+    touchset_entry_t entry;
+    for (; index < touchsetCount; index++) {
+        touchset_read_entry(index, &entry);
+        if (memcmp(&entry, key, 4) != 0) break;
+        if ((entry.action >> 6) == trigger) touchset_run_action(entry.action & 0x3F, entry.param);
+    }
+}
+
+/**
+ * @brief Mark chord lookup cache as stale (call after any mode stack change)
+ */
+void touchset_invalidate() {
+    touchsetEffectiveDirty = 1;
+}
+
+/**
+ * @brief Calculate chord lookup cache set for a packed chord
+ * @param[in] chord Packed chord (3 bytes)
+ * @return Index of first slot in set
+ */
+uint8_t touchset_effective_hash(const uint8_t *chord) {
+    // XOR the four 6-bit indexes with different multipliers, so single-combination chords never collide
+    uint8_t h = chord[0] >> 2;
+    h ^= (((chord[0] & 0x03) << 4) | (chord[1] >> 4)) * 3;
+    h ^= (((chord[1] & 0x0F) << 2) | (chord[2] >> 6)) * 5;
+    h ^= (chord[2] & 0x3F) * 7;
+    return (h & (KG_TOUCHSET_EFFECTIVE_SLOTS / KG_TOUCHSET_EFFECTIVE_WAYS - 1)) * KG_TOUCHSET_EFFECTIVE_WAYS;
+}
+
+/**
+ * @brief Find the topmost mode on the stack which defines a chord
+ * @param[in,out] key Key buffer with packed chord, mode byte is filled in if found
+ * @param[out] index Table index of first entry for the resulting key
+ * @return Zero if found, non-zero if no mode on the stack defines the chord
+ */
+uint8_t touchset_find_effective(uint8_t *key, uint16_t *index) {
+    touchset_entry_t entry;
+    uint8_t set, way, slot, pos;
+
+    if (touchsetEffectiveDirty) {
+        touchsetEffectiveDirty = 0;
+        for (slot = 0; slot < KG_TOUCHSET_EFFECTIVE_SLOTS; slot++) touchsetEffective[slot].chord[0] = KG_TOUCHSET_EFFECTIVE_EMPTY;
+    }
+
+    // check every way in this chord's set, remembering an unused slot in case it is not cached
+    set = touchset_effective_hash(key + 1);
+    slot = KG_TOUCHSET_EFFECTIVE_SLOTS;
+    for (way = 0; way < KG_TOUCHSET_EFFECTIVE_WAYS; way++) {
+        if (touchsetEffective[set + way].chord[0] == KG_TOUCHSET_EFFECTIVE_EMPTY) {
+            slot = set + way;
+        } else if (memcmp(touchsetEffective[set + way].chord, key + 1, 3) == 0) {
+            key[0] = touchsetEffective[set + way].mode;
+            *index = touchsetEffective[set + way].index;
+            return key[0] == KG_TOUCHSET_MODE_NONE;
+        }
+    }
+    if (slot == KG_TOUCHSET_EFFECTIVE_SLOTS) {
+        // set is full, so replace each way in turn
+        slot = set + touchsetEffectiveNext;
+        touchsetEffectiveNext = (touchsetEffectiveNext + 1) & (KG_TOUCHSET_EFFECTIVE_WAYS - 1);
+    }
+
+    // not cached, so search each mode on the stack from the top and cache the result, even if not found
+    memcpy(touchsetEffective[slot].chord, key + 1, 3);
+    touchsetEffective[slot].mode = KG_TOUCHSET_MODE_NONE;
+    for (pos = touchModeStackPos; pos > 0; pos--) {
+        key[0] = touchModeStack[pos - 1];
+        *index = touchset_lower_bound(key);
+        if (!touchset_read_entry(*index, &entry) && memcmp(&entry, key, 4) == 0) {
+            touchsetEffective[slot].mode = key[0];
+            touchsetEffective[slot].index = *index;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Pack the currently active chord into a lookup key
+ * @param[out] key Key buffer (4 bytes), mode byte is left untouched
+ * @return Zero for success, non-zero if no valid chord is active
+ */
+uint8_t touchset_chord_key(uint8_t *key) {
+    if (touchsetActiveCount == 0 || touchsetActiveCount > KG_TOUCHSET_CHORD_MAX) return 1;
+    return touchset_pack_chord(key + 1, touchsetChordSize, touchsetChord);
+}
+
+/**
+ * @brief Run touch or untouch entries for a single base combination
+ * @param[in] index Base combination index which changed
+ * @param[in] trigger KG_TOUCHSET_TRIGGER_TOUCH or KG_TOUCHSET_TRIGGER_UNTOUCH
+ *
+ * The topmost mode on the stack which defines the combination as a chord of
+ * its own handles it, at the time of the change.
+ */
+void touchset_run_single(uint8_t index, uint8_t trigger) {
+    uint8_t key[4];
+    uint16_t first;
+    if (touchset_pack_chord(key + 1, 1, &index) || touchset_find_effective(key, &first)) return;
+    touchset_run_key(first, key, trigger);
+}
+
+/**
+ * @brief Process a change in debounced touch status
+ * @param[in] touches New touch status bits
+ *
+ * Called from update_touch() whenever the registered touch status changes.
+ * Only bits which differ from the previous status are examined, so the
+ * active chord is maintained in time proportional to the number of changes.
+ * Touch and untouch entries for each changed combination run as it is
+ * applied, before the chord release and press entries.
+ */
+void touchset_process(const uint8_t *touches) {
+    uint8_t oldKey[4], newKey[4];
+    uint8_t oldValid, newValid;
+    uint8_t i, j, k, diff, index;
+
+    oldValid = !touchset_chord_key(oldKey);
+
+    // apply changed bits to sorted active chord list
+    for (i = 0; i < KG_BASE_COMBINATION_BYTES; i++) {
+        diff = touchsetPrev[i] ^ touches[i];
+        if (!diff) continue;
+        for (j = 0; j < 8; j++) {
+            if (!(diff & (1 << j))) continue;
+            index = (i << 3) + j;
+            if (touches[i] & (1 << j)) {
+                touchsetActiveCount++;
+                if (touchsetChordSize < KG_TOUCHSET_CHORD_MAX) {
+                    for (k = touchsetChordSize++; k > 0 && touchsetChord[k - 1] > index; k--) touchsetChord[k] = touchsetChord[k - 1];
+                    touchsetChord[k] = index;
+                }
+                touchset_run_single(index, KG_TOUCHSET_TRIGGER_TOUCH);
+            } else {
+                touchsetActiveCount--;
+                for (k = 0; k < touchsetChordSize && touchsetChord[k] != index; k++);
+                if (k < touchsetChordSize) {
+                    for (touchsetChordSize--; k < touchsetChordSize; k++) touchsetChord[k] = touchsetChord[k + 1];
+                }
+                touchset_run_single(index, KG_TOUCHSET_TRIGGER_UNTOUCH);
+            }
+        }
+        touchsetPrev[i] = touches[i];
+    }
+
+    // list may be stale after too many simultaneous touches, so rebuild once it fits again
+    if (touchsetActiveCount <= KG_TOUCHSET_CHORD_MAX && touchsetChordSize != touchsetActiveCount) {
+        touchsetChordSize = 0;
+        for (index = 0; index < KG_BASE_COMBINATIONS && touchsetChordSize < touchsetActiveCount; index++) {
+            if (touches[index >> 3] & (1 << (index & 7))) touchsetChord[touchsetChordSize++] = index;
+        }
+    }
+
+    newValid = !touchset_chord_key(newKey);
+    if (oldValid && newValid && memcmp(oldKey + 1, newKey + 1, 3) == 0) return;
+
+    // release old chord in whichever mode handled the press
+    if (oldValid && touchsetChordMode != KG_TOUCHSET_MODE_NONE) {
+        oldKey[0] = touchsetChordMode;
+        touchset_run_key(touchsetChordIndex, oldKey, KG_TOUCHSET_TRIGGER_RELEASE);
+    }
+    touchsetChordMode = KG_TOUCHSET_MODE_NONE;
+
+    // press new chord in topmost mode on the stack which defines it (after any mode changes from release)
+    if (newValid && !touchset_find_effective(newKey, &touchsetChordIndex)) {
+        touchsetChordMode = newKey[0];
+        touchset_run_key(touchsetChordIndex, newKey, KG_TOUCHSET_TRIGGER_PRESS);
+    }
+}
@@ -0,0 +1,206 @@
+// Keyglove controller source code - Touchset (chord map) engine declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_touchset.h
+ * @brief Touchset (chord map) engine declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * A touchset is a list of entries that map a chord (a set of up to four base
+ * touch combinations active at the same time) in a specific touch mode to a
+ * single action, such as a key press, mouse click, mode change, or feedback
+ * pattern. Entries are stored in a table sorted by mode and packed chord, so
+ * that lookups are a binary search rather than a linear scan.
+ *
+ * Press and release entries match the exact set of active combinations, so
+ * adding a finger to a chord releases it and presses a different one. Touch
+ * and untouch entries take a single combination and follow only that one, no
+ * matter what else is touched at the same time.
+ *
+ * The same 6-byte entry format is used in RAM, in EEPROM, and in the blob
+ * produced by the "kgtouchset.py" host compiler.
+ *
+ * Each EEPROM byte takes about 3.4ms to program, so uploaded data is only
+ * buffered by the KGAPI commands and written by update_touchset() one byte
+ * per main loop pass, whenever the EEPROM is ready. A command that arrives
+ * before the previous chunk is written fails with a "busy" result and may
+ * simply be sent again.
+ */
+
+#ifndef _SUPPORT_TOUCHSET_H_
+#define _SUPPORT_TOUCHSET_H_
+
+#include "support_board.h"
+
+#ifndef KG_TOUCHSET_RAM_ENTRIES
+    #define KG_TOUCHSET_RAM_ENTRIES     64          ///< Maximum number of entries in RAM-based touchset table (6 bytes each)
+#endif
+
+#ifndef KG_TOUCHSET_EFFECTIVE_SLOTS
+    #define KG_TOUCHSET_EFFECTIVE_SLOTS 64          ///< Slots in chord lookup cache (power of 2 up to 128, 6 bytes each)
+#endif
+
+#ifndef KG_TOUCHSET_EFFECTIVE_WAYS
+    #define KG_TOUCHSET_EFFECTIVE_WAYS  4           ///< Slots per chord lookup cache set (power of 2)
+#endif
+
+#ifndef KG_TOUCHSET_WRITE_BUFFER
+    #define KG_TOUCHSET_WRITE_BUFFER    32          ///< Bytes of uploaded EEPROM touchset data buffered for background writing
+#endif
+
+#define KG_TOUCHSET_CHORD_MAX           4           ///< Maximum number of base combinations in a single chord
+#define KG_TOUCHSET_CHORD_PAD           0x3F        ///< Packed index value for unused chord slots (above any valid combination)
+#define KG_TOUCHSET_MODE_NONE           0xFF        ///< Indicates that no mode currently owns the active chord
+#define KG_TOUCHSET_EFFECTIVE_EMPTY     0xFF        ///< First chord byte of an unused lookup cache slot (never a valid packed chord)
+
+#define KG_TOUCHSET_TRIGGER_PRESS       0x00        ///< Run action when chord becomes active
+#define KG_TOUCHSET_TRIGGER_RELEASE     0x01        ///< Run action when chord stops being active
+#define KG_TOUCHSET_TRIGGER_TOUCH       0x02        ///< Run action when single combination becomes active, whatever else is touched
+#define KG_TOUCHSET_TRIGGER_UNTOUCH     0x03        ///< Run action when single combination stops being active, whatever else is touched
+
+/**
+ * @brief Build packed action byte from trigger and action code
+ */
+#define KG_TOUCHSET_ACTION(trigger, action) ((uint8_t)(((trigger) << 6) | ((action) & 0x3F)))
+
+/**
+ * @brief List of possible touchset entry actions
+ */
+typedef enum {
+    KG_TOUCHSET_ACTION_NONE = 0,            ///< (0) No action
+    KG_TOUCHSET_ACTION_KEY_DOWN,            ///< (1) Keyboard key down, param = key code
+    KG_TOUCHSET_ACTION_KEY_UP,              ///< (2) Keyboard key up, param = key code
+    KG_TOUCHSET_ACTION_KEY_PRESS,           ///< (3) Keyboard key down and up, param = key code
+    KG_TOUCHSET_ACTION_MODIFIER_DOWN,       ///< (4) Keyboard modifier down, param = modifier code
+    KG_TOUCHSET_ACTION_MODIFIER_UP,         ///< (5) Keyboard modifier up, param = modifier code
+    KG_TOUCHSET_ACTION_MODIFIER_TOGGLE,     ///< (6) Keyboard modifier toggle, param = modifier code
+    KG_TOUCHSET_ACTION_MODIFIER_PRESS,      ///< (7) Keyboard modifier down and up, param = modifier code
+    KG_TOUCHSET_ACTION_MOUSE_DOWN,          ///< (8) Mouse button down, param = button mask
+    KG_TOUCHSET_ACTION_MOUSE_UP,            ///< (9) Mouse button up, param = button mask
+    KG_TOUCHSET_ACTION_MOUSE_CLICK,         ///< (10) Mouse button down and up, param = button mask
+    KG_TOUCHSET_ACTION_MOUSE_ON,            ///< (11) Enable mouse movement, param = MOUSE_ACTION_* value
+    KG_TOUCHSET_ACTION_MOUSE_OFF,           ///< (12) Disable mouse movement, param = MOUSE_ACTION_* value
+    KG_TOUCHSET_ACTION_MODE_SET,            ///< (13) Replace touch mode stack, param = mode
+    KG_TOUCHSET_ACTION_MODE_PUSH,           ///< (14) Push touch mode, param = mode
+    KG_TOUCHSET_ACTION_MODE_POP,            ///< (15) Pop touch mode, param ignored
+    KG_TOUCHSET_ACTION_MODE_TOGGLE,         ///< (16) Toggle touch mode, param = mode
+    KG_TOUCHSET_ACTION_BLINK,               ///< (17) Set blink mode, param = blink mode
+    KG_TOUCHSET_ACTION_PIEZO,               ///< (18) Set piezo mode, param = piezo mode
+    KG_TOUCHSET_ACTION_VIBRATE,             ///< (19) Set vibrate mode, param = vibrate mode
+    KG_TOUCHSET_ACTION_MOTION_ON,           ///< (20) Enable motion sensor, param = sensor index
+    KG_TOUCHSET_ACTION_MOTION_OFF,          ///< (21) Disable motion sensor, param = sensor index
+    KG_TOUCHSET_ACTION_MAX
+} touchset_action_t;
+
+/**
+ * @brief Packed touchset table entry (6 bytes)
+ *
+ * The first four bytes form the sort key. The chord holds four 6-bit base
+ * combination indexes in ascending order, packed big-endian and padded with
+ * KG_TOUCHSET_CHORD_PAD, so comparing the key bytes with memcmp() gives the
+ * same ordering as comparing (mode, chord) numerically.
+ */
+typedef struct {
+    uint8_t mode;                           ///< Touch mode in which this entry is active
+    uint8_t chord[3];                       ///< Packed chord (4x 6-bit base combination indexes)
+    uint8_t action;                         ///< Trigger (bits 7-6) and action code (bits 5-0)
+    uint8_t param;                          ///< Action parameter
+} touchset_entry_t;
+
+#define KG_TOUCHSET_EEPROM_ADDRESS      0x0000      ///< EEPROM address of stored touchset header
+#define KG_TOUCHSET_EEPROM_SIZE         (KG_EEPROM_RECORDS_ADDRESS - KG_TOUCHSET_EEPROM_ADDRESS)  ///< EEPROM bytes available for stored touchset (header + entries)
+#define KG_TOUCHSET_EEPROM_MAGIC        0x544B      ///< Stored touchset header magic number ("KT")
+#define KG_TOUCHSET_EEPROM_VERSION      0x01        ///< Stored touchset format version
+
+/**
+ * @brief Stored EEPROM touchset header (8 bytes), followed by packed entries
+ */
+typedef struct {
+    uint16_t magic;                         ///< KG_TOUCHSET_EEPROM_MAGIC if stored touchset is valid
+    uint8_t version;                        ///< Stored format version
+    uint8_t entry_size;                     ///< Size of each entry in bytes
+    uint16_t count;                         ///< Number of stored entries
+    uint16_t crc;                           ///< CRC16 (XMODEM) of all entry data
+} touchset_header_t;
+
+#define KG_TOUCHSET_UPLOAD_IDLE         0x00        ///< No EEPROM touchset upload in progress
+#define KG_TOUCHSET_UPLOAD_DATA         0x01        ///< Receiving entry data
+#define KG_TOUCHSET_UPLOAD_HEADER       0x02        ///< Entry data verified, header being written
+#define KG_TOUCHSET_UPLOAD_MAGIC        0x03        ///< Header written, magic number being written
+
+#define KG_TOUCHSET_WRITE_BUSY          0x02        ///< Result from EEPROM write functions when earlier data is still being written
+
+#define KG_TOUCHSET_EEPROM_ENTRIES      ((KG_TOUCHSET_EEPROM_SIZE - sizeof(touchset_header_t)) / sizeof(touchset_entry_t))  ///< Maximum number of stored EEPROM entries
+
+/**
+ * @brief Chord lookup cache slot (6 bytes)
+ */
+typedef struct {
+    uint8_t chord[3];                       ///< Packed chord (first byte KG_TOUCHSET_EFFECTIVE_EMPTY if slot unused)
+    uint8_t mode;                           ///< Topmost mode on stack defining this chord (KG_TOUCHSET_MODE_NONE if no mode does)
+    uint16_t index;                         ///< Table index of first entry for this chord in that mode
+} touchset_effective_t;
+
+/**
+ * @brief Human-readable touchset rule, used to compile a table from flash
+ */
+typedef struct {
+    uint8_t mode;                           ///< Touch mode in which this rule is active
+    uint8_t trigger;                        ///< Trigger condition (press or release)
+    uint8_t action;                         ///< Action code
+    uint8_t param;                          ///< Action parameter
+    uint8_t combos[KG_TOUCHSET_CHORD_MAX];  ///< Base combination indexes (KGB_*), unused slots KG_TOUCHSET_CHORD_PAD
+} touchset_rule_t;
+
+extern uint8_t touchsetSource;
+extern uint16_t touchsetCount;
+extern uint8_t touchsetChordMode;
+
+void setup_touchset();
+void touchset_release_chord();
+void touchset_select_source();
+void touchset_clear();
+uint16_t touchset_capacity();
+uint8_t touchset_read_entry(uint16_t index, touchset_entry_t *entry);
+uint8_t touchset_pack_chord(uint8_t *packed, uint8_t combos_len, const uint8_t *combos);
+uint8_t touchset_add_entry(uint8_t mode, uint8_t action, uint8_t param, uint8_t combos_len, const uint8_t *combos);
+uint8_t touchset_compile(const touchset_rule_t *rules, uint16_t count);
+#if (KG_TOUCHSET & KG_TOUCHSET_EEPROM)
+    uint8_t touchset_erase();
+    uint8_t touchset_write_begin(uint16_t count);
+    uint8_t touchset_write_data(uint16_t offset, uint8_t data_len, const uint8_t *data);
+    uint8_t touchset_write_end(uint16_t crc);
+    void update_touchset();
+#endif
+void touchset_run_key(uint16_t index, const uint8_t *key, uint8_t trigger);
+uint8_t touchset_chord_key(uint8_t *key);
+void touchset_invalidate();
+void touchset_process(const uint8_t *touches);
+
+#endif // _SUPPORT_TOUCHSET_H_
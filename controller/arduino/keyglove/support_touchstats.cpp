@@ -0,0 +1,133 @@
+// Keyglove controller source code - Touch usage statistics implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_touchstats.cpp
+ * @brief Touch usage statistics implementations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * Statistics are updated only for combinations whose status changed, so the
+ * cost of each touch status change is proportional to the number of changed
+ * bits. Press start times are kept in 16 bits, so a single hold longer than
+ * about 65 seconds is counted modulo 65536ms.
+ *
+ * Bigrams use a bounded "space saving" table: a pair that is not yet tracked
+ * replaces the least frequent slot and inherits its count plus one. This
+ * keeps the most frequent pairs with a count that is never too low, and may
+ * be too high by at most the count of the slot it replaced. Finding the pair
+ * and the least frequent slot is one scan of the table, so each press costs
+ * up to KG_TOUCHSTATS_BIGRAMS slot compares on top of its per-bit updates.
+ * This is a fixed bound (32 compares by default, well under the cost of one
+ * touch scan), so the table is not indexed.
+ *
+ * Normally it is not necessary to edit this file.
+ */
+
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touchstats.h"
+
+touchstats_t touchstats;                                                ///< Usage statistics block (downloaded as-is)
+uint32_t touchstatsResetTime;                                           ///< Timestamp of last statistics reset
+uint16_t touchstatsStart[KG_BASE_COMBINATIONS];                         ///< Press timestamp (low 16 bits of millis()) for each active combination
+uint8_t touchstatsPrev[KG_BASE_COMBINATION_BYTES];                      ///< Touch status bits from the previous call to touchstats_process()
+uint8_t touchstatsLast;                                                 ///< Most recently pressed combination (for bigrams)
+
+/**
+ * @brief Initialize touch usage statistics
+ */
+void setup_touchstats() {
+    memset(touchstatsPrev, 0, KG_BASE_COMBINATION_BYTES);
+    touchstats_reset();
+}
+
+/**
+ * @brief Clear all touch usage statistics
+ */
+void touchstats_reset() {
+    memset(&touchstats, 0, sizeof(touchstats));
+    touchstats.combinations = KG_BASE_COMBINATIONS;
+    touchstats.bigrams = KG_TOUCHSTATS_BIGRAMS;
+    touchstatsResetTime = millis();
+    touchstatsLast = KG_TOUCHSTATS_LAST_NONE;
+}
+
+/**
+ * @brief Count one occurrence of a consecutive combination pair
+ * @param[in] prev Combination pressed first
+ * @param[in] next Combination pressed immediately after
+ *
+ * Scans all KG_TOUCHSTATS_BIGRAMS slots once, for both the lookup and the
+ * least frequent slot to replace.
+ */
+void touchstats_bigram(uint8_t prev, uint8_t next) {
+    uint8_t i, low = 0;
+    touchstats_bigram_t *bigram = touchstats.bigram;
+    for (i = 0; i < KG_TOUCHSTATS_BIGRAMS; i++) {
+        if (bigram[i].count && bigram[i].prev == prev && bigram[i].next == next) {
+            if (bigram[i].count < 0xFFFF) bigram[i].count++;
+            return;
+        }
+        if (bigram[i].count < bigram[low].count) low = i;
+    }
+
+    // not tracked yet, so replace least frequent (or unused) slot
+    bigram[low].prev = prev;
+    bigram[low].next = next;
+    if (bigram[low].count < 0xFFFF) bigram[low].count++;
+}
+
+/**
+ * @brief Update usage statistics for combinations whose status changed
+ * @param[in] touches Current registered touch status bits
+ */
+void touchstats_process(const uint8_t *touches) {
+    uint8_t i, j, index, diff;
+    uint16_t now = millis();
+
+    for (i = 0; i < KG_BASE_COMBINATION_BYTES; i++) {
+        diff = touchstatsPrev[i] ^ touches[i];
+        if (!diff) continue;
+        for (j = 0; j < 8; j++) {
+            if (!(diff & (1 << j))) continue;
+            index = (i << 3) + j;
+            if (touches[i] & (1 << j)) {
+                // press
+                if (touchstats.hits[index] < 0xFFFF) touchstats.hits[index]++;
+                touchstatsStart[index] = now;
+                if (touchstatsLast != KG_TOUCHSTATS_LAST_NONE) touchstats_bigram(touchstatsLast, index);
+                touchstatsLast = index;
+            } else {
+                // release
+                touchstats.hold[index] += (uint16_t)(now - touchstatsStart[index]);
+            }
+        }
+        touchstatsPrev[i] = touches[i];
+    }
+}
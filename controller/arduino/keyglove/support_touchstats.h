@@ -0,0 +1,76 @@
+// Keyglove controller source code - Touch usage statistics declarations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file support_touchstats.h
+ * @brief Touch usage statistics declarations
+ * @author Jeff Rowberg
+ * @date 2015-07-03
+ *
+ * The statistics store counts how often each base touch combination is
+ * pressed, how long it is held in total, and which combinations are pressed
+ * one after another. Everything lives in one fixed-size block of RAM which
+ * is downloaded as-is with the kg_cmd_touch_get_usage() command, for layout
+ * analysis on the host.
+ */
+
+#ifndef _SUPPORT_TOUCHSTATS_H_
+#define _SUPPORT_TOUCHSTATS_H_
+
+#include "support_board.h"
+
+#ifndef KG_TOUCHSTATS_BIGRAMS
+    #define KG_TOUCHSTATS_BIGRAMS       32          ///< Number of tracked combination pairs (most frequent are kept, each press scans them all once)
+#endif
+
+#define KG_TOUCHSTATS_CHUNK             64          ///< Bytes of statistics data in each kg_evt_touch_usage() event
+#define KG_TOUCHSTATS_LAST_NONE         0xFF        ///< No previous combination for bigram tracking
+
+typedef struct {
+    uint8_t prev;                           ///< Combination pressed first
+    uint8_t next;                           ///< Combination pressed immediately after
+    uint16_t count;                         ///< Number of times this pair occurred (0 = unused slot)
+} touchstats_bigram_t;
+
+typedef struct {
+    uint8_t combinations;                   ///< Number of base combinations (KG_BASE_COMBINATIONS)
+    uint8_t bigrams;                        ///< Number of bigram slots (KG_TOUCHSTATS_BIGRAMS)
+    uint32_t elapsed;                       ///< Milliseconds since statistics were last reset
+    uint16_t hits[KG_BASE_COMBINATIONS];    ///< Press count for each base combination (saturates at 65535)
+    uint32_t hold[KG_BASE_COMBINATIONS];    ///< Total hold time in milliseconds for each base combination
+    touchstats_bigram_t bigram[KG_TOUCHSTATS_BIGRAMS]; ///< Most frequent consecutive combination pairs
+} touchstats_t;
+
+extern touchstats_t touchstats;
+extern uint32_t touchstatsResetTime;
+
+void setup_touchstats();
+void touchstats_reset();
+void touchstats_process(const uint8_t *touches);
+
+#endif // _SUPPORT_TOUCHSTATS_H_
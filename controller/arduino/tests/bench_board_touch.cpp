@@ -0,0 +1,88 @@
+// Keyglove controller host tests - Board touch scan benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file bench_board_touch.cpp
+ * @brief Cost of one update_board_touch() scan on each board
+ *
+ * Built once per board (see the Makefile). The simulated time a scan spends
+ * in settle delays is exact for the AVR, since it comes from the delays the
+ * scan code asks for. Host nanoseconds are measured with the simulator
+ * detached (PINx held at the levels it computed for the closed contacts) so
+ * they only cover the scan code, and are only useful for comparing changes
+ * to that code built the same way.
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touch.h"
+#include "touchsim.h"
+
+#define BENCH_SCANS             200000
+
+void run(uint8_t samples) {
+    uint8_t touches[KG_BASE_COMBINATION_BYTES];
+    uint32_t t0, drives;
+    uint64_t ns;
+
+    opt_touch_samples = samples;
+
+    // one scan through the simulator for the exact delay and step count
+    touchsim_reset();
+    touchsim_connect('A', 'Y');
+    touchsim_connect('D', 'Y');
+    memset(touches, 0, sizeof(touches));
+    t0 = mock_us;
+    update_board_touch(touches);
+    t0 = mock_us - t0;
+    drives = touchsimDrives;
+    CHECK(KGT_AY(touches) && KGT_DY(touches));
+
+    // then the scan code alone, with PINx left as the simulator set them
+    mock_delay_hook = 0;
+    ns = bench_ns();
+    for (uint32_t i = 0; i < BENCH_SCANS; i++) {
+        memset(touches, 0, sizeof(touches));
+        update_board_touch(touches);
+        bench_keep(touches);
+    }
+    ns = bench_ns() - ns;
+
+    printf("%d sample(s) per port: %u scan steps, %u us simulated settle delay per scan, %.1f host ns per scan\n",
+        samples, drives, t0, (double)ns / BENCH_SCANS);
+}
+
+int main() {
+    setup_board();
+    setup_touch();
+    printf("%d base combinations, KG_BOARD_TOUCH_SETTLE_US = %d\n", KG_BASE_COMBINATIONS, KG_BOARD_TOUCH_SETTLE_US);
+    run(1);
+    run(3);
+    return test_result();
+}
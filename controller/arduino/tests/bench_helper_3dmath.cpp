@@ -0,0 +1,141 @@
+// Keyglove controller host tests - Fixed-point 3D math benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_helper_3dmath.cpp
+ * @brief Cost of the fixed-point Mahony filter and rotation against the same math in float
+ *
+ * Times one MahonyFilter update against a float Mahony filter with the same
+ * algorithm, and fixed_rotate_q15() against the float VectorInt16::rotate()
+ * from helper_3dmath.h, on the same 100Hz samples. The host has a hardware
+ * FPU, so these timings favor float. On the AVR every float operation runs
+ * in software at 100+ cycles, while the fixed-point code only uses integer
+ * multiplies, so the gap there is much wider than shown here.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_helper_3dmath.h"
+
+#define BENCH_UPDATES           1000000
+#define RATE                    100
+#define GYRO_LSB                16.4
+
+/**
+ * @brief Float Mahony filter, same steps as MahonyFilter::update()
+ */
+struct FloatMahony {
+    Quaternion q;
+    float integral[3];
+    float gyroStep, kp, ki;
+
+    void update(VectorInt16 *accel, VectorInt16 *gyro) {
+        float hx = gyro -> x * gyroStep, hy = gyro -> y * gyroStep, hz = gyro -> z * gyroStep;
+        float m = sqrtf((float)accel -> x * accel -> x + (float)accel -> y * accel -> y + (float)accel -> z * accel -> z);
+        if (m > 0) {
+            float ax = accel -> x / m, ay = accel -> y / m, az = accel -> z / m;
+            float vx = 2 * (q.x * q.z - q.w * q.y), vy = 2 * (q.w * q.x + q.y * q.z), vz = q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z;
+            float ex = ay * vz - az * vy, ey = az * vx - ax * vz, ez = ax * vy - ay * vx;
+            integral[0] += ex * ki;
+            integral[1] += ey * ki;
+            integral[2] += ez * ki;
+            hx += integral[0] + ex * kp;
+            hy += integral[1] + ey * kp;
+            hz += integral[2] + ez * kp;
+        }
+        Quaternion c = q;
+        q.w -= hx * c.x + hy * c.y + hz * c.z;
+        q.x += hx * c.w + hz * c.y - hy * c.z;
+        q.y += hy * c.w - hz * c.x + hx * c.z;
+        q.z += hz * c.w + hy * c.x - hx * c.y;
+        q.normalize();
+    }
+};
+
+VectorInt16 benchAccel[1024], benchGyro[1024];
+
+int main() {
+    uint32_t i;
+    uint64_t t0, fixedNs, floatNs, fixedRotNs, floatRotNs;
+
+    // tilting hand: gravity swings around, gyro follows
+    for (i = 0; i < 1024; i++) {
+        double t = i / (double)RATE, roll = 0.8 * sin(1.3 * t), pitch = 0.5 * sin(0.9 * t);
+        benchAccel[i] = VectorInt16(lround(16384 * sin(pitch)), lround(-16384 * sin(roll) * cos(pitch)), lround(16384 * cos(roll) * cos(pitch)));
+        benchGyro[i] = VectorInt16(lround(0.8 * 1.3 * cos(1.3 * t) * 180 / M_PI * GYRO_LSB), lround(0.5 * 0.9 * cos(0.9 * t) * 180 / M_PI * GYRO_LSB), 0);
+    }
+
+    MahonyFilter fixed(KG_MAHONY_GYRO_STEP(GYRO_LSB, RATE), KG_MAHONY_KP_STEP(0.5, RATE), KG_MAHONY_KI_STEP(0.05, RATE));
+    FloatMahony flt = { Quaternion(), { 0, 0, 0 }, (float)(M_PI / 360 / GYRO_LSB / RATE), 0.5f / 2 / RATE, 0.05f / 2 / RATE / RATE };
+
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) fixed.update(&benchAccel[i & 1023], &benchGyro[i & 1023]);
+    fixedNs = bench_ns() - t0;
+    bench_keep(fixed.q);
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) flt.update(&benchAccel[i & 1023], &benchGyro[i & 1023]);
+    floatNs = bench_ns() - t0;
+    bench_keep(flt.q);
+
+    // both filters should agree on tilt (heading has no accel correction, so it drifts apart)
+    QuaternionQ15 q = fixed.getQuaternion();
+    double w = q.w / 32768.0, x = q.x / 32768.0, y = q.y / 32768.0, z = q.z / 32768.0;
+    double g1[3] = { 2 * (x * z - w * y), 2 * (w * x + y * z), w * w - x * x - y * y + z * z };
+    double g2[3] = { 2 * (flt.q.x * flt.q.z - flt.q.w * flt.q.y), 2 * (flt.q.w * flt.q.x + flt.q.y * flt.q.z), flt.q.w * flt.q.w - flt.q.x * flt.q.x - flt.q.y * flt.q.y + flt.q.z * flt.q.z };
+    double dot = (g1[0] * g2[0] + g1[1] * g2[1] + g1[2] * g2[2]) / sqrt(g1[0] * g1[0] + g1[1] * g1[1] + g1[2] * g1[2]);
+    double apart = acos(fmin(dot, 1.0)) * 180 / M_PI;
+    printf("Mahony update: fixed %.1f host ns, float %.1f host ns, tilt %.3f deg apart after %u updates\n",
+        (double)fixedNs / BENCH_UPDATES, (double)floatNs / BENCH_UPDATES, apart, BENCH_UPDATES);
+    CHECK(apart < 0.5);
+
+    // world-frame rotation of an accel sample, as done for every fused sample
+    Quaternion fq(flt.q.w, flt.q.x, flt.q.y, flt.q.z);
+    int32_t sum = 0;
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) {
+        VectorInt16 v = benchAccel[i & 1023];
+        fixed_rotate_q15(&v, &q);
+        sum += v.x;
+    }
+    fixedRotNs = bench_ns() - t0;
+    bench_keep(sum);
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) {
+        VectorInt16 v = benchAccel[i & 1023];
+        v.rotate(&fq);
+        sum += v.x;
+    }
+    floatRotNs = bench_ns() - t0;
+    bench_keep(sum);
+    printf("VectorInt16 rotation: fixed_rotate_q15() %.1f host ns, float rotate() %.1f host ns\n",
+        (double)fixedRotNs / BENCH_UPDATES, (double)floatRotNs / BENCH_UPDATES);
+    return test_result();
+}
@@ -0,0 +1,189 @@
+// Keyglove controller host tests - Mouse response curve benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_hid_mouse_curve.cpp
+ * @brief Cost and accuracy of the mouse response curve tables against the pow()/sqrt() code they replaced
+ *
+ * The old code ran 3 * (x / 30)^1.3 for each of the three gyro axes and
+ * sqrt(x / 30) for scroll on every update, in float. That code is kept here
+ * as a template, so it can run on plain floats for host timing and on a
+ * float stand-in that counts every soft-float library call it would make on
+ * the AVR. The per-call cycle costs below are rough figures for avr-libc's
+ * float library on a part with a hardware multiplier. There is no AVR
+ * toolchain in this build, so nothing here is measured on the glove, and the
+ * AVR cycle totals are estimates. The call counts themselves are exact.
+ *
+ * The table lookup uses only 16-bit and 32-bit integer math: one 32-bit
+ * multiply and one 32-bit shift, plus about a dozen 8/16-bit operations and
+ * two RAM reads. That is estimated at 150 cycles per lookup, call included.
+ *
+ * Output of both is compared over the whole useful input range, to check the
+ * tables stay within one count of the old formulas.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_protocol.h"
+#include "support_protocol_hid.h"
+#include "support_hid_mouse.h"
+
+#define BENCH_UPDATES           200000
+
+#define AVR_CYCLES_ADD          110     ///< Estimated cycles for a float add or subtract
+#define AVR_CYCLES_MUL          140     ///< Estimated cycles for a float multiply
+#define AVR_CYCLES_DIV          470     ///< Estimated cycles for a float divide
+#define AVR_CYCLES_CMP          50      ///< Estimated cycles for a float compare
+#define AVR_CYCLES_FROM_INT     70      ///< Estimated cycles for an int to float conversion
+#define AVR_CYCLES_TO_INT       80      ///< Estimated cycles for a float to int conversion
+#define AVR_CYCLES_SQRT         490     ///< Estimated cycles for sqrt()
+#define AVR_CYCLES_POW          3000    ///< Estimated cycles for pow() (log, multiply and exp)
+#define AVR_CYCLES_LOOKUP       150     ///< Estimated cycles for one hid_mouse_curve() call
+
+/**
+ * @brief Counts of soft-float library calls
+ */
+struct float_ops_t {
+    uint32_t add, mul, div, cmp, fromInt, toInt, sqrt, pow;
+} floatOps;
+
+/**
+ * @brief Float stand-in counting each operation the AVR would run in software
+ *
+ * Negation only flips the sign bit, and constants are folded by the
+ * compiler, so neither is counted.
+ */
+struct CountedFloat {
+    float v;
+    CountedFloat(float value, bool) : v(value) { }
+    explicit CountedFloat(int16_t value) : v(value) { floatOps.fromInt++; }
+    explicit operator int8_t() const { floatOps.toInt++; return (int8_t)v; }
+    CountedFloat operator-() const { return CountedFloat(-v, true); }
+    CountedFloat operator-(const CountedFloat &b) const { floatOps.add++; return CountedFloat(v - b.v, true); }
+    CountedFloat operator*(float b) const { floatOps.mul++; return CountedFloat(v * b, true); }
+    CountedFloat operator/(float b) const { floatOps.div++; return CountedFloat(v / b, true); }
+    bool operator<(float b) const { floatOps.cmp++; return v < b; }
+};
+
+CountedFloat pow(const CountedFloat &x, float y) { floatOps.pow++; return CountedFloat(powf(x.v, y), true); }
+CountedFloat sqrt(const CountedFloat &x) { floatOps.sqrt++; return CountedFloat(sqrtf(x.v), true); }
+
+/**
+ * @brief One update of the old tilt-position cursor and scroll code
+ *
+ * Same expressions as update_hid_mouse() before the response curves, with
+ * the float type as a parameter. On the AVR, double is the same as float.
+ */
+template <typename T> void old_update(int16_t gx, int16_t gy, int16_t gz, int8_t *dx, int8_t *dy, int8_t *scroll) {
+    *dx = (int8_t)(((gy < 0) ? -pow(-T(gy)/30, 1.3f)*3 : pow(T(gy)/30, 1.3f)*3) - ((gz < 0) ? -pow(-T(gz)/30, 1.3f)*3 : pow(T(gz)/30, 1.3f)*3));
+    *dy = (int8_t)((gx < 0) ? -pow(-T(gx)/30, 1.3f)*3 : pow(T(gx)/30, 1.3f)*3);
+    *scroll = (int8_t)(T((int16_t)*scroll) - ((T(gy) < 0) ? -sqrt(-T(gy) / 30) : sqrt(T(gy) / 30)));
+}
+
+/**
+ * @brief One update of the same modes with the response curve tables, like hid_mouse_sample() does it
+ */
+void new_update(int16_t gx, int16_t gy, int16_t gz, int16_t *dx, int16_t *dy, int16_t *dz) {
+    *dx = hid_mouse_curve(KG_HID_CURVE_CURSOR, gy) - hid_mouse_curve(KG_HID_CURVE_CURSOR, gz);
+    *dy = hid_mouse_curve(KG_HID_CURVE_CURSOR, gx);
+    *dz -= hid_mouse_curve(KG_HID_CURVE_SCROLL, gy);
+}
+
+int16_t benchGyro[1024][3];
+
+/**
+ * @brief Largest difference between a table and its formula over an input range, in counts
+ */
+double curve_error(uint8_t curve, int16_t from, int16_t to) {
+    double worst = 0;
+    for (int16_t v = from; v <= to; v++) {
+        double a = fabs(v) / 30, expect = curve == KG_HID_CURVE_CURSOR ? 3 * pow(a, 1.3) : sqrt(a);
+        if (v < 0) expect = -expect;
+        worst = fmax(worst, fabs(hid_mouse_curve(curve, v) / 16.0 - expect));
+    }
+    return worst;
+}
+
+int main() {
+    uint32_t i, seed = 4321;
+    uint64_t t0, oldNs, newNs;
+    setup_hid_mouse();
+
+    // slow hand tilts with sensor noise, filtered gyro units
+    for (i = 0; i < 1024; i++) {
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            seed = seed * 1103515245 + 12345;
+            benchGyro[i][axis] = (int16_t)(300 * sin(2 * M_PI * (i + axis * 100) / 256.0)) + (int16_t)((seed >> 16) % 21) - 10;
+        }
+    }
+
+    // accuracy: within one count over the range the tables were built for, and held at the last point beyond it
+    double cursorError = curve_error(KG_HID_CURVE_CURSOR, -512, 512), scrollError = curve_error(KG_HID_CURVE_SCROLL, -512, 512);
+    printf("table vs formula over +/-512: cursor %.3f counts, scroll %.3f counts worst case\n", cursorError, scrollError);
+    CHECK(cursorError < 1.0);
+    CHECK(scrollError < 1.0);
+    CHECK_EQ(hid_mouse_curve(KG_HID_CURVE_CURSOR, 2000), hidMouseCurve[KG_HID_CURVE_CURSOR][KG_HID_MOUSE_CURVE_POINTS - 1]);
+    CHECK_EQ(hid_mouse_curve(KG_HID_CURVE_CURSOR, -2000), -hidMouseCurve[KG_HID_CURVE_CURSOR][KG_HID_MOUSE_CURVE_POINTS - 1]);
+
+    // AVR cost per update: count float library calls of the old code
+    int8_t odx = 0, ody = 0, oscroll = 0;
+    memset(&floatOps, 0, sizeof(floatOps));
+    for (i = 0; i < 1024; i++) old_update<CountedFloat>(benchGyro[i][0], benchGyro[i][1], benchGyro[i][2], &odx, &ody, &oscroll);
+    double add = floatOps.add / 1024.0, mul = floatOps.mul / 1024.0, div = floatOps.div / 1024.0, cmp = floatOps.cmp / 1024.0;
+    double fromInt = floatOps.fromInt / 1024.0, toInt = floatOps.toInt / 1024.0, sqrtCalls = floatOps.sqrt / 1024.0, powCalls = floatOps.pow / 1024.0;
+    double oldCycles = add * AVR_CYCLES_ADD + mul * AVR_CYCLES_MUL + div * AVR_CYCLES_DIV + cmp * AVR_CYCLES_CMP
+        + fromInt * AVR_CYCLES_FROM_INT + toInt * AVR_CYCLES_TO_INT + sqrtCalls * AVR_CYCLES_SQRT + powCalls * AVR_CYCLES_POW;
+    double newCycles = 4 * AVR_CYCLES_LOOKUP + 2 * 4;   // four lookups, two 16-bit subtracts
+    printf("pow/sqrt per update: %.0f pow, %.0f sqrt, %.0f div, %.0f mul, %.0f add/sub, %.0f compare, %.0f int->float, %.0f float->int\n",
+        powCalls, sqrtCalls, div, mul, add, cmp, fromInt, toInt);
+    printf("estimated AVR cycles per update: pow/sqrt %.0f (%.2fms at 8MHz) | tables %.0f (%.3fms at 8MHz)\n",
+        oldCycles, oldCycles / 8000, newCycles, newCycles / 8000);
+    CHECK_EQ(floatOps.pow, 3 * 1024);
+    CHECK_EQ(floatOps.sqrt, 1024);
+    CHECK(oldCycles > 10 * newCycles);
+
+    // host timing of both, same inputs
+    int16_t ndx = 0, ndy = 0, ndz = 0;
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) {
+        old_update<float>(benchGyro[i & 1023][0], benchGyro[i & 1023][1], benchGyro[i & 1023][2], &odx, &ody, &oscroll);
+        bench_keep(odx);
+    }
+    oldNs = bench_ns() - t0;
+    t0 = bench_ns();
+    for (i = 0; i < BENCH_UPDATES; i++) {
+        new_update(benchGyro[i & 1023][0], benchGyro[i & 1023][1], benchGyro[i & 1023][2], &ndx, &ndy, &ndz);
+        bench_keep(ndx);
+    }
+    newNs = bench_ns() - t0;
+    printf("host ns per update: pow/sqrt %.1f | tables %.1f\n", (double)oldNs / BENCH_UPDATES, (double)newNs / BENCH_UPDATES);
+    return test_result();
+}
@@ -0,0 +1,164 @@
+// Keyglove controller host tests - Motion batch event size and rate
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_motion_batch.cpp
+ * @brief Packets per second and link bytes per sample, separate motion data events vs. motion batch events
+ *
+ * Runs the real hand sensor driver against a simulated MPU-6050 for ten
+ * seconds at 100Hz with each batch setting, and catches every outgoing KGAPI
+ * packet. Built once without fusion (12-byte raw samples) and once with the
+ * Mahony filter (26-byte fused samples). Every motion batch event is unpacked
+ * the way kglib.py does it and compared with the samples the driver handed to
+ * kg_evt_motion_data, including the tick time of the first sample.
+ *
+ * Packet counts and KGAPI bytes are measured. The Bluetooth figures add the
+ * iWRAP MUX frame (start byte, link, two flag/length bytes, and a trailing
+ * inverted link byte) to every packet, which is taken from the iWRAP frame
+ * format since the iWRAP library isn't built here, and leave out radio and
+ * RFCOMM overhead. The UART carries 10 bits per byte at
+ * KG_HOSTIF_BT2_SERIAL_BAUD.
+ */
+
+#include <math.h>
+#include <vector>
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "mpusim.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+
+#define BENCH_SECONDS           10
+#define BENCH_LOOP_US           100     ///< Simulated time per main loop pass
+#define BENCH_MUX_BYTES         5       ///< iWRAP MUX frame bytes added to every packet sent over Bluetooth
+
+MpuSim mpu(0x68, KG_INTERRUPT_NUM_MPU6050_HAND);
+bool benchBluetooth;                    ///< What bluetooth_api_ready() reports
+
+std::vector<uint8_t> sent;              ///< Sample data handed to kg_evt_motion_data, back to back
+std::vector<uint8_t> received;          ///< Sample data unpacked from outgoing packets, back to back
+std::vector<uint16_t> sentTime;         ///< Tick time of every sample handed to kg_evt_motion_data
+uint32_t packets, packetBytes, badTimes, sampleSize;
+
+bool bluetooth_api_ready() {
+    return benchBluetooth;
+}
+
+/**
+ * @brief Slow hand rotation, so the driver never decides the hand is still
+ */
+void hand_motion(uint32_t us, int16_t *motion) {
+    double t = us / 1000000.0;
+    motion[0] = 4000 * sin(t * 3.1);
+    motion[1] = 3000 * cos(t * 2.3);
+    motion[2] = 15000;
+    motion[3] = 2000 * sin(t * 5.0);
+    motion[4] = 1500 * cos(t * 4.1);
+    motion[5] = 1000 * sin(t * 1.7);
+}
+
+uint8_t record_motion_data(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data) {
+    sent.insert(sent.end(), data_data, data_data + data_len);
+    sentTime.push_back(keygloveTock * 100 + keygloveTick);
+    sampleSize = data_len;
+    return 0;   // let the driver build its packet
+}
+
+/**
+ * @brief Catch outgoing packets and unpack motion data and motion batch events
+ */
+uint8_t send_keyglove_packet(uint8_t type, uint8_t length, uint8_t packet_class, uint8_t packet_id, uint8_t *payload) {
+    packets++;
+    packetBytes += 4 + length;
+    if (packet_class != KG_PACKET_CLASS_MOTION) return 0;
+    if (packet_id == KG_PACKET_ID_EVT_MOTION_DATA) {
+        received.insert(received.end(), payload + 3, payload + 3 + payload[2]);
+    } else if (packet_id == KG_PACKET_ID_EVT_MOTION_BATCH) {
+        // time (payload[3..4]) belongs to the first sample in the batch
+        uint32_t first = received.size() / sampleSize;
+        if (first >= sentTime.size() || sentTime[first] != (payload[3] | (payload[4] << 8))) badTimes++;
+        if (payload[5] != payload[2] * sampleSize) badTimes++;
+        received.insert(received.end(), payload + 6, payload + 6 + payload[5]);
+    }
+    return 0;
+}
+
+void run(const char *name, uint8_t batch, bool bluetooth) {
+    twisim_reset();
+    mpu.reset();
+    mpu.source = hand_motion;
+    twisim_attach(&mpu);
+    setup_i2c();
+    TWBR = ((F_CPU / 400000) - 16) / 2;
+    opt_motion_hand_batch = batch;
+    benchBluetooth = bluetooth;
+    setup_motion();
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_ON);
+
+    sent.clear();
+    received.clear();
+    sentTime.clear();
+    packets = packetBytes = badTimes = 0;
+
+    for (uint32_t end = mock_us + BENCH_SECONDS * 1000000UL; (int32_t)(mock_us - end) < 0; ) {
+        mock_advance_us(BENCH_LOOP_US);
+        keygloveTock = mock_us / 1000000;
+        keygloveTick = mock_us / 10000 % 100;
+        update_motion();
+        update_i2c();
+    }
+
+    // turning the sensor off sends any partial batch
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_OFF);
+
+    uint32_t samples = sentTime.size();
+    double perSample = (double)packetBytes / samples, perSampleBT = (double)(packetBytes + packets * BENCH_MUX_BYTES) / samples;
+    double uart = perSampleBT * samples / BENCH_SECONDS / (KG_HOSTIF_BT2_SERIAL_BAUD / 10) * 100;
+    printf("%-2u-byte samples, %-16s %4u samples, %5.1f pkt/s | %4.1f B/sample (USB) | %4.1f B/sample, %4.1f%% of BT UART (Bluetooth)\n",
+        sampleSize, name, samples, (double)packets / BENCH_SECONDS, perSample, perSampleBT, uart);
+
+    CHECK(samples >= BENCH_SECONDS * 100 - 20);
+    CHECK(received == sent);
+    CHECK_EQ(badTimes, 0);
+    CHECK_EQ(packets, (samples + motion_mpu6050_hand_batch_size() - 1) / motion_mpu6050_hand_batch_size());
+}
+
+int main() {
+    kg_evt_motion_data = record_motion_data;
+    opt_motion_hand_rate_div = 9;   // 100Hz
+    run("unbatched:", 1, false);
+    run("auto, USB:", 0, false);
+    run("auto, Bluetooth:", 0, true);
+    run("largest batch:", 255, false);
+    return test_result();
+}
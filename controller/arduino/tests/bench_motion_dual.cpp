@@ -0,0 +1,191 @@
+// Keyglove controller host tests - Two motion sensors and battery gauge on one I2C bus
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_motion_dual.cpp
+ * @brief Throughput and latency of the I2C scheduler with hand and index tip sensors at 200Hz each
+ *
+ * Runs the real I2C scheduler, hand and index tip drivers against two
+ * simulated MPU-6050s (0x68 and 0x69) and a MAX17048 battery gauge (0x36),
+ * all on one simulated TWI bus, for ten seconds at 100kHz and 400kHz. Both
+ * sensors sample at 200Hz. The battery gauge client is the same one-byte SOC
+ * read that keyglove.cpp requests once per second. Each delivered sample also
+ * costs BENCH_PROCESS_US of main loop time, standing in for filtering,
+ * fusion and the host link.
+ *
+ * Latency is measured from when a sensor takes a sample until its motion data
+ * event, using the sample times recorded by the simulated sensors. Bus time
+ * leaves out clock stretching and the interrupt latency between bytes (see
+ * bench_motion_i2c.cpp), so real bus load is a little higher.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "mpusim.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+
+#define BENCH_SECONDS           10
+#define BENCH_LOOP_US           100     ///< Simulated time per main loop pass
+#define BENCH_PROCESS_US        250     ///< Simulated main loop time used per delivered sample
+#define BENCH_RATE_DIV          4       ///< 1kHz / (1 + 4) = 200Hz
+#define BENCH_HISTORY           1024    ///< Sample times remembered per sensor (must cover the FIFO)
+
+/**
+ * @brief Sample times and delivery statistics for one simulated sensor
+ */
+struct sensor_t {
+    uint32_t taken;                     ///< Samples taken since the run started
+    uint32_t delivered;                 ///< Motion data events since the run started
+    uint32_t sampleUs[BENCH_HISTORY];   ///< Time each sample was taken, by sample number
+    uint32_t worstUs;                   ///< Longest time from sample to event
+    uint64_t totalUs;                   ///< Sum of times from sample to event
+    uint16_t worstFifo;                 ///< Most bytes seen waiting in the FIFO
+};
+
+sensor_t sensors[2];
+MpuSim hand(0x68, KG_INTERRUPT_NUM_MPU6050_HAND), tip(0x69, KG_INTERRUPT_NUM_MPU6050_INDEXTIP);
+TwisimDevice gauge(0x36);
+
+uint8_t batteryClient;                  ///< I2C client for the battery gauge
+uint8_t batteryBuffer;                  ///< SOC register high byte
+uint32_t batteryReads;                  ///< Completed battery gauge reads
+
+/**
+ * @brief Keep both sensors moving, and remember when each sample was taken
+ */
+void record(sensor_t *sensor, uint32_t us, int16_t *motion, double phase) {
+    double t = us / 1000000.0 + phase;
+    motion[0] = 4000 * sin(t * 3.1);
+    motion[1] = 3000 * cos(t * 2.3);
+    motion[2] = 15000;
+    motion[3] = 2000 * sin(t * 5.0);
+    motion[4] = 1500 * cos(t * 4.1);
+    motion[5] = 1000 * sin(t * 1.7);
+    sensor -> sampleUs[sensor -> taken++ % BENCH_HISTORY] = us;
+}
+
+void hand_motion(uint32_t us, int16_t *motion) { record(&sensors[0], us, motion, 0); }
+void tip_motion(uint32_t us, int16_t *motion) { record(&sensors[1], us, motion, 1.5); }
+
+uint8_t count_motion_data(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data) {
+    sensor_t *sensor = &sensors[index];
+    uint32_t age = mock_us - sensor -> sampleUs[sensor -> delivered++ % BENCH_HISTORY];
+    if (age > sensor -> worstUs) sensor -> worstUs = age;
+    sensor -> totalUs += age;
+    mock_advance_us(BENCH_PROCESS_US);
+    return 1;   // don't build a packet
+}
+
+/**
+ * @brief Battery gauge service and completion routines, same transfer as keyglove.cpp
+ */
+void battery_update() {
+    i2c_read(batteryClient, 0x36, 0x04, 1, &batteryBuffer);
+}
+
+uint8_t battery_complete(uint8_t status) {
+    if (status == KG_I2C_STATUS_DONE && batteryBuffer == 87) batteryReads++;
+    return 0;
+}
+
+void run(uint32_t clock) {
+    uint32_t nextBatteryUs, startSpinUs;
+    uint64_t startBusNs;
+
+    twisim_reset();
+    hand.reset();
+    tip.reset();
+    hand.source = hand_motion;
+    tip.source = tip_motion;
+    gauge.regs[0x04] = 87;
+    twisim_attach(&hand);
+    twisim_attach(&tip);
+    twisim_attach(&gauge);
+    setup_i2c();
+    TWBR = ((F_CPU / clock) - 16) / 2;
+    batteryClient = i2c_register(battery_update, battery_complete);
+    batteryReads = 0;
+
+    opt_motion_hand_rate_div = BENCH_RATE_DIV;
+    opt_motion_indextip_rate_div = BENCH_RATE_DIV;
+    setup_motion();
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_ON);
+    motion_set_mode(KG_MOTION_MPU6050_INDEXTIP_INDEX, KG_MOTION_MODE_ON);
+
+    // both FIFOs were just reset, so count samples from here
+    memset(sensors, 0, sizeof(sensors));
+    startSpinUs = twisimSpinUs;
+    startBusNs = twisimBusNs;
+    nextBatteryUs = mock_us;
+
+    for (uint32_t end = mock_us + BENCH_SECONDS * 1000000UL; (int32_t)(mock_us - end) < 0; ) {
+        mock_advance_us(BENCH_LOOP_US);
+        if ((int32_t)(mock_us - nextBatteryUs) >= 0) {
+            i2c_request(batteryClient);
+            nextBatteryUs += 1000000;
+        }
+        update_motion();
+        update_i2c();
+        sensors[0].worstFifo = max(sensors[0].worstFifo, hand.fifo_count());
+        sensors[1].worstFifo = max(sensors[1].worstFifo, tip.fifo_count());
+    }
+
+    double busy = (twisimBusNs - startBusNs) / 10000000.0 / BENCH_SECONDS;
+    for (uint8_t i = 0; i < 2; i++) {
+        sensor_t *sensor = &sensors[i];
+        printf("%3ukHz, %-9s %5u taken, %5u delivered (%5.1f/s) | latency %5.1fms avg, %5.1fms worst | FIFO at most %2u samples\n",
+            clock / 1000, i ? "index tip:" : "hand:", sensor -> taken, sensor -> delivered, (double)sensor -> delivered / BENCH_SECONDS,
+            sensor -> totalUs / 1000.0 / sensor -> delivered, sensor -> worstUs / 1000.0, sensor -> worstFifo / KG_MPU6050_FIFO_SAMPLE_SIZE);
+
+        // every sample arrives, except the ones still waiting for the FIFO watermark at the end
+        CHECK(sensor -> delivered + 2 * KG_MPU6050_HAND_FIFO_BURST >= sensor -> taken);
+        CHECK(sensor -> worstUs < 50000);
+    }
+    printf("%3ukHz: bus %.1f%% busy, %u battery reads, %u us main loop blocked\n", clock / 1000, busy, batteryReads, twisimSpinUs - startSpinUs);
+    CHECK_EQ(hand.overflows + tip.overflows, 0);
+    CHECK(batteryReads >= BENCH_SECONDS);
+    CHECK_EQ(twisimSpinUs, startSpinUs);
+    CHECK(busy < 100);
+
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_OFF);
+    motion_set_mode(KG_MOTION_MPU6050_INDEXTIP_INDEX, KG_MOTION_MODE_OFF);
+}
+
+int main() {
+    kg_evt_motion_data = count_motion_data;
+    run(100000);
+    run(400000);
+    return test_result();
+}
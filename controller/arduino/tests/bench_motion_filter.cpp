@@ -0,0 +1,181 @@
+// Keyglove controller host tests - Motion smoothing filter benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_motion_filter.cpp
+ * @brief Cost and frequency response of each motion smoothing filter setting
+ *
+ * Times six axes of filtering per sample for the old float smoothing code,
+ * the shift filter, and the fixed-point biquad, plus a float biquad for
+ * reference. Host timings only compare the implementations with each other;
+ * on the AVR, float math is done in software and the gap is much wider.
+ *
+ * The frequency response is measured by running sine waves through the
+ * firmware filter at a 100Hz sample rate: lag at 2Hz (typical hand motion),
+ * and how much is left of 20Hz (tremor and vibration) and of white noise.
+ * The biquad removes the same amount of 20Hz as a shift filter with less lag,
+ * but white noise is spread over all frequencies, so it does no better there.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_motion.h"
+
+#define BENCH_SAMPLES           200000
+#define BENCH_RATE              100.0
+
+int16_t benchInput[1024][6];
+double benchLag[KG_MPU6050_FILTER_BIQUAD + KG_MPU6050_FILTER_BIQUAD_COUNT];     ///< 2Hz lag by setting
+double benchLeft[KG_MPU6050_FILTER_BIQUAD + KG_MPU6050_FILTER_BIQUAD_COUNT];    ///< 20Hz gain by setting
+
+/**
+ * @brief Measure gain and lag of axis 0's filter for a sine at one frequency
+ */
+void response(double hz, double *gain, double *lagMs) {
+    double s = 0, c = 0, w = 2 * M_PI * hz / BENCH_RATE, phase;
+    motion_mpu6050_hand_filter_reset();
+    for (uint32_t i = 0; i < 3000; i++) {
+        int16_t out = motion_mpu6050_hand_filter(0, (int16_t)(16000 * sin(w * i)));
+        if (i < 1000) continue;
+        s += out * sin(w * i);
+        c += out * cos(w * i);
+    }
+    *gain = sqrt(s * s + c * c) / 16000 / 1000;
+    phase = -atan2(c, s);
+    if (phase < 0) phase += 2 * M_PI;
+    *lagMs = phase / w * 1000 / BENCH_RATE;
+}
+
+/**
+ * @brief Measure how much of white noise is left after axis 0's filter
+ */
+double noise() {
+    double in = 0, out = 0;
+    uint32_t seed = 99;
+    motion_mpu6050_hand_filter_reset();
+    for (uint32_t i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        int16_t raw = (int16_t)((seed >> 12) & 0x1FFF) - 4096, filtered = motion_mpu6050_hand_filter(0, raw);
+        in += (double)raw * raw;
+        out += (double)filtered * filtered;
+    }
+    return sqrt(out / in);
+}
+
+void run(const char *name, uint8_t setting) {
+    double gain2, lag2, gain20, lag20;
+    uint64_t t0, ns;
+    int32_t sum = 0;
+
+    memset(opt_motion_hand_filter, setting, sizeof(opt_motion_hand_filter));
+    response(2, &gain2, &lag2);
+    response(20, &gain20, &lag20);
+
+    motion_mpu6050_hand_filter_reset();
+    t0 = bench_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        const int16_t *raw = benchInput[i & 1023];
+        for (uint8_t axis = 0; axis < 6; axis++) sum += motion_mpu6050_hand_filter(axis, raw[axis]);
+    }
+    ns = bench_ns() - t0;
+    bench_keep(sum);
+    benchLag[setting] = lag2;
+    benchLeft[setting] = gain20;
+    printf("%-14s %5.1f host ns/sample | 2Hz lag %5.1f ms, 20Hz left %5.1f%%, noise left %5.1f%%\n",
+        name, (double)ns / BENCH_SAMPLES, lag2, gain20 * 100, noise() * 100);
+}
+
+/**
+ * @brief Old smoothing code, in float as avr-gcc compiles it (double is float there)
+ */
+void run_old_float() {
+    int16_t state[6] = { 0 };
+    uint64_t t0 = bench_ns(), ns;
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        const int16_t *raw = benchInput[i & 1023];
+        for (uint8_t axis = 0; axis < 6; axis++) {
+            state[axis] = state[axis] + (0.25f * (raw[axis] - state[axis]));
+            sum += state[axis];
+        }
+    }
+    ns = bench_ns() - t0;
+    bench_keep(sum);
+    printf("%-14s %5.1f host ns/sample\n", "old float 1/4", (double)ns / BENCH_SAMPLES);
+}
+
+/**
+ * @brief Same biquad in float, with the 10% coefficients
+ */
+void run_float_biquad() {
+    const float b0 = 0.0674553f, b1 = 0.1349105f, a1 = -1.1429805f, a2 = 0.4128016f;
+    float h[6][4] = { { 0 } };
+    uint64_t t0 = bench_ns(), ns;
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        const int16_t *raw = benchInput[i & 1023];
+        for (uint8_t axis = 0; axis < 6; axis++) {
+            float *s = h[axis], y = b0 * (raw[axis] + s[1]) + b1 * s[0] - a1 * s[2] - a2 * s[3];
+            s[1] = s[0];
+            s[0] = raw[axis];
+            s[3] = s[2];
+            s[2] = y;
+            sum += (int16_t)y;
+        }
+    }
+    ns = bench_ns() - t0;
+    bench_keep(sum);
+    printf("%-14s %5.1f host ns/sample\n", "float biquad", (double)ns / BENCH_SAMPLES);
+}
+
+int main() {
+    char name[32];
+    for (uint16_t i = 0; i < 1024; i++) {
+        for (uint8_t axis = 0; axis < 6; axis++) benchInput[i][axis] = (int16_t)(8000 * sin(i * 0.05 + axis) + (i * 7919 + axis * 104729) % 401 - 200);
+    }
+
+    run_old_float();
+    for (uint8_t shift = 1; shift <= 4; shift++) {
+        snprintf(name, sizeof(name), "shift %d", shift);
+        run(name, shift);
+    }
+    for (uint8_t n = 0; n < KG_MPU6050_FILTER_BIQUAD_COUNT; n++) {
+        snprintf(name, sizeof(name), "biquad %2d%%", (n + 1) * 5);
+        run(name, KG_MPU6050_FILTER_BIQUAD + n);
+    }
+    run_float_biquad();
+
+    // for the same or better tremor removal, the biquad lags less than the shift filter
+    CHECK(benchLeft[KG_MPU6050_FILTER_BIQUAD + 1] < benchLeft[2] && benchLag[KG_MPU6050_FILTER_BIQUAD + 1] < benchLag[2]);
+    CHECK(benchLeft[KG_MPU6050_FILTER_BIQUAD] < benchLeft[4] && benchLag[KG_MPU6050_FILTER_BIQUAD] < benchLag[4]);
+    return test_result();
+}
@@ -0,0 +1,223 @@
+// Keyglove controller host tests - Motion sensor I2C cost benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_motion_i2c.cpp
+ * @brief I2C traffic and main loop blocking per hand sensor sample, polled vs. FIFO bursts
+ *
+ * Runs the real I2C queue and hand sensor driver against a simulated MPU-6050
+ * on a simulated TWI bus for ten seconds of hand motion at 100Hz. The FIFO
+ * path is the current driver, which counts data-ready interrupts and reads
+ * KG_MPU6050_HAND_FIFO_WATERMARK samples at a time in the background. The
+ * polled path is what the driver used to do for every data-ready interrupt:
+ * read INT_STATUS, then all 14 bytes of accel, temperature, and gyro data,
+ * waiting for each read to finish. It is run at both 100kHz (the old Wire
+ * clock) and 400kHz.
+ *
+ * Bus bytes, START conditions, and TWI interrupts carry over to the AVR
+ * exactly. Bus time follows the TWI bit rate formula, but leaves out clock
+ * stretching and the interrupt latency between bytes, so real transfers take
+ * a little longer. Main loop blocking is the simulated time spent spinning in
+ * i2c_read_bytes()/i2c_write_bytes(), i.e. while the CPU could not scan
+ * touches or handle the host link.
+ *
+ * The FIFO path is also run with one long main loop stall in the middle, to
+ * check that 85 samples of FIFO space cover a stall of up to 850ms without
+ * losing anything, and that a longer one is detected and recovered from.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "mpusim.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+
+#define BENCH_SECONDS           10
+#define BENCH_LOOP_US           100     ///< Simulated time per main loop pass
+
+MpuSim mpu(0x68, KG_INTERRUPT_NUM_MPU6050_HAND);
+uint32_t benchEvents;                   ///< Motion data events sent
+volatile bool benchReady;               ///< Polled path data-ready flag
+
+/**
+ * @brief Slow hand rotation, so the driver never decides the hand is still
+ */
+void hand_motion(uint32_t us, int16_t *motion) {
+    double t = us / 1000000.0;
+    motion[0] = 4000 * sin(t * 3.1);
+    motion[1] = 3000 * cos(t * 2.3);
+    motion[2] = 15000;
+    motion[3] = 2000 * sin(t * 5.0);
+    motion[4] = 1500 * cos(t * 4.1);
+    motion[5] = 1000 * sin(t * 1.7);
+}
+
+uint8_t count_motion_data(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data) {
+    benchEvents++;
+    return 1;   // don't build a packet
+}
+
+/**
+ * @brief Bus counters at one point in time, to take the difference over a run
+ */
+struct counters_t {
+    uint32_t starts, bytes, interrupts, spinUs, samples;
+    uint64_t busNs;
+
+    void take() {
+        starts = twisimStarts;
+        bytes = twisimBytes;
+        interrupts = twisimInterrupts;
+        spinUs = twisimSpinUs;
+        busNs = twisimBusNs;
+        samples = mpu.samples;
+    }
+};
+
+counters_t benchStart;                  ///< Counters at the start of the last FIFO run
+
+void bus_setup(uint32_t clock) {
+    twisim_reset();
+    mpu.reset();
+    mpu.source = hand_motion;
+    twisim_attach(&mpu);
+    setup_i2c();
+    TWBR = ((F_CPU / clock) - 16) / 2;
+}
+
+void report(const char *name, const counters_t &start, uint32_t delivered) {
+    counters_t end;
+    end.take();
+    uint32_t samples = end.samples - start.samples;
+    printf("%-28s %5u samples, %5u delivered | per sample: %5.2f STARTs, %5.1f bytes, %5.1f TWI interrupts, %6.1f us bus, %6.1f us main loop blocked\n",
+        name, samples, delivered,
+        (double)(end.starts - start.starts) / samples, (double)(end.bytes - start.bytes) / samples,
+        (double)(end.interrupts - start.interrupts) / samples,
+        (end.busNs - start.busNs) / 1000.0 / samples, (double)(end.spinUs - start.spinUs) / samples);
+}
+
+void polled_interrupt() {
+    benchReady = true;
+}
+
+/**
+ * @brief Old per-sample path: blocking INT_STATUS and data register reads on every data-ready interrupt
+ */
+void run_polled(uint32_t clock) {
+    uint8_t config[4] = { 9, 3, 3 << 3, 0 }, status, data[14];
+    uint32_t delivered = 0;
+    counters_t start;
+    char name[32];
+
+    bus_setup(clock);
+    i2c_write_byte(0x68, MPU6050_RA_INT_PIN_CFG, 0xD0);
+    i2c_write_byte(0x68, MPU6050_RA_INT_ENABLE, 0x01);
+    i2c_write_bytes(0x68, MPU6050_RA_SMPLRT_DIV, 4, config);
+    i2c_write_byte(0x68, MPU6050_RA_PWR_MGMT_1, 0x01);
+    attachInterrupt(KG_INTERRUPT_NUM_MPU6050_HAND, polled_interrupt, FALLING);
+    benchReady = false;
+
+    start.take();
+    for (uint32_t end = mock_us + BENCH_SECONDS * 1000000UL; (int32_t)(mock_us - end) < 0; ) {
+        mock_advance_us(BENCH_LOOP_US);
+        if (!benchReady) continue;
+        benchReady = false;
+        if (i2c_read_bytes(0x68, MPU6050_RA_INT_STATUS, 1, &status) != KG_I2C_STATUS_DONE || !(status & 0x01)) continue;
+        if (i2c_read_bytes(0x68, MPU6050_RA_ACCEL_XOUT_H, 14, data) == KG_I2C_STATUS_DONE) delivered++;
+    }
+    detachInterrupt(KG_INTERRUPT_NUM_MPU6050_HAND);
+    snprintf(name, sizeof(name), "polled, %3ukHz:", clock / 1000);
+    report(name, start, delivered);
+    CHECK_EQ(mpu.overflows, 0);
+    CHECK(delivered + 1 >= mpu.samples - start.samples);
+}
+
+/**
+ * @brief Current path: the hand sensor driver reading FIFO bursts through the I2C queue
+ */
+void run_fifo(uint32_t clock, uint32_t stallMs = 0) {
+    bool stalled = false;
+    char name[48];
+
+    bus_setup(clock);
+    setup_motion();
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_ON);
+    benchEvents = 0;
+
+    benchStart.take();
+    for (uint32_t end = mock_us + BENCH_SECONDS * 1000000UL; (int32_t)(mock_us - end) < 0; ) {
+        mock_advance_us(BENCH_LOOP_US);
+        update_motion();
+        update_i2c();
+        if (stallMs && !stalled && (int32_t)(mock_us - end) >= -(int32_t)(BENCH_SECONDS * 500000UL)) {
+            mock_advance_us(stallMs * 1000);
+            stalled = true;
+        }
+    }
+    if (stallMs) snprintf(name, sizeof(name), "FIFO, %3ukHz, %4ums stall:", clock / 1000, stallMs);
+    else snprintf(name, sizeof(name), "FIFO bursts, %3ukHz:", clock / 1000);
+    report(name, benchStart, benchEvents);
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_OFF);
+}
+
+int main() {
+    kg_evt_motion_data = count_motion_data;
+    run_polled(100000);
+    run_polled(400000);
+    uint32_t lost;
+
+    run_fifo(100000);
+    run_fifo(400000);
+
+    // nothing lost or blocked while streaming, only the last (partial) burst is still waiting
+    CHECK_EQ(mpu.overflows, 0);
+    CHECK(benchEvents + KG_MPU6050_HAND_FIFO_WATERMARK >= mpu.samples);
+    CHECK_EQ(twisimSpinUs, benchStart.spinUs);
+
+    // an 800ms stall fits in the FIFO
+    mock_calls_clear();
+    run_fifo(400000, 800);
+    CHECK_EQ(mpu.overflows, 0);
+    CHECK(benchEvents + KG_MPU6050_HAND_FIFO_WATERMARK >= mpu.samples);
+    CHECK(strstr(mock_calls, "MOTION OFLO") == 0);
+
+    // a 2s stall overflows it, which is detected, and only the samples from the stall are lost
+    mock_calls_clear();
+    run_fifo(400000, 2000);
+    lost = mpu.samples - benchEvents;
+    CHECK(mpu.overflows > 0);
+    CHECK(strstr(mock_calls, "MOTION OFLO") != 0);
+    CHECK(lost >= 200 && lost < 200 + 2 * KG_MPU6050_HAND_FIFO_BURST);
+    return test_result();
+}
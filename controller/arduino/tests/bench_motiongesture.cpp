@@ -0,0 +1,191 @@
+// Keyglove controller host tests - Motion gesture engine benchmark over gyro traces
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_motiongesture.cpp
+ * @brief Per-sample cost and match results of the motion gesture engine over gyro traces
+ *
+ * Stores the four templates in traces/gesture_*.csv in EEPROM through
+ * motiongesture_set_template(), then replays traces/gesture_session.csv (a
+ * minute of hand motion at 100Hz with each gesture performed three times at
+ * different speeds and sizes) through motiongesture_process(), the same way
+ * the hand sensor driver calls it. See traces/make_gesture_traces.py for how
+ * the traces were made.
+ *
+ * Every reported match has to fall right after a marked gesture of the same
+ * slot, and every marked gesture has to be reported once. Template cells
+ * advanced per sample are counted exactly from EEPROM byte reads (three per
+ * cell). There is no AVR toolchain in this build, so the AVR time per sample
+ * is an estimate from those counts and rough per-cell and per-sample cycle
+ * costs, not a measurement. Host nanoseconds are only for comparing builds.
+ */
+
+#include <vector>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_motiongesture.h"
+
+#define BENCH_RANGE             3       ///< Gyro range the traces were recorded at (2000 deg/sec)
+#define BENCH_REPORT_SAMPLES    160     ///< Latest a match may be reported after its gesture ends
+#define BENCH_TICK_US           10000   ///< Main loop tick, which one sample must fit well inside
+
+#define AVR_CYCLES_CELL         100     ///< Estimated cycles per template cell (3 EEPROM reads, 3 differences, min of 3, saturating add)
+#define AVR_CYCLES_SAMPLE       300     ///< Estimated cycles per sample outside the cells (sums, call, frame scaling every 4th sample)
+#define AVR_MHZ                 8       ///< CPU clock the board timer setup assumes
+
+const char *templateNames[KG_MOTIONGESTURE_SLOTS] = { "flick", "circle", "shake", "twist" };    ///< Template traces are traces/gesture_<name>.csv
+
+/**
+ * @brief Marked gesture in the session trace
+ */
+struct gesture_t {
+    uint8_t slot;
+    uint32_t start, samples;
+    uint32_t reported;                  ///< Matches reported for this gesture
+    uint16_t score;
+    uint32_t delay;                     ///< Samples from end of gesture to report
+};
+
+std::vector<int16_t> session;           ///< Gyro X/Y/Z samples, back to back
+std::vector<gesture_t> gestures;
+uint32_t sampleNum, falseMatches;
+
+/**
+ * @brief Read a kgpredict.py style CSV gyro trace, keeping '# threshold' and '# gesture' markers
+ */
+bool read_trace(const char *name, std::vector<int16_t> *samples, uint16_t *threshold, std::vector<gesture_t> *marks) {
+    char path[64], line[128];
+    snprintf(path, sizeof(path), "traces/%s.csv", name);
+    FILE *f = fopen(path, "r");
+    if (!f) { printf("can't open %s\n", path); return false; }
+    while (fgets(line, sizeof(line), f)) {
+        int a, b, c;
+        unsigned s, n;
+        if (line[0] == '#') {
+            if (threshold && sscanf(line, "# threshold %d", &a) == 1) *threshold = a;
+            if (marks && sscanf(line, "# gesture %u %u", &s, &n) == 2) marks -> push_back({ (uint8_t)s, (uint32_t)samples -> size() / 3, n, 0, 0, 0 });
+        } else if (sscanf(line, "%d,%d,%d", &a, &b, &c) == 3) {
+            samples -> push_back(a);
+            samples -> push_back(b);
+            samples -> push_back(c);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Turn a template trace into frames the same way motiongesture_process() builds them, and store it
+ */
+bool load_template(uint8_t slot) {
+    std::vector<int16_t> samples;
+    int8_t frames[KG_MOTIONGESTURE_FRAMES_MAX * 3];
+    uint16_t threshold = 0;
+    uint8_t length = 0;
+    char name[32];
+    snprintf(name, sizeof(name), "gesture_%s", templateNames[slot]);
+    if (!read_trace(name, &samples, &threshold, 0)) return false;
+    for (size_t i = 0; i + 3 * KG_MOTIONGESTURE_DECIMATION <= samples.size() && length < KG_MOTIONGESTURE_FRAMES_MAX; i += 3 * KG_MOTIONGESTURE_DECIMATION, length++) {
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            int32_t sum = 0;
+            for (uint8_t k = 0; k < KG_MOTIONGESTURE_DECIMATION; k++) sum += samples[i + 3 * k + axis];
+            int32_t value = (sum / KG_MOTIONGESTURE_DECIMATION) >> (10 - BENCH_RANGE);
+            frames[length * 3 + axis] = value > 127 ? 127 : (value < -127 ? -127 : value);
+        }
+    }
+    motiongesture_set_template(slot, threshold, length, frames);
+    printf("template %d (%s): %d frames, threshold %d\n", slot, templateNames[slot], length, threshold);
+    return true;
+}
+
+/**
+ * @brief Match each report to the gesture it belongs to
+ */
+uint8_t check_gesture(uint8_t index, uint8_t slot, uint16_t score, uint8_t frames) {
+    for (gesture_t &g : gestures) {
+        uint32_t end = g.start + g.samples;
+        if (g.slot == slot && sampleNum >= end - g.samples / 2 && sampleNum <= end + BENCH_REPORT_SAMPLES) {
+            if (!g.reported++) {
+                g.score = score;
+                g.delay = sampleNum > end ? sampleNum - end : 0;
+            }
+            return 1;
+        }
+    }
+    printf("false match: slot %d (%s), score %u, %u frames, at sample %u\n", slot, templateNames[slot], score, frames, sampleNum);
+    falseMatches++;
+    return 1;
+}
+
+int main() {
+    uint32_t reads, worstReads = 0, found = 0;
+    uint64_t totalNs = 0, worstNs = 0, t0, ns;
+
+    for (uint8_t slot = 0; slot < KG_MOTIONGESTURE_SLOTS; slot++) CHECK(load_template(slot));
+    CHECK(read_trace("gesture_session", &session, 0, &gestures));
+    setup_motiongesture();
+    kg_evt_motion_gesture = check_gesture;
+
+    for (sampleNum = 0; sampleNum < session.size() / 3; sampleNum++) {
+        const int16_t *g = &session[sampleNum * 3];
+        mock_eeprom_reads = 0;
+        t0 = bench_ns();
+        motiongesture_process(g[0], g[1], g[2], BENCH_RANGE);
+        ns = bench_ns() - t0;
+        reads = mock_eeprom_reads;
+        totalNs += ns;
+        if (ns > worstNs) worstNs = ns;
+        if (reads > worstReads) worstReads = reads;
+    }
+
+    for (gesture_t &g : gestures) {
+        printf("gesture at %5.2fs: slot %d (%-6s) %u samples, ", g.start / 100.0, g.slot, templateNames[g.slot], g.samples);
+        if (g.reported) printf("score %3u, reported %3u ms after it ended\n", g.score, g.delay * 10);
+        else printf("not found\n");
+        if (g.reported == 1) found++;
+    }
+
+    uint32_t worstCells = worstReads / 3, worstCycles = AVR_CYCLES_SAMPLE + worstCells * AVR_CYCLES_CELL;
+    uint32_t limitCycles = AVR_CYCLES_SAMPLE + KG_MOTIONGESTURE_FRAMES_MAX * AVR_CYCLES_CELL;
+    printf("%u of %u gestures found once, %u false matches\n", found, (uint32_t)gestures.size(), falseMatches);
+    printf("per sample: host %.0f ns avg, %llu ns worst | at most %u template cells, estimated %u AVR cycles = %u us at %dMHz (%.1f%% of the 10ms tick)\n",
+        (double)totalNs / sampleNum, (unsigned long long)worstNs, worstCells, worstCycles, worstCycles / AVR_MHZ, AVR_MHZ,
+        worstCycles / AVR_MHZ * 100.0 / BENCH_TICK_US);
+    printf("longest possible template (%d frames): estimated %u AVR cycles = %u us (%.1f%% of the 10ms tick)\n",
+        KG_MOTIONGESTURE_FRAMES_MAX, limitCycles, limitCycles / AVR_MHZ, limitCycles / AVR_MHZ * 100.0 / BENCH_TICK_US);
+
+    CHECK_EQ(found, gestures.size());
+    CHECK_EQ(falseMatches, 0);
+    CHECK(worstCells <= KG_MOTIONGESTURE_FRAMES_MAX);
+    CHECK(limitCycles / AVR_MHZ < BENCH_TICK_US / 10);
+    return test_result();
+}
@@ -0,0 +1,197 @@
+// Keyglove controller host tests - Touch detection latency with oversampling
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file bench_touch_latency.cpp
+ * @brief Press/release latency and cost of update_touch() for each oversampling setting
+ *
+ * Runs the main loop's touch scheduling (a 100Hz tick plus burst scans between
+ * ticks) in simulated time against the touch matrix simulator, and closes or
+ * opens the AY contact at a random point in the tick. Latency is the simulated
+ * time from the contact change until the touch status event, so it covers scan
+ * rate, debouncing and the settle delays of every scan, and carries over to
+ * the AVR apart from the time the code itself takes to run.
+ *
+ * Two kinds of disturbance are replayed as well: a contact that bounces for
+ * the first 3ms of every press, and a 0.5ms closure with no press at all.
+ * Both happen between scans, not between the reads of one scan, since every
+ * read within a scan step sees the same simulated PINx level; a 0.5ms glitch
+ * is also slower than the reads of any scan on the AVR, so the majority vote
+ * would not catch it there either. The simulator has no way to flip a pin
+ * between two reads of one step, so rejection of fast noise by the vote is
+ * not measured here.
+ *
+ * Host nanoseconds per update_touch() call only cover the scan and status
+ * code (no contact change), and like every host timing are only useful for
+ * comparing the settings with each other.
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touch.h"
+#include "touchsim.h"
+
+#define BENCH_TRIALS            500
+#define BENCH_LOOP_US           100     ///< Simulated time for one main loop pass apart from touch scanning
+#define BENCH_TICK_US           10000
+#define BENCH_BOUNCE_US         3000    ///< Contact bounce after each press
+#define BENCH_BOUNCE_PERIOD_US  700     ///< Contact changes state this often while bouncing
+#define BENCH_GLITCH_US         500
+#define BENCH_SCANS             200000
+
+extern uint16_t opt_touch_detect_threshold;
+
+uint32_t benchSeed = 12345;
+uint32_t benchTickUs;                   ///< Simulated time of the next 100Hz tick
+uint32_t benchEvents;                   ///< Touch status events since last reset
+uint32_t benchEventUs;                  ///< Simulated time of the last touch status event
+uint32_t benchScans;                    ///< update_touch() calls since last reset
+
+uint32_t bench_random(uint32_t range) {
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (benchSeed >> 8) % range;
+}
+
+uint8_t bench_touch_status(uint8_t status_len, uint8_t *status_data) {
+    benchEvents++;
+    benchEventUs = mock_us;
+    return 1;
+}
+
+/**
+ * @brief Run one main loop pass: touch scan on the 100Hz tick, or in between at burst rate
+ */
+void loop_pass() {
+    mock_advance_us(BENCH_LOOP_US);
+    if ((int32_t)(mock_us - benchTickUs) >= 0) {
+        benchTickUs += BENCH_TICK_US;
+        if (touch_scan_due(1)) { update_touch(); benchScans++; }
+    } else if (touch_scan_due(0)) {
+        update_touch();
+        benchScans++;
+    }
+}
+
+/**
+ * @brief Run loop passes until a given simulated time, with AY closed or bouncing as requested
+ * @param[in] until Simulated time to stop at
+ * @param[in] closeUs Simulated time AY closes (or starts bouncing), zero to leave it open
+ * @param[in] bounce Non-zero to bounce the contact for BENCH_BOUNCE_US after closing
+ */
+void run_until(uint32_t until, uint32_t closeUs, uint8_t bounce) {
+    while ((int32_t)(mock_us - until) < 0) {
+        uint8_t closed = closeUs && (int32_t)(mock_us - closeUs) >= 0;
+        if (closed && bounce && mock_us - closeUs < BENCH_BOUNCE_US) closed = !(((mock_us - closeUs) / BENCH_BOUNCE_PERIOD_US) & 1);
+        if (closed) touchsim_connect('A', 'Y');
+        else touchsim_disconnect('A', 'Y');
+        loop_pass();
+    }
+}
+
+void run(uint8_t samples, uint8_t bounce) {
+    uint32_t trial, t, pressSum = 0, pressMax = 0, releaseSum = 0, releaseMax = 0, extra = 0, glitches = 0, scans = 0;
+
+    // start from zero each time, since simulated microseconds wrap after 71 minutes
+    opt_touch_samples = samples;
+    mock_us = 0;
+    benchTickUs = BENCH_TICK_US;
+    setup_touch();
+    benchSeed = 777;
+    for (trial = 0; trial < BENCH_TRIALS; trial++) {
+        // settle at the normal scan rate, then press at a random point in the tick
+        run_until(mock_us + 1000000, 0, 0);
+        t = mock_us + bench_random(BENCH_TICK_US);
+        run_until(t, 0, 0);
+        benchEvents = 0;
+        benchScans = 0;
+        run_until(t + 100000, t, bounce);
+        CHECK(KGT_AY(touches_active));
+        pressSum += benchEventUs - t;
+        if (benchEventUs - t > pressMax) pressMax = benchEventUs - t;
+        extra += benchEvents - 1;
+        scans += benchScans;
+
+        // release, still at burst rate
+        t = mock_us + bench_random(BENCH_TICK_US);
+        run_until(t, mock_us, 0);
+        benchEvents = 0;
+        run_until(t + 100000, 0, 0);
+        CHECK(!KGT_AY(touches_active));
+        releaseSum += benchEventUs - t;
+        if (benchEventUs - t > releaseMax) releaseMax = benchEventUs - t;
+        extra += benchEvents - 1;
+
+        // short closure with no press, starting from the normal scan rate
+        run_until(mock_us + 1000000, 0, 0);
+        t = mock_us + bench_random(BENCH_TICK_US);
+        run_until(t, 0, 0);
+        benchEvents = 0;
+        run_until(t + BENCH_GLITCH_US, t, 0);
+        run_until(t + 100000, 0, 0);
+        if (benchEvents) glitches++;
+    }
+
+    // neither a bouncing press nor a closure caught by one scan may produce more events
+    CHECK_EQ(extra, 0);
+    CHECK_EQ(glitches, 0);
+
+    printf("%d sample(s), %s: press %5.2f ms mean %5.2f ms max, release %5.2f ms mean %5.2f ms max, %4.2f extra events/press, %3u%% of %.1f ms closures reported, %4.1f scans in first 100 ms\n",
+        samples, bounce ? "bouncing" : "clean   ",
+        pressSum / 1000.0 / BENCH_TRIALS, pressMax / 1000.0, releaseSum / 1000.0 / BENCH_TRIALS, releaseMax / 1000.0,
+        (double)extra / BENCH_TRIALS, glitches * 100 / BENCH_TRIALS, BENCH_GLITCH_US / 1000.0, (double)scans / BENCH_TRIALS);
+}
+
+void run_cost(uint8_t samples) {
+    uint64_t ns;
+    opt_touch_samples = samples;
+    run_until(mock_us + 100000, mock_us, 0);
+    mock_delay_hook = 0;
+    ns = bench_ns();
+    for (uint32_t i = 0; i < BENCH_SCANS; i++) update_touch();
+    ns = bench_ns() - ns;
+    touchsim_reset();
+    printf("%d sample(s): %.1f host ns per update_touch()\n", samples, (double)ns / BENCH_SCANS);
+}
+
+int main() {
+    setup_board();
+    setup_touch();
+    touchsim_reset();
+    kg_evt_touch_status = bench_touch_status;
+    printf("detect threshold %u ms, burst interval %u us, %u ms bounce, %u trials\n",
+        opt_touch_detect_threshold, opt_touch_burst_interval, BENCH_BOUNCE_US / 1000, BENCH_TRIALS);
+
+    for (uint8_t samples = 1; samples <= 7; samples += 2) run(samples, 0);
+    for (uint8_t samples = 1; samples <= 7; samples += 2) run(samples, 1);
+    for (uint8_t samples = 1; samples <= 7; samples += 2) run_cost(samples);
+    return test_result();
+}
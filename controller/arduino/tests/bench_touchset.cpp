@@ -0,0 +1,237 @@
+// Keyglove controller host tests - Touchset lookup benchmark
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file bench_touchset.cpp
+ * @brief Per-event cost of the touchset engine with a 500-entry stored layout
+ *
+ * Uploads a 500-entry layout (10 modes, 50 chords each) through the EEPROM
+ * write commands, then replays chord presses and releases with 1, 4 and 8
+ * modes stacked. Chords are either drawn at random from every stacked mode
+ * plus random undefined ones (worst case for the lookup cache), or from a
+ * set of 32 chords played over and over, which is closer to real typing.
+ * The engine is compared to a linear scan of the same table for every event,
+ * which is what walking a flat rule list per event would cost. Entry reads
+ * per event do not depend on the host, so they carry over to the AVR
+ * directly (each one is six EEPROM byte reads there). Running the entries
+ * for a release and a press adds about four reads per event on top of the
+ * lookup itself.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <util/crc16.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touch.h"
+#include "support_touchset.h"
+
+#define BENCH_MODES             10
+#define BENCH_CHORDS_PER_MODE   50
+#define BENCH_EVENTS            20000
+#define BENCH_PLAYED            32
+
+uint32_t benchSeed = 12345;
+
+uint32_t bench_random(uint32_t range) {
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (benchSeed >> 8) % range;
+}
+
+std::vector<touchset_entry_t> layout;
+
+/**
+ * @brief Build a sorted layout with unique 1-3 combination chords in every mode
+ */
+void build_layout() {
+    for (uint8_t mode = 0; mode < BENCH_MODES; mode++) {
+        std::vector<uint32_t> used;
+        while (used.size() < BENCH_CHORDS_PER_MODE) {
+            uint8_t combos[3], count = 1 + bench_random(3);
+            for (uint8_t i = 0; i < count; i++) combos[i] = bench_random(KG_BASE_COMBINATIONS);
+            touchset_entry_t entry;
+            if (touchset_pack_chord(entry.chord, count, combos)) continue;
+            uint32_t key = ((uint32_t)entry.chord[0] << 16) | (entry.chord[1] << 8) | entry.chord[2];
+            if (std::find(used.begin(), used.end(), key) != used.end()) continue;
+            used.push_back(key);
+            entry.mode = mode;
+            entry.action = KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_NONE);
+            entry.param = 0;
+            layout.push_back(entry);
+        }
+    }
+    std::sort(layout.begin(), layout.end(), [](const touchset_entry_t &a, const touchset_entry_t &b) { return memcmp(&a, &b, 4) < 0; });
+}
+
+/**
+ * @brief Run one main loop pass of background EEPROM writing
+ */
+void loop_pass() {
+    update_touchset();
+    mock_advance_us(100);
+}
+
+void upload_layout() {
+    uint16_t crc = 0;
+    const uint8_t *data = (const uint8_t *)layout.data();
+    uint16_t length = layout.size() * sizeof(touchset_entry_t);
+    for (uint16_t i = 0; i < length; i++) crc = _crc_xmodem_update(crc, data[i]);
+    // data is written in the background, so run loop passes while a command reports busy
+    while (touchset_write_begin(layout.size()) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    for (uint16_t offset = 0; offset < length; offset += 24) {
+        while (touchset_write_data(offset, length - offset < 24 ? length - offset : 24, data + offset) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    }
+    while (touchset_write_end(crc) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    while (touchsetSource != KG_TOUCHSET_EEPROM) loop_pass();
+}
+
+/**
+ * @brief Reference lookup: scan the whole table for the topmost mode on the stack defining a chord
+ */
+uint8_t linear_lookup(const uint8_t *chord) {
+    touchset_entry_t entry;
+    for (uint8_t pos = touchModeStackPos; pos > 0; pos--) {
+        for (uint16_t i = 0; i < touchsetCount; i++) {
+            touchset_read_entry(i, &entry);
+            if (entry.mode == touchModeStack[pos - 1] && memcmp(entry.chord, chord, 3) == 0) return entry.mode;
+        }
+    }
+    return KG_TOUCHSET_MODE_NONE;
+}
+
+/**
+ * @brief Pick a chord to play: a defined one from a random stacked mode, or a random one
+ */
+uint8_t pick_chord(uint8_t *combos) {
+    if (bench_random(2)) {
+        uint8_t mode = touchModeStack[bench_random(touchModeStackPos)];
+        const touchset_entry_t &entry = layout[mode * BENCH_CHORDS_PER_MODE + bench_random(BENCH_CHORDS_PER_MODE)];
+        uint32_t key = ((uint32_t)entry.chord[0] << 16) | (entry.chord[1] << 8) | entry.chord[2];
+        uint8_t count = 0;
+        for (int8_t shift = 18; shift >= 0; shift -= 6) {
+            uint8_t c = (key >> shift) & 0x3F;
+            if (c != KG_TOUCHSET_CHORD_PAD) combos[count++] = c;
+        }
+        return count;
+    }
+    uint8_t count = 1 + bench_random(3);
+    for (uint8_t i = 0; i < count; i++) {
+        combos[i] = bench_random(KG_BASE_COMBINATIONS);
+        for (uint8_t j = 0; j < i; j++) if (combos[j] == combos[i]) { i--; break; }
+    }
+    return count;
+}
+
+uint8_t played[BENCH_PLAYED][KG_TOUCHSET_CHORD_MAX + 1];     ///< Chords in the played set (count first)
+uint8_t playedCount;                                        ///< Number of chords in the played set (zero for random chords)
+
+/**
+ * @brief Pick the next chord from the played set, or at random if there is none
+ */
+uint8_t next_chord(uint8_t *combos) {
+    if (!playedCount) return pick_chord(combos);
+    const uint8_t *chord = played[bench_random(playedCount)];
+    memcpy(combos, chord + 1, chord[0]);
+    return chord[0];
+}
+
+void run(uint8_t depth, uint8_t playedSize) {
+    uint8_t status[KG_BASE_COMBINATION_BYTES], combos[KG_TOUCHSET_CHORD_MAX], count, i, j;
+    uint32_t events = 0, engineReads, linearReads = 0, found = 0;
+    uint64_t engineNs = 0, linearNs = 0, t0;
+
+    touch_set_mode(0);
+    for (i = 1; i < depth; i++) touch_push_mode(i);
+    memset(status, 0, sizeof(status));
+    touchset_process(status);
+
+    benchSeed = 555;
+    for (playedCount = 0; playedCount < playedSize; playedCount++) played[playedCount][0] = pick_chord(played[playedCount] + 1);
+
+    benchSeed = 777;
+    mock_eeprom_reads = 0;
+    while (events < BENCH_EVENTS) {
+        count = next_chord(combos);
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < count; i++) {
+                if (j == 0) status[combos[i] >> 3] |= 1 << (combos[i] & 7);
+                else status[combos[i] >> 3] &= ~(1 << (combos[i] & 7));
+                t0 = bench_ns();
+                touchset_process(status);
+                engineNs += bench_ns() - t0;
+                events++;
+            }
+        }
+    }
+    engineReads = mock_eeprom_reads;
+
+    benchSeed = 777;
+    for (events = 0; events < BENCH_EVENTS; ) {
+        count = next_chord(combos);
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < count; i++) {
+                uint8_t chord[3], active[KG_TOUCHSET_CHORD_MAX], n = 0;
+                if (j == 0) status[combos[i] >> 3] |= 1 << (combos[i] & 7);
+                else status[combos[i] >> 3] &= ~(1 << (combos[i] & 7));
+                for (uint8_t c = 0; c < KG_BASE_COMBINATIONS; c++) if (KGT_BIT(status, c) && n < KG_TOUCHSET_CHORD_MAX) active[n++] = c;
+                mock_eeprom_reads = 0;
+                t0 = bench_ns();
+                if (n && !touchset_pack_chord(chord, n, active) && linear_lookup(chord) != KG_TOUCHSET_MODE_NONE) found++;
+                linearNs += bench_ns() - t0;
+                linearReads += mock_eeprom_reads;
+                events++;
+            }
+        }
+    }
+
+    printf("%d mode(s) stacked, %s: engine %6.1f entry reads/event, %7.0f host ns/event | linear scan %6.1f entry reads/event, %7.0f host ns/event\n",
+        depth, playedSize ? "played set" : "random    ",
+        (double)engineReads / sizeof(touchset_entry_t) / events, (double)engineNs / events,
+        (double)linearReads / sizeof(touchset_entry_t) / events, (double)linearNs / events);
+    bench_keep(found);
+}
+
+int main() {
+    setup_touch();
+    setup_touchset();
+    build_layout();
+    upload_layout();
+    printf("touchset: %u entries from %s\n", touchsetCount, touchsetSource == KG_TOUCHSET_EEPROM ? "EEPROM" : "RAM");
+    CHECK_EQ(touchsetCount, BENCH_MODES * BENCH_CHORDS_PER_MODE);
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_EEPROM);
+
+    run(1, 0);
+    run(4, 0);
+    run(8, 0);
+    run(1, BENCH_PLAYED);
+    run(4, BENCH_PLAYED);
+    run(8, BENCH_PLAYED);
+    return test_result();
+}
@@ -0,0 +1,285 @@
+// Keyglove controller host tests - Arduino/Teensyduino core stand-in
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file Arduino.h
+ * @brief Minimal Teensy++ 2.0 core stand-in for host builds of firmware modules
+ *
+ * Identifies itself as a Teensy++ 2.0 so that config.h selects the normal
+ * board and feature set. Time only moves when firmware calls delay() or
+ * delayMicroseconds(), or when a test calls mock_advance_us(), so every
+ * result is deterministic.
+ */
+
+#ifndef _MOCK_ARDUINO_H_
+#define _MOCK_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define CORE_TEENSY
+#define __AVR_AT90USB1286__
+#define CORE_TEENSY_SERIAL
+
+#ifndef F_CPU
+    #define F_CPU 8000000UL
+#endif
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define LOW             0
+#define HIGH            1
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+#ifndef min
+    #define min(a, b) ((a) < (b) ? (a) : (b))
+    #define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define SCL             0
+#define SDA             1
+
+// simulated clock
+extern uint32_t mock_us;
+extern void (*mock_delay_hook)(uint32_t us);
+extern void (*mock_time_hook)();
+void mock_advance_us(uint32_t us);
+
+// external interrupt handlers set with attachInterrupt()
+extern void (*mock_interrupt_handler[8])();
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint16_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void attachInterrupt(uint8_t num, void (*handler)(), int mode);
+void detachInterrupt(uint8_t num);
+void tone(uint8_t pin, uint16_t frequency);
+void noTone(uint8_t pin);
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+/**
+ * @brief Serial port stand-in which discards output and never has input
+ */
+class MockSerial {
+    public:
+        void begin(uint32_t baud) { }
+        int available() { return 0; }
+        uint16_t read() { return 0xFFFF; }
+        size_t write(uint8_t b) { return 1; }
+        size_t write(const uint8_t *buf, size_t len) { return len; }
+        size_t print(const char *s) { return strlen(s); }
+        size_t print(const __FlashStringHelper *s) { return 0; }
+        size_t print(long n, int base = 10) { return 0; }
+        size_t println() { return 0; }
+        size_t println(const char *s) { return strlen(s); }
+        size_t println(const __FlashStringHelper *s) { return 0; }
+        size_t println(long n, int base = 10) { return 0; }
+        operator bool() { return true; }
+};
+extern MockSerial Serial, Serial1;
+
+/**
+ * @brief USB keyboard stand-in which records every report sent
+ */
+class MockKeyboard {
+    public:
+        uint8_t modifier, keys[6];
+        uint16_t reports;
+        void set_modifier(uint8_t code) { modifier = code; }
+        void set_key1(uint8_t code) { keys[0] = code; }
+        void set_key2(uint8_t code) { keys[1] = code; }
+        void set_key3(uint8_t code) { keys[2] = code; }
+        void set_key4(uint8_t code) { keys[3] = code; }
+        void set_key5(uint8_t code) { keys[4] = code; }
+        void set_key6(uint8_t code) { keys[5] = code; }
+        void send_now() { reports++; }
+};
+extern MockKeyboard Keyboard;
+
+/**
+ * @brief USB mouse stand-in which records every report sent
+ */
+class MockMouse {
+    public:
+        int8_t x, y, wheel;
+        uint8_t buttons;
+        uint16_t reports;
+        int32_t sumX, sumY;
+        void move(int8_t dx, int8_t dy, int8_t dwheel = 0) { x = dx; y = dy; wheel = dwheel; sumX += dx; sumY += dy; reports++; }
+        void set_buttons(uint8_t left, uint8_t middle, uint8_t right) { buttons = left | (middle << 1) | (right << 2); reports++; }
+};
+extern MockMouse Mouse;
+
+/**
+ * @brief USB raw HID stand-in
+ */
+class MockRawHID {
+    public:
+        int recv(void *buffer, uint16_t timeout) { return 0; }
+        int send(const void *buffer, uint16_t timeout) { return 64; }
+};
+extern MockRawHID RawHID;
+
+// keyboard modifier and usage codes (Teensy keylayouts.h values)
+#define MODIFIERKEY_CTRL        0x01
+#define MODIFIERKEY_SHIFT       0x02
+#define MODIFIERKEY_ALT         0x04
+#define MODIFIERKEY_GUI         0x08
+#define KEY_A                   4
+#define KEY_B                   5
+#define KEY_C                   6
+#define KEY_D                   7
+#define KEY_E                   8
+#define KEY_F                   9
+#define KEY_G                   10
+#define KEY_H                   11
+#define KEY_I                   12
+#define KEY_J                   13
+#define KEY_K                   14
+#define KEY_L                   15
+#define KEY_M                   16
+#define KEY_N                   17
+#define KEY_O                   18
+#define KEY_P                   19
+#define KEY_Q                   20
+#define KEY_R                   21
+#define KEY_S                   22
+#define KEY_T                   23
+#define KEY_U                   24
+#define KEY_V                   25
+#define KEY_W                   26
+#define KEY_X                   27
+#define KEY_Y                   28
+#define KEY_Z                   29
+#define KEY_1                   30
+#define KEY_2                   31
+#define KEY_3                   32
+#define KEY_4                   33
+#define KEY_5                   34
+#define KEY_6                   35
+#define KEY_7                   36
+#define KEY_8                   37
+#define KEY_9                   38
+#define KEY_0                   39
+#define KEY_ENTER               40
+#define KEY_ESC                 41
+#define KEY_BACKSPACE           42
+#define KEY_TAB                 43
+#define KEY_SPACE               44
+#define KEY_MINUS               45
+#define KEY_EQUAL               46
+#define KEY_LEFT_BRACE          47
+#define KEY_RIGHT_BRACE         48
+#define KEY_BACKSLASH           49
+#define KEY_NON_US_NUM          50
+#define KEY_SEMICOLON           51
+#define KEY_QUOTE               52
+#define KEY_TILDE               53
+#define KEY_COMMA               54
+#define KEY_PERIOD              55
+#define KEY_SLASH               56
+#define KEY_CAPS_LOCK           57
+#define KEY_F1                  58
+#define KEY_F2                  59
+#define KEY_F3                  60
+#define KEY_F4                  61
+#define KEY_F5                  62
+#define KEY_F6                  63
+#define KEY_F7                  64
+#define KEY_F8                  65
+#define KEY_F9                  66
+#define KEY_F10                 67
+#define KEY_F11                 68
+#define KEY_F12                 69
+#define KEY_PRINTSCREEN         70
+#define KEY_SCROLL_LOCK         71
+#define KEY_PAUSE               72
+#define KEY_INSERT              73
+#define KEY_HOME                74
+#define KEY_PAGE_UP             75
+#define KEY_DELETE              76
+#define KEY_END                 77
+#define KEY_PAGE_DOWN           78
+#define KEY_RIGHT               79
+#define KEY_LEFT                80
+#define KEY_DOWN                81
+#define KEY_UP                  82
+#define KEY_NUM_LOCK            83
+#define KEY_BACKSLASH2          100
+#define KEY_APP                 101
+#define KEY_POWER               102
+#define KEY_F13                 104
+#define KEY_F14                 105
+#define KEY_F15                 106
+#define KEY_F16                 107
+#define KEY_F17                 108
+#define KEY_F18                 109
+#define KEY_F19                 110
+#define KEY_F20                 111
+#define KEY_F21                 112
+#define KEY_F22                 113
+#define KEY_F23                 114
+#define KEY_F24                 115
+#define KEY_EXECUTE             116
+#define KEY_HELP                117
+#define KEY_MENU                118
+#define KEY_SELECT              119
+#define KEY_STOP                120
+#define KEY_AGAIN               121
+#define KEY_UNDO                122
+#define KEY_CUT                 123
+#define KEY_COPY                124
+#define KEY_PASTE               125
+#define KEY_FIND                126
+#define KEY_MUTE                127
+#define KEY_VOLUP               128
+#define KEY_VOLDOWN             129
+
+#endif // _MOCK_ARDUINO_H_
@@ -0,0 +1,72 @@
+// Keyglove controller host tests - I2Cdevlib stand-in
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file I2Cdev.h
+ * @brief I2Cdevlib interface stand-in for host builds
+ *
+ * keyglove.h includes this first, so it also pulls in the Arduino core
+ * stand-in like the real library does. The register access functions have
+ * weak default definitions in mock.cpp that report a failed transfer, and a
+ * test which needs a simulated device defines its own (see wiresim.cpp).
+ */
+
+#ifndef _MOCK_I2CDEV_H_
+#define _MOCK_I2CDEV_H_
+
+#include "Arduino.h"
+
+#define I2CDEV_ARDUINO_WIRE         1
+#define I2CDEV_BUILTIN_NBWIRE       2
+#define I2CDEV_BUILTIN_FASTWIRE     3
+
+#ifndef I2CDEV_IMPLEMENTATION
+    #define I2CDEV_IMPLEMENTATION   I2CDEV_BUILTIN_FASTWIRE
+#endif
+
+class I2Cdev {
+    public:
+        static int8_t readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout = 0);
+        static int8_t readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout = 0);
+        static int8_t readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout = 0);
+        static int8_t readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout = 0);
+        static bool writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data);
+        static bool writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data);
+        static bool writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data);
+        static bool writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data);
+        static bool writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data);
+};
+
+#if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE
+class Fastwire {
+    public:
+        static void setup(int khz, bool pullup);
+};
+#endif
+
+#endif // _MOCK_I2CDEV_H_
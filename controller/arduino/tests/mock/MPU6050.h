@@ -0,0 +1,117 @@
+// Keyglove controller host tests - I2Cdevlib MPU6050 stand-in
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file MPU6050.h
+ * @brief MPU-6050 class and register stand-ins for host builds
+ *
+ * Only the members and register addresses used by the firmware are declared.
+ * Methods have weak do-nothing definitions in mock.cpp. Like the library, the
+ * DMP members need helper_3dmath.h to be included first.
+ */
+
+#ifndef _MOCK_MPU6050_H_
+#define _MOCK_MPU6050_H_
+
+#include "I2Cdev.h"
+
+#define MPU6050_DEFAULT_ADDRESS     0x68
+
+#define MPU6050_RA_SMPLRT_DIV       0x19
+#define MPU6050_RA_CONFIG           0x1A
+#define MPU6050_RA_GYRO_CONFIG      0x1B
+#define MPU6050_RA_ACCEL_CONFIG     0x1C
+#define MPU6050_RA_MOT_THR          0x1F
+#define MPU6050_RA_MOT_DUR          0x20
+#define MPU6050_RA_ZRMOT_THR        0x21
+#define MPU6050_RA_ZRMOT_DUR        0x22
+#define MPU6050_RA_FIFO_EN          0x23
+#define MPU6050_RA_INT_PIN_CFG      0x37
+#define MPU6050_RA_INT_ENABLE       0x38
+#define MPU6050_RA_INT_STATUS       0x3A
+#define MPU6050_RA_ACCEL_XOUT_H     0x3B
+#define MPU6050_RA_GYRO_XOUT_H      0x43
+#define MPU6050_RA_USER_CTRL        0x6A
+#define MPU6050_RA_PWR_MGMT_1       0x6B
+#define MPU6050_RA_PWR_MGMT_2       0x6C
+#define MPU6050_RA_FIFO_COUNTH      0x72
+#define MPU6050_RA_FIFO_R_W         0x74
+#define MPU6050_RA_WHO_AM_I         0x75
+
+#define MPU6050_DLPF_BW_256         0x00
+#define MPU6050_DLPF_BW_188         0x01
+#define MPU6050_DLPF_BW_98          0x02
+#define MPU6050_DLPF_BW_42          0x03
+#define MPU6050_DLPF_BW_20          0x04
+#define MPU6050_DLPF_BW_10          0x05
+#define MPU6050_DLPF_BW_5           0x06
+
+#define MPU6050_GYRO_FS_250         0x00
+#define MPU6050_GYRO_FS_500         0x01
+#define MPU6050_GYRO_FS_1000        0x02
+#define MPU6050_GYRO_FS_2000        0x03
+
+#define MPU6050_ACCEL_FS_2          0x00
+#define MPU6050_ACCEL_FS_4          0x01
+#define MPU6050_ACCEL_FS_8          0x02
+#define MPU6050_ACCEL_FS_16         0x03
+
+class MPU6050 {
+    public:
+        MPU6050(uint8_t address = MPU6050_DEFAULT_ADDRESS) : devAddr(address) { }
+        void initialize();
+        bool testConnection();
+        void reset();
+        void setSleepEnabled(bool enabled);
+        void setRate(uint8_t rate);
+        void setDLPFMode(uint8_t bandwidth);
+        void setFullScaleGyroRange(uint8_t range);
+        void setFullScaleAccelRange(uint8_t range);
+        void setIntEnabled(uint8_t enabled);
+        void setInterruptMode(bool mode);
+        void setInterruptDrive(bool drive);
+        void setInterruptLatch(bool latch);
+        void setInterruptLatchClear(bool clear);
+        void setMotionDetectionThreshold(uint8_t threshold);
+        void setMotionDetectionDuration(uint8_t duration);
+        void setZeroMotionDetectionThreshold(uint8_t threshold);
+        void setZeroMotionDetectionDuration(uint8_t duration);
+        uint8_t getIntStatus();
+        void getMotion6(int16_t *ax, int16_t *ay, int16_t *az, int16_t *gx, int16_t *gy, int16_t *gz);
+        #ifdef MPU6050_INCLUDE_DMP_MOTIONAPPS20
+            uint8_t dmpInitialize();
+            void setDMPEnabled(bool enabled);
+            uint8_t dmpGetQuaternion(int16_t *data, const uint8_t *packet = 0);
+            uint8_t dmpGetGyro(VectorInt16 *v, const uint8_t *packet = 0);
+            uint8_t dmpGetAccel(VectorInt16 *v, const uint8_t *packet = 0);
+        #endif
+    private:
+        uint8_t devAddr;
+};
+
+#endif // _MOCK_MPU6050_H_
@@ -0,0 +1,49 @@
+// Keyglove controller host tests - I2Cdevlib MPU6050 DMP stand-in
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file MPU6050_6Axis_MotionApps20.h
+ * @brief I2Cdevlib MotionApps 2.0 DMP header stand-in for host builds
+ *
+ * Includes the same headers in the same order as the library, so a build
+ * with KG_FUSION_DMP checks that the firmware and the library agree on one
+ * set of 3D math classes. The DMP methods have weak definitions in mock.cpp,
+ * and dmpInitialize() fails so the firmware falls back to raw samples.
+ */
+
+#ifndef _MOCK_MPU6050_6AXIS_MOTIONAPPS20_H_
+#define _MOCK_MPU6050_6AXIS_MOTIONAPPS20_H_
+
+#include "I2Cdev.h"
+#include "helper_3dmath.h"
+
+#define MPU6050_INCLUDE_DMP_MOTIONAPPS20
+#include "MPU6050.h"
+
+#endif // _MOCK_MPU6050_6AXIS_MOTIONAPPS20_H_
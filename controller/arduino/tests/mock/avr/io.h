@@ -0,0 +1,93 @@
+// Keyglove controller host tests - AVR register stand-ins
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file avr/io.h
+ * @brief AT90USB1286 register stand-ins for host builds
+ *
+ * Registers are plain variables. Port input registers (PINx) are refreshed by
+ * the touch matrix simulator (see touchsim.h) whenever firmware waits with
+ * delayMicroseconds(), which is how the scan loops let driven pins settle.
+ * TWI registers are driven by the I2C bus simulator (see twisim.h), which
+ * sees every TWCR write as it happens, like the TWI module does. SREG only
+ * holds the global interrupt flag, which it shares with cli()/sei(), so
+ * saving and restoring it around a critical section works as on the AVR.
+ */
+
+#ifndef _MOCK_AVR_IO_H_
+#define _MOCK_AVR_IO_H_
+
+#include <stdint.h>
+
+#define E2END           0x0FFF      ///< Last EEPROM address (4 KB)
+
+extern volatile uint8_t PINA, PINB, PINC, PIND, PINE, PINF;
+extern volatile uint8_t DDRA, DDRB, DDRC, DDRD, DDRE, DDRF;
+extern volatile uint8_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF;
+extern volatile uint8_t TWSR, TWDR, TWBR, TWAR;
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, PCICR, PCMSK0;
+extern volatile uint16_t OCR1A, ADC;
+
+extern volatile uint8_t mock_interrupts;
+
+/**
+ * @brief Status register stand-in, bit 7 (I) is mock_interrupts
+ */
+class MockSREG {
+    public:
+        operator uint8_t() const { return mock_interrupts ? 0x80 : 0x00; }
+        MockSREG &operator=(uint8_t value) { mock_interrupts = (value & 0x80) ? 1 : 0; return *this; }
+};
+extern MockSREG SREG;
+
+extern void (*mock_twcr_hook)();
+
+/**
+ * @brief TWI control register stand-in, calls mock_twcr_hook after every write
+ */
+class MockTWCR {
+    public:
+        uint8_t value;
+        operator uint8_t() const { return value; }
+        MockTWCR &operator=(uint8_t v) { value = v; if (mock_twcr_hook) mock_twcr_hook(); return *this; }
+};
+extern MockTWCR TWCR;
+
+#define OCIE1A          1
+
+#define TWINT           7
+#define TWEA            6
+#define TWSTA           5
+#define TWSTO           4
+#define TWWC            3
+#define TWEN            2
+#define TWIE            0
+#define TWPS1           1
+#define TWPS0           0
+
+#endif // _MOCK_AVR_IO_H_
@@ -0,0 +1,100 @@
+// Keyglove controller host tests - I2Cdevlib 3D math stand-in
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file helper_3dmath.h
+ * @brief I2Cdevlib float quaternion and vector classes for host builds
+ *
+ * Same members and math as the library header, inline like the original, so
+ * firmware code built here uses the same float classes as on the glove.
+ */
+
+#ifndef _HELPER_3DMATH_H_
+#define _HELPER_3DMATH_H_
+
+#include <math.h>
+#include <stdint.h>
+
+class Quaternion {
+    public:
+        float w, x, y, z;
+        Quaternion() : w(1.0f), x(0.0f), y(0.0f), z(0.0f) { }
+        Quaternion(float nw, float nx, float ny, float nz) : w(nw), x(nx), y(ny), z(nz) { }
+        Quaternion getProduct(Quaternion q) {
+            return Quaternion(
+                w*q.w - x*q.x - y*q.y - z*q.z,
+                w*q.x + x*q.w + y*q.z - z*q.y,
+                w*q.y - x*q.z + y*q.w + z*q.x,
+                w*q.z + x*q.y - y*q.x + z*q.w);
+        }
+        Quaternion getConjugate() { return Quaternion(w, -x, -y, -z); }
+        float getMagnitude() { return sqrt(w*w + x*x + y*y + z*z); }
+        void normalize() { float m = getMagnitude(); w /= m; x /= m; y /= m; z /= m; }
+        Quaternion getNormalized() { Quaternion r(w, x, y, z); r.normalize(); return r; }
+};
+
+class VectorInt16 {
+    public:
+        int16_t x, y, z;
+        VectorInt16() : x(0), y(0), z(0) { }
+        VectorInt16(int16_t nx, int16_t ny, int16_t nz) : x(nx), y(ny), z(nz) { }
+        float getMagnitude() { return sqrt(x*x + y*y + z*z); }
+        void normalize() { float m = getMagnitude(); x /= m; y /= m; z /= m; }
+        VectorInt16 getNormalized() { VectorInt16 r(x, y, z); r.normalize(); return r; }
+        void rotate(Quaternion *q) {
+            Quaternion p(0, x, y, z);
+            p = q -> getProduct(p);
+            p = p.getProduct(q -> getConjugate());
+            x = p.x;
+            y = p.y;
+            z = p.z;
+        }
+        VectorInt16 getRotated(Quaternion *q) { VectorInt16 r(x, y, z); r.rotate(q); return r; }
+};
+
+class VectorFloat {
+    public:
+        float x, y, z;
+        VectorFloat() : x(0), y(0), z(0) { }
+        VectorFloat(float nx, float ny, float nz) : x(nx), y(ny), z(nz) { }
+        float getMagnitude() { return sqrt(x*x + y*y + z*z); }
+        void normalize() { float m = getMagnitude(); x /= m; y /= m; z /= m; }
+        VectorFloat getNormalized() { VectorFloat r(x, y, z); r.normalize(); return r; }
+        void rotate(Quaternion *q) {
+            Quaternion p(0, x, y, z);
+            p = q -> getProduct(p);
+            p = p.getProduct(q -> getConjugate());
+            x = p.x;
+            y = p.y;
+            z = p.z;
+        }
+        VectorFloat getRotated(Quaternion *q) { VectorFloat r(x, y, z); r.rotate(q); return r; }
+};
+
+#endif // _HELPER_3DMATH_H_
@@ -0,0 +1,172 @@
+// Keyglove controller host tests - Arduino core and AVR stand-in implementations
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file mock.cpp
+ * @brief Shared definitions for the host build stand-ins
+ */
+
+#include <Arduino.h>
+#include <I2Cdev.h>
+#include <helper_3dmath.h>
+#define MPU6050_INCLUDE_DMP_MOTIONAPPS20
+#include <MPU6050.h>
+#include <Wire.h>
+#include <avr/eeprom.h>
+
+uint32_t mock_us;                                   ///< Simulated time in microseconds since start
+void (*mock_delay_hook)(uint32_t us);               ///< Called at the start of every delayMicroseconds() (e.g. touch matrix settling)
+void (*mock_time_hook)();                           ///< Called whenever simulated time is read or advanced (e.g. I2C bus simulation)
+volatile uint8_t mock_interrupts = 1;               ///< Global interrupt enable flag (cli/sei)
+void (*mock_interrupt_handler[8])();                ///< Handlers set with attachInterrupt(), by interrupt number
+void (*mock_twcr_hook)();                           ///< Called after every TWCR write (I2C bus simulation)
+
+volatile uint8_t PINA, PINB, PINC, PIND, PINE, PINF;
+volatile uint8_t DDRA, DDRB, DDRC, DDRD, DDRE, DDRF;
+volatile uint8_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF;
+volatile uint8_t TWSR, TWDR, TWBR, TWAR;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, PCICR, PCMSK0;
+MockSREG SREG;
+MockTWCR TWCR;
+volatile uint16_t OCR1A, ADC;
+
+MockSerial Serial, Serial1;
+MockKeyboard Keyboard;
+MockMouse Mouse;
+MockRawHID RawHID;
+TwoWire Wire;
+
+void mock_advance_us(uint32_t us) {
+    mock_us += us;
+    if (mock_time_hook) mock_time_hook();
+}
+
+uint32_t millis() {
+    if (mock_time_hook) mock_time_hook();
+    return mock_us / 1000;
+}
+
+uint32_t micros() {
+    if (mock_time_hook) mock_time_hook();
+    return mock_us;
+}
+
+void delay(uint32_t ms) { mock_advance_us(ms * 1000); }
+
+void delayMicroseconds(uint16_t us) {
+    if (mock_delay_hook) mock_delay_hook(us);
+    mock_advance_us(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { }
+void digitalWrite(uint8_t pin, uint8_t value) { }
+int digitalRead(uint8_t pin) { return HIGH; }
+int analogRead(uint8_t pin) { return 0; }
+void analogWrite(uint8_t pin, int value) { }
+void attachInterrupt(uint8_t num, void (*handler)(), int mode) { mock_interrupt_handler[num & 7] = handler; }
+void detachInterrupt(uint8_t num) { mock_interrupt_handler[num & 7] = 0; }
+void tone(uint8_t pin, uint16_t frequency) { }
+void noTone(uint8_t pin) { }
+
+// ========================== EEPROM ==========================
+
+uint8_t mock_eeprom[E2END + 1];                     ///< Simulated EEPROM contents
+uint32_t mock_eeprom_reads;                         ///< Number of bytes read
+uint32_t mock_eeprom_writes;                        ///< Number of bytes programmed
+uint32_t mock_eeprom_ready_us;                      ///< Simulated time when the current byte write finishes
+
+uint8_t eeprom_is_ready() { return (int32_t)(mock_us - mock_eeprom_ready_us) >= 0; }
+void eeprom_busy_wait() { if (!eeprom_is_ready()) mock_us = mock_eeprom_ready_us; }
+
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    eeprom_busy_wait();
+    mock_eeprom_reads++;
+    return mock_eeprom[(uintptr_t)addr & E2END];
+}
+
+uint16_t eeprom_read_word(const uint16_t *addr) {
+    uint16_t value;
+    eeprom_read_block(&value, addr, 2);
+    return value;
+}
+
+uint32_t eeprom_read_dword(const uint32_t *addr) {
+    uint32_t value;
+    eeprom_read_block(&value, addr, 4);
+    return value;
+}
+
+void eeprom_read_block(void *dst, const void *src, size_t n) {
+    for (size_t i = 0; i < n; i++) ((uint8_t *)dst)[i] = eeprom_read_byte((const uint8_t *)src + i);
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value) {
+    eeprom_busy_wait();
+    mock_eeprom_writes++;
+    mock_eeprom[(uintptr_t)addr & E2END] = value;
+    mock_eeprom_ready_us = mock_us + MOCK_EEPROM_WRITE_US;
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) eeprom_write_byte(addr, value);
+}
+
+void eeprom_update_word(uint16_t *addr, uint16_t value) { eeprom_update_block(&value, addr, 2); }
+void eeprom_update_dword(uint32_t *addr, uint32_t value) { eeprom_update_block(&value, addr, 4); }
+
+void eeprom_update_block(const void *src, void *dst, size_t n) {
+    for (size_t i = 0; i < n; i++) eeprom_update_byte((uint8_t *)dst + i, ((const uint8_t *)src)[i]);
+}
+
+// ========================== I2Cdev (weak, no devices attached) ==========================
+
+__attribute__((weak)) int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout) { return -1; }
+__attribute__((weak)) int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout) { return -1; }
+__attribute__((weak)) int8_t I2Cdev::readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout) { return -1; }
+__attribute__((weak)) int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) { return -1; }
+__attribute__((weak)) bool I2Cdev::writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data) { return false; }
+__attribute__((weak)) bool I2Cdev::writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data) { return false; }
+__attribute__((weak)) bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) { return false; }
+__attribute__((weak)) bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) { return false; }
+__attribute__((weak)) bool I2Cdev::writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data) { return false; }
+#if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE
+__attribute__((weak)) void Fastwire::setup(int khz, bool pullup) { }
+#endif
+
+// ========================== Wire and TWI interrupt (weak, nothing on the bus) ==========================
+
+__attribute__((weak)) void TwoWire::begin() { }
+extern "C" __attribute__((weak)) void TWI_vect(void) { }     // firmware built with KG_I2C_WIRE has no TWI interrupt handler
+
+// ========================== MPU6050 DMP (weak, firmware never loads) ==========================
+
+__attribute__((weak)) uint8_t MPU6050::dmpInitialize() { return 1; }
+__attribute__((weak)) void MPU6050::setDMPEnabled(bool enabled) { }
+__attribute__((weak)) uint8_t MPU6050::dmpGetQuaternion(int16_t *data, const uint8_t *packet) { return 0; }
+__attribute__((weak)) uint8_t MPU6050::dmpGetGyro(VectorInt16 *v, const uint8_t *packet) { return 0; }
+__attribute__((weak)) uint8_t MPU6050::dmpGetAccel(VectorInt16 *v, const uint8_t *packet) { return 0; }
@@ -0,0 +1,140 @@
+// Keyglove controller host tests - Weak stand-ins for firmware modules
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file stubs.cpp
+ * @brief Weak stand-ins for firmware functions and variables outside the module under test
+ *
+ * Every test program links this file. Any firmware module linked alongside it
+ * replaces the matching weak definitions here with the real ones. Stand-ins
+ * for actions append a short description to mock_calls, so a test can check
+ * what ran and in which order.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touch.h"
+#include "support_touchset.h"
+#include "support_hid_keyboard.h"
+#include "support_hid_mouse.h"
+#include "support_recorder.h"
+#include "support_touchgesture.h"
+#include "support_touchstats.h"
+#include "support_motiongesture.h"
+#include "support_bluetooth2_iwrap.h"
+#include "mock.h"
+
+#define WEAK __attribute__((weak))
+
+char mock_calls[1024];                                  ///< Log of stand-in actions since last mock_calls_clear()
+
+void mock_calls_clear() {
+    mock_calls[0] = 0;
+}
+
+void mock_call(const char *format, ...) {
+    size_t len = strlen(mock_calls);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(mock_calls + len, sizeof(mock_calls) - len, format, args);
+    va_end(args);
+    len = strlen(mock_calls);
+    if (len + 1 < sizeof(mock_calls)) strcat(mock_calls, " ");
+}
+
+// main loop
+WEAK volatile uint8_t keyglove100Hz;
+WEAK uint8_t keygloveTick;
+WEAK uint32_t keygloveTock;
+WEAK volatile uint8_t keygloveBatteryInterrupt;
+WEAK volatile uint8_t keygloveBatteryStatus;
+
+// board
+WEAK extern const uint8_t boardGhostTriangles[KG_GHOST_TRIANGLES][3] = { };
+WEAK void update_board_touch(uint8_t *touches) { }
+
+// protocol
+WEAK bool inBinPacket;
+WEAK uint8_t skipPacket;
+WEAK uint8_t (*kg_evt_touch_mode)(uint8_t mode);
+WEAK uint8_t (*kg_evt_touch_status)(uint8_t status_len, uint8_t *status_data);
+WEAK uint8_t (*kg_evt_touch_ambiguous)(uint8_t status_len, uint8_t *status_data);
+WEAK uint8_t (*kg_evt_system_ready)();
+WEAK uint8_t (*kg_evt_system_timer_tick)(uint8_t handle, uint32_t seconds, uint8_t subticks);
+WEAK uint8_t (*kg_evt_motion_data)(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data);
+WEAK uint8_t (*kg_evt_motion_state)(uint8_t index, uint8_t state);
+WEAK uint8_t (*kg_evt_motion_batch)(uint8_t index, uint8_t flags, uint8_t count, uint16_t time, uint8_t data_len, uint8_t *data_data);
+WEAK uint8_t (*kg_evt_motion_gesture)(uint8_t index, uint8_t gesture, uint16_t score, uint8_t frames);
+WEAK uint8_t (*kg_evt_bluetooth_ready)();
+WEAK uint8_t send_keyglove_packet(uint8_t type, uint8_t length, uint8_t packet_class, uint8_t packet_id, uint8_t *payload) { return 0; }
+WEAK uint8_t send_keyglove_log(uint8_t level, uint8_t length, const __FlashStringHelper *message) { mock_call("log(%.*s)", length, (const char *)message); return 0; }
+WEAK bool bluetooth_api_ready() { return false; }
+WEAK uint16_t kg_cmd_feedback_set_blink_mode(uint8_t mode) { mock_call("blink(%d)", mode); return 0; }
+WEAK uint16_t kg_cmd_feedback_set_piezo_mode(uint8_t index, uint8_t mode, uint8_t duration, uint16_t frequency) { mock_call("piezo(%d)", mode); return 0; }
+WEAK uint16_t kg_cmd_feedback_set_vibrate_mode(uint8_t index, uint8_t mode, uint8_t duration) { mock_call("vibrate(%d)", mode); return 0; }
+WEAK uint16_t kg_cmd_bluetooth_set_mode(uint8_t mode) { mock_call("bluetooth(%d)", mode); return 0; }
+WEAK uint16_t kg_cmd_motion_set_mode(uint8_t index, uint8_t mode) { mock_call("motion(%d,%d)", index, mode); return 0; }
+
+// HID
+WEAK void keyboard_key_down(uint8_t code) { mock_call("key_down(%d)", code); }
+WEAK void keyboard_key_up(uint8_t code) { mock_call("key_up(%d)", code); }
+WEAK void keyboard_key_press(uint8_t code) { mock_call("key_press(%d)", code); }
+WEAK void keyboard_modifier_down(uint8_t code) { mock_call("modifier_down(%d)", code); }
+WEAK void keyboard_modifier_up(uint8_t code) { mock_call("modifier_up(%d)", code); }
+WEAK void keyboard_modifier_toggle(uint8_t code) { mock_call("modifier_toggle(%d)", code); }
+WEAK void keyboard_modifier_press(uint8_t code) { mock_call("modifier_press(%d)", code); }
+WEAK void mouse_on(uint8_t mode) { mock_call("mouse_on(%d)", mode); }
+WEAK void mouse_off(uint8_t mode) { mock_call("mouse_off(%d)", mode); }
+WEAK void mouse_down(uint8_t button) { mock_call("mouse_down(%d)", button); }
+WEAK void mouse_up(uint8_t button) { mock_call("mouse_up(%d)", button); }
+WEAK void mouse_click(uint8_t button) { mock_call("mouse_click(%d)", button); }
+
+// Bluetooth HID
+WEAK bool interfaceBT2HIDReady;
+WEAK BTKeyboardWrapper BTKeyboard;
+WEAK BTMouseWrapper BTMouse;
+WEAK void BTMouseWrapper::move(int8_t x, int8_t y) { mock_call("bt_move(%d,%d)", x, y); }
+WEAK void BTMouseWrapper::scroll(int8_t vscroll, int8_t hscroll) { mock_call("bt_scroll(%d)", vscroll); }
+WEAK void BTMouseWrapper::move(int8_t x, int8_t y, int8_t vscroll, int8_t hscroll) { mock_call("bt_move(%d,%d,%d)", x, y, vscroll); }
+
+// touch consumers
+WEAK void touchset_process(const uint8_t *touches) { }
+WEAK void touchset_invalidate() { }
+WEAK void recorder_touch(uint8_t mode, const uint8_t *touches) { }
+WEAK void touchgesture_process(const uint8_t *touches) { }
+WEAK void touchstats_process(const uint8_t *touches) { }
+
+// motion consumers
+WEAK void recorder_motion(uint8_t index, int16_t x, int16_t y, int16_t z) { }
+WEAK void recorder_trigger(uint8_t source) { mock_call("recorder_trigger(%d)", source); }
+WEAK void hid_mouse_sample(uint8_t period) { }
+WEAK void motiongesture_process(int16_t x, int16_t y, int16_t z, uint8_t range) { }
+WEAK void motiongesture_reset() { }
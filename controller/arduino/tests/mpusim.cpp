@@ -0,0 +1,201 @@
+// Keyglove controller host tests - MPU-6050 simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file mpusim.cpp
+ * @brief MPU-6050 register, FIFO and interrupt model on the simulated I2C bus
+ */
+
+#include <Arduino.h>
+#include <MPU6050.h>
+#include "mpusim.h"
+
+#define MPUSIM_RA_FIFO_COUNTL   0x73
+
+MpuSim::MpuSim(uint8_t address, uint8_t interrupt) : TwisimDevice(address), source(0), interrupt(interrupt) {
+    reset();
+}
+
+/**
+ * @brief Power-on register state (asleep), empty FIFO, and cleared counters
+ */
+void MpuSim::reset() {
+    memset(regs, 0, sizeof(regs));
+    regs[MPU6050_RA_PWR_MGMT_1] = 0x40;
+    regs[MPU6050_RA_WHO_AM_I] = 0x68;
+    fifoHead = fifoCount = fifoCountLatch = 0;
+    samples = overflows = pulses = 0;
+    awake = 0;
+    nextUs = mock_us;
+    memset(wakeAccel, 0, sizeof(wakeAccel));
+}
+
+/**
+ * @brief Time between samples (or cycle mode wake-ups) at the current settings
+ */
+uint32_t MpuSim::sample_us() {
+    static const uint32_t wake[4] = { 800000, 200000, 50000, 25000 };
+    uint8_t dlpf = regs[MPU6050_RA_CONFIG] & 0x07;
+    if (awake == 2) return wake[regs[MPU6050_RA_PWR_MGMT_2] >> 6];
+    return (uint32_t)(regs[MPU6050_RA_SMPLRT_DIV] + 1) * (dlpf == 0 || dlpf == 7 ? 125 : 1000);
+}
+
+/**
+ * @brief Take every sample due up to the current simulated time
+ */
+void MpuSim::update() {
+    uint8_t now = (regs[MPU6050_RA_PWR_MGMT_1] & 0x40) ? 0 : (regs[MPU6050_RA_PWR_MGMT_1] & 0x20) ? 2 : 1;
+    if (now != awake) {
+        awake = now;
+        nextUs = mock_us + sample_us();
+    }
+    if (!awake) return;
+    while ((int32_t)(mock_us - nextUs) >= 0) {
+        sample();
+        nextUs += sample_us();
+    }
+}
+
+/**
+ * @brief Set interrupt status bits, and pulse INT if any of them are enabled
+ */
+void MpuSim::pulse(uint8_t status) {
+    regs[MPU6050_RA_INT_STATUS] |= status;
+    if (!(regs[MPU6050_RA_INT_ENABLE] & status)) return;
+    pulses++;
+    if (mock_interrupt_handler[interrupt] && mock_interrupts) mock_interrupt_handler[interrupt]();
+}
+
+/**
+ * @brief Add bytes to FIFO, dropping the oldest ones if it is full
+ */
+void MpuSim::fifo_push(const uint8_t *data, uint8_t length) {
+    bool overflow = false;
+    for (uint8_t i = 0; i < length; i++) {
+        if (fifoCount == MPUSIM_FIFO_SIZE) {
+            fifoHead = (fifoHead + 1) % MPUSIM_FIFO_SIZE;
+            fifoCount--;
+            overflow = true;
+        }
+        fifo[(fifoHead + fifoCount++) % MPUSIM_FIFO_SIZE] = data[i];
+    }
+    if (overflow) {
+        overflows++;
+        pulse(0x10);    // FIFO_OFLOW_INT
+    }
+}
+
+/**
+ * @brief Take one sample (or one cycle mode wake-up)
+ */
+void MpuSim::sample() {
+    int16_t motion[6] = { 0, 0, 16384, 0, 0, 0 };
+    uint8_t i, data[14];
+    if (source) source(nextUs, motion);
+
+    if (awake == 2) {
+        // cycle mode: accel only, compared against the last wake-up for motion detection
+        for (i = 0; i < 3; i++) {
+            if (abs(motion[i] - wakeAccel[i]) > regs[MPU6050_RA_MOT_THR] * 32) break;
+        }
+        memcpy(wakeAccel, motion, sizeof(wakeAccel));
+        if (i < 3) pulse(0x40);     // MOT_INT
+        return;
+    }
+
+    // data registers: accel X/Y/Z, temperature, gyro X/Y/Z (big-endian)
+    samples++;
+    for (i = 0; i < 3; i++) {
+        data[i * 2] = motion[i] >> 8;
+        data[i * 2 + 1] = motion[i] & 0xFF;
+        data[8 + i * 2] = motion[3 + i] >> 8;
+        data[8 + i * 2 + 1] = motion[3 + i] & 0xFF;
+    }
+    data[6] = data[7] = 0;
+    memcpy(regs + MPU6050_RA_ACCEL_XOUT_H, data, sizeof(data));
+    memcpy(wakeAccel, motion, sizeof(wakeAccel));
+
+    // FIFO gets enabled sources in register order
+    if (regs[MPU6050_RA_USER_CTRL] & 0x40) {
+        uint8_t enable = regs[MPU6050_RA_FIFO_EN];
+        if (enable & 0x08) fifo_push(data, 6);          // ACCEL_FIFO_EN
+        if (enable & 0x80) fifo_push(data + 6, 2);      // TEMP_FIFO_EN
+        if (enable & 0x40) fifo_push(data + 8, 2);      // XG_FIFO_EN
+        if (enable & 0x20) fifo_push(data + 10, 2);     // YG_FIFO_EN
+        if (enable & 0x10) fifo_push(data + 12, 2);     // ZG_FIFO_EN
+    }
+    pulse(0x01);    // DATA_RDY_INT
+}
+
+uint8_t MpuSim::read_register(uint8_t reg) {
+    uint8_t value;
+    switch (reg) {
+        case MPU6050_RA_INT_STATUS:
+            // cleared by reading
+            value = regs[reg];
+            regs[reg] = 0;
+            return value;
+        case MPU6050_RA_FIFO_COUNTH:
+            fifoCountLatch = fifoCount;
+            return fifoCountLatch >> 8;
+        case MPUSIM_RA_FIFO_COUNTL:
+            return fifoCountLatch & 0xFF;
+        case MPU6050_RA_FIFO_R_W:
+            if (!fifoCount) return 0;
+            value = fifo[fifoHead];
+            fifoHead = (fifoHead + 1) % MPUSIM_FIFO_SIZE;
+            fifoCount--;
+            return value;
+    }
+    return regs[reg];
+}
+
+void MpuSim::write_register(uint8_t reg, uint8_t value) {
+    if (reg == MPU6050_RA_PWR_MGMT_1 && (value & 0x80)) {
+        // DEVICE_RESET
+        uint32_t s = samples, o = overflows, p = pulses;
+        reset();
+        samples = s;
+        overflows = o;
+        pulses = p;
+        return;
+    }
+    if (reg == MPU6050_RA_USER_CTRL && (value & 0x04)) {
+        // FIFO_RESET clears itself
+        fifoHead = fifoCount = 0;
+        value &= ~0x04;
+    }
+    if (reg == MPU6050_RA_WHO_AM_I || reg == MPU6050_RA_INT_STATUS || (reg >= MPU6050_RA_ACCEL_XOUT_H && reg <= 0x48)) return;
+    regs[reg] = value;
+    if (reg == MPU6050_RA_PWR_MGMT_1 || reg == MPU6050_RA_PWR_MGMT_2) update();
+}
+
+bool MpuSim::increments(uint8_t reg) {
+    return reg != MPU6050_RA_FIFO_R_W;
+}
@@ -0,0 +1,86 @@
+// Keyglove controller host tests - MPU-6050 simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file mpusim.h
+ * @brief MPU-6050 register, FIFO and interrupt model on the simulated I2C bus
+ *
+ * Samples are taken at the rate set by SMPLRT_DIV and CONFIG while the sensor
+ * is awake, from a source function giving accel and gyro readings for any
+ * point in simulated time (flat and still by default). Each sample updates the
+ * data registers, goes into the 1024-byte FIFO in register order for every
+ * source enabled in FIFO_EN, and pulses the interrupt pin (calls the handler
+ * set with attachInterrupt()) if DATA_RDY_EN is set. A full FIFO drops its
+ * oldest bytes and sets FIFO_OFLOW_INT, just like the chip, so sample
+ * alignment is lost. In cycle mode, the accelerometer wakes at the
+ * LP_WAKE_CTRL rate and pulses MOT_INT when any axis has moved by more than
+ * MOT_THR (2mg per count at 2g range) since the last wake-up.
+ *
+ * The DMP is not simulated.
+ */
+
+#ifndef _MPUSIM_H_
+#define _MPUSIM_H_
+
+#include "twisim.h"
+
+#define MPUSIM_FIFO_SIZE        1024
+
+class MpuSim : public TwisimDevice {
+    public:
+        void (*source)(uint32_t us, int16_t *motion);   ///< Accel X/Y/Z and gyro X/Y/Z at a point in time (0 = flat and still)
+        uint8_t interrupt;                  ///< External interrupt number wired to INT
+        uint32_t samples;                   ///< Samples taken while awake
+        uint32_t overflows;                 ///< Samples that overflowed the FIFO
+        uint32_t pulses;                    ///< Interrupt pulses sent
+
+        MpuSim(uint8_t address, uint8_t interrupt);
+        void reset();
+        void update();
+        uint8_t read_register(uint8_t reg);
+        void write_register(uint8_t reg, uint8_t value);
+        bool increments(uint8_t reg);
+        uint16_t fifo_count() { return fifoCount; }
+        uint32_t sample_us();
+
+    private:
+        uint8_t fifo[MPUSIM_FIFO_SIZE];     ///< FIFO ring buffer
+        uint16_t fifoHead;                  ///< Oldest byte in FIFO
+        uint16_t fifoCount;                 ///< Bytes in FIFO
+        uint16_t fifoCountLatch;            ///< FIFO count when FIFO_COUNTH was read
+        uint32_t nextUs;                    ///< When the next sample (or wake-up in cycle mode) is taken
+        uint8_t awake;                      ///< 0 = sleeping, 1 = sampling, 2 = cycle mode
+        int16_t wakeAccel[3];               ///< Accel reading at the last cycle mode wake-up
+
+        void sample();
+        void pulse(uint8_t status);
+        void fifo_push(const uint8_t *data, uint8_t length);
+};
+
+#endif // _MPUSIM_H_
@@ -0,0 +1,86 @@
+// Keyglove controller host tests - Minimal test and benchmark helpers
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test.h
+ * @brief Minimal test and benchmark helpers shared by all host test programs
+ *
+ * Each test program is a plain main() which calls CHECK() as many times as it
+ * likes and returns test_result(), so "make test" can stop at the first
+ * program with a failure. Benchmark timings are host nanoseconds and are only
+ * useful for comparing two implementations built the same way; anything
+ * that should hold on the AVR is checked with operation counts instead.
+ */
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static int testChecks, testFailures;
+
+#define CHECK(cond) do { \
+    testChecks++; \
+    if (!(cond)) { testFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+} while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+    long long _a = (long long)(actual), _e = (long long)(expected); \
+    testChecks++; \
+    if (_a != _e) { testFailures++; printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #actual, #expected, _a, _e); } \
+} while (0)
+
+/**
+ * @brief Print check summary and get program exit code
+ * @return Zero if every check passed, one otherwise
+ */
+static inline int test_result() {
+    printf("%d checks, %d failures\n", testChecks, testFailures);
+    return testFailures ? 1 : 0;
+}
+
+/**
+ * @brief Read host monotonic clock
+ * @return Nanoseconds since an arbitrary fixed point
+ */
+static inline uint64_t bench_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Keep the compiler from discarding a benchmarked result
+ */
+template <typename T> static inline void bench_keep(const T &value) {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+#endif // _TEST_H_
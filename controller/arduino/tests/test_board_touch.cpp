@@ -0,0 +1,325 @@
+// Keyglove controller host tests - Board touch scan decoding
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file test_board_touch.cpp
+ * @brief Every base combination decodes to its own KGB_* bit and KGT_* macro, and ghosts are resolved
+ *
+ * Built once per board (see the Makefile). Each base combination is closed on
+ * the simulated glove by itself, and update_board_touch() must set exactly
+ * the one status bit named by its KGB_* index, which its KGT_* macro must
+ * then report. The sensor pairs come from the KGB_* names and the pins from
+ * the board's pin diagram, so neither side is derived from the scan code.
+ *
+ * Ghost scenarios close every pair of combinations to check that the board's
+ * ghost triangle table lists every ghost the wiring can produce, then run
+ * each triangle through update_touch() in every ghost handling mode.
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touch.h"
+#include "touchsim.h"
+
+/**
+ * @brief Base combination under test: its two sensors, status bit, and test macro
+ */
+typedef struct {
+    char a, b;
+    uint8_t index;
+    bool (*test)(const uint8_t *touches);
+} combination_t;
+
+#define ROW(a, b) { #a[0], #b[0], KGB_##a##b, [](const uint8_t *t) -> bool { return KGT_##a##b(t); } }
+
+#if KG_BOARD == KG_BOARD_TEENSYPP2_T19
+    const combination_t combinations[] = {
+        ROW(A, Y), ROW(B, Y), ROW(C, Y), ROW(D, Y), ROW(E, Y), ROW(F, Y), ROW(G, Y), ROW(H, Y), ROW(I, Y),
+        ROW(J, Y), ROW(K, Y), ROW(L, Y), ROW(Y, 4), ROW(Y, 5), ROW(Y, 6), ROW(Y, 7), ROW(Y, 1),
+        ROW(A, 1), ROW(D, 1), ROW(G, 1), ROW(J, 1),
+        ROW(A, 8), ROW(D, 8), ROW(G, 8), ROW(J, 8),
+    };
+#elif KG_BOARD == KG_BOARD_TEENSYPP2_T37
+    const combination_t combinations[] = {
+        ROW(D, M),
+        ROW(A, Y), ROW(B, Y), ROW(C, Y), ROW(D, Y), ROW(E, Y), ROW(F, Y), ROW(G, Y), ROW(H, Y), ROW(I, Y),
+        ROW(J, Y), ROW(K, Y), ROW(L, Y), ROW(M, Y), ROW(N, Y), ROW(O, Y), ROW(P, Y), ROW(Q, Y), ROW(R, Y),
+        ROW(S, Y), ROW(T, Y), ROW(U, Y), ROW(V, Y), ROW(W, Y), ROW(X, Y),
+        ROW(M, Z), ROW(N, Z), ROW(O, Z), ROW(P, Z), ROW(Q, Z), ROW(R, Z),
+        ROW(A, 1), ROW(D, 1), ROW(G, 1), ROW(J, 1), ROW(Y, 1),
+        ROW(A, 2), ROW(D, 2), ROW(G, 2), ROW(J, 2),
+        ROW(A, 3), ROW(D, 3), ROW(G, 3), ROW(J, 3),
+        ROW(D, 4), ROW(Y, 4), ROW(Z, 4), ROW(Y, 5), ROW(Z, 5),
+        ROW(D, 6), ROW(Y, 6), ROW(Z, 6), ROW(D, 7), ROW(G, 7), ROW(Y, 7), ROW(Z, 7),
+        ROW(A, 8), ROW(D, 8), ROW(G, 8), ROW(J, 8),
+    };
+#endif
+
+#define COMBINATIONS (sizeof(combinations) / sizeof(combination_t))
+
+const combination_t *find_combination(uint8_t index) {
+    for (uint8_t i = 0; i < COMBINATIONS; i++) if (combinations[i].index == index) return &combinations[i];
+    return 0;
+}
+
+/**
+ * @brief Run one scan and count the status bits it set
+ */
+uint8_t scan(uint8_t *touches) {
+    uint8_t count = 0;
+    memset(touches, 0, KG_BASE_COMBINATION_BYTES);
+    update_board_touch(touches);
+    for (uint8_t i = 0; i < KG_BASE_COMBINATIONS; i++) if (KGT_BIT(touches, i)) count++;
+    return count;
+}
+
+/**
+ * @brief Table covers every base combination exactly once
+ */
+void test_table() {
+    uint8_t seen[KG_BASE_COMBINATIONS] = { 0 };
+    CHECK_EQ(COMBINATIONS, KG_BASE_COMBINATIONS);
+    for (uint8_t i = 0; i < COMBINATIONS; i++) {
+        CHECK(combinations[i].index < KG_BASE_COMBINATIONS);
+        if (combinations[i].index < KG_BASE_COMBINATIONS) seen[combinations[i].index]++;
+    }
+    for (uint8_t i = 0; i < KG_BASE_COMBINATIONS; i++) CHECK_EQ(seen[i], 1);
+}
+
+/**
+ * @brief Each single closed contact sets only its own bit, with and without oversampling
+ */
+void test_single_contacts(uint8_t samples) {
+    uint8_t touches[KG_BASE_COMBINATION_BYTES];
+    opt_touch_samples = samples;
+    for (uint8_t i = 0; i < COMBINATIONS; i++) {
+        const combination_t *c = &combinations[i];
+        touchsim_reset();
+        touchsim_connect(c -> a, c -> b);
+        uint8_t count = scan(touches);
+        if (count != 1 || !KGT_BIT(touches, c -> index) || !c -> test(touches)) {
+            printf("%c%c (bit %d, %d samples): %d bits set, own bit %s, KGT macro %s\n", c -> a, c -> b, c -> index, samples,
+                count, KGT_BIT(touches, c -> index) ? "set" : "clear", c -> test(touches) ? "true" : "false");
+        }
+        CHECK_EQ(count, 1);
+        CHECK(c -> test(touches));
+    }
+    touchsim_reset();
+    CHECK_EQ(scan(touches), 0);
+    opt_touch_samples = 1;
+}
+
+/**
+ * @brief Closing two sides of a ghost triangle always shows the third
+ */
+void test_ghost_triangles() {
+    uint8_t touches[KG_BASE_COMBINATION_BYTES], triangle[3];
+    for (uint8_t i = 0; i < KG_GHOST_TRIANGLES; i++) {
+        memcpy_P(triangle, boardGhostTriangles[i], 3);
+        const combination_t *a = find_combination(triangle[0]), *b = find_combination(triangle[1]);
+        CHECK(a && b);
+        if (!a || !b) continue;
+        touchsim_reset();
+        touchsim_connect(a -> a, a -> b);
+        touchsim_connect(b -> a, b -> b);
+        CHECK_EQ(scan(touches), 3);
+        for (uint8_t j = 0; j < 3; j++) CHECK(KGT_BIT(touches, triangle[j]));
+    }
+}
+
+/**
+ * @brief Check whether a ghost triangle contains all three given combinations
+ */
+bool find_triangle(uint8_t a, uint8_t b, uint8_t c) {
+    uint8_t triangle[3], found;
+    for (uint8_t i = 0; i < KG_GHOST_TRIANGLES; i++) {
+        memcpy_P(triangle, boardGhostTriangles[i], 3);
+        found = 0;
+        for (uint8_t j = 0; j < 3; j++) if (triangle[j] == a || triangle[j] == b || triangle[j] == c) found++;
+        if (found == 3) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Every ghost that any two closed contacts can produce is in a ghost triangle
+ *
+ * Closes every pair of base combinations on the simulated glove. Any extra
+ * bit the scan sets is a ghost, and touch_resolve_ghosts() can only handle it
+ * if the board lists those three combinations as a triangle.
+ */
+void test_ghost_pairs() {
+    uint8_t touches[KG_BASE_COMBINATION_BYTES];
+    uint16_t ghosts = 0;
+    for (uint8_t i = 0; i < COMBINATIONS; i++) {
+        for (uint8_t j = i + 1; j < COMBINATIONS; j++) {
+            const combination_t *a = &combinations[i], *b = &combinations[j];
+            touchsim_reset();
+            touchsim_connect(a -> a, a -> b);
+            touchsim_connect(b -> a, b -> b);
+            scan(touches);
+            CHECK(KGT_BIT(touches, a -> index) && KGT_BIT(touches, b -> index));
+            for (uint8_t k = 0; k < KG_BASE_COMBINATIONS; k++) {
+                if (k == a -> index || k == b -> index || !KGT_BIT(touches, k)) continue;
+                ghosts++;
+                if (!find_triangle(a -> index, b -> index, k)) {
+                    const combination_t *c = find_combination(k);
+                    printf("%c%c + %c%c shows %c%c, which is not in any ghost triangle\n", a -> a, a -> b, b -> a, b -> b, c -> a, c -> b);
+                }
+                CHECK(find_triangle(a -> index, b -> index, k));
+            }
+        }
+    }
+    CHECK_EQ(ghosts, 3 * KG_GHOST_TRIANGLES);
+}
+
+uint8_t ambiguousEvents;                                ///< Touch ambiguous events since last cleared
+uint8_t ambiguousStatus[KG_BASE_COMBINATION_BYTES];     ///< Status data from the last touch ambiguous event
+
+uint8_t test_touch_ambiguous(uint8_t status_len, uint8_t *status_data) {
+    ambiguousEvents++;
+    memcpy(ambiguousStatus, status_data, status_len);
+    return 1;
+}
+
+/**
+ * @brief Run update_touch() once per millisecond, long enough for any change to register
+ */
+void hold() {
+    for (uint8_t i = 0; i < 30; i++) {
+        update_touch();
+        mock_advance_us(1000);
+    }
+}
+
+/**
+ * @brief Count status bits set in a touch status buffer
+ */
+uint8_t count_bits(const uint8_t *touches) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < KG_BASE_COMBINATIONS; i++) if (KGT_BIT(touches, i)) count++;
+    return count;
+}
+
+/**
+ * @brief Ghost handling through update_touch() in every mode, for every triangle and each side as the ghost
+ *
+ * Off registers the ghost like any other contact. Report registers it too, and
+ * sends all three sides of the triangle as ambiguous. Mask drops the last side
+ * in the board's table, whichever one was really the ghost, unless that side
+ * was registered before the triangle closed, when it reports instead. The
+ * contacts close either one after the other or both in the same scan.
+ */
+void test_ghost_modes() {
+    uint8_t triangle[3], ghost, mode, sequential, dropped;
+    const combination_t *a, *b;
+    kg_evt_touch_ambiguous = test_touch_ambiguous;
+    for (uint8_t i = 0; i < KG_GHOST_TRIANGLES; i++) {
+        memcpy_P(triangle, boardGhostTriangles[i], 3);
+        for (ghost = 0; ghost < 3; ghost++) {
+            a = find_combination(triangle[(ghost + 1) % 3]);
+            b = find_combination(triangle[(ghost + 2) % 3]);
+            for (mode = KG_TOUCH_GHOST_MODE_OFF; mode <= KG_TOUCH_GHOST_MODE_MASK; mode++) {
+                for (sequential = 0; sequential < 2; sequential++) {
+                    opt_touch_ghost_mode = mode;
+                    touchsim_reset();
+                    hold();
+                    ambiguousEvents = 0;
+                    touchsim_connect(a -> a, a -> b);
+                    if (sequential) hold();
+                    touchsim_connect(b -> a, b -> b);
+                    hold();
+
+                    dropped = KG_BASE_COMBINATIONS;
+                    if (mode == KG_TOUCH_GHOST_MODE_MASK && !(sequential && a -> index == triangle[2])) dropped = triangle[2];
+                    for (uint8_t j = 0; j < 3; j++) CHECK_EQ(KGT_BIT(touches_active, triangle[j]) ? 1 : 0, triangle[j] != dropped);
+                    CHECK_EQ(count_bits(touches_active), dropped == KG_BASE_COMBINATIONS ? 3 : 2);
+                    if (mode == KG_TOUCH_GHOST_MODE_OFF || dropped != KG_BASE_COMBINATIONS) {
+                        CHECK_EQ(ambiguousEvents, 0);
+                    } else {
+                        CHECK_EQ(ambiguousEvents, 1);
+                        CHECK_EQ(count_bits(ambiguousStatus), 3);
+                        for (uint8_t j = 0; j < 3; j++) CHECK(KGT_BIT(ambiguousStatus, triangle[j]));
+                    }
+
+                    // opening one real contact takes the ghost with it, and clears any ambiguous report
+                    touchsim_disconnect(b -> a, b -> b);
+                    hold();
+                    CHECK_EQ(count_bits(touches_active), 1);
+                    CHECK(KGT_BIT(touches_active, a -> index));
+                    CHECK_EQ(count_bits(touches_ambiguous), 0);
+                }
+            }
+        }
+    }
+
+    // two fingertips on the thumb share a sensor but close no triangle, so nothing is ambiguous
+    opt_touch_ghost_mode = KG_TOUCH_GHOST_MODE_REPORT;
+    touchsim_reset();
+    hold();
+    ambiguousEvents = 0;
+    touchsim_connect('A', 'Y');
+    touchsim_connect('D', 'Y');
+    hold();
+    CHECK_EQ(count_bits(touches_active), 2);
+    CHECK(KGT_AY(touches_active) && KGT_DY(touches_active));
+    CHECK_EQ(ambiguousEvents, 0);
+
+    touchsim_reset();
+    hold();
+    kg_evt_touch_ambiguous = 0;
+}
+
+/**
+ * @brief A pin slower than KG_BOARD_TOUCH_SETTLE_US is missed, one within it is seen
+ */
+void test_settle_delay() {
+    uint8_t touches[KG_BASE_COMBINATION_BYTES];
+    touchsim_reset();
+    touchsim_connect('A', 'Y');
+    touchsim_settle('A', KG_BOARD_TOUCH_SETTLE_US);
+    CHECK_EQ(scan(touches), 1);
+    CHECK(KGT_AY(touches));
+    touchsim_settle('A', KG_BOARD_TOUCH_SETTLE_US + 1);
+    CHECK_EQ(scan(touches), 0);
+}
+
+int main() {
+    setup_board();
+    setup_touch();
+    test_table();
+    test_single_contacts(1);
+    test_single_contacts(3);
+    test_ghost_triangles();
+    test_ghost_pairs();
+    test_ghost_modes();
+    test_settle_delay();
+    return test_result();
+}
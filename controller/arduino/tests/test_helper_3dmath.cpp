@@ -0,0 +1,297 @@
+// Keyglove controller host tests - Fixed-point 3D math and Mahony filter
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file test_helper_3dmath.cpp
+ * @brief Fixed-point quaternion, vector and Mahony filter code checked against double precision
+ *
+ * Every fixed-point function is run on random inputs next to the same math in
+ * doubles. The Mahony filter is run for ten simulated minutes of continuous
+ * hand rotation at 100Hz, next to a double-precision Mahony filter with the
+ * same gains, fed the same integer gyro and accel samples. Only tilt is
+ * compared, since heading has no accel correction in either filter.
+ *
+ * This program is built with KG_FUSION_DMP and KG_FUSION_MAHONY, so it also
+ * checks that the hand sensor code and the I2Cdevlib DMP header build
+ * together with a single set of float 3D math classes.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_motion.h"
+#include "support_helper_3dmath.h"
+
+#define RATE            100         ///< Simulated update rate (Hz)
+#define GYRO_LSB        16.4        ///< Gyro counts per deg/sec (2000 deg/sec range)
+#define ACCEL_LSB       16384       ///< Accel counts per g (2g range)
+#define KP              0.5         ///< Proportional gain (rad/sec per unit of gravity error)
+#define KI              0.05        ///< Integral gain (rad/sec^2 per unit of gravity error)
+
+uint32_t seed = 2468;
+
+/**
+ * @brief Uniform random number in [-1, 1)
+ */
+double rnd() {
+    seed = seed * 1103515245 + 12345;
+    return ((seed >> 8) & 0xFFFF) / 32768.0 - 1.0;
+}
+
+/**
+ * @brief Double-precision quaternion, (w, x, y, z)
+ */
+struct dquat {
+    double w, x, y, z;
+};
+
+dquat dquat_product(const dquat &a, const dquat &b) {
+    dquat r = {
+        a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z,
+        a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+        a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+        a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w };
+    return r;
+}
+
+void dquat_normalize(dquat *q) {
+    double m = sqrt(q -> w*q -> w + q -> x*q -> x + q -> y*q -> y + q -> z*q -> z);
+    q -> w /= m;
+    q -> x /= m;
+    q -> y /= m;
+    q -> z /= m;
+}
+
+dquat dquat_random() {
+    dquat q = { rnd(), rnd(), rnd(), rnd() };
+    dquat_normalize(&q);
+    return q;
+}
+
+/**
+ * @brief Rotate a vector by a quaternion, v' = q * v * conj(q)
+ */
+void dquat_rotate(const dquat &q, double *v) {
+    dquat p = { 0, v[0], v[1], v[2] }, c = { q.w, -q.x, -q.y, -q.z };
+    p = dquat_product(dquat_product(q, p), c);
+    v[0] = p.x;
+    v[1] = p.y;
+    v[2] = p.z;
+}
+
+dquat from_q15(const QuaternionQ15 &q) {
+    dquat r = { q.w / 32768.0, q.x / 32768.0, q.y / 32768.0, q.z / 32768.0 };
+    return r;
+}
+
+QuaternionQ15 to_q15(const dquat &q) {
+    return QuaternionQ15(lround(q.w * 32767), lround(q.x * 32767), lround(q.y * 32767), lround(q.z * 32767));
+}
+
+/**
+ * @brief fixed_mul_q15() matches a 64-bit product, and fixed_inv_sqrt() is within 1e-4 everywhere
+ */
+void test_scalar() {
+    double worst = 0;
+    int64_t worstMul = 0;
+    uint32_t i;
+    for (i = 0; i < 100000; i++) {
+        int32_t a = (int32_t)(rnd() * 1073741823.0);
+        int16_t b = (int16_t)(rnd() * 32767);
+        int64_t expect = ((int64_t)a * b) >> 15, error = fixed_mul_q15(a, b) - expect;
+        if (error < 0) error = -error;
+        if (error > worstMul) worstMul = error;
+    }
+    printf("fixed_mul_q15: max error %lld LSB\n", (long long)worstMul);
+    CHECK(worstMul <= 1);
+
+    // every power-of-two range, plus random values
+    for (i = 0; i < 200000; i++) {
+        uint32_t x = i < 32 * 64 ? ((1UL << (i / 64)) + (uint32_t)((1UL << (i / 64)) * (i % 64) / 64.0)) : (uint32_t)(seed = seed * 1103515245 + 12345) >> (i % 32);
+        uint8_t shift;
+        if (!x) continue;
+        uint16_t n = fixed_inv_sqrt(x, &shift);
+        double result = n / 32768.0 / pow(2.0, shift), expect = 1.0 / sqrt((double)x);
+        worst = fmax(worst, fabs(result / expect - 1.0));
+    }
+    printf("fixed_inv_sqrt: max relative error %.2e\n", worst);
+    CHECK(worst < 1e-4);
+}
+
+/**
+ * @brief Q1.15 product, normalization and both fixed-point rotations stay within a few LSB of doubles
+ */
+void test_quaternion() {
+    double worstProduct = 0, worstNorm = 0, worstRotate = 0, worstQ16 = 0;
+    for (uint32_t i = 0; i < 20000; i++) {
+        dquat a = dquat_random(), b = dquat_random(), p = dquat_product(a, b);
+        QuaternionQ15 qa = to_q15(a), qb = to_q15(b), qp = qa.getProduct(qb);
+        worstProduct = fmax(worstProduct, fmax(fmax(fabs(qp.w - p.w * 32768), fabs(qp.x - p.x * 32768)), fmax(fabs(qp.y - p.y * 32768), fabs(qp.z - p.z * 32768))));
+
+        // a quaternion off by up to 10% in magnitude comes back to unit length
+        double scale = 0.9 + 0.1 * rnd();
+        QuaternionQ15 qs(lround(a.w * 32767 * scale), lround(a.x * 32767 * scale), lround(a.y * 32767 * scale), lround(a.z * 32767 * scale));
+        qs.normalize();
+        worstNorm = fmax(worstNorm, fabs(sqrt((double)qs.w*qs.w + (double)qs.x*qs.x + (double)qs.y*qs.y + (double)qs.z*qs.z) - 32767));
+
+        // 16-bit vector, sized like a 2g accel reading
+        double v[3] = { rnd() * 16000, rnd() * 16000, rnd() * 16000 }, r[3] = { v[0], v[1], v[2] };
+        dquat_rotate(a, r);
+        if (fabs(r[0]) > 32000 || fabs(r[1]) > 32000 || fabs(r[2]) > 32000) continue;
+        VectorInt16 vi(lround(v[0]), lround(v[1]), lround(v[2]));
+        fixed_rotate_q15(&vi, &qa);
+        worstRotate = fmax(worstRotate, fmax(fabs(vi.x - r[0]), fmax(fabs(vi.y - r[1]), fabs(vi.z - r[2]))));
+
+        // Q16.16 vector, +/-1000.0
+        double w[3] = { rnd() * 1000, rnd() * 1000, rnd() * 1000 }, s[3] = { w[0], w[1], w[2] };
+        dquat_rotate(a, s);
+        VectorQ16 vq(lround(w[0] * 65536), lround(w[1] * 65536), lround(w[2] * 65536));
+        vq.rotate(&qa);
+        worstQ16 = fmax(worstQ16, fmax(fabs(vq.x / 65536.0 - s[0]), fmax(fabs(vq.y / 65536.0 - s[1]), fabs(vq.z / 65536.0 - s[2]))) / 1000);
+    }
+    printf("QuaternionQ15: product max error %.1f LSB, normalized magnitude max error %.1f LSB\n", worstProduct, worstNorm);
+    printf("rotation: VectorInt16 max error %.1f LSB, VectorQ16 max error %.1e of input range\n", worstRotate, worstQ16);
+    CHECK(worstProduct < 4);
+    CHECK(worstNorm < 4);
+    CHECK(worstRotate < 8);
+    CHECK(worstQ16 < 5e-4);
+
+    // normalizing a zero quaternion leaves it alone instead of dividing by zero
+    QuaternionQ15 zero(0, 0, 0, 0);
+    zero.normalize();
+    CHECK_EQ(zero.w, 0);
+}
+
+/**
+ * @brief Double-precision Mahony filter, same algorithm and gains as MahonyFilter
+ */
+struct dmahony {
+    dquat q;
+    double integral[3];
+    double gyroStep, kp, ki;
+
+    void update(const VectorInt16 &accel, const VectorInt16 &gyro) {
+        double h[3] = { gyro.x * gyroStep, gyro.y * gyroStep, gyro.z * gyroStep };
+        double m = sqrt((double)accel.x*accel.x + (double)accel.y*accel.y + (double)accel.z*accel.z);
+        if (m > 0) {
+            double a[3] = { accel.x / m, accel.y / m, accel.z / m };
+            double v[3] = { 2 * (q.x*q.z - q.w*q.y), 2 * (q.w*q.x + q.y*q.z), q.w*q.w - q.x*q.x - q.y*q.y + q.z*q.z };
+            double e[3] = { a[1]*v[2] - a[2]*v[1], a[2]*v[0] - a[0]*v[2], a[0]*v[1] - a[1]*v[0] };
+            for (uint8_t i = 0; i < 3; i++) {
+                integral[i] += e[i] * ki / 2 / RATE / RATE;
+                h[i] += integral[i] + e[i] * kp / 2 / RATE;
+            }
+        }
+        dquat c = q;
+        q.w -= h[0]*c.x + h[1]*c.y + h[2]*c.z;
+        q.x += h[0]*c.w + h[2]*c.y - h[1]*c.z;
+        q.y += h[1]*c.w - h[2]*c.x + h[0]*c.z;
+        q.z += h[2]*c.w + h[1]*c.x - h[0]*c.y;
+        dquat_normalize(&q);
+    }
+};
+
+/**
+ * @brief Angle between the gravity directions two orientations predict, in degrees
+ */
+double tilt_angle(const dquat &a, const dquat &b) {
+    double ga[3] = { 0, 0, 1 }, gb[3] = { 0, 0, 1 };
+    dquat ia = { a.w, -a.x, -a.y, -a.z }, ib = { b.w, -b.x, -b.y, -b.z };
+    dquat_rotate(ia, ga);
+    dquat_rotate(ib, gb);
+    double dot = (ga[0]*gb[0] + ga[1]*gb[1] + ga[2]*gb[2]) / sqrt(ga[0]*ga[0] + ga[1]*ga[1] + ga[2]*ga[2]) / sqrt(gb[0]*gb[0] + gb[1]*gb[1] + gb[2]*gb[2]);
+    return acos(fmin(dot, 1.0)) * 180 / M_PI;
+}
+
+/**
+ * @brief Results of one simulated Mahony run
+ */
+struct mahony_run_t {
+    double refTilt;     ///< Largest tilt difference from the double filter (deg)
+    double truthTilt;   ///< Largest tilt error against the true orientation after the first 30s (deg)
+};
+
+/**
+ * @brief Ten minutes of continuous rotation with a gyro bias, fixed-point and double filters side by side
+ *
+ * Accel feedback only corrects tilt. Heading is integrated from the gyro alone
+ * in both filters, so rounding differences there add up over time and are
+ * not compared.
+ */
+mahony_run_t run_mahony(double ki) {
+    MahonyFilter filter(KG_MAHONY_GYRO_STEP(GYRO_LSB, RATE), KG_MAHONY_KP_STEP(KP, RATE), ki > 0 ? KG_MAHONY_KI_STEP(ki, RATE) : 0);
+    // the reference uses the rounded constants too, so only the arithmetic differs
+    dmahony ref = { { 1, 0, 0, 0 }, { 0, 0, 0 }, filter.gyroStep / 1073741824.0, filter.kpStep * 2.0 * RATE / 65536, filter.kiStep * 2.0 * RATE * RATE / 16777216 };
+    dquat truth = { 1, 0, 0, 0 }, fixed;
+    mahony_run_t run = { 0, 0 };
+
+    for (uint32_t i = 0; i < 600 * RATE; i++) {
+        // smooth rotation up to a few hundred deg/sec on each axis, plus a constant gyro bias
+        double t = (double)i / RATE, w[3] = { 3.0 * sin(0.7 * t), 2.0 * sin(0.43 * t + 1), 4.0 * sin(0.29 * t + 2) };
+        VectorInt16 gyro(lround((w[0] * 180 / M_PI + 0.5) * GYRO_LSB), lround((w[1] * 180 / M_PI - 0.3) * GYRO_LSB), lround(w[2] * 180 / M_PI * GYRO_LSB));
+
+        // advance the true orientation by the exact rotation over this update
+        double angle = sqrt(w[0]*w[0] + w[1]*w[1] + w[2]*w[2]) / RATE;
+        if (angle > 0) {
+            double s = sin(angle / 2) / (angle * RATE);
+            dquat d = { cos(angle / 2), w[0] * s, w[1] * s, w[2] * s };
+            truth = dquat_product(truth, d);
+            dquat_normalize(&truth);
+        }
+
+        // gravity seen by the sensor, with a little noise
+        double g[3] = { 0, 0, 1 };
+        dquat inv = { truth.w, -truth.x, -truth.y, -truth.z };
+        dquat_rotate(inv, g);
+        VectorInt16 accel(lround((g[0] + 0.01 * rnd()) * ACCEL_LSB), lround((g[1] + 0.01 * rnd()) * ACCEL_LSB), lround((g[2] + 0.01 * rnd()) * ACCEL_LSB));
+
+        filter.update(&accel, &gyro);
+        ref.update(accel, gyro);
+        fixed = from_q15(filter.getQuaternion());
+        run.refTilt = fmax(run.refTilt, tilt_angle(fixed, ref.q));
+        if (i >= 30 * RATE) run.truthTilt = fmax(run.truthTilt, tilt_angle(fixed, truth));
+    }
+    return run;
+}
+
+int main() {
+    test_scalar();
+    test_quaternion();
+
+    mahony_run_t p = run_mahony(0), pi = run_mahony(KI);
+    printf("Mahony, 10 min at %dHz, Kp %.2f, Ki %.2f: tilt max %.3f deg from double filter, tilt error %.2f deg\n", RATE, KP, 0.0, p.refTilt, p.truthTilt);
+    printf("Mahony, 10 min at %dHz, Kp %.2f, Ki %.2f: tilt max %.3f deg from double filter, tilt error %.2f deg\n", RATE, KP, KI, pi.refTilt, pi.truthTilt);
+    CHECK(p.refTilt < 0.1);
+    CHECK(pi.refTilt < 0.1);
+    CHECK(pi.truthTilt < p.truthTilt);
+    CHECK(pi.truthTilt < 3);
+    return test_result();
+}
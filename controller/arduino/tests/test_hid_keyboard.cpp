@@ -0,0 +1,228 @@
+// Keyglove controller host tests - HID keyboard report batching
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test_hid_keyboard.cpp
+ * @brief Keyboard reports sent for key and modifier changes made during loop() passes
+ *
+ * Key and modifier calls only change the report state, and update_hid_keyboard()
+ * sends one report per loop pass with everything that changed. Every
+ * Bluetooth HID keyboard report is caught and counted, and the last one is
+ * kept, so each check can see how many reports a chord transition cost and
+ * what the host saw in the end.
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_hid_keyboard.h"
+#include "support_bluetooth2_iwrap.h"
+
+uint8_t btModifier, btKeys[6];
+uint16_t btReports;
+
+void BTKeyboardWrapper::set_modifier(uint8_t code) { btModifier = code; }
+void BTKeyboardWrapper::set_key1(uint8_t code) { btKeys[0] = code; }
+void BTKeyboardWrapper::set_key2(uint8_t code) { btKeys[1] = code; }
+void BTKeyboardWrapper::set_key3(uint8_t code) { btKeys[2] = code; }
+void BTKeyboardWrapper::set_key4(uint8_t code) { btKeys[3] = code; }
+void BTKeyboardWrapper::set_key5(uint8_t code) { btKeys[4] = code; }
+void BTKeyboardWrapper::set_key6(uint8_t code) { btKeys[5] = code; }
+void BTKeyboardWrapper::send_now() { btReports++; }
+
+/**
+ * @brief Check whether a key is down in the last Bluetooth report
+ */
+bool bt_key_down(uint8_t code) {
+    for (uint8_t i = 0; i < 6; i++) if (btKeys[i] == code) return true;
+    return false;
+}
+
+/**
+ * @brief Release everything, send the release, and start counting from zero
+ */
+void reset() {
+    interfaceBT2HIDReady = true;
+    setup_hid_keyboard();
+    for (uint8_t code = KEY_A; code <= KEY_Z; code++) keyboard_key_up(code);
+    keyboard_modifier_up(0xFF);
+    update_hid_keyboard();
+    btReports = 0;
+    Keyboard.reports = 0;
+}
+
+/**
+ * @brief Run the end of one loop() pass and get the number of reports sent since the last reset
+ */
+uint16_t loop_pass() {
+    update_hid_keyboard();
+    #if KG_HOSTIF & KG_HOSTIF_USB_HID
+        CHECK_EQ(Keyboard.reports, btReports);
+    #endif
+    return btReports;
+}
+
+/**
+ * @brief A chord pressed or released in one pass is one report, not one per key
+ */
+void test_chord() {
+    reset();
+    keyboard_key_down(KEY_A);
+    keyboard_key_down(KEY_S);
+    keyboard_key_down(KEY_D);
+    CHECK_EQ(loop_pass(), 1);
+    CHECK(bt_key_down(KEY_A) && bt_key_down(KEY_S) && bt_key_down(KEY_D));
+    CHECK_EQ(loop_pass(), 1);     // nothing changed, nothing sent
+    keyboard_key_up(KEY_A);
+    keyboard_key_up(KEY_S);
+    keyboard_key_up(KEY_D);
+    CHECK_EQ(loop_pass(), 2);
+    CHECK(!bt_key_down(KEY_A) && !bt_key_down(KEY_S) && !bt_key_down(KEY_D));
+}
+
+/**
+ * @brief Five chord transitions cost five reports (one per key and modifier change used to be thirteen)
+ */
+void test_sequence() {
+    reset();
+    keyboard_key_down(KEY_A);
+    keyboard_key_down(KEY_S);
+    keyboard_key_down(KEY_D);
+    loop_pass();
+    keyboard_key_up(KEY_A);
+    keyboard_key_up(KEY_S);
+    keyboard_key_up(KEY_D);
+    loop_pass();
+    keyboard_modifier_down(MODIFIERKEY_CTRL);
+    keyboard_modifier_down(MODIFIERKEY_SHIFT);
+    keyboard_key_down(KEY_T);
+    loop_pass();
+    CHECK_EQ(btModifier, MODIFIERKEY_CTRL | MODIFIERKEY_SHIFT);
+    CHECK(bt_key_down(KEY_T));
+    keyboard_key_up(KEY_T);
+    keyboard_key_down(KEY_N);
+    loop_pass();
+    CHECK(!bt_key_down(KEY_T) && bt_key_down(KEY_N));
+    keyboard_key_up(KEY_N);
+    keyboard_modifier_up(MODIFIERKEY_CTRL);
+    keyboard_modifier_up(MODIFIERKEY_SHIFT);
+    CHECK_EQ(loop_pass(), 5);
+    CHECK_EQ(btModifier, 0);
+    CHECK(!bt_key_down(KEY_N));
+}
+
+/**
+ * @brief A key or modifier tapped within one pass still reaches the host as a press and a release
+ */
+void test_tap() {
+    reset();
+    keyboard_key_down(KEY_A);
+    keyboard_key_up(KEY_A);
+    CHECK_EQ(btReports, 1);       // the press went out before the release replaced it
+    CHECK(bt_key_down(KEY_A));
+    CHECK_EQ(loop_pass(), 2);
+    CHECK(!bt_key_down(KEY_A));
+
+    reset();
+    keyboard_modifier_down(MODIFIERKEY_ALT);
+    keyboard_modifier_up(MODIFIERKEY_ALT);
+    CHECK_EQ(btReports, 1);
+    CHECK_EQ(btModifier, MODIFIERKEY_ALT);
+    CHECK_EQ(loop_pass(), 2);
+    CHECK_EQ(btModifier, 0);
+}
+
+/**
+ * @brief A key released and pressed again within one pass sends the release first
+ */
+void test_repress() {
+    reset();
+    keyboard_key_down(KEY_A);
+    CHECK_EQ(loop_pass(), 1);
+    keyboard_key_up(KEY_A);
+    keyboard_key_down(KEY_A);
+    CHECK_EQ(btReports, 2);
+    CHECK(!bt_key_down(KEY_A));
+    CHECK_EQ(loop_pass(), 3);
+    CHECK(bt_key_down(KEY_A));
+    keyboard_key_up(KEY_A);
+    CHECK_EQ(loop_pass(), 4);
+}
+
+/**
+ * @brief Key and modifier presses send the down report before their delay, and the up report with the next pass
+ */
+void test_press() {
+    reset();
+    keyboard_key_press(KEY_B);
+    CHECK_EQ(btReports, 1);
+    CHECK(bt_key_down(KEY_B));
+    CHECK_EQ(loop_pass(), 2);
+    CHECK(!bt_key_down(KEY_B));
+
+    reset();
+    keyboard_modifier_press(MODIFIERKEY_GUI);
+    CHECK_EQ(btReports, 1);
+    CHECK_EQ(btModifier, MODIFIERKEY_GUI);
+    CHECK_EQ(loop_pass(), 2);
+    CHECK_EQ(btModifier, 0);
+}
+
+/**
+ * @brief Nothing goes to Bluetooth until its HID link is ready
+ */
+void test_bt_not_ready() {
+    reset();
+    interfaceBT2HIDReady = false;
+    keyboard_key_down(KEY_C);
+    update_hid_keyboard();
+    keyboard_key_up(KEY_C);
+    update_hid_keyboard();
+    CHECK_EQ(btReports, 0);
+
+    // state is still kept, so the first report after the link comes up is right
+    keyboard_key_down(KEY_D);
+    update_hid_keyboard();
+    interfaceBT2HIDReady = true;
+    keyboard_modifier_down(MODIFIERKEY_SHIFT);
+    update_hid_keyboard();
+    CHECK_EQ(btReports, 1);
+    CHECK(bt_key_down(KEY_D) && !bt_key_down(KEY_C));
+    CHECK_EQ(btModifier, MODIFIERKEY_SHIFT);
+}
+
+int main() {
+    test_chord();
+    test_sequence();
+    test_tap();
+    test_repress();
+    test_press();
+    test_bt_not_ready();
+    return test_result();
+}
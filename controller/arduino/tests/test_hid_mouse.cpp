@@ -0,0 +1,414 @@
+// Keyglove controller host tests - Mouse report stream from gyro traces
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file test_hid_mouse.cpp
+ * @brief Mouse reports sent for gyro traces played through the hand sensor driver
+ *
+ * Each trace in traces/mouse_*.csv (see traces/make_mouse_traces.py) is played
+ * into a simulated MPU-6050 at 100Hz, with the accelerometer following the
+ * hand's tilt, and the real hand driver, I2C queue and mouse pipeline run
+ * like loop() runs them. Every Bluetooth HID mouse report is caught, and the
+ * stream is checked against the movement the response curve gives for the
+ * filtered gyro data the driver sent out with each sample:
+ *
+ *  - reports are at least KG_HID_MOUSE_REPORT_INTERVAL ms apart
+ *  - a whole count of movement never waits longer than one report interval
+ *  - for movement reports can keep up with, reports add up to the measured
+ *    movement to within one count, so slow movement is not lost to rounding,
+ *    even at 1kHz where each sample is a fraction of a 1/16 count
+ *  - movement faster than reports can carry is split across full reports
+ *    instead of wrapping around, and the cursor stops within a couple of
+ *    reports of the hand stopping; the backlog cap drops the rest, so the
+ *    totals no longer add up, but each flick is only shortened, keeping its
+ *    direction
+ *
+ * The point-and-stop trace is also played with the cursor predictor on, which
+ * must move the cursor ahead in time without overshooting where it stops.
+ */
+
+#include <math.h>
+#include <vector>
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "mpusim.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+#include "support_motion_mpu6050_hand.h"
+#include "support_hid_mouse.h"
+#include "support_bluetooth2_iwrap.h"
+
+#define TEST_LOOP_US            100     ///< Simulated time per main loop pass
+#define TEST_TRACE_US           10000   ///< Time between trace samples (100Hz)
+#define TEST_SETTLE_MS          1000    ///< Time to run after the trace ends
+#define TEST_LAG_MAX            60      ///< Largest time shift tried when lining up cursor and measured paths, in ms
+
+extern uint8_t opt_hid_mouse_invert_x, opt_hid_mouse_invert_y;
+
+/**
+ * @brief Outcome of one trace replay
+ */
+struct replay_t {
+    uint32_t samples;                   ///< Samples the driver handed to the mouse pipeline
+    uint32_t reports;                   ///< Bluetooth mouse reports sent
+    uint32_t fullReports;               ///< Reports with 127 counts on an axis
+    uint32_t waitMaxUs;                 ///< Longest time a whole count waited to be reported
+    uint16_t gapMinMs;                  ///< Shortest time between two reports
+    int32_t measured[2];                ///< Measured movement, in 1/16 counts
+    int32_t reported[2];                ///< Reported movement, in counts
+    int32_t pendingMax;                 ///< Largest measured minus reported movement on either axis, in 1/16 counts
+    int32_t truncated;                  ///< Path length (X + Y) if every sample were rounded down to whole counts by itself, in counts
+    int32_t length;                     ///< Path length (X + Y) reported, in counts
+    int32_t measuredLength;             ///< Path length (X + Y) measured, in counts
+    int32_t fine;                       ///< Path length (X + Y) measured in samples of less than one count, in 1/16 counts
+    uint32_t lateMaxUs;                 ///< Longest time from the last sample with a whole count of movement to a report of 16 counts or more
+    int16_t lag;                        ///< Time shift that best lines up the reported path with the measured path, in ms
+    double overshoot;                   ///< Worst overshoot past where a move came to rest, as a share of the move
+    double angleMax;                    ///< Largest angle between reported and measured movement over one flick, in degrees
+    double stretchMax;                  ///< Most that reported movement over one flick was longer than measured, in counts
+};
+
+MpuSim mpu(0x68, KG_INTERRUPT_NUM_MPU6050_HAND);
+std::vector<int16_t> trace;             ///< Accel X/Y/Z and gyro X/Y/Z samples, back to back
+uint32_t traceStartUs;
+replay_t result;
+std::vector<int32_t> measuredPath, reportedPath;    ///< X/Y positions at every millisecond, in 1/16 counts
+uint32_t lastReportMs, lastMovingUs;
+bool bigReport;                         ///< A report of 16 counts or more went out during this loop pass
+
+/**
+ * @brief Read a kgpredict.py style CSV gyro trace and tilt the accelerometer to match
+ *
+ * The trace only has gyro data, so accel readings come from integrating the
+ * rotation, which keeps the driver's still detection seeing a moving hand.
+ */
+bool read_trace(const char *name) {
+    char path[64], line[128];
+    double pitch = 0, roll = 0;
+    snprintf(path, sizeof(path), "traces/%s.csv", name);
+    FILE *f = fopen(path, "r");
+    if (!f) { printf("can't open %s\n", path); return false; }
+    trace.clear();
+    while (fgets(line, sizeof(line), f)) {
+        int gx, gy, gz;
+        if (line[0] == '#' || sscanf(line, "%d,%d,%d", &gx, &gy, &gz) != 3) continue;
+        roll += gx / 16.4 / 100 * M_PI / 180;
+        pitch += gy / 16.4 / 100 * M_PI / 180;
+        trace.push_back(16384 * sin(pitch));
+        trace.push_back(-16384 * sin(roll) * cos(pitch));
+        trace.push_back(16384 * cos(roll) * cos(pitch));
+        trace.push_back(gx);
+        trace.push_back(gy);
+        trace.push_back(gz);
+    }
+    fclose(f);
+    return trace.size() > 0;
+}
+
+/**
+ * @brief Trace sample at a point in simulated time (flat and still before the trace starts)
+ */
+void trace_motion(uint32_t us, int16_t *motion) {
+    memset(motion, 0, 6 * sizeof(int16_t));
+    motion[2] = 16384;
+    if ((int32_t)(us - traceStartUs) < 0) return;
+    uint32_t i = (us - traceStartUs) / TEST_TRACE_US;
+    if (i >= trace.size() / 6) {
+        memcpy(motion, &trace[trace.size() - 6], 3 * sizeof(int16_t));
+    } else {
+        memcpy(motion, &trace[i * 6], 6 * sizeof(int16_t));
+    }
+}
+
+/**
+ * @brief Add up the movement the response curve gives for each filtered sample, like tilt-position mode does
+ */
+uint8_t measure_sample(uint8_t index, uint8_t flags, uint8_t data_len, uint8_t *data_data) {
+    int16_t gx = data_data[6] | (data_data[7] << 8), gy = data_data[8] | (data_data[9] << 8), gz = data_data[10] | (data_data[11] << 8);
+    int16_t dx = hid_mouse_curve(KG_HID_CURVE_CURSOR, gy) - hid_mouse_curve(KG_HID_CURVE_CURSOR, gz);
+    int16_t dy = hid_mouse_curve(KG_HID_CURVE_CURSOR, gx);
+    if (opt_hid_mouse_invert_x) dx = -dx;
+    if (opt_hid_mouse_invert_y) dy = -dy;
+    result.measured[0] += dx;
+    result.measured[1] += dy;
+    result.truncated += abs(dx / 16) + abs(dy / 16);
+    result.measuredLength += (abs(dx) + abs(dy)) / 16;
+    if (abs(dx) < 16 && abs(dy) < 16) result.fine += abs(dx) + abs(dy);
+    if (abs(dx) >= 16 || abs(dy) >= 16) lastMovingUs = mock_us;
+    result.samples++;
+    return 1;   // no motion data packets needed
+}
+
+void BTMouseWrapper::move(int8_t x, int8_t y, int8_t vscroll, int8_t hscroll) {
+    uint32_t now = millis();
+    if (result.reports && now - lastReportMs < result.gapMinMs) result.gapMinMs = now - lastReportMs;
+    lastReportMs = now;
+    if (abs(x) >= 16 || abs(y) >= 16) bigReport = true;
+    result.reported[0] += x;
+    result.reported[1] += y;
+    result.length += abs(x) + abs(y);
+    if (abs(x) == 127 || abs(y) == 127) result.fullReports++;
+    result.reports++;
+}
+
+/**
+ * @brief Find the time shift that best lines up the reported path with the measured path
+ */
+int16_t path_lag() {
+    double best = -1;
+    int16_t lag = 0;
+    size_t points = measuredPath.size() / 2;
+    for (int16_t shift = -TEST_LAG_MAX; shift <= TEST_LAG_MAX; shift++) {
+        double sum = 0;
+        for (size_t t = TEST_LAG_MAX; t + TEST_LAG_MAX < points; t++) {
+            double ex = reportedPath[(t + shift) * 2] - measuredPath[t * 2], ey = reportedPath[(t + shift) * 2 + 1] - measuredPath[t * 2 + 1];
+            sum += ex * ex + ey * ey;
+        }
+        if (best < 0 || sum < best) { best = sum; lag = shift; }
+    }
+    return lag;
+}
+
+/**
+ * @brief Split the measured path into moves
+ * @param[in] rest Milliseconds the cursor must be slow for before a move ends
+ * @param[out] ends Where each move ended (the end of the path for the last one)
+ * @return Start of every move, then the end of the path
+ *
+ * A move starts when the measured cursor moves faster than two counts per
+ * 10ms.
+ */
+std::vector<size_t> path_moves(size_t rest, std::vector<size_t> *ends) {
+    size_t points = measuredPath.size() / 2, quiet = 0;
+    std::vector<size_t> starts;
+    bool moving = false;
+    ends -> clear();
+    for (size_t t = 10; t < points; t++) {
+        double speed = fabs(measuredPath[t * 2] - measuredPath[(t - 10) * 2]) + fabs(measuredPath[t * 2 + 1] - measuredPath[(t - 10) * 2 + 1]);
+        if (speed > 2 * 16) {
+            if (!moving) starts.push_back(t - 10);
+            moving = true;
+            quiet = 0;
+        } else if (moving && ++quiet >= rest) {
+            ends -> push_back(t);
+            moving = false;
+        }
+    }
+    if (moving) ends -> push_back(points - 1);
+    starts.push_back(points);
+    return starts;
+}
+
+/**
+ * @brief Find the worst overshoot past the resting point after each move, as a share of the move
+ *
+ * Moves are separated by 200ms of slow movement, and the cursor comes to rest
+ * where the measured path is when the next move starts.
+ */
+double path_overshoot() {
+    std::vector<size_t> ends, starts = path_moves(200, &ends);
+    double worst = 0;
+    for (size_t i = 0; i + 1 < starts.size(); i++) {
+        size_t start = starts[i];
+        size_t stop = starts[i + 1];
+        double fx = measuredPath[(stop - 1) * 2], fy = measuredPath[(stop - 1) * 2 + 1];
+        double dx = fx - measuredPath[start * 2], dy = fy - measuredPath[start * 2 + 1], length = hypot(dx, dy);
+        if (length < 10 * 16) continue;
+        for (size_t t = start; t < stop; t++) {
+            double past = ((reportedPath[t * 2] - fx) * dx + (reportedPath[t * 2 + 1] - fy) * dy) / length;
+            worst = fmax(worst, past / length);
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Compare the reported and measured movement over each separate flick
+ *
+ * A move ends after 30ms of slow movement, which splits each flick from its
+ * return and leaves time for the backlog to drain. The reported movement over
+ * a move should point the same way as the measured movement even when the
+ * backlog cap shortens it, and should never be longer.
+ */
+void path_direction() {
+    std::vector<size_t> ends, starts = path_moves(30, &ends);
+    for (size_t i = 0; i < ends.size(); i++) {
+        size_t start = starts[i], stop = ends[i];
+        double mx = measuredPath[stop * 2] - measuredPath[start * 2], my = measuredPath[stop * 2 + 1] - measuredPath[start * 2 + 1];
+        double rx = reportedPath[stop * 2] - reportedPath[start * 2], ry = reportedPath[stop * 2 + 1] - reportedPath[start * 2 + 1];
+        if (hypot(mx, my) < 10 * 16) continue;
+        result.angleMax = fmax(result.angleMax, fabs(atan2(mx * ry - my * rx, mx * rx + my * ry)) * 180 / M_PI);
+        result.stretchMax = fmax(result.stretchMax, (hypot(rx, ry) - hypot(mx, my)) / 16);
+    }
+}
+
+/**
+ * @brief Play a trace through the hand driver and mouse pipeline, and collect what was reported
+ */
+void replay(const char *name, bool predict) {
+    CHECK(read_trace(name));
+    memset(&result, 0, sizeof(result));
+    result.gapMinMs = 0xFFFF;
+    measuredPath.clear();
+    reportedPath.clear();
+    Mouse.sumX = Mouse.sumY = Mouse.reports = 0;
+
+    twisim_reset();
+    mpu.reset();
+    mpu.source = trace_motion;
+    twisim_attach(&mpu);
+    setup_i2c();
+    TWBR = ((F_CPU / 400000) - 16) / 2;
+    setup_motion();
+    motion_mpu6050_hand_bias_reset();   // every trace starts from the same filter and bias state
+    setup_hid_mouse();
+    opt_hid_mouse_predictor[MOUSE_MODE_TILT_POSITION].enabled = predict;
+    mouse_on(MOUSE_ACTION_MOVE);
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_ON);
+
+    traceStartUs = mock_us + 100000;
+    uint32_t end = traceStartUs + trace.size() / 6 * TEST_TRACE_US + TEST_SETTLE_MS * 1000UL, waitStart = 0, lastMs = millis();
+    bool waiting = false;
+    while ((int32_t)(mock_us - end) < 0) {
+        mock_advance_us(TEST_LOOP_US);
+        update_motion();
+        update_i2c();
+        update_hid_mouse();
+
+        // a report can go out before later samples from the same FIFO burst are measured, so check after the pass
+        if (bigReport) result.lateMaxUs = max(result.lateMaxUs, mock_us - lastMovingUs);
+        bigReport = false;
+
+        // a whole count measured but not yet reported starts the wait clock
+        int32_t pendingX = result.measured[0] - result.reported[0] * 16, pendingY = result.measured[1] - result.reported[1] * 16;
+        result.pendingMax = max(result.pendingMax, max(abs(pendingX), abs(pendingY)));
+        if (abs(pendingX) >= 16 || abs(pendingY) >= 16) {
+            if (!waiting) waitStart = mock_us;
+            waiting = true;
+            result.waitMaxUs = max(result.waitMaxUs, mock_us - waitStart);
+        } else {
+            waiting = false;
+        }
+        if (millis() != lastMs && (int32_t)(mock_us - traceStartUs) >= 0) {
+            lastMs = millis();
+            measuredPath.push_back(result.measured[0]);
+            measuredPath.push_back(result.measured[1]);
+            reportedPath.push_back(result.reported[0] * 16);
+            reportedPath.push_back(result.reported[1] * 16);
+        }
+    }
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_OFF);
+    result.lag = path_lag();
+    result.overshoot = path_overshoot();
+    path_direction();
+
+    printf("%-12s predictor %-3s: %4u samples, %4u reports (%3u full), gap >= %u ms, wait <= %4.1f ms | moved %6.1f,%6.1f reported %5d,%5d counts | path %5d counts (%5d rounding each sample, %4d in samples under one count) | lag %3d ms, overshoot %4.1f%%, flick direction within %4.1f deg, last report %4.1f ms after the hand stopped\n",
+        name, predict ? "on" : "off", result.samples, result.reports, result.fullReports, result.gapMinMs, result.waitMaxUs / 1000.0,
+        result.measured[0] / 16.0, result.measured[1] / 16.0, result.reported[0], result.reported[1], result.length, result.truncated, result.fine / 16, result.lag, result.overshoot * 100, result.angleMax, result.lateMaxUs / 1000.0);
+
+    CHECK(result.samples >= trace.size() / 6);
+    CHECK(result.gapMinMs >= KG_HID_MOUSE_REPORT_INTERVAL);
+    #if KG_HOSTIF & KG_HOSTIF_USB_HID
+        CHECK_EQ(Mouse.reports, result.reports);
+        CHECK_EQ(Mouse.sumX, result.reported[0]);
+        CHECK_EQ(Mouse.sumY, result.reported[1]);
+    #endif
+}
+
+/**
+ * @brief Reports add up to the measured movement, to within the fraction still waiting
+ */
+void check_totals() {
+    CHECK(abs(result.measured[0] - result.reported[0] * 16) < 16);
+    CHECK(abs(result.measured[1] - result.reported[1] * 16) < 16);
+}
+
+/**
+ * @brief Hold a slow tilt sampled at 1kHz, where each sample scales to less than 1/16 count
+ * @return Movement the tilt gives per 10ms, in 1/16 counts
+ */
+int16_t replay_fine_rate() {
+    int16_t dx;
+    memset(&result, 0, sizeof(result));
+    hid_mouse_clear();
+    opt_hid_mouse_predictor[MOUSE_MODE_TILT_POSITION].enabled = false;
+    gv.x = gv.y = gv.z = 0;
+    while ((dx = hid_mouse_curve(KG_HID_CURVE_CURSOR, ++gv.y)) < 5);
+    for (uint16_t ms = 0; ms < 1000 + TEST_SETTLE_MS; ms++) {
+        mock_advance_us(1000);
+        if (ms < 1000) hid_mouse_sample(1);
+        update_hid_mouse();
+    }
+    printf("fine rate    predictor off: 1000 samples of %d/160 counts, moved %5.1f counts, reported %3d counts\n",
+        dx, dx * 100 / 16.0, abs(result.reported[0]));
+    return dx;
+}
+
+int main() {
+    kg_evt_motion_data = measure_sample;
+    opt_motion_hand_rate_div = 9;   // 100Hz
+
+    // ordinary pointing: one report per sample, nothing waits longer than a report interval
+    replay("mouse_point", false);
+    check_totals();
+    CHECK(result.waitMaxUs <= KG_HID_MOUSE_REPORT_INTERVAL * 1000UL);
+    CHECK_EQ(result.fullReports, 0);
+    CHECK(result.overshoot < 0.02);
+    int16_t lagOff = result.lag;
+
+    // slow movement: samples under one count add up to real movement instead of being rounded away
+    replay("mouse_slow", false);
+    check_totals();
+    CHECK(result.waitMaxUs <= KG_HID_MOUSE_REPORT_INTERVAL * 1000UL);
+    CHECK(result.length >= result.truncated + result.fine / 16 / 2);
+
+    // fast movement: more than one report's worth per sample is split, and the cursor stops with the hand
+    replay("mouse_fast", false);
+    CHECK(result.fullReports > 0);
+    CHECK(result.lateMaxUs <= (KG_HID_MOUSE_BACKLOG_MAX / 127 + 1) * KG_HID_MOUSE_REPORT_INTERVAL * 1000UL);
+    CHECK(result.length <= result.measuredLength + 2);
+    CHECK(result.angleMax < 5);
+    CHECK(result.stretchMax <= 2);
+
+    // predictor: cursor leads the measured path, and stops where it should
+    replay("mouse_point", true);
+    check_totals();
+    CHECK(result.lag <= lagOff - 10);
+    CHECK(result.overshoot < 0.15);
+
+    // 1kHz sampling: the part of a 1/16 count dropped scaling each sample to 1ms is carried, not lost
+    int16_t fine = replay_fine_rate();
+    CHECK(fine < 10);
+    CHECK(abs(abs(result.reported[0]) * 16 - fine * 100) < 16);
+    return test_result();
+}
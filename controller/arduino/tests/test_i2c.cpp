@@ -0,0 +1,233 @@
+// Keyglove controller host tests - I2C transaction queue
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file test_i2c.cpp
+ * @brief I2C transaction queue behavior on the simulated TWI bus, with KG_I2C_TWI and KG_I2C_WIRE
+ *
+ * Built twice: once with the TWI interrupt driver, and once the default way,
+ * through I2Cdev built for the Wire library (see wiresim.cpp).
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "keyglove.h"
+#include "support_i2c.h"
+
+extern "C" void TWI_vect(void);
+extern i2c_transfer_t i2cTransfer[KG_I2C_TRANSFER_MAX];
+
+TwisimDevice memory(0x50), gauge(0x36);
+
+uint8_t burstClient, gaugeClient;
+uint8_t burstLeft;                      ///< Bursts still to read
+uint8_t burstBuffer[8], gaugeBuffer;
+uint8_t burstData[32];                  ///< Everything the bursts read, in order
+char order[16];                         ///< Completion order, 'B' for burst and 'G' for gauge
+uint8_t lastStatus;
+
+void burst_update() {
+    i2c_read(burstClient, 0x50, 0x10 + (4 - burstLeft) * 8, 8, burstBuffer);
+}
+
+uint8_t burst_complete(uint8_t status) {
+    memcpy(burstData + (4 - burstLeft) * 8, burstBuffer, 8);
+    strcat(order, "B");
+    lastStatus = status;
+    return --burstLeft;
+}
+
+void gauge_update() {
+    i2c_read(gaugeClient, 0x36, 0x04, 1, &gaugeBuffer);
+}
+
+uint8_t gauge_complete(uint8_t status) {
+    strcat(order, "G");
+    lastStatus = status;
+    return 0;
+}
+
+void service_none() { }
+uint8_t complete_none(uint8_t status) { return 0; }
+
+/**
+ * @brief Run main loop passes until nothing is pending or on the wire
+ */
+void run_idle() {
+    for (uint16_t i = 0; i < 1000 && (i2cPending || twisim_busy() || i2cTransfer[burstClient].status || i2cTransfer[gaugeClient].status); i++) {
+        mock_advance_us(100);
+        update_i2c();
+    }
+}
+
+/**
+ * @brief A four-burst drain and a one-byte read interleave, and every byte arrives in order
+ */
+void test_interleave() {
+    for (uint8_t i = 0; i < 32; i++) memory.regs[0x10 + i] = i * 7 + 1;
+    gauge.regs[0x04] = 87;
+    burstLeft = 4;
+    order[0] = 0;
+    i2c_request(burstClient);
+    i2c_request(gaugeClient);
+    run_idle();
+
+    printf("completion order: %s\n", order);
+    CHECK_EQ(strlen(order), 5);
+    CHECK(strchr(order, 'G') - order <= 1);
+    CHECK_EQ(gaugeBuffer, 87);
+    for (uint8_t i = 0; i < 32; i++) CHECK_EQ(burstData[i], i * 7 + 1);
+}
+
+/**
+ * @brief Blocking write and read back, including one queued behind a background burst
+ */
+void test_blocking() {
+    uint8_t out[4] = { 0xDE, 0xAD, 0xBE, 0xEF }, in[4] = { 0 };
+    CHECK_EQ(i2c_write_bytes(0x50, 0x80, 4, out), KG_I2C_STATUS_DONE);
+    CHECK_EQ(memory.regs[0x83], 0xEF);
+    CHECK_EQ(i2c_read_bytes(0x50, 0x80, 4, in), KG_I2C_STATUS_DONE);
+    CHECK(memcmp(in, out, 4) == 0);
+
+    burstLeft = 1;
+    order[0] = 0;
+    i2c_request(burstClient);
+    update_i2c();
+    CHECK_EQ(i2c_write_byte(0x50, 0x90, 0x42), KG_I2C_STATUS_DONE);
+    CHECK_EQ(memory.regs[0x90], 0x42);
+    run_idle();
+    CHECK(strcmp(order, "B") == 0);
+    CHECK_EQ(lastStatus, KG_I2C_STATUS_DONE);
+}
+
+/**
+ * @brief A missing device is reported as NACK, both for clients and blocking calls
+ */
+void test_nack() {
+    uint8_t in;
+    CHECK_EQ(i2c_read_bytes(0x77, 0x00, 1, &in), KG_I2C_STATUS_NACK);
+    gauge.nack = true;
+    order[0] = 0;
+    i2c_request(gaugeClient);
+    run_idle();
+    CHECK(strcmp(order, "G") == 0);
+    CHECK_EQ(lastStatus, KG_I2C_STATUS_NACK);
+    gauge.nack = false;
+    CHECK_EQ(i2c_read_bytes(0x36, 0x04, 1, &in), KG_I2C_STATUS_DONE);
+}
+
+#if (KG_I2C == KG_I2C_TWI)
+
+/**
+ * @brief A stuck bus is reset after KG_I2C_TIMEOUT, and the next transfer works, even after a long idle spell
+ */
+void test_timeout() {
+    uint8_t in;
+    uint32_t start = millis();
+    twisimStuck = true;
+    CHECK_EQ(i2c_read_bytes(0x50, 0x80, 1, &in), KG_I2C_STATUS_BUS_ERROR);
+    CHECK(millis() - start >= KG_I2C_TIMEOUT);
+    twisimStuck = false;
+    CHECK_EQ(i2c_read_bytes(0x50, 0x80, 1, &in), KG_I2C_STATUS_DONE);
+    CHECK_EQ(in, 0xDE);
+
+    // main loop busy elsewhere for longer than the timeout (e.g. EEPROM writes), then a transfer starts
+    mock_us += (KG_I2C_TIMEOUT + 50) * 1000UL;
+    CHECK_EQ(i2c_read_bytes(0x50, 0x81, 1, &in), KG_I2C_STATUS_DONE);
+    CHECK_EQ(in, 0xAD);
+}
+
+/**
+ * @brief A TWI interrupt with no transfer active leaves the transfer pool and TWDR alone
+ */
+void test_spurious_interrupt() {
+    i2c_transfer_t before[KG_I2C_TRANSFER_MAX];
+    uint8_t in;
+    run_idle();
+    memcpy(before, i2cTransfer, sizeof(before));
+    TWDR = 0x5A;
+    TWSR = 0x08;    // "START sent", which would make the handler write an address to TWDR
+    TWI_vect();
+    CHECK_EQ(TWDR, 0x5A);
+    CHECK(memcmp(before, i2cTransfer, sizeof(before)) == 0);
+    CHECK_EQ(TWCR & (1 << TWIE), 0);
+    CHECK_EQ(i2c_read_bytes(0x50, 0x81, 1, &in), KG_I2C_STATUS_DONE);
+    CHECK_EQ(in, 0xAD);
+}
+
+#endif
+
+/**
+ * @brief Registering more than KG_I2C_CLIENT_MAX clients fails cleanly
+ */
+void test_register_limit() {
+    uint8_t client = 0, registered = 2;
+    while (registered < KG_I2C_CLIENT_MAX) {
+        client = i2c_register(service_none, complete_none);
+        CHECK_EQ(client, registered);
+        registered++;
+    }
+    CHECK_EQ(i2c_register(service_none, complete_none), KG_I2C_CLIENT_NONE);
+    uint8_t pending = i2cPending;
+    i2c_request(KG_I2C_CLIENT_NONE);
+    CHECK_EQ(i2cPending, pending);
+
+    // the clients registered first still work
+    order[0] = 0;
+    i2c_request(gaugeClient);
+    run_idle();
+    CHECK(strcmp(order, "G") == 0);
+    CHECK_EQ(lastStatus, KG_I2C_STATUS_DONE);
+}
+
+int main() {
+    twisim_reset();
+    twisim_attach(&memory);
+    twisim_attach(&gauge);
+    setup_i2c();
+    burstClient = i2c_register(burst_update, burst_complete);
+    gaugeClient = i2c_register(gauge_update, gauge_complete);
+
+    test_interleave();
+    test_blocking();
+    test_nack();
+    #if (KG_I2C == KG_I2C_TWI)
+        test_timeout();
+        test_spurious_interrupt();
+        CHECK(twisimInterrupts > 0);
+    #else
+        // I2Cdev polls, so the main loop waits out every byte
+        CHECK_EQ(twisimInterrupts, 0);
+        CHECK(twisimSpinUs > 0);
+    #endif
+    test_register_limit();
+    printf("%s: %u bus bytes, %u TWI interrupts, %u us main loop blocked\n", KG_I2C == KG_I2C_TWI ? "KG_I2C_TWI" : "KG_I2C_WIRE", twisimBytes, twisimInterrupts, twisimSpinUs);
+    return test_result();
+}
@@ -0,0 +1,139 @@
+// Keyglove controller host tests - Hand sensor gyro bias storage
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test_motion_bias.cpp
+ * @brief Gyro bias saved to EEPROM in the background when the hand sensor goes still
+ *
+ * A simulated MPU-6050 with a constant gyro offset is left still until the
+ * hand driver estimates the bias and puts the sensor into low-power mode,
+ * with the real I2C queue and driver run like loop() runs them. The bias
+ * record must reach EEPROM without any single loop pass waiting for an
+ * EEPROM write (each byte takes MOCK_EEPROM_WRITE_US), since touches are
+ * still being scanned while the hand rests, and must be loaded at the next
+ * boot.
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "twisim.h"
+#include "mpusim.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_i2c.h"
+#include "support_motion.h"
+#include "support_motion_mpu6050_hand.h"
+
+#define TEST_LOOP_US            100     ///< Simulated time per main loop pass
+
+MpuSim mpu(0x68, KG_INTERRUPT_NUM_MPU6050_HAND);
+uint32_t maxPassUs;                     ///< Longest simulated time spent inside a single loop pass
+
+/**
+ * @brief Flat and still, with a constant gyro offset on every axis
+ */
+void offset_motion(uint32_t us, int16_t *motion) {
+    motion[0] = 0;
+    motion[1] = 0;
+    motion[2] = 16384;
+    motion[3] = 40;
+    motion[4] = -25;
+    motion[5] = 12;
+}
+
+void boot() {
+    twisim_reset();
+    mpu.reset();
+    mpu.source = offset_motion;
+    twisim_attach(&mpu);
+    setup_i2c();
+    TWBR = ((F_CPU / 400000) - 16) / 2;
+    setup_motion();
+    motion_set_mode(KG_MOTION_MPU6050_HAND_INDEX, KG_MOTION_MODE_ON);
+}
+
+/**
+ * @brief Run main loop passes for a while, tracking how long each one blocks
+ */
+void run_ms(uint32_t ms) {
+    uint32_t end = mock_us + ms * 1000;
+    while ((int32_t)(mock_us - end) < 0) {
+        uint32_t t0 = mock_us;
+        update_motion();
+        update_i2c();
+        if (mock_us - t0 > maxPassUs) maxPassUs = mock_us - t0;
+        mock_advance_us(TEST_LOOP_US);
+    }
+}
+
+/**
+ * @brief Read the stored bias record
+ */
+mpu6050_bias_record_t stored() {
+    mpu6050_bias_record_t record;
+    memcpy(&record, mock_eeprom + KG_EEPROM_MOTION_BIAS_ADDRESS, sizeof(record));
+    return record;
+}
+
+int main() {
+    memset(mock_eeprom, 0xFF, sizeof(mock_eeprom));
+    opt_motion_hand_rate_div = 9;   // 100Hz
+    boot();
+    motion_mpu6050_hand_bias_reset();
+    run_ms(100);
+    CHECK(stored().magic != KG_MPU6050_BIAS_EEPROM_MAGIC);
+
+    // still long enough to estimate the bias and go to sleep, then a little longer for the write
+    maxPassUs = 0;
+    mock_eeprom_writes = 0;
+    run_ms(KG_MPU6050_HAND_STILL_TIME + 1000);
+    CHECK_EQ(mpuHandState, KG_MOTION_STATE_STILL);
+    mpu6050_bias_record_t record = stored();
+    printf("bias %d,%d,%d (1/256 counts) stored with %u byte writes, longest loop pass %u us\n",
+        mpuHandBias[0], mpuHandBias[1], mpuHandBias[2], mock_eeprom_writes, maxPassUs);
+    CHECK_EQ(record.magic, KG_MPU6050_BIAS_EEPROM_MAGIC);
+    CHECK(memcmp(record.bias, mpuHandBias, sizeof(record.bias)) == 0);
+    CHECK(mpuHandBias[0] != 0 && mpuHandBias[1] != 0 && mpuHandBias[2] != 0);
+    CHECK(maxPassUs < MOCK_EEPROM_WRITE_US);
+
+    // next boot starts from the stored bias
+    int32_t bias[3];
+    memcpy(bias, mpuHandBias, sizeof(bias));
+    memset(mpuHandBias, 0, sizeof(mpuHandBias));
+    boot();
+    CHECK(memcmp(bias, mpuHandBias, sizeof(bias)) == 0);
+
+    // reset erases the stored copy, also in the background
+    maxPassUs = 0;
+    motion_mpu6050_hand_bias_reset();
+    run_ms(100);
+    CHECK(stored().magic != KG_MPU6050_BIAS_EEPROM_MAGIC);
+    CHECK(maxPassUs < MOCK_EEPROM_WRITE_US);
+    return test_result();
+}
@@ -0,0 +1,165 @@
+// Keyglove controller host tests - Motion smoothing filters
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file test_motion_filter.cpp
+ * @brief Fixed-point motion smoothing filters against double-precision references
+ *
+ * Both filter types are fed a slow sine plus noise, a constant, and full-scale
+ * steps, and compared sample by sample against the same filter computed in
+ * double precision with exact coefficients. The old float smoothing code is
+ * run alongside for comparison.
+ */
+
+#include <math.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_motion.h"
+
+#define TEST_SAMPLES            20000
+
+uint32_t testSeed = 1;
+
+int16_t test_input(uint32_t i) {
+    testSeed = testSeed * 1103515245 + 12345;
+    return (int16_t)(12000 * sin(i * 0.013) + 4000 * sin(i * 0.71) + (int32_t)((testSeed >> 16) & 0x3FF) - 512);
+}
+
+/**
+ * @brief Shift filter matches a double EMA with the same factor to within rounding
+ */
+void test_shift() {
+    for (uint8_t shift = 0; shift <= KG_MPU6050_FILTER_SHIFT_MAX; shift++) {
+        double ref = 0, err, maxErr = 0, maxOld = 0;
+        int16_t old = 0, raw, out;
+        memset(opt_motion_hand_filter, shift, sizeof(opt_motion_hand_filter));
+        motion_mpu6050_hand_filter_reset();
+        for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
+            raw = test_input(i);
+            out = motion_mpu6050_hand_filter(0, raw);
+            ref += (raw - ref) / (1 << shift);
+            err = fabs(out - ref);
+            if (err > maxErr) maxErr = err;
+
+            // old float code (fixed 1/4, truncating into int16 state every step)
+            old = old + (0.25 * (raw - old));
+            if (shift == 2 && fabs(old - ref) > maxOld) maxOld = fabs(old - ref);
+        }
+        printf("shift %d: max error %.2f counts", shift, maxErr);
+        if (shift == 2) printf(" (old float code: %.2f)", maxOld);
+        printf("\n");
+        CHECK(maxErr < 0.55);
+    }
+}
+
+/**
+ * @brief Biquad matches a double Butterworth low-pass with exact coefficients
+ */
+void test_biquad() {
+    for (uint8_t n = 0; n < KG_MPU6050_FILTER_BIQUAD_COUNT; n++) {
+        double w = 2 * M_PI * (n + 1) * 0.05, alpha = sin(w) / sqrt(2.0), a0 = 1 + alpha;
+        double b0 = (1 - cos(w)) / 2 / a0, b1 = (1 - cos(w)) / a0, a1 = -2 * cos(w) / a0, a2 = (1 - alpha) / a0;
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0, y, err, maxErr = 0;
+        int16_t raw, out;
+        memset(opt_motion_hand_filter, KG_MPU6050_FILTER_BIQUAD + n, sizeof(opt_motion_hand_filter));
+        motion_mpu6050_hand_filter_reset();
+        for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
+            raw = test_input(i);
+            out = motion_mpu6050_hand_filter(3, raw);
+            y = b0 * (raw + x2) + b1 * x1 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = raw;
+            y2 = y1;
+            y1 = y;
+            err = fabs(out - y);
+            if (err > maxErr) maxErr = err;
+        }
+        printf("biquad %2d%%: max error %.2f counts\n", (n + 1) * 5, maxErr);
+        CHECK(maxErr < 3.0);
+    }
+}
+
+/**
+ * @brief Constant input comes out exactly, for every setting and sign
+ */
+void test_dc() {
+    const int16_t levels[] = { 12345, -20000, 1, -1, 32767, -32768 };
+    for (uint8_t setting = 0; setting < KG_MPU6050_FILTER_BIQUAD + KG_MPU6050_FILTER_BIQUAD_COUNT; setting++) {
+        if (!motion_mpu6050_hand_filter_valid(setting)) continue;
+        opt_motion_hand_filter[1] = setting;
+        for (uint8_t j = 0; j < sizeof(levels) / sizeof(levels[0]); j++) {
+            int16_t out = 0;
+            motion_mpu6050_hand_filter_reset();
+            for (uint16_t i = 0; i < 4000; i++) out = motion_mpu6050_hand_filter(1, levels[j]);
+            CHECK_EQ(out, levels[j]);
+        }
+    }
+}
+
+/**
+ * @brief Full-scale steps overshoot into saturation instead of wrapping around
+ */
+void test_saturation() {
+    for (uint8_t n = 0; n < KG_MPU6050_FILTER_BIQUAD_COUNT; n++) {
+        int16_t out, lowest = 32767, highest = -32768;
+        opt_motion_hand_filter[2] = KG_MPU6050_FILTER_BIQUAD + n;
+        motion_mpu6050_hand_filter_reset();
+        for (uint16_t i = 0; i < 2000; i++) {
+            out = motion_mpu6050_hand_filter(2, (i / 100) & 1 ? -32768 : 32767);
+            // after the first step, the output follows the sign of the input within a few samples
+            if (i >= 100 && i % 100 >= 20) {
+                if ((i / 100) & 1) highest = out > highest ? out : highest;
+                else lowest = out < lowest ? out : lowest;
+            }
+        }
+        CHECK(highest < -30000);
+        CHECK(lowest > 30000);
+    }
+}
+
+/**
+ * @brief Only shift and biquad settings are accepted
+ */
+void test_settings() {
+    for (uint16_t setting = 0; setting < 256; setting++) {
+        bool valid = setting <= 8 || (setting >= 16 && setting <= 20);
+        CHECK_EQ(motion_mpu6050_hand_filter_valid(setting), valid);
+    }
+}
+
+int main() {
+    test_shift();
+    test_biquad();
+    test_dc();
+    test_saturation();
+    test_settings();
+    return test_result();
+}
@@ -0,0 +1,200 @@
+// Keyglove controller host tests - Touch gesture timing
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test_touchgesture.cpp
+ * @brief Touch gesture events and timer wheel behavior at the default thresholds
+ *
+ * Touch changes go straight into touchgesture_process(), and each 10ms tick is
+ * one update_touchgesture() call, like loop() runs it. Every gesture event is
+ * logged with the tick it was sent on, so each check covers both what was
+ * reported and when. The default hold (50 ticks) and long press (150 ticks)
+ * deadlines are both past one revolution of the 32-slot wheel.
+ */
+
+#include <string>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_protocol.h"
+#include "support_touchgesture.h"
+
+extern uint16_t touchgestureTick;
+
+uint8_t (*kg_evt_touch_gesture)(uint8_t combination, uint8_t gesture);
+
+uint8_t status[KG_BASE_COMBINATION_BYTES];
+std::string events;                         ///< Log of "gesture(combination)@tick " for every event since reset()
+
+uint8_t log_gesture(uint8_t combination, uint8_t gesture) {
+    static const char *names[] = { "", "tap", "double", "hold", "long" };
+    char line[32];
+    snprintf(line, sizeof(line), "%s(%d)@%d ", gesture <= 4 ? names[gesture] : "?", combination, touchgestureTick);
+    events += line;
+    return 1;   // no event packets needed
+}
+
+void reset() {
+    memset(status, 0, sizeof(status));
+    opt_touch_tap_time = 200;
+    opt_touch_hold_time = 500;
+    opt_touch_long_press_time = 1500;
+    opt_touch_multi_tap_time = 250;
+    setup_touchgesture();
+    kg_evt_touch_gesture = log_gesture;
+    events.clear();
+}
+
+/**
+ * @brief Change one base combination and process the new status like update_touch() does
+ */
+void set_touch(uint8_t index, uint8_t active) {
+    if (active) status[index >> 3] |= 1 << (index & 7);
+    else status[index >> 3] &= ~(1 << (index & 7));
+    touchgesture_process(status);
+}
+
+/**
+ * @brief Run timer wheel ticks until a given tick
+ */
+void run_until(uint16_t tick) {
+    while (touchgestureTick < tick) update_touchgesture();
+}
+
+/**
+ * @brief A short press is a tap once the multi-tap gap passes without a second press
+ */
+void test_tap() {
+    reset();
+    set_touch(KGB_AY, 1);
+    run_until(5);
+    set_touch(KGB_AY, 0);
+    run_until(29);
+    CHECK(events == "");
+    run_until(30);
+    CHECK(events == "tap(0)@30 ");
+    run_until(300);
+    CHECK(events == "tap(0)@30 ");
+
+    // with no multi-tap gap, the tap is sent on release
+    reset();
+    opt_touch_multi_tap_time = 0;
+    set_touch(KGB_AY, 1);
+    run_until(5);
+    set_touch(KGB_AY, 0);
+    CHECK(events == "tap(0)@5 ");
+    run_until(100);
+    CHECK(events == "tap(0)@5 ");
+}
+
+/**
+ * @brief A second tap within the gap is one double-tap, and a held second press splits into a tap and a hold
+ */
+void test_double_tap() {
+    reset();
+    set_touch(KGB_AY, 1);
+    run_until(5);
+    set_touch(KGB_AY, 0);
+    run_until(15);
+    set_touch(KGB_AY, 1);       // TAP_WAIT -> SECOND
+    run_until(20);
+    set_touch(KGB_AY, 0);       // SECOND -> DOUBLE_TAP
+    CHECK(events == "double(0)@20 ");
+    run_until(300);
+    CHECK(events == "double(0)@20 ");
+
+    reset();
+    set_touch(KGB_AY, 1);
+    run_until(5);
+    set_touch(KGB_AY, 0);
+    run_until(15);
+    set_touch(KGB_AY, 1);
+    run_until(200);
+    CHECK(events == "tap(0)@35 hold(0)@65 long(0)@165 ");
+    set_touch(KGB_AY, 0);
+    run_until(300);
+    CHECK(events == "tap(0)@35 hold(0)@65 long(0)@165 ");
+}
+
+/**
+ * @brief Hold and long press deadlines past one wheel revolution fire on their own tick, not a revolution early
+ */
+void test_hold_long() {
+    reset();
+    set_touch(KGB_AY, 1);
+    run_until(49);
+    CHECK(events == "");
+    run_until(149);
+    CHECK(events == "hold(0)@50 ");
+    run_until(150);
+    CHECK(events == "hold(0)@50 long(0)@150 ");
+
+    // releasing in the LONG state (no timer running) sends nothing and leaves the wheel intact
+    set_touch(KGB_AY, 0);
+    run_until(400);
+    CHECK(events == "hold(0)@50 long(0)@150 ");
+    set_touch(KGB_AY, 1);
+    run_until(405);
+    set_touch(KGB_AY, 0);
+    run_until(430);
+    CHECK(events == "hold(0)@50 long(0)@150 tap(0)@430 ");
+
+    // releasing in the HELD state cancels the long press timer
+    reset();
+    set_touch(KGB_AY, 1);
+    run_until(60);
+    set_touch(KGB_AY, 0);
+    run_until(300);
+    CHECK(events == "hold(0)@50 ");
+}
+
+/**
+ * @brief Timers for several combinations sharing wheel slots each fire on their own deadline
+ */
+void test_shared_slots() {
+    reset();
+    set_touch(KGB_AY, 1);       // hold at 50 (slot 18), long press at 150 (slot 22)
+    run_until(18);
+    set_touch(KGB_DY, 1);       // tap timer at 38 (slot 6), hold at 68 (slot 4), long press at 168 (slot 8)
+    run_until(55);
+    set_touch(KGB_AY, 0);       // cancels the long press at 150
+    set_touch(KGB_AY, 1);
+    run_until(60);
+    set_touch(KGB_AY, 0);       // tap, multi-tap timer at 85 (slot 21)
+    run_until(200);
+    CHECK(events == "hold(0)@50 hold(3)@68 tap(0)@85 long(3)@168 ");
+}
+
+int main() {
+    test_tap();
+    test_double_tap();
+    test_hold_long();
+    test_shared_slots();
+    return test_result();
+}
@@ -0,0 +1,254 @@
+// Keyglove controller host tests - Touchset engine
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test_touchset.cpp
+ * @brief Touchset engine behavior with the default layout and hand-built tables
+ */
+
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touch.h"
+#include "support_touchset.h"
+#include "application.h"
+
+#define NC KG_TOUCHSET_CHORD_PAD
+
+uint8_t status[KG_BASE_COMBINATION_BYTES];
+
+/**
+ * @brief Change one base combination and process the new status like update_touch() does
+ */
+void set_touch(uint8_t index, uint8_t active) {
+    if (active) status[index >> 3] |= 1 << (index & 7);
+    else status[index >> 3] &= ~(1 << (index & 7));
+    mock_calls_clear();
+    touchset_process(status);
+}
+
+void reset() {
+    memset(status, 0, sizeof(status));
+    setup_touch();
+    setup_touchset();
+    mock_calls_clear();
+}
+
+/**
+ * @brief Default layout keeps AY (motion) and DY (key A) independent, like the old if/else handler
+ */
+void test_default_layout() {
+    reset();
+    setup_application();
+
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "motion(0,1) ") == 0);
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "key_down(4) ") == 0);
+    set_touch(KGB_DY, 0);
+    CHECK(strcmp(mock_calls, "key_up(4) ") == 0);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "motion(0,0) ") == 0);
+
+    // DY first, then AY, then release in the same order
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "key_down(4) ") == 0);
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "motion(0,1) ") == 0);
+    set_touch(KGB_DY, 0);
+    CHECK(strcmp(mock_calls, "key_up(4) ") == 0);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "motion(0,0) ") == 0);
+
+    // GY types a full key press on release, even with AY held
+    set_touch(KGB_AY, 1);
+    set_touch(KGB_GY, 1);
+    CHECK(strcmp(mock_calls, "") == 0);
+    set_touch(KGB_GY, 0);
+    CHECK(strcmp(mock_calls, "key_press(4) ") == 0);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "motion(0,0) ") == 0);
+}
+
+/**
+ * @brief Press and release entries match the exact set of active combinations
+ */
+void test_exact_chords() {
+    const uint8_t ay[] = { KGB_AY }, ady[] = { KGB_DY, KGB_AY };
+    reset();
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_DOWN), KEY_B, 1, ay), 0);
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_RELEASE, KG_TOUCHSET_ACTION_KEY_UP), KEY_B, 1, ay), 0);
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_C, 2, ady), 0);
+
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_down(5) ") == 0);
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "key_up(5) key_press(6) ") == 0);
+    set_touch(KGB_DY, 0);
+    CHECK(strcmp(mock_calls, "key_down(5) ") == 0);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "key_up(5) ") == 0);
+}
+
+/**
+ * @brief Touch and untouch triggers only accept a single combination
+ */
+void test_single_trigger_check() {
+    const uint8_t ady[] = { KGB_AY, KGB_DY }, ay[] = { KGB_AY };
+    reset();
+    CHECK(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_TOUCH, KG_TOUCHSET_ACTION_KEY_DOWN), KEY_A, 2, ady) != 0);
+    CHECK(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_UNTOUCH, KG_TOUCHSET_ACTION_KEY_UP), KEY_A, 2, ady) != 0);
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_TOUCH, KG_TOUCHSET_ACTION_KEY_DOWN), KEY_A, 1, ay), 0);
+    CHECK_EQ(touchsetCount, 1);
+}
+
+/**
+ * @brief Push, pop, toggle and table changes all empty the chord lookup cache
+ */
+void test_mode_stack_invalidation() {
+    const uint8_t ay[] = { KGB_AY }, dy[] = { KGB_DY };
+    reset();
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_B, 1, ay), 0);
+    CHECK_EQ(touchset_add_entry(1, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_C, 1, ay), 0);
+    CHECK_EQ(touchset_add_entry(1, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_D, 1, dy), 0);
+    touch_set_mode(0);
+
+    // DY is not defined in mode 0, and that result is cached too
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "") == 0);
+    set_touch(KGB_DY, 0);
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_press(5) ") == 0);
+    set_touch(KGB_AY, 0);
+
+    touch_push_mode(1);
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_press(6) ") == 0);
+    set_touch(KGB_AY, 0);
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "key_press(7) ") == 0);
+    set_touch(KGB_DY, 0);
+
+    touch_pop_mode();
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_press(5) ") == 0);
+    set_touch(KGB_AY, 0);
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "") == 0);
+    set_touch(KGB_DY, 0);
+
+    touch_toggle_mode(1);
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_press(6) ") == 0);
+    set_touch(KGB_AY, 0);
+    touch_toggle_mode(1);
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_press(5) ") == 0);
+    set_touch(KGB_AY, 0);
+
+    // adding an entry for a chord cached as undefined makes it work right away
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_E, 1, dy), 0);
+    set_touch(KGB_DY, 1);
+    CHECK(strcmp(mock_calls, "key_press(8) ") == 0);
+    set_touch(KGB_DY, 0);
+}
+
+/**
+ * @brief More played chords than cache slots still resolve to the right mode every time
+ */
+void test_cache_replacement() {
+    uint8_t combos[2], i, pass, found;
+    char expect[32];
+    reset();
+    for (i = 0; i < KG_TOUCHSET_RAM_ENTRIES; i++) {
+        combos[0] = i % KG_BASE_COMBINATIONS;
+        combos[1] = (combos[0] + 1 + i / KG_BASE_COMBINATIONS) % KG_BASE_COMBINATIONS;
+        CHECK_EQ(touchset_add_entry(i & 1, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), i, 2, combos), 0);
+    }
+    touch_set_mode(0);
+    touch_push_mode(1);
+
+    for (pass = 0, found = 0; pass < 3; pass++) {
+        for (i = 0; i < KG_TOUCHSET_RAM_ENTRIES; i++) {
+            combos[0] = i % KG_BASE_COMBINATIONS;
+            combos[1] = (combos[0] + 1 + i / KG_BASE_COMBINATIONS) % KG_BASE_COMBINATIONS;
+            set_touch(combos[0], 1);
+            set_touch(combos[1], 1);
+            snprintf(expect, sizeof(expect), "key_press(%d) ", i);
+            if (strcmp(mock_calls, expect) == 0) found++;
+            set_touch(combos[1], 0);
+            set_touch(combos[0], 0);
+        }
+    }
+    CHECK_EQ(found, 3 * KG_TOUCHSET_RAM_ENTRIES);
+}
+
+/**
+ * @brief Changing the table under a held chord runs its release entries, so no key is left down
+ */
+void test_table_change_held() {
+    const uint8_t ay[] = { KGB_AY }, dy[] = { KGB_DY };
+    reset();
+    CHECK_EQ(touchset_add_entry(1, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_DOWN), KEY_B, 1, ay), 0);
+    CHECK_EQ(touchset_add_entry(1, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_RELEASE, KG_TOUCHSET_ACTION_KEY_UP), KEY_B, 1, ay), 0);
+    touch_set_mode(0);
+    touch_push_mode(1);
+
+    // a mode 0 entry sorts ahead of the held chord moves its index, but the release still comes from the old table
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_down(5) ") == 0);
+    mock_calls_clear();
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_C, 1, dy), 0);
+    CHECK(strcmp(mock_calls, "key_up(5) ") == 0);
+    CHECK_EQ(touchsetChordMode, KG_TOUCHSET_MODE_NONE);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "") == 0);
+
+    // clearing the table releases too, and nothing runs twice
+    set_touch(KGB_AY, 1);
+    CHECK(strcmp(mock_calls, "key_down(5) ") == 0);
+    mock_calls_clear();
+    touchset_clear();
+    CHECK(strcmp(mock_calls, "key_up(5) ") == 0);
+    mock_calls_clear();
+    touchset_clear();
+    CHECK(strcmp(mock_calls, "") == 0);
+    set_touch(KGB_AY, 0);
+    CHECK(strcmp(mock_calls, "") == 0);
+}
+
+int main() {
+    test_default_layout();
+    test_exact_chords();
+    test_single_trigger_check();
+    test_mode_stack_invalidation();
+    test_cache_replacement();
+    test_table_change_held();
+    return test_result();
+}
@@ -0,0 +1,257 @@
+// Keyglove controller host tests - Touchset EEPROM upload and boot
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file test_touchset_eeprom.cpp
+ * @brief Touchset EEPROM upload, activation, boot, clear and erase
+ *
+ * The upload runs the way the main loop does: commands arrive between loop
+ * passes, and each pass calls update_touchset(). The simulated clock only
+ * moves inside a call when it waits for the EEPROM, so the time a single call
+ * takes here is exactly how long it would stall loop() on the AVR.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <util/crc16.h>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touch.h"
+#include "support_touchset.h"
+
+#define LOOP_PASS_US            100         ///< Simulated time between main loop passes
+#define CHUNK_SIZE              24          ///< Same chunk size as kgtouchset.py
+
+std::vector<touchset_entry_t> layout;
+uint32_t maxStallUs;                        ///< Longest simulated time spent inside a single call
+
+/**
+ * @brief Build a sorted layout with every single combination and every neighbouring pair in each mode
+ */
+void build_layout(uint8_t modes) {
+    layout.clear();
+    for (uint8_t mode = 0; mode < modes; mode++) {
+        for (uint8_t c = 0; c < KG_BASE_COMBINATIONS; c++) {
+            uint8_t combos[2] = { c, (uint8_t)(c + 1) };
+            for (uint8_t n = 1; n <= 2 && c + n <= KG_BASE_COMBINATIONS; n++) {
+                touchset_entry_t entry;
+                touchset_pack_chord(entry.chord, n, combos);
+                entry.mode = mode;
+                entry.action = KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS);
+                entry.param = c;
+                layout.push_back(entry);
+            }
+        }
+    }
+    std::sort(layout.begin(), layout.end(), [](const touchset_entry_t &a, const touchset_entry_t &b) { return memcmp(&a, &b, 4) < 0; });
+}
+
+uint16_t layout_crc() {
+    uint16_t crc = 0;
+    const uint8_t *data = (const uint8_t *)layout.data();
+    for (size_t i = 0; i < layout.size() * sizeof(touchset_entry_t); i++) crc = _crc_xmodem_update(crc, data[i]);
+    return crc;
+}
+
+/**
+ * @brief Run one main loop pass, tracking how long update_touchset() blocks
+ */
+void loop_pass() {
+    uint32_t t0 = mock_us;
+    update_touchset();
+    if (mock_us - t0 > maxStallUs) maxStallUs = mock_us - t0;
+    mock_advance_us(LOOP_PASS_US);
+}
+
+/**
+ * @brief Result of a command, tracking how long it blocks
+ */
+uint8_t timed(uint8_t result, uint32_t t0) {
+    if (mock_us - t0 > maxStallUs) maxStallUs = mock_us - t0;
+    return result;
+}
+
+#define TIMED(call) timed((call), mock_us)
+
+/**
+ * @brief Send the whole layout like kgtouchset.py does, repeating busy commands after a loop pass
+ * @return Result of the first command which did not succeed, or zero
+ */
+uint8_t upload(uint32_t *busy) {
+    const uint8_t *data = (const uint8_t *)layout.data();
+    uint16_t length = layout.size() * sizeof(touchset_entry_t);
+    uint8_t result;
+    while ((result = TIMED(touchset_write_begin(layout.size()))) == KG_TOUCHSET_WRITE_BUSY) { loop_pass(); (*busy)++; }
+    if (result) return result;
+    for (uint16_t offset = 0; offset < length; offset += CHUNK_SIZE) {
+        uint8_t len = length - offset < CHUNK_SIZE ? length - offset : CHUNK_SIZE;
+        loop_pass();
+        while ((result = TIMED(touchset_write_data(offset, len, data + offset))) == KG_TOUCHSET_WRITE_BUSY) { loop_pass(); (*busy)++; }
+        if (result) return result;
+    }
+    while ((result = TIMED(touchset_write_end(layout_crc()))) == KG_TOUCHSET_WRITE_BUSY) { loop_pass(); (*busy)++; }
+    return result;
+}
+
+void reset_eeprom() {
+    memset(mock_eeprom, 0xFF, sizeof(mock_eeprom));
+    mock_eeprom_ready_us = mock_us;
+    setup_touch();
+    setup_touchset();
+}
+
+/**
+ * @brief Upload never stalls the main loop for longer than it takes to start one byte write
+ */
+void test_upload_stall() {
+    uint32_t busy = 0, t0, passes;
+    reset_eeprom();
+    build_layout(KG_TOUCHSET_EEPROM_ENTRIES / (2 * KG_BASE_COMBINATIONS - 1));
+    maxStallUs = 0;
+    mock_eeprom_writes = 0;
+    t0 = mock_us;
+
+    CHECK_EQ(upload(&busy), 0);
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_RAM);
+    for (passes = 0; touchsetSource != KG_TOUCHSET_EEPROM && passes < 100000; passes++) loop_pass();
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_EEPROM);
+    CHECK_EQ(touchsetCount, layout.size());
+    CHECK_EQ(maxStallUs, 0);
+    CHECK(memcmp(mock_eeprom + sizeof(touchset_header_t), layout.data(), layout.size() * sizeof(touchset_entry_t)) == 0);
+
+    // reference: the same chunk written with eeprom_update_block() blocks for every changed byte
+    uint32_t t1 = mock_us;
+    uint8_t blank[CHUNK_SIZE];
+    memset(blank, 0x5A, sizeof(blank));
+    eeprom_update_block(blank, (void *)0x0800, sizeof(blank));
+    eeprom_busy_wait();
+    uint32_t blockingUs = mock_us - t1;
+    CHECK(blockingUs >= (CHUNK_SIZE - 1) * MOCK_EEPROM_WRITE_US);
+
+    printf("upload of %u entries: %u byte writes, %u busy retries, %.1f s simulated, longest single call %u us (blocking write of one %d-byte chunk: %.1f ms)\n",
+        (unsigned)layout.size(), mock_eeprom_writes, busy, (mock_us - t0) / 1e6, maxStallUs, CHUNK_SIZE, blockingUs / 1e3);
+}
+
+/**
+ * @brief Boot with a stored touchset reads only the header from EEPROM
+ */
+void test_boot() {
+    uint32_t busy = 0;
+    reset_eeprom();
+    build_layout(10);
+    CHECK_EQ(upload(&busy), 0);
+    while (touchsetSource != KG_TOUCHSET_EEPROM) loop_pass();
+    eeprom_busy_wait();
+
+    mock_eeprom_reads = 0;
+    uint32_t t0 = mock_us;
+    uint64_t ns = bench_ns();
+    setup_touch();
+    setup_touchset();
+    ns = bench_ns() - ns;
+    CHECK_EQ(mock_eeprom_reads, sizeof(touchset_header_t));
+    CHECK_EQ(mock_us, t0);
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_EEPROM);
+    CHECK_EQ(touchsetCount, layout.size());
+    printf("boot with %u stored entries: %u EEPROM bytes read, %.0f host ns in setup_touchset()\n",
+        touchsetCount, mock_eeprom_reads, (double)ns);
+}
+
+/**
+ * @brief Clear only empties the RAM table, erase invalidates the stored touchset
+ */
+void test_clear_erase() {
+    const uint8_t ay[] = { KGB_AY };
+    uint32_t busy = 0;
+    reset_eeprom();
+    build_layout(1);
+    CHECK_EQ(upload(&busy), 0);
+    while (touchsetSource != KG_TOUCHSET_EEPROM) loop_pass();
+
+    touchset_clear();
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_EEPROM);
+    CHECK_EQ(touchsetCount, layout.size());
+
+    CHECK_EQ(touchset_erase(), 0);
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_RAM);
+    CHECK_EQ(touchsetCount, 0);
+    CHECK_EQ(touchset_add_entry(0, KG_TOUCHSET_ACTION(KG_TOUCHSET_TRIGGER_PRESS, KG_TOUCHSET_ACTION_KEY_PRESS), KEY_A, 1, ay), 0);
+    CHECK_EQ(touchsetCount, 1);
+    for (int i = 0; i < 100; i++) loop_pass();
+    CHECK_EQ(mock_eeprom[0], 0xFF);
+    CHECK_EQ(mock_eeprom[1], 0xFF);
+
+    setup_touchset();
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_RAM);
+}
+
+/**
+ * @brief Invalid uploads are rejected and never become active
+ */
+void test_bad_upload() {
+    uint32_t busy = 0;
+    reset_eeprom();
+    build_layout(2);
+
+    // wrong CRC
+    layout[5].param ^= 1;
+    uint16_t crc = layout_crc();
+    layout[5].param ^= 1;
+    const uint8_t *data = (const uint8_t *)layout.data();
+    uint16_t length = layout.size() * sizeof(touchset_entry_t);
+    CHECK_EQ(touchset_write_begin(layout.size()), 0);
+    for (uint16_t offset = 0; offset < length; offset += CHUNK_SIZE) {
+        while (touchset_write_data(offset, CHUNK_SIZE, data + offset) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    }
+    while (touchset_write_end(crc) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    for (int i = 0; i < 1000; i++) loop_pass();
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_RAM);
+
+    // chunks out of order
+    while (touchset_write_begin(layout.size()) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    CHECK(touchset_write_data(CHUNK_SIZE, CHUNK_SIZE, data + CHUNK_SIZE) != 0);
+
+    // second chunk before the first one is written
+    while (touchset_write_begin(layout.size()) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    while (touchset_write_data(0, CHUNK_SIZE, data) == KG_TOUCHSET_WRITE_BUSY) loop_pass();
+    CHECK_EQ(touchset_write_data(CHUNK_SIZE, CHUNK_SIZE, data + CHUNK_SIZE), KG_TOUCHSET_WRITE_BUSY);
+
+    // entries out of order
+    std::swap(layout[0], layout[1]);
+    CHECK(upload(&busy) != 0);
+    CHECK_EQ(touchsetSource, KG_TOUCHSET_RAM);
+}
+
+int main() {
+    test_upload_stall();
+    test_boot();
+    test_clear_erase();
+    test_bad_upload();
+    return test_result();
+}
@@ -0,0 +1,140 @@
+// Keyglove controller host tests - Touch usage statistics
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+/**
+ * @file test_touchstats.cpp
+ * @brief Touch usage counts, hold times and bigram table guarantees
+ *
+ * The bigram check plays a long, skewed press sequence with many more
+ * distinct pairs than table slots, counts every pair exactly on the side,
+ * and checks the space-saving guarantees against the exact counts: every
+ * pair seen more than (pairs / slots) times is kept, no kept count is too
+ * low, and none is too high by more than the smallest kept count.
+ */
+
+#include <map>
+#include "test.h"
+#include "mock.h"
+#include "keyglove.h"
+#include "support_board.h"
+#include "support_touchstats.h"
+
+#define TEST_PRESSES    20000
+
+uint8_t status[KG_BASE_COMBINATION_BYTES];
+uint32_t testSeed = 34;
+
+uint32_t test_random(uint32_t range) {
+    testSeed = testSeed * 1103515245 + 12345;
+    return (testSeed >> 8) % range;
+}
+
+/**
+ * @brief Press and release one base combination, held for a given time
+ */
+void tap(uint8_t index, uint16_t ms) {
+    status[index >> 3] |= 1 << (index & 7);
+    touchstats_process(status);
+    mock_advance_us(ms * 1000UL);
+    status[index >> 3] &= ~(1 << (index & 7));
+    touchstats_process(status);
+    mock_advance_us(1000);
+}
+
+/**
+ * @brief Press counts and total hold times follow each combination
+ */
+void test_hits_hold() {
+    memset(status, 0, sizeof(status));
+    setup_touchstats();
+    tap(KGB_AY, 120);
+    tap(KGB_DY, 30);
+    tap(KGB_AY, 80);
+    CHECK_EQ(touchstats.hits[KGB_AY], 2);
+    CHECK_EQ(touchstats.hits[KGB_DY], 1);
+    CHECK_EQ(touchstats.hold[KGB_AY], 200);
+    CHECK_EQ(touchstats.hold[KGB_DY], 30);
+
+    // AY -> DY and DY -> AY once each
+    uint8_t found = 0;
+    for (uint8_t i = 0; i < KG_TOUCHSTATS_BIGRAMS; i++) {
+        if (touchstats.bigram[i].count == 1 && touchstats.bigram[i].prev == KGB_AY && touchstats.bigram[i].next == KGB_DY) found++;
+        if (touchstats.bigram[i].count == 1 && touchstats.bigram[i].prev == KGB_DY && touchstats.bigram[i].next == KGB_AY) found++;
+    }
+    CHECK_EQ(found, 2);
+}
+
+/**
+ * @brief Eviction keeps every frequent pair, with a count bounded by the exact one
+ */
+void test_bigram_eviction() {
+    // a few rolls of five combinations make up most pairs, the rest are random
+    const uint8_t roll[] = { 1, 7, 4, 12, 9 };
+    std::map<uint16_t, uint32_t> exact;
+    uint8_t prev = KG_TOUCHSTATS_LAST_NONE, next, pos = 0;
+    uint32_t pairs = 0;
+
+    memset(status, 0, sizeof(status));
+    setup_touchstats();
+    for (uint32_t n = 0; n < TEST_PRESSES; n++) {
+        if (test_random(100) < 60) next = roll[pos++ % sizeof(roll)];
+        else next = test_random(KG_BASE_COMBINATIONS);
+        tap(next, 10);
+        if (prev != KG_TOUCHSTATS_LAST_NONE) { exact[(prev << 8) | next]++; pairs++; }
+        prev = next;
+    }
+
+    uint16_t minCount = 0xFFFF;
+    for (uint8_t i = 0; i < KG_TOUCHSTATS_BIGRAMS; i++) minCount = min(minCount, touchstats.bigram[i].count);
+    uint32_t frequent = 0, kept = 0, low = 0, high = 0;
+    for (std::map<uint16_t, uint32_t>::iterator it = exact.begin(); it != exact.end(); it++) {
+        if (it -> second <= pairs / KG_TOUCHSTATS_BIGRAMS) continue;
+        frequent++;
+        for (uint8_t i = 0; i < KG_TOUCHSTATS_BIGRAMS; i++) {
+            if (((touchstats.bigram[i].prev << 8) | touchstats.bigram[i].next) == it -> first) { kept++; break; }
+        }
+    }
+    for (uint8_t i = 0; i < KG_TOUCHSTATS_BIGRAMS; i++) {
+        uint32_t count = touchstats.bigram[i].count, real = exact[(touchstats.bigram[i].prev << 8) | touchstats.bigram[i].next];
+        if (count < real) low++;
+        if (count > real + minCount) high++;
+    }
+    printf("bigrams: %u pairs, %u distinct, %u over %u occurrences and all kept: %s, smallest kept count %u\n",
+        pairs, (uint32_t)exact.size(), frequent, pairs / KG_TOUCHSTATS_BIGRAMS, kept == frequent ? "yes" : "no", minCount);
+    CHECK(exact.size() > 4 * KG_TOUCHSTATS_BIGRAMS);
+    CHECK(frequent >= sizeof(roll));
+    CHECK_EQ(kept, frequent);
+    CHECK_EQ(low, 0);
+    CHECK_EQ(high, 0);
+}
+
+int main() {
+    test_hits_hold();
+    test_bigram_eviction();
+    return test_result();
+}
@@ -0,0 +1,165 @@
+// Keyglove controller host tests - Touch matrix simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file touchsim.cpp
+ * @brief Register-level touch matrix simulator implementation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mock.h"
+#include "keyglove.h"
+#include "touchsim.h"
+
+#define TOUCHSIM_PINS           48          ///< Port A-F, 8 pins each
+#define TOUCHSIM_NONE           0xFF        ///< Pin index for an unknown sensor
+
+#define PA(n) (0x00 + (n))
+#define PB(n) (0x08 + (n))
+#define PC(n) (0x10 + (n))
+#define PD(n) (0x18 + (n))
+#define PE(n) (0x20 + (n))
+#define PF(n) (0x28 + (n))
+
+/**
+ * @brief Sensor name and the port pin it is wired to
+ */
+typedef struct {
+    char sensor;
+    uint8_t pin;
+} touchsim_sensor_t;
+
+#if KG_BOARD == KG_BOARD_TEENSYPP2_T19
+    // from the pin diagram in support_board_teensypp2_t19.cpp
+    const touchsim_sensor_t touchsimSensors[] = {
+        { 'Y', PB(6) }, { '1', PB(7) }, { '8', PB(5) },
+        { 'A', PF(1) }, { 'B', PF(2) }, { 'C', PF(3) }, { 'D', PF(5) }, { 'E', PF(6) }, { 'F', PF(7) },
+        { 'G', PC(3) }, { 'H', PC(2) }, { 'I', PC(1) }, { 'J', PE(1) }, { 'K', PE(0) }, { 'L', PD(7) },
+        { '4', PF(4) }, { '5', PC(7) }, { '6', PC(0) }, { '7', PD(5) },
+    };
+#elif KG_BOARD == KG_BOARD_TEENSYPP2_T37
+    // from the pin diagram in support_board_teensypp2_t37.cpp (without KEYGLOVE_KIT_BUG_PORTA_REVERSED)
+    const touchsim_sensor_t touchsimSensors[] = {
+        { 'A', PB(0) }, { 'B', PF(0) }, { 'C', PF(1) }, { 'D', PF(6) }, { 'E', PF(7) }, { 'F', PA(3) },
+        { 'G', PA(5) }, { 'H', PA(6) }, { 'I', PA(7) }, { 'J', PC(3) }, { 'K', PC(2) }, { 'L', PC(1) },
+        { 'M', PF(2) }, { 'N', PF(3) }, { 'O', PF(4) }, { 'P', PA(2) }, { 'Q', PA(1) }, { 'R', PA(0) },
+        { 'S', PC(7) }, { 'T', PC(6) }, { 'U', PC(5) }, { 'V', PC(0) }, { 'W', PE(1) }, { 'X', PE(0) },
+        { 'Y', PB(6) }, { 'Z', PB(5) },
+        { '1', PD(5) }, { '2', PD(4) }, { '3', PB(7) }, { '4', PF(5) }, { '5', PA(4) }, { '6', PC(4) },
+        { '7', PD(7) }, { '8', PB(3) },
+    };
+#else
+    #error Touch matrix simulator does not know this board
+#endif
+
+volatile uint8_t *const touchsimPinReg[6] = { &PINA, &PINB, &PINC, &PIND, &PINE, &PINF };
+volatile uint8_t *const touchsimDdrReg[6] = { &DDRA, &DDRB, &DDRC, &DDRD, &DDRE, &DDRF };
+volatile uint8_t *const touchsimPortReg[6] = { &PORTA, &PORTB, &PORTC, &PORTD, &PORTE, &PORTF };
+
+uint64_t touchsimLinks[TOUCHSIM_PINS];      ///< Closed contacts, as a bit mask of joined pins for each pin
+uint8_t touchsimSettleUs[TOUCHSIM_PINS];    ///< Time a pin needs to follow a driven pin low
+uint8_t touchsimDriven[TOUCHSIM_PINS];      ///< Indicates that a pin was driven low at the last delay
+uint32_t touchsimDriveStart[TOUCHSIM_PINS]; ///< Simulated time when a pin started being driven low
+uint32_t touchsimDrives;
+
+/**
+ * @brief Refresh PINx for the end of a delay, called at the start of delayMicroseconds()
+ */
+void touchsim_delay_hook(uint32_t us) {
+    uint8_t value[6], pin, p;
+    uint64_t reached, next;
+    uint8_t driving = 0;
+
+    for (p = 0; p < 6; p++) value[p] = *touchsimPortReg[p];
+    for (pin = 0; pin < TOUCHSIM_PINS; pin++) {
+        uint8_t mask = 1 << (pin & 7);
+        if (!(*touchsimDdrReg[pin >> 3] & mask) || (*touchsimPortReg[pin >> 3] & mask)) {
+            touchsimDriven[pin] = 0;
+            continue;
+        }
+        if (!touchsimDriven[pin]) {
+            touchsimDriven[pin] = 1;
+            touchsimDriveStart[pin] = mock_us;
+        }
+        driving = 1;
+
+        // every pin joined through closed contacts follows once it has settled
+        for (reached = touchsimLinks[pin] | (1ull << pin), next = 0; next != reached; ) {
+            next = reached;
+            for (p = 0; p < TOUCHSIM_PINS; p++) if (reached & (1ull << p)) reached |= touchsimLinks[p];
+        }
+        for (p = 0; p < TOUCHSIM_PINS; p++) {
+            if ((reached & (1ull << p)) && mock_us + us - touchsimDriveStart[pin] >= touchsimSettleUs[p]) value[p >> 3] &= ~(1 << (p & 7));
+        }
+    }
+    for (p = 0; p < 6; p++) *touchsimPinReg[p] = value[p];
+    if (driving) touchsimDrives++;
+}
+
+/**
+ * @brief Open all contacts, clear settle times, and attach the simulator to delayMicroseconds()
+ */
+void touchsim_reset() {
+    memset(touchsimLinks, 0, sizeof(touchsimLinks));
+    memset(touchsimSettleUs, 0, sizeof(touchsimSettleUs));
+    memset(touchsimDriven, 0, sizeof(touchsimDriven));
+    touchsimDrives = 0;
+    mock_delay_hook = touchsim_delay_hook;
+}
+
+/**
+ * @brief Find the pin a sensor is wired to
+ * @param[in] sensor Sensor name
+ * @return Pin index (port * 8 + bit), aborts if the board has no such sensor
+ */
+uint8_t touchsim_pin(char sensor) {
+    for (uint8_t i = 0; i < sizeof(touchsimSensors) / sizeof(touchsim_sensor_t); i++) {
+        if (touchsimSensors[i].sensor == sensor) return touchsimSensors[i].pin;
+    }
+    printf("touchsim: unknown sensor '%c'\n", sensor);
+    abort();
+}
+
+void touchsim_connect(char a, char b) {
+    uint8_t pa = touchsim_pin(a), pb = touchsim_pin(b);
+    touchsimLinks[pa] |= 1ull << pb;
+    touchsimLinks[pb] |= 1ull << pa;
+}
+
+void touchsim_disconnect(char a, char b) {
+    uint8_t pa = touchsim_pin(a), pb = touchsim_pin(b);
+    touchsimLinks[pa] &= ~(1ull << pb);
+    touchsimLinks[pb] &= ~(1ull << pa);
+}
+
+/**
+ * @brief Set how long a sensor pin takes to follow a driven pin low
+ */
+void touchsim_settle(char sensor, uint8_t us) {
+    touchsimSettleUs[touchsim_pin(sensor)] = us;
+}
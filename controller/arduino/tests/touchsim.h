@@ -0,0 +1,57 @@
+// Keyglove controller host tests - Touch matrix simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+/**
+ * @file touchsim.h
+ * @brief Register-level touch matrix simulator for update_board_touch()
+ *
+ * Simulates a glove wired to the Teensy++ port pins, with any set of closed
+ * contacts between sensors. Whenever firmware calls delayMicroseconds(), the
+ * simulator looks at DDRx/PORTx to find pins being driven low, and sets PINx
+ * for the moment the delay ends: a pin reads low if a chain of closed
+ * contacts joins it to a driven pin (so ghost contacts appear just like on
+ * the real glove) and it has been driven for at least that pin's settle time.
+ * Every other pin reads its pull-up (PORTx) level.
+ *
+ * Sensors are named by the single characters used in the KGB_* names, and
+ * mapped to pins for whichever board KG_BOARD selects.
+ */
+
+#ifndef _TOUCHSIM_H_
+#define _TOUCHSIM_H_
+
+#include <stdint.h>
+
+extern uint32_t touchsimDrives;             ///< Number of scan steps (delays with a pin driven low) since touchsim_reset()
+
+void touchsim_reset();
+uint8_t touchsim_pin(char sensor);
+void touchsim_connect(char a, char b);
+void touchsim_disconnect(char a, char b);
+void touchsim_settle(char sensor, uint8_t us);
+
+#endif // _TOUCHSIM_H_
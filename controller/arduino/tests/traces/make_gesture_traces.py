@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+
+"""
+================================================================================
+Keyglove motion gesture trace generator
+2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+Changelog:
+    2015-07-03 - Initial release
+
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+
+Writes the gyro traces used by bench_motiongesture in the CSV format that
+kgpredict.py reads (gx,gy,gz per line, 100Hz, '#' starts a comment), with raw
+counts at the 2000 deg/sec range (16.4 counts per deg/sec):
+
+    gesture_<name>.csv      one clean performance of each gesture, which the
+                            benchmark turns into a stored template; the
+                            '# threshold N' line sets its match threshold
+    gesture_session.csv     a minute of slow hand motion and sensor noise with
+                            each gesture performed three times at 0.7x-1.4x
+                            speed and 0.85x-1.15x size; a '# gesture S N' line
+                            marks the next N samples as gesture slot S
+
+These are generated rather than captured from a glove, so they are only as
+realistic as the motion model below. Traces captured from the hand sensor in
+the same format can be dropped in instead, as long as the gesture markers are
+added by hand.
+
+Usage:
+    make_gesture_traces.py              # writes into the current directory
+
+"""
+
+__author__ = "Jeff Rowberg"
+__license__ = "MIT"
+__version__ = "2015-07-03"
+__email__ = "jeff@rowberg.net"
+
+import math, random
+
+RATE = 100                  # samples per second
+COUNTS_PER_DPS = 16.4       # 2000 deg/sec range
+SESSION_SECONDS = 60
+
+# gesture name, match threshold, duration at 1.0x speed (s), and gyro X/Y/Z in deg/sec at time t (0..1)
+GESTURES = [
+    ('flick', 250, 0.32, lambda t: (600 * math.sin(math.pi * t / 0.6) if t < 0.6 else -250 * math.sin(math.pi * (t - 0.6) / 0.4), 0, 0)),
+    ('circle', 500, 1.0, lambda t: (220 * math.sin(2 * math.pi * t), 220 * math.sin(math.pi * t) * math.cos(2 * math.pi * t), 0)),
+    ('shake', 470, 0.8, lambda t: (0, 0, 350 * math.sin(2 * math.pi * 4 * t))),
+    ('twist', 400, 0.6, lambda t: (0, 400 * math.sin(2 * math.pi * t), 80 * math.sin(math.pi * t))),
+]
+
+def counts(dps):
+    return int(round(max(-32767, min(32767, dps * COUNTS_PER_DPS))))
+
+def write_template(slot):
+    name, threshold, duration, shape = GESTURES[slot]
+    samples = int(round(duration * RATE))
+    with open('gesture_%s.csv' % name, 'w') as f:
+        f.write('# %s gesture template, %d samples at %dHz, gyro counts at 2000 deg/sec (generated by make_gesture_traces.py)\n' % (name, samples, RATE))
+        f.write('# threshold %d\n' % threshold)
+        for i in range(samples):
+            f.write('%d,%d,%d\n' % tuple(counts(v) for v in shape((i + 0.5) / samples)))
+
+def write_session():
+    rng = random.Random(2015)
+    order = [ slot for slot in range(len(GESTURES)) for _ in range(3) ]
+    rng.shuffle(order)
+    # slow drifting hand motion up to about 120 deg/sec, plus sensor noise
+    phases = [ [ rng.uniform(0, 2 * math.pi) for _ in range(3) ] for _ in range(3) ]
+    def background(t):
+        return [ sum(40 * math.sin(2 * math.pi * f * t + phases[axis][k]) for k, f in enumerate((0.13, 0.37, 0.71))) + rng.gauss(0, 8) for axis in range(3) ]
+
+    gap = SESSION_SECONDS * RATE // (len(order) + 1)
+    with open('gesture_session.csv', 'w') as f:
+        f.write('# %d s of hand motion with %d gestures at %dHz, gyro counts at 2000 deg/sec (generated by make_gesture_traces.py)\n' % (SESSION_SECONDS, len(order), RATE))
+        i = 0
+        for n, slot in enumerate(order):
+            start = (n + 1) * gap + rng.randint(-gap // 4, gap // 4)
+            while i < start:
+                f.write('%d,%d,%d\n' % tuple(counts(v) for v in background(i / float(RATE))))
+                i += 1
+            name, threshold, duration, shape = GESTURES[slot]
+            speed, size = rng.uniform(0.7, 1.4), rng.uniform(0.85, 1.15)
+            samples = int(round(duration * RATE / speed))
+            f.write('# gesture %d %d (%s, %.2fx speed, %.2fx size)\n' % (slot, samples, name, speed, size))
+            for k in range(samples):
+                g = shape((k + 0.5) / samples)
+                b = background(i / float(RATE))
+                f.write('%d,%d,%d\n' % tuple(counts(g[axis] * size + b[axis]) for axis in range(3)))
+                i += 1
+        while i < SESSION_SECONDS * RATE:
+            f.write('%d,%d,%d\n' % tuple(counts(v) for v in background(i / float(RATE))))
+            i += 1
+
+if __name__ == '__main__':
+    for slot in range(len(GESTURES)):
+        write_template(slot)
+    write_session()
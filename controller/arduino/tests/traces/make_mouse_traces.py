@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+
+"""
+================================================================================
+Keyglove mouse trace generator
+2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+Changelog:
+    2015-07-03 - Initial release
+
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+
+Writes the gyro traces used by test_hid_mouse in the CSV format that
+kgpredict.py reads (gx,gy,gz per line, 100Hz, '#' starts a comment), with raw
+counts at the 2000 deg/sec range (16.4 counts per deg/sec):
+
+    mouse_point.csv     point-and-stop cursor moves at ordinary speed, each
+                        a bell-shaped (minimum-jerk) rotation burst followed
+                        by a short rest
+    mouse_slow.csv      fine adjustments well under one count per sample,
+                        with a small repositioning move every few seconds
+                        (which also keeps the hand driver from deciding the
+                        hand is resting and putting the sensor to sleep)
+    mouse_fast.csv      fast flicks and twists, where one sample moves the
+                        cursor further than a single report can carry
+
+All three have sensor noise on every axis. In tilt-position mode, gyro Y
+minus gyro Z moves the cursor in X and gyro X moves it in Y.
+
+These are generated rather than captured from a glove, so they are only as
+realistic as the motion model below. Flight recorder dumps can be turned
+into the same format (kgpredict.py -d -o dump.bin, then one 'gx,gy,gz' line
+per hand motion record) and dropped in instead.
+
+Usage:
+    make_mouse_traces.py                # writes into the current directory
+
+"""
+
+__author__ = "Jeff Rowberg"
+__license__ = "MIT"
+__version__ = "2015-07-03"
+__email__ = "jeff@rowberg.net"
+
+import math, random
+
+RATE = 100                  # samples per second
+COUNTS_PER_DPS = 16.4       # 2000 deg/sec range
+
+def counts(dps):
+    return int(round(max(-32767, min(32767, dps * COUNTS_PER_DPS))))
+
+def bell(s):
+    # minimum-jerk speed profile, peak 1.0 at s = 0.5
+    return 16.0 * (s ** 2) * ((1 - s) ** 2) if 0 <= s <= 1 else 0.0
+
+class Trace(object):
+    def __init__(self, seed, noise):
+        self.rng, self.noise, self.rows = random.Random(seed), noise, []
+    def rest(self, samples):
+        for i in range(samples):
+            self.rows.append([ self.rng.gauss(0, self.noise) for axis in range(3) ])
+    def move(self, samples, peak):
+        # peak rotation speed on each axis in deg/sec, then back to rest
+        for i in range(samples):
+            shape = bell((i + 0.5) / samples)
+            self.rows.append([ peak[axis] * shape + self.rng.gauss(0, self.noise) for axis in range(3) ])
+    def write(self, name, comment):
+        with open(name, 'w') as f:
+            f.write('# %s, %d samples at %dHz, gyro counts at 2000 deg/sec (generated by make_mouse_traces.py)\n' % (comment, len(self.rows), RATE))
+            for row in self.rows:
+                f.write('%d,%d,%d\n' % tuple(counts(v) for v in row))
+
+def write_point():
+    trace = Trace(48, 0.25)
+    trace.rest(50)
+    for n in range(16):
+        duration = trace.rng.randint(18, 40)
+        peak = [ trace.rng.choice([ -1, 1 ]) * trace.rng.uniform(3, 12) for axis in range(2) ] + [ trace.rng.uniform(-1, 1) ]
+        trace.move(duration, peak)
+        trace.rest(trace.rng.randint(30, 70))
+    trace.write('mouse_point.csv', 'point-and-stop cursor moves')
+
+def write_slow():
+    trace = Trace(4848, 0.15)
+    trace.rest(50)
+    for n in range(8):
+        # fine adjustment: 0.1-0.8 deg/sec drifts, well under one count per sample
+        for k in range(trace.rng.randint(2, 3)):
+            trace.move(trace.rng.randint(60, 120), [ trace.rng.choice([ -1, 1 ]) * trace.rng.uniform(0.2, 0.8) for axis in range(2) ] + [ 0 ])
+        trace.rest(20)
+        # small repositioning move
+        trace.move(trace.rng.randint(25, 40), [ trace.rng.choice([ -1, 1 ]) * trace.rng.uniform(6, 9) for axis in range(2) ] + [ 0 ])
+        trace.rest(30)
+    trace.write('mouse_slow.csv', 'fine cursor adjustments')
+
+def write_fast():
+    trace = Trace(484848, 0.4)
+    trace.rest(50)
+    for n in range(10):
+        # flick out and back; twists turn gyro Y and Z against each other, which doubles X movement
+        twist = n % 2
+        peak = [ trace.rng.choice([ -1, 1 ]) * trace.rng.uniform(150, 400), trace.rng.choice([ -1, 1 ]) * trace.rng.uniform(150, 400), 0 ]
+        if twist: peak[2] = -peak[1] * trace.rng.uniform(0.5, 1.0)
+        duration = trace.rng.randint(12, 25)
+        trace.move(duration, peak)
+        trace.rest(trace.rng.randint(10, 30))
+        trace.move(duration, [ -v * trace.rng.uniform(0.8, 1.2) for v in peak ])
+        trace.rest(trace.rng.randint(40, 80))
+    trace.write('mouse_fast.csv', 'fast flicks and twists')
+
+if __name__ == '__main__':
+    write_point()
+    write_slow()
+    write_fast()
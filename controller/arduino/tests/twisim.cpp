@@ -0,0 +1,271 @@
+// Keyglove controller host tests - I2C (TWI) bus simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file twisim.cpp
+ * @brief AT90USB1286 TWI (I2C master) simulator with register-based devices
+ */
+
+#include <Arduino.h>
+#include "twisim.h"
+
+#define TWISIM_STOP_DONE        0xFF    ///< Internal result for a STOP, which does not raise the TWI flag
+#define TWISIM_SPIN_READS       64      ///< Clock reads without time passing that count as a blocking wait
+#define TWISIM_SPIN_STEP_US     10      ///< Time skipped per blocking wait check with nothing on the bus
+
+extern "C" void TWI_vect(void);
+
+/**
+ * @brief What the next byte on the bus is, from the master's point of view
+ */
+enum {
+    TWISIM_MODE_IDLE,                   ///< Bus free, or owned after a NACK until STOP
+    TWISIM_MODE_ADDRESS,                ///< START sent, next byte is SLA+R/W
+    TWISIM_MODE_TRANSMIT,               ///< Device addressed for writing
+    TWISIM_MODE_RECEIVE,                ///< Device addressed for reading
+};
+
+uint32_t twisimStarts;
+uint32_t twisimBytes;
+uint64_t twisimBusNs;
+uint32_t twisimInterrupts;
+uint32_t twisimSpinUs;
+bool twisimStuck;
+
+TwisimDevice *twisimDevices;            ///< Devices on the bus
+TwisimDevice *twisimTarget;             ///< Device addressed in the current transfer
+uint8_t twisimMode;                     ///< Current bus mode
+bool twisimOwned;                       ///< START sent and no STOP since
+bool twisimBusy;                        ///< Bus action in progress
+bool twisimFlag;                        ///< TWI interrupt flag raised and not yet serviced
+uint8_t twisimResult;                   ///< TWSR status when the action in progress finishes
+uint8_t twisimReceived;                 ///< Byte that lands in TWDR when a receive finishes
+uint64_t twisimEndNs;                   ///< When the action in progress finishes (or the last one finished)
+uint32_t twisimSpinClock;               ///< Clock value at the last time hook call
+uint8_t twisimSpinCount;                ///< Time hook calls in a row at that clock value
+bool twisimRunning;                     ///< Inside the time hook (no nesting)
+
+TwisimDevice::TwisimDevice(uint8_t address) : address(address), pointer(0), nack(false), reads(0), writes(0), next(0), addressed(false) {
+    memset(regs, 0, sizeof(regs));
+}
+
+/**
+ * @brief Device has just been addressed
+ * @param[in] read True for SLA+R, false for SLA+W
+ */
+void TwisimDevice::start(bool read) {
+    addressed = !read;
+}
+
+/**
+ * @brief Byte written by the master
+ */
+void TwisimDevice::write(uint8_t value) {
+    if (addressed) {
+        pointer = value;
+        addressed = false;
+        return;
+    }
+    writes++;
+    write_register(pointer, value);
+    if (increments(pointer)) pointer++;
+}
+
+/**
+ * @brief Byte read by the master
+ */
+uint8_t TwisimDevice::read() {
+    uint8_t value = read_register(pointer);
+    reads++;
+    if (increments(pointer)) pointer++;
+    return value;
+}
+
+/**
+ * @brief Bus time for a number of SCL periods at the current TWBR and prescaler
+ */
+uint64_t twisim_bits_ns(uint8_t bits) {
+    static const uint8_t prescaler[4] = { 1, 4, 16, 64 };
+    return (uint64_t)bits * (16 + 2 * (uint32_t)TWBR * prescaler[TWSR & 0x03]) * 1000000000ull / F_CPU;
+}
+
+/**
+ * @brief Start the bus action firmware asked for with its last TWCR write
+ */
+void twisim_command() {
+    uint8_t command = TWCR.value, bits = 9;
+    uint64_t now = (uint64_t)mock_us * 1000;
+    TWCR.value &= ~((1 << TWINT) | (1 << TWSTO));
+
+    if (command & (1 << TWSTO)) {
+        twisimTarget = 0;
+        twisimMode = TWISIM_MODE_IDLE;
+        twisimOwned = false;
+        bits = 1;
+        twisimResult = TWISIM_STOP_DONE;
+    }
+    if (command & (1 << TWSTA)) {
+        twisimResult = twisimOwned ? 0x10 : 0x08;
+        twisimMode = TWISIM_MODE_ADDRESS;
+        twisimOwned = true;
+        bits = (command & (1 << TWSTO)) ? 2 : 1;
+        twisimStarts++;
+    } else if (command & (1 << TWSTO)) {
+        // STOP only
+    } else if (twisimMode == TWISIM_MODE_ADDRESS) {
+        uint8_t sla = TWDR;
+        for (twisimTarget = twisimDevices; twisimTarget && (twisimTarget -> address != (sla >> 1) || twisimTarget -> nack); twisimTarget = twisimTarget -> next);
+        twisimBytes++;
+        if (!twisimTarget) {
+            twisimMode = TWISIM_MODE_IDLE;
+            twisimResult = (sla & 1) ? 0x48 : 0x20;
+        } else {
+            twisimTarget -> start(sla & 1);
+            twisimMode = (sla & 1) ? TWISIM_MODE_RECEIVE : TWISIM_MODE_TRANSMIT;
+            twisimResult = (sla & 1) ? 0x40 : 0x18;
+        }
+    } else if (twisimMode == TWISIM_MODE_TRANSMIT) {
+        twisimTarget -> write(TWDR);
+        twisimBytes++;
+        twisimResult = 0x28;
+    } else if (twisimMode == TWISIM_MODE_RECEIVE) {
+        twisimReceived = twisimTarget -> read();
+        twisimBytes++;
+        twisimResult = (command & (1 << TWEA)) ? 0x50 : 0x58;
+    } else {
+        // data byte with nobody listening
+        twisimResult = 0x00;
+    }
+
+    // an action given before the last one (e.g. a STOP) finished starts right after it
+    if (twisimEndNs < now) twisimEndNs = now;
+    twisimEndNs += twisim_bits_ns(bits);
+    twisimBusNs += twisim_bits_ns(bits);
+    twisimBusy = true;
+}
+
+/**
+ * @brief TWCR write hook: reset the module, or start the next bus action
+ */
+void twisim_write() {
+    if (!(TWCR.value & (1 << TWEN))) {
+        // module disabled (or reset by firmware), so everything in progress is abandoned
+        twisimBusy = twisimFlag = twisimOwned = false;
+        twisimTarget = 0;
+        twisimMode = TWISIM_MODE_IDLE;
+        TWCR.value &= ~(1 << TWINT);
+        return;
+    }
+    if (!(TWCR.value & (1 << TWINT))) return;
+
+    // writing a one to TWINT clears the flag and starts the action
+    twisimFlag = false;
+    twisim_command();
+}
+
+/**
+ * @brief Run the TWI module up to the current simulated time
+ */
+void twisim_step() {
+    for (;;) {
+        if (twisimBusy) {
+            if (twisimStuck || twisimEndNs > (uint64_t)mock_us * 1000) return;
+            twisimBusy = false;
+            if (twisimResult == TWISIM_STOP_DONE) return;
+            if (twisimResult == 0x50 || twisimResult == 0x58) TWDR = twisimReceived;
+            TWSR = (TWSR & 0x03) | twisimResult;
+            TWCR.value |= (1 << TWINT);
+            twisimFlag = true;
+        }
+        if (!twisimFlag || !(TWCR.value & (1 << TWIE)) || !mock_interrupts) return;
+        mock_interrupts = 0;
+        twisimInterrupts++;
+        TWI_vect();
+        mock_interrupts = 1;
+
+        // a handler that leaves the flag set would be called again forever
+        if (twisimFlag) return;
+    }
+}
+
+/**
+ * @brief Time hook: update devices, run the bus, and skip ahead in blocking waits
+ */
+void twisim_hook() {
+    if (twisimRunning) return;
+    twisimRunning = true;
+    for (TwisimDevice *device = twisimDevices; device; device = device -> next) device -> update();
+    twisim_step();
+
+    if (mock_us != twisimSpinClock) {
+        twisimSpinClock = mock_us;
+        twisimSpinCount = 0;
+    } else if (++twisimSpinCount >= TWISIM_SPIN_READS) {
+        uint32_t skip = TWISIM_SPIN_STEP_US;
+        if (twisimBusy && !twisimStuck) skip = (uint32_t)((twisimEndNs + 999) / 1000 - mock_us);
+        if (!skip) skip = 1;
+        mock_us += skip;
+        twisimSpinUs += skip;
+        twisimSpinClock = mock_us;
+        twisimSpinCount = 0;
+        for (TwisimDevice *device = twisimDevices; device; device = device -> next) device -> update();
+        twisim_step();
+    }
+    twisimRunning = false;
+}
+
+/**
+ * @brief Remove all devices, clear counters and bus state, and start simulating
+ */
+void twisim_reset() {
+    twisimDevices = twisimTarget = 0;
+    twisimMode = TWISIM_MODE_IDLE;
+    twisimBusy = twisimFlag = twisimOwned = twisimStuck = false;
+    twisimStarts = twisimBytes = twisimInterrupts = twisimSpinUs = 0;
+    twisimBusNs = 0;
+    twisimEndNs = (uint64_t)mock_us * 1000;
+    TWCR.value = 0;
+    mock_time_hook = twisim_hook;
+    mock_twcr_hook = twisim_write;
+}
+
+/**
+ * @brief Connect a device to the bus
+ */
+void twisim_attach(TwisimDevice *device) {
+    device -> next = twisimDevices;
+    twisimDevices = device;
+}
+
+/**
+ * @brief Check whether a bus action is in progress or waiting for its interrupt
+ */
+bool twisim_busy() {
+    return twisimBusy || twisimFlag;
+}
@@ -0,0 +1,99 @@
+// Keyglove controller host tests - I2C (TWI) bus simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file twisim.h
+ * @brief AT90USB1286 TWI (I2C master) simulator with register-based devices
+ *
+ * Runs the TWI module the way support_i2c.cpp drives it. Whenever firmware
+ * writes TWCR with TWINT set, the simulator starts the bus action it asks for
+ * (START, STOP, or one byte plus acknowledge), and once that action's bus
+ * time has passed in simulated time, it sets TWSR and TWINT and calls the TWI
+ * interrupt handler (if TWIE and global interrupts are enabled). Clearing
+ * TWEN abandons whatever was in progress, as on the AVR. Bus time follows
+ * TWBR and the TWSR prescaler, at 9 bit times per byte and one per START or
+ * STOP, so transfers run alongside main loop code just like on the AVR.
+ *
+ * The simulator runs from mock_time_hook, so it sees time pass whenever
+ * firmware or a test reads or advances the clock. A loop which keeps reading
+ * the clock while it stands still (a blocking wait for the bus) is moved on to
+ * the next bus event, which is where the CPU would have spun to; that time is
+ * added up in twisimSpinUs.
+ */
+
+#ifndef _TWISIM_H_
+#define _TWISIM_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Simulated I2C device with auto-incrementing 8-bit register addresses
+ *
+ * The first byte written after the device is addressed sets the register
+ * pointer, and every following byte written or read moves it on by one,
+ * unless increments() says otherwise (e.g. for a FIFO data register).
+ * Subclasses override the register accessors and update() for behavior.
+ */
+class TwisimDevice {
+    public:
+        uint8_t address;                    ///< 7-bit device address
+        uint8_t regs[256];                  ///< Register contents
+        uint8_t pointer;                    ///< Register pointer
+        bool nack;                          ///< Do not acknowledge the address (device missing)
+        uint32_t reads;                     ///< Register bytes read since attached
+        uint32_t writes;                    ///< Register bytes written since attached
+        TwisimDevice *next;                 ///< Next device on the bus
+
+        TwisimDevice(uint8_t address);
+        virtual ~TwisimDevice() { }
+        virtual void update() { }
+        virtual uint8_t read_register(uint8_t reg) { return regs[reg]; }
+        virtual void write_register(uint8_t reg, uint8_t value) { regs[reg] = value; }
+        virtual bool increments(uint8_t reg) { return true; }
+
+        void start(bool read);
+        void write(uint8_t value);
+        uint8_t read();
+
+    private:
+        bool addressed;                     ///< Next byte written sets the register pointer
+};
+
+extern uint32_t twisimStarts;               ///< START and repeated START conditions since twisim_reset()
+extern uint32_t twisimBytes;                ///< Bytes on the bus (addresses and data) since twisim_reset()
+extern uint64_t twisimBusNs;                ///< Time the bus was busy since twisim_reset() (nanoseconds)
+extern uint32_t twisimInterrupts;           ///< TWI interrupt handler calls since twisim_reset()
+extern uint32_t twisimSpinUs;               ///< Simulated time skipped over in blocking waits since twisim_reset()
+extern bool twisimStuck;                    ///< Hold the bus action in progress forever (e.g. SDA held low)
+
+void twisim_reset();
+void twisim_attach(TwisimDevice *device);
+bool twisim_busy();
+
+#endif // _TWISIM_H_
@@ -0,0 +1,110 @@
+// Keyglove controller host tests - I2Cdev register access on the TWI simulator
+// 2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+/* ============================================
+Controller code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+
+
+/**
+ * @file wiresim.cpp
+ * @brief I2Cdev register access on the simulated TWI bus, waiting for each transfer like the Wire library
+ *
+ * Linked into programs built with KG_I2C_WIRE, so support_i2c.cpp's I2Cdev
+ * calls reach the devices attached to twisim. Each call drives the TWI
+ * registers with the interrupt disabled and reads the clock until TWINT comes
+ * back, so the caller waits for the whole transfer, as it does with Wire on
+ * the AVR. That waiting shows up in twisimSpinUs.
+ */
+
+#include <Arduino.h>
+#include <I2Cdev.h>
+#include "twisim.h"
+
+#define WIRESIM_TIMEOUT_MS      1000    ///< I2Cdev default read timeout
+
+/**
+ * @brief Start a bus action and wait for it to finish
+ * @return TWSR status, or zero on timeout
+ */
+static uint8_t wiresim_go(uint8_t flags, uint16_t timeout) {
+    uint32_t start = millis();
+    TWCR = (1 << TWINT) | (1 << TWEN) | flags;
+    while (!(TWCR & (1 << TWINT))) {
+        if (millis() - start > timeout) return 0;
+    }
+    return TWSR & 0xF8;
+}
+
+static void wiresim_stop() {
+    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+}
+
+/**
+ * @brief Send START, address for writing, and register address
+ */
+static bool wiresim_begin(uint8_t devAddr, uint8_t regAddr, uint16_t timeout) {
+    if (wiresim_go(1 << TWSTA, timeout) != 0x08) return false;
+    TWDR = devAddr << 1;
+    if (wiresim_go(0, timeout) != 0x18) return false;
+    TWDR = regAddr;
+    return wiresim_go(0, timeout) == 0x28;
+}
+
+int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
+    uint8_t count = 0;
+    if (!timeout) timeout = WIRESIM_TIMEOUT_MS;
+    if (wiresim_begin(devAddr, regAddr, timeout) && wiresim_go(1 << TWSTA, timeout) == 0x10) {
+        TWDR = (devAddr << 1) | 1;
+        if (wiresim_go(0, timeout) == 0x40) {
+            for (; count < length; count++) {
+                uint8_t last = (count + 1 == length);
+                if (wiresim_go(last ? 0 : (1 << TWEA), timeout) != (last ? 0x58 : 0x50)) break;
+                data[count] = TWDR;
+            }
+        }
+    }
+    wiresim_stop();
+    return count == length ? count : -1;
+}
+
+bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) {
+    uint8_t count = 0;
+    if (wiresim_begin(devAddr, regAddr, WIRESIM_TIMEOUT_MS)) {
+        for (; count < length; count++) {
+            TWDR = data[count];
+            if (wiresim_go(0, WIRESIM_TIMEOUT_MS) != 0x28) break;
+        }
+    }
+    wiresim_stop();
+    return count == length;
+}
+
+int8_t I2Cdev::readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout) {
+    return readBytes(devAddr, regAddr, 1, data, timeout);
+}
+
+bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
+    return writeBytes(devAddr, regAddr, 1, &data);
+}
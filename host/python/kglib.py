@@ -459,6 +459,14 @@ class KGAPI(object):
         return struct.pack('<4B', 0xC0, 0x00, 0x01, 0x06)
     def kg_cmd_system_set_timer(self, handle, interval, oneshot):
         return struct.pack('<4BBHB', 0xC0, 0x04, 0x01, 0x07, handle, interval, oneshot)
+    def kg_cmd_system_get_recorder(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x01, 0x08)
+    def kg_cmd_system_set_recorder(self, mode, post):
+        return struct.pack('<4BBH', 0xC0, 0x03, 0x01, 0x09, mode, post)
+    def kg_cmd_system_trigger_recorder(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x01, 0x0A)
+    def kg_cmd_system_read_recorder(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x01, 0x0B)
     
     def kg_cmd_bluetooth_get_mode(self):
         return struct.pack('<4B', 0xC0, 0x00, 0x02, 0x01)
@@ -506,11 +514,79 @@ class KGAPI(object):
         return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x01)
     def kg_cmd_touch_set_mode(self, mode):
         return struct.pack('<4BB', 0xC0, 0x01, 0x04, 0x02, mode)
+    def kg_cmd_touch_get_gesture_timing(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x03)
+    def kg_cmd_touch_set_gesture_timing(self, tap, hold, long_press, multi_tap):
+        return struct.pack('<4BHHHH', 0xC0, 0x08, 0x04, 0x04, tap, hold, long_press, multi_tap)
+    def kg_cmd_touch_get_oversampling(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x05)
+    def kg_cmd_touch_set_oversampling(self, samples):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x04, 0x06, samples)
+    def kg_cmd_touch_get_scan_config(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x07)
+    def kg_cmd_touch_set_scan_config(self, idle_timeout, idle_interval, burst_interval, burst_timeout):
+        return struct.pack('<4BHBHH', 0xC0, 0x07, 0x04, 0x08, idle_timeout, idle_interval, burst_interval, burst_timeout)
+    def kg_cmd_touch_get_scan_stats(self, rate):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x04, 0x09, rate)
+    def kg_cmd_touch_get_ghost_mode(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x0A)
+    def kg_cmd_touch_set_ghost_mode(self, mode):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x04, 0x0B, mode)
+    def kg_cmd_touch_get_usage(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x0C)
+    def kg_cmd_touch_reset_usage(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x04, 0x0D)
     
     def kg_cmd_motion_get_mode(self, index):
         return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x01, index)
     def kg_cmd_motion_set_mode(self, index, mode):
         return struct.pack('<4BBB', 0xC0, 0x02, 0x05, 0x02, index, mode)
+    def kg_cmd_motion_get_filter(self, index):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x03, index)
+    def kg_cmd_motion_set_filter(self, index, accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z):
+        return struct.pack('<4BBBBBBBB', 0xC0, 0x07, 0x05, 0x04, index, accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z)
+    def kg_cmd_motion_get_config(self, index):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x05, index)
+    def kg_cmd_motion_set_config(self, index, rate, dlpf, gyro_range, accel_range, decimation):
+        return struct.pack('<4BBHBBBB', 0xC0, 0x07, 0x05, 0x06, index, rate, dlpf, gyro_range, accel_range, decimation)
+    def kg_cmd_motion_get_bias(self, index):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x07, index)
+    def kg_cmd_motion_reset_bias(self, index):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x08, index)
+    def kg_cmd_motion_get_batch(self, index):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x09, index)
+    def kg_cmd_motion_set_batch(self, index, batch):
+        return struct.pack('<4BBB', 0xC0, 0x02, 0x05, 0x0A, index, batch)
+    def kg_cmd_motion_get_gesture(self, gesture):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x05, 0x0B, gesture)
+    def kg_cmd_motion_set_gesture(self, gesture, threshold, frames):
+        return struct.pack('<4BBHB' + str(len(frames)) + 's', 0xC0, 0x04 + len(frames), 0x05, 0x0C, gesture, threshold, len(frames), b''.join(chr(i) for i in frames))
+    
+    def kg_cmd_touchset_get_info(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x08, 0x01)
+    def kg_cmd_touchset_clear(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x08, 0x02)
+    def kg_cmd_touchset_add_entry(self, mode, action, param, chord):
+        return struct.pack('<4BBBBB' + str(len(chord)) + 's', 0xC0, 0x04 + len(chord), 0x08, 0x03, mode, action, param, len(chord), b''.join(chr(i) for i in chord))
+    def kg_cmd_touchset_write_begin(self, count):
+        return struct.pack('<4BH', 0xC0, 0x02, 0x08, 0x04, count)
+    def kg_cmd_touchset_write_data(self, offset, data):
+        return struct.pack('<4BHB' + str(len(data)) + 's', 0xC0, 0x03 + len(data), 0x08, 0x05, offset, len(data), b''.join(chr(i) for i in data))
+    def kg_cmd_touchset_write_end(self, crc):
+        return struct.pack('<4BH', 0xC0, 0x02, 0x08, 0x06, crc)
+    def kg_cmd_touchset_erase(self):
+        return struct.pack('<4B', 0xC0, 0x00, 0x08, 0x07)
+    
+    def kg_cmd_hid_get_curve_point(self, curve, index):
+        return struct.pack('<4BBB', 0xC0, 0x02, 0x09, 0x01, curve, index)
+    def kg_cmd_hid_set_curve(self, curve, points):
+        return struct.pack('<4BBB' + str(len(points)) + 's', 0xC0, 0x02 + len(points), 0x09, 0x02, curve, len(points), b''.join(chr(i) for i in points))
+    def kg_cmd_hid_reset_curve(self, curve):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x09, 0x03, curve)
+    def kg_cmd_hid_get_predictor(self, mode):
+        return struct.pack('<4BB', 0xC0, 0x01, 0x09, 0x04, mode)
+    def kg_cmd_hid_set_predictor(self, mode, enabled, lead, alpha, beta, jerk):
+        return struct.pack('<4BBBBBBB', 0xC0, 0x06, 0x09, 0x05, mode, enabled, lead, alpha, beta, jerk)
     
     kg_rsp_system_ping = KeygloveEvent()
     kg_rsp_system_reset = KeygloveEvent()
@@ -519,6 +595,10 @@ class KGAPI(object):
     kg_rsp_system_get_memory = KeygloveEvent()
     kg_rsp_system_get_battery_status = KeygloveEvent()
     kg_rsp_system_set_timer = KeygloveEvent()
+    kg_rsp_system_get_recorder = KeygloveEvent()
+    kg_rsp_system_set_recorder = KeygloveEvent()
+    kg_rsp_system_trigger_recorder = KeygloveEvent()
+    kg_rsp_system_read_recorder = KeygloveEvent()
     
     kg_rsp_bluetooth_get_mode = KeygloveEvent()
     kg_rsp_bluetooth_set_mode = KeygloveEvent()
@@ -544,9 +624,44 @@ class KGAPI(object):
     
     kg_rsp_touch_get_mode = KeygloveEvent()
     kg_rsp_touch_set_mode = KeygloveEvent()
+    kg_rsp_touch_get_gesture_timing = KeygloveEvent()
+    kg_rsp_touch_set_gesture_timing = KeygloveEvent()
+    kg_rsp_touch_get_oversampling = KeygloveEvent()
+    kg_rsp_touch_set_oversampling = KeygloveEvent()
+    kg_rsp_touch_get_scan_config = KeygloveEvent()
+    kg_rsp_touch_set_scan_config = KeygloveEvent()
+    kg_rsp_touch_get_scan_stats = KeygloveEvent()
+    kg_rsp_touch_get_ghost_mode = KeygloveEvent()
+    kg_rsp_touch_set_ghost_mode = KeygloveEvent()
+    kg_rsp_touch_get_usage = KeygloveEvent()
+    kg_rsp_touch_reset_usage = KeygloveEvent()
     
     kg_rsp_motion_get_mode = KeygloveEvent()
     kg_rsp_motion_set_mode = KeygloveEvent()
+    kg_rsp_motion_get_filter = KeygloveEvent()
+    kg_rsp_motion_set_filter = KeygloveEvent()
+    kg_rsp_motion_get_config = KeygloveEvent()
+    kg_rsp_motion_set_config = KeygloveEvent()
+    kg_rsp_motion_get_bias = KeygloveEvent()
+    kg_rsp_motion_reset_bias = KeygloveEvent()
+    kg_rsp_motion_get_batch = KeygloveEvent()
+    kg_rsp_motion_set_batch = KeygloveEvent()
+    kg_rsp_motion_get_gesture = KeygloveEvent()
+    kg_rsp_motion_set_gesture = KeygloveEvent()
+    
+    kg_rsp_touchset_get_info = KeygloveEvent()
+    kg_rsp_touchset_clear = KeygloveEvent()
+    kg_rsp_touchset_add_entry = KeygloveEvent()
+    kg_rsp_touchset_write_begin = KeygloveEvent()
+    kg_rsp_touchset_write_data = KeygloveEvent()
+    kg_rsp_touchset_write_end = KeygloveEvent()
+    kg_rsp_touchset_erase = KeygloveEvent()
+    
+    kg_rsp_hid_get_curve_point = KeygloveEvent()
+    kg_rsp_hid_set_curve = KeygloveEvent()
+    kg_rsp_hid_reset_curve = KeygloveEvent()
+    kg_rsp_hid_get_predictor = KeygloveEvent()
+    kg_rsp_hid_set_predictor = KeygloveEvent()
     
     kg_evt_protocol_error = KeygloveEvent()
     
@@ -556,6 +671,7 @@ class KGAPI(object):
     kg_evt_system_capability = KeygloveEvent()
     kg_evt_system_battery_status = KeygloveEvent()
     kg_evt_system_timer_tick = KeygloveEvent()
+    kg_evt_system_recorder_data = KeygloveEvent()
     
     kg_evt_bluetooth_mode = KeygloveEvent()
     kg_evt_bluetooth_ready = KeygloveEvent()
@@ -574,10 +690,15 @@ class KGAPI(object):
     
     kg_evt_touch_mode = KeygloveEvent()
     kg_evt_touch_status = KeygloveEvent()
+    kg_evt_touch_gesture = KeygloveEvent()
+    kg_evt_touch_ambiguous = KeygloveEvent()
+    kg_evt_touch_usage = KeygloveEvent()
     
     kg_evt_motion_mode = KeygloveEvent()
     kg_evt_motion_data = KeygloveEvent()
     kg_evt_motion_state = KeygloveEvent()
+    kg_evt_motion_batch = KeygloveEvent()
+    kg_evt_motion_gesture = KeygloveEvent()
     
     kg_log = KeygloveEvent()
 
@@ -603,6 +724,14 @@ class KGAPI(object):
     def get_last_event(self):
         return self.last_event
 
+    def unpack_motion_batch(self, payload):
+        # fire kg_evt_motion_data once per sample, so batched and unbatched streams look the same
+        if payload['count'] == 0:
+            return
+        size = len(payload['data']) // payload['count']
+        for i in range(payload['count']):
+            self.kg_evt_motion_data({ 'index': payload['index'], 'flags': payload['flags'], 'data': payload['data'][i * size:(i + 1) * size] })
+
     def parse(self, b):
         if len(self.kgapi_rx_buffer) == 0 and (b == 0xC0 or b == 0x80):
             self.kgapi_rx_buffer.append(b)
@@ -662,6 +791,22 @@ class KGAPI(object):
                         result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
                         self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_rsp_system_set_timer(self.last_response['payload'])
+                    elif packet_command == 8: # kg_rsp_system_get_recorder
+                        mode, state, trigger, count, post, = struct.unpack('<BBBHH', self.kgapi_rx_payload[:7])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': mode, 'state': state, 'trigger': trigger, 'count': count, 'post': post }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_system_get_recorder(self.last_response['payload'])
+                    elif packet_command == 9: # kg_rsp_system_set_recorder
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_system_set_recorder(self.last_response['payload'])
+                    elif packet_command == 10: # kg_rsp_system_trigger_recorder
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_system_trigger_recorder(self.last_response['payload'])
+                    elif packet_command == 11: # kg_rsp_system_read_recorder
+                        count, timestamp, = struct.unpack('<HL', self.kgapi_rx_payload[:6])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': count, 'timestamp': timestamp }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_system_read_recorder(self.last_response['payload'])
                 elif packet_class == 2: # BLUETOOTH
                     if packet_command == 1: # kg_rsp_bluetooth_get_mode
                         result, mode, = struct.unpack('<HB', self.kgapi_rx_payload[:3])
@@ -754,6 +899,50 @@ class KGAPI(object):
                         result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
                         self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_rsp_touch_set_mode(self.last_response['payload'])
+                    elif packet_command == 3: # kg_rsp_touch_get_gesture_timing
+                        tap, hold, long_press, multi_tap, = struct.unpack('<HHHH', self.kgapi_rx_payload[:8])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'tap': tap, 'hold': hold, 'long_press': long_press, 'multi_tap': multi_tap }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_gesture_timing(self.last_response['payload'])
+                    elif packet_command == 4: # kg_rsp_touch_set_gesture_timing
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_set_gesture_timing(self.last_response['payload'])
+                    elif packet_command == 5: # kg_rsp_touch_get_oversampling
+                        samples, = struct.unpack('<B', self.kgapi_rx_payload[:1])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'samples': samples }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_oversampling(self.last_response['payload'])
+                    elif packet_command == 6: # kg_rsp_touch_set_oversampling
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_set_oversampling(self.last_response['payload'])
+                    elif packet_command == 7: # kg_rsp_touch_get_scan_config
+                        idle_timeout, idle_interval, burst_interval, burst_timeout, = struct.unpack('<HBHH', self.kgapi_rx_payload[:7])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'idle_timeout': idle_timeout, 'idle_interval': idle_interval, 'burst_interval': burst_interval, 'burst_timeout': burst_timeout }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_scan_config(self.last_response['payload'])
+                    elif packet_command == 8: # kg_rsp_touch_set_scan_config
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_set_scan_config(self.last_response['payload'])
+                    elif packet_command == 9: # kg_rsp_touch_get_scan_stats
+                        current, scans, duration, = struct.unpack('<BLL', self.kgapi_rx_payload[:9])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'current': current, 'scans': scans, 'duration': duration }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_scan_stats(self.last_response['payload'])
+                    elif packet_command == 10: # kg_rsp_touch_get_ghost_mode
+                        mode, = struct.unpack('<B', self.kgapi_rx_payload[:1])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': mode }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_ghost_mode(self.last_response['payload'])
+                    elif packet_command == 11: # kg_rsp_touch_set_ghost_mode
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_set_ghost_mode(self.last_response['payload'])
+                    elif packet_command == 12: # kg_rsp_touch_get_usage
+                        count, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': count }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_get_usage(self.last_response['payload'])
+                    elif packet_command == 13: # kg_rsp_touch_reset_usage
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touch_reset_usage(self.last_response['payload'])
                 elif packet_class == 5: # MOTION
                     if packet_command == 1: # kg_rsp_motion_get_mode
                         mode, = struct.unpack('<B', self.kgapi_rx_payload[:1])
@@ -763,6 +952,96 @@ class KGAPI(object):
                         result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
                         self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_rsp_motion_set_mode(self.last_response['payload'])
+                    elif packet_command == 3: # kg_rsp_motion_get_filter
+                        accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z, = struct.unpack('<BBBBBB', self.kgapi_rx_payload[:6])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'accel_x': accel_x, 'accel_y': accel_y, 'accel_z': accel_z, 'gyro_x': gyro_x, 'gyro_y': gyro_y, 'gyro_z': gyro_z }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_get_filter(self.last_response['payload'])
+                    elif packet_command == 4: # kg_rsp_motion_set_filter
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_set_filter(self.last_response['payload'])
+                    elif packet_command == 5: # kg_rsp_motion_get_config
+                        rate, dlpf, gyro_range, accel_range, decimation, = struct.unpack('<HBBBB', self.kgapi_rx_payload[:6])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'rate': rate, 'dlpf': dlpf, 'gyro_range': gyro_range, 'accel_range': accel_range, 'decimation': decimation }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_get_config(self.last_response['payload'])
+                    elif packet_command == 6: # kg_rsp_motion_set_config
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_set_config(self.last_response['payload'])
+                    elif packet_command == 7: # kg_rsp_motion_get_bias
+                        x, y, z, still, = struct.unpack('<HHHB', self.kgapi_rx_payload[:7])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'x': x, 'y': y, 'z': z, 'still': still }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_get_bias(self.last_response['payload'])
+                    elif packet_command == 8: # kg_rsp_motion_reset_bias
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_reset_bias(self.last_response['payload'])
+                    elif packet_command == 9: # kg_rsp_motion_get_batch
+                        batch, current, = struct.unpack('<BB', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'batch': batch, 'current': current }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_get_batch(self.last_response['payload'])
+                    elif packet_command == 10: # kg_rsp_motion_set_batch
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_set_batch(self.last_response['payload'])
+                    elif packet_command == 11: # kg_rsp_motion_get_gesture
+                        frames, threshold, = struct.unpack('<BH', self.kgapi_rx_payload[:3])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'frames': frames, 'threshold': threshold }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_get_gesture(self.last_response['payload'])
+                    elif packet_command == 12: # kg_rsp_motion_set_gesture
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_motion_set_gesture(self.last_response['payload'])
+                elif packet_class == 8: # TOUCHSET
+                    if packet_command == 1: # kg_rsp_touchset_get_info
+                        count, capacity, source, = struct.unpack('<HHB', self.kgapi_rx_payload[:5])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': count, 'capacity': capacity, 'source': source }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_get_info(self.last_response['payload'])
+                    elif packet_command == 2: # kg_rsp_touchset_clear
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_clear(self.last_response['payload'])
+                    elif packet_command == 3: # kg_rsp_touchset_add_entry
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_add_entry(self.last_response['payload'])
+                    elif packet_command == 4: # kg_rsp_touchset_write_begin
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_write_begin(self.last_response['payload'])
+                    elif packet_command == 5: # kg_rsp_touchset_write_data
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_write_data(self.last_response['payload'])
+                    elif packet_command == 6: # kg_rsp_touchset_write_end
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_write_end(self.last_response['payload'])
+                    elif packet_command == 7: # kg_rsp_touchset_erase
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_touchset_erase(self.last_response['payload'])
+                elif packet_class == 9: # HID
+                    if packet_command == 1: # kg_rsp_hid_get_curve_point
+                        value, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'value': value }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_hid_get_curve_point(self.last_response['payload'])
+                    elif packet_command == 2: # kg_rsp_hid_set_curve
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_hid_set_curve(self.last_response['payload'])
+                    elif packet_command == 3: # kg_rsp_hid_reset_curve
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_hid_reset_curve(self.last_response['payload'])
+                    elif packet_command == 4: # kg_rsp_hid_get_predictor
+                        enabled, lead, alpha, beta, jerk, = struct.unpack('<BBBBB', self.kgapi_rx_payload[:5])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'enabled': enabled, 'lead': lead, 'alpha': alpha, 'beta': beta, 'jerk': jerk }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_hid_get_predictor(self.last_response['payload'])
+                    elif packet_command == 5: # kg_rsp_hid_set_predictor
+                        result, = struct.unpack('<H', self.kgapi_rx_payload[:2])
+                        self.last_response = { 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': result }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_rsp_hid_set_predictor(self.last_response['payload'])
                 self.kg_response(self.last_response)
             elif packet_type & 0xC0 == 0x80:
                 # 0x80 = event packet
@@ -798,6 +1077,11 @@ class KGAPI(object):
                         handle, seconds, subticks, = struct.unpack('<BLB', self.kgapi_rx_payload[:6])
                         self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'handle': handle, 'seconds': seconds, 'subticks': subticks }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_evt_system_timer_tick(self.last_event['payload'])
+                    elif packet_command == 7: # kg_evt_system_recorder_data
+                        offset, records_len, = struct.unpack('<HB', self.kgapi_rx_payload[:3])
+                        records_data = [ord(b) for b in self.kgapi_rx_payload[3:]]
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'offset': offset, 'records': records_data }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_system_recorder_data(self.last_event['payload'])
                 elif packet_class == 2: # BLUETOOTH
                     if packet_command == 1: # kg_evt_bluetooth_mode
                         mode, = struct.unpack('<B', self.kgapi_rx_payload[:1])
@@ -867,6 +1151,20 @@ class KGAPI(object):
                         status_data = [ord(b) for b in self.kgapi_rx_payload[1:]]
                         self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'status': status_data }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_evt_touch_status(self.last_event['payload'])
+                    elif packet_command == 3: # kg_evt_touch_gesture
+                        combination, gesture, = struct.unpack('<BB', self.kgapi_rx_payload[:2])
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'combination': combination, 'gesture': gesture }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_touch_gesture(self.last_event['payload'])
+                    elif packet_command == 4: # kg_evt_touch_ambiguous
+                        status_len, = struct.unpack('<B', self.kgapi_rx_payload[:1])
+                        status_data = [ord(b) for b in self.kgapi_rx_payload[1:]]
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'status': status_data }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_touch_ambiguous(self.last_event['payload'])
+                    elif packet_command == 5: # kg_evt_touch_usage
+                        offset, data_len, = struct.unpack('<HB', self.kgapi_rx_payload[:3])
+                        data_data = [ord(b) for b in self.kgapi_rx_payload[3:]]
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'offset': offset, 'data': data_data }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_touch_usage(self.last_event['payload'])
                 elif packet_class == 5: # MOTION
                     if packet_command == 1: # kg_evt_motion_mode
                         index, mode, = struct.unpack('<BB', self.kgapi_rx_payload[:2])
@@ -881,6 +1179,15 @@ class KGAPI(object):
                         index, state, = struct.unpack('<BB', self.kgapi_rx_payload[:2])
                         self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': index, 'state': state }, 'raw': self.kgapi_last_rx_packet }
                         self.kg_evt_motion_state(self.last_event['payload'])
+                    elif packet_command == 4: # kg_evt_motion_batch
+                        index, flags, count, time, data_len, = struct.unpack('<BBBHB', self.kgapi_rx_payload[:6])
+                        data_data = [ord(b) for b in self.kgapi_rx_payload[6:]]
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': index, 'flags': flags, 'count': count, 'time': time, 'data': data_data }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_motion_batch(self.last_event['payload'])
+                    elif packet_command == 5: # kg_evt_motion_gesture
+                        index, gesture, score, frames, = struct.unpack('<BBHB', self.kgapi_rx_payload[:5])
+                        self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': index, 'gesture': gesture, 'score': score, 'frames': frames }, 'raw': self.kgapi_last_rx_packet }
+                        self.kg_evt_motion_gesture(self.last_event['payload'])
                 elif packet_class == 0xFF: # LOG
                     if packet_command == 0xFF: # kg_log
                         level, = struct.unpack('<B', self.kgapi_rx_payload[:1])
@@ -888,6 +1195,8 @@ class KGAPI(object):
                         payload = { 'level': level, 'message': message }
                         self.last_event = { 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': payload, 'raw': self.kgapi_last_rx_packet }
                         self.kg_log(payload)
+                if packet_class == 5 and packet_command == 4: # kg_evt_motion_batch
+                    self.unpack_motion_batch(self.last_event['payload'])
                 self.kg_event(self.last_event)
 
             return packet_type & 0xC0
@@ -928,6 +1237,15 @@ class KGAPI(object):
                 elif packet_command == 7: # kg_cmd_system_set_timer
                     handle, interval, oneshot, = struct.unpack('<BHB', payload[:4])
                     return { 'type': 'command', 'name': 'kg_cmd_system_set_timer', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'handle': ('%d' % (handle)), 'interval': ('%d' % (interval)), 'oneshot': ('%d' % (oneshot)) }, 'payload_keys': [ 'handle', 'interval', 'oneshot' ] }
+                elif packet_command == 8: # kg_cmd_system_get_recorder
+                    return { 'type': 'command', 'name': 'kg_cmd_system_get_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 9: # kg_cmd_system_set_recorder
+                    mode, post, = struct.unpack('<BH', payload[:3])
+                    return { 'type': 'command', 'name': 'kg_cmd_system_set_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode), 'post': ('%d' % (post)) }, 'payload_keys': [ 'mode', 'post' ] }
+                elif packet_command == 10: # kg_cmd_system_trigger_recorder
+                    return { 'type': 'command', 'name': 'kg_cmd_system_trigger_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 11: # kg_cmd_system_read_recorder
+                    return { 'type': 'command', 'name': 'kg_cmd_system_read_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
             elif packet_class == 2: # BLUETOOTH
                 if packet_command == 1: # kg_cmd_bluetooth_get_mode
                     return { 'type': 'command', 'name': 'kg_cmd_bluetooth_get_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
@@ -990,6 +1308,33 @@ class KGAPI(object):
                 elif packet_command == 2: # kg_cmd_touch_set_mode
                     mode, = struct.unpack('<B', payload[:1])
                     return { 'type': 'command', 'name': 'kg_cmd_touch_set_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode) }, 'payload_keys': [ 'mode' ] }
+                elif packet_command == 3: # kg_cmd_touch_get_gesture_timing
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_gesture_timing', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 4: # kg_cmd_touch_set_gesture_timing
+                    tap, hold, long_press, multi_tap, = struct.unpack('<HHHH', payload[:8])
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_set_gesture_timing', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'tap': ('%d %s' % (tap, 'ms')), 'hold': ('%d %s' % (hold, 'ms')), 'long_press': ('%d %s' % (long_press, 'ms')), 'multi_tap': ('%d %s' % (multi_tap, 'ms')) }, 'payload_keys': [ 'tap', 'hold', 'long_press', 'multi_tap' ] }
+                elif packet_command == 5: # kg_cmd_touch_get_oversampling
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_oversampling', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 6: # kg_cmd_touch_set_oversampling
+                    samples, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_set_oversampling', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'samples': ('%d' % (samples)) }, 'payload_keys': [ 'samples' ] }
+                elif packet_command == 7: # kg_cmd_touch_get_scan_config
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_scan_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 8: # kg_cmd_touch_set_scan_config
+                    idle_timeout, idle_interval, burst_interval, burst_timeout, = struct.unpack('<HBHH', payload[:7])
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_set_scan_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'idle_timeout': ('%d %s' % (idle_timeout, 'second' if (idle_timeout == 1) else 'seconds')), 'idle_interval': ('%d' % (idle_interval)), 'burst_interval': ('%d %s' % (burst_interval, 'us')), 'burst_timeout': ('%d %s' % (burst_timeout, 'ms')) }, 'payload_keys': [ 'idle_timeout', 'idle_interval', 'burst_interval', 'burst_timeout' ] }
+                elif packet_command == 9: # kg_cmd_touch_get_scan_stats
+                    rate, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_scan_stats', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'rate': ('%02X' % rate) }, 'payload_keys': [ 'rate' ] }
+                elif packet_command == 10: # kg_cmd_touch_get_ghost_mode
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_ghost_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 11: # kg_cmd_touch_set_ghost_mode
+                    mode, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_set_ghost_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode) }, 'payload_keys': [ 'mode' ] }
+                elif packet_command == 12: # kg_cmd_touch_get_usage
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_get_usage', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 13: # kg_cmd_touch_reset_usage
+                    return { 'type': 'command', 'name': 'kg_cmd_touch_reset_usage', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
             elif packet_class == 5: # MOTION
                 if packet_command == 1: # kg_cmd_motion_get_mode
                     index, = struct.unpack('<B', payload[:1])
@@ -997,6 +1342,75 @@ class KGAPI(object):
                 elif packet_command == 2: # kg_cmd_motion_set_mode
                     index, mode, = struct.unpack('<BB', payload[:2])
                     return { 'type': 'command', 'name': 'kg_cmd_motion_set_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'mode': ('%02X' % mode) }, 'payload_keys': [ 'index', 'mode' ] }
+                elif packet_command == 3: # kg_cmd_motion_get_filter
+                    index, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_get_filter', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)) }, 'payload_keys': [ 'index' ] }
+                elif packet_command == 4: # kg_cmd_motion_set_filter
+                    index, accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z, = struct.unpack('<BBBBBBB', payload[:7])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_set_filter', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'accel_x': ('%d' % (accel_x)), 'accel_y': ('%d' % (accel_y)), 'accel_z': ('%d' % (accel_z)), 'gyro_x': ('%d' % (gyro_x)), 'gyro_y': ('%d' % (gyro_y)), 'gyro_z': ('%d' % (gyro_z)) }, 'payload_keys': [ 'index', 'accel_x', 'accel_y', 'accel_z', 'gyro_x', 'gyro_y', 'gyro_z' ] }
+                elif packet_command == 5: # kg_cmd_motion_get_config
+                    index, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_get_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)) }, 'payload_keys': [ 'index' ] }
+                elif packet_command == 6: # kg_cmd_motion_set_config
+                    index, rate, dlpf, gyro_range, accel_range, decimation, = struct.unpack('<BHBBBB', payload[:7])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_set_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'rate': ('%d %s' % (rate, 'Hz')), 'dlpf': ('%02X' % dlpf), 'gyro_range': ('%02X' % gyro_range), 'accel_range': ('%02X' % accel_range), 'decimation': ('%d' % (decimation)) }, 'payload_keys': [ 'index', 'rate', 'dlpf', 'gyro_range', 'accel_range', 'decimation' ] }
+                elif packet_command == 7: # kg_cmd_motion_get_bias
+                    index, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_get_bias', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)) }, 'payload_keys': [ 'index' ] }
+                elif packet_command == 8: # kg_cmd_motion_reset_bias
+                    index, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_reset_bias', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)) }, 'payload_keys': [ 'index' ] }
+                elif packet_command == 9: # kg_cmd_motion_get_batch
+                    index, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_get_batch', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)) }, 'payload_keys': [ 'index' ] }
+                elif packet_command == 10: # kg_cmd_motion_set_batch
+                    index, batch, = struct.unpack('<BB', payload[:2])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_set_batch', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'batch': ('%d' % (batch)) }, 'payload_keys': [ 'index', 'batch' ] }
+                elif packet_command == 11: # kg_cmd_motion_get_gesture
+                    gesture, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_get_gesture', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'gesture': ('%d' % (gesture)) }, 'payload_keys': [ 'gesture' ] }
+                elif packet_command == 12: # kg_cmd_motion_set_gesture
+                    gesture, threshold, frames_len, = struct.unpack('<BHB', payload[:4])
+                    frames_data = [ord(b) for b in payload[4:]]
+                    return { 'type': 'command', 'name': 'kg_cmd_motion_set_gesture', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'gesture': ('%d' % (gesture)), 'threshold': ('%d' % (threshold)), 'frames': ' '.join(['%02X' % b for b in frames_data]) }, 'payload_keys': [ 'gesture', 'threshold', 'frames' ] }
+            elif packet_class == 8: # TOUCHSET
+                if packet_command == 1: # kg_cmd_touchset_get_info
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_get_info', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 2: # kg_cmd_touchset_clear
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_clear', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+                elif packet_command == 3: # kg_cmd_touchset_add_entry
+                    mode, action, param, chord_len, = struct.unpack('<BBBB', payload[:4])
+                    chord_data = [ord(b) for b in payload[4:]]
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_add_entry', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode), 'action': ('%02X' % action), 'param': ('%02X' % param), 'chord': ' '.join(['%02X' % b for b in chord_data]) }, 'payload_keys': [ 'mode', 'action', 'param', 'chord' ] }
+                elif packet_command == 4: # kg_cmd_touchset_write_begin
+                    count, = struct.unpack('<H', payload[:2])
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_write_begin', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': ('%d' % (count)) }, 'payload_keys': [ 'count' ] }
+                elif packet_command == 5: # kg_cmd_touchset_write_data
+                    offset, data_len, = struct.unpack('<HB', payload[:3])
+                    data_data = [ord(b) for b in payload[3:]]
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_write_data', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'offset': ('%d' % (offset)), 'data': ' '.join(['%02X' % b for b in data_data]) }, 'payload_keys': [ 'offset', 'data' ] }
+                elif packet_command == 6: # kg_cmd_touchset_write_end
+                    crc, = struct.unpack('<H', payload[:2])
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_write_end', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'crc': ('%04X' % crc) }, 'payload_keys': [ 'crc' ] }
+                elif packet_command == 7: # kg_cmd_touchset_erase
+                    return { 'type': 'command', 'name': 'kg_cmd_touchset_erase', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': {  }, 'payload_keys': [  ] }
+            elif packet_class == 9: # HID
+                if packet_command == 1: # kg_cmd_hid_get_curve_point
+                    curve, index, = struct.unpack('<BB', payload[:2])
+                    return { 'type': 'command', 'name': 'kg_cmd_hid_get_curve_point', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'curve': ('%02X' % curve), 'index': ('%d' % (index)) }, 'payload_keys': [ 'curve', 'index' ] }
+                elif packet_command == 2: # kg_cmd_hid_set_curve
+                    curve, points_len, = struct.unpack('<BB', payload[:2])
+                    points_data = [ord(b) for b in payload[2:]]
+                    return { 'type': 'command', 'name': 'kg_cmd_hid_set_curve', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'curve': ('%02X' % curve), 'points': ' '.join(['%02X' % b for b in points_data]) }, 'payload_keys': [ 'curve', 'points' ] }
+                elif packet_command == 3: # kg_cmd_hid_reset_curve
+                    curve, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_hid_reset_curve', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'curve': ('%02X' % curve) }, 'payload_keys': [ 'curve' ] }
+                elif packet_command == 4: # kg_cmd_hid_get_predictor
+                    mode, = struct.unpack('<B', payload[:1])
+                    return { 'type': 'command', 'name': 'kg_cmd_hid_get_predictor', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode) }, 'payload_keys': [ 'mode' ] }
+                elif packet_command == 5: # kg_cmd_hid_set_predictor
+                    mode, enabled, lead, alpha, beta, jerk, = struct.unpack('<BBBBBB', payload[:6])
+                    return { 'type': 'command', 'name': 'kg_cmd_hid_set_predictor', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode), 'enabled': ('%d' % (enabled)), 'lead': ('%d' % (lead)), 'alpha': ('%d' % (alpha)), 'beta': ('%d' % (beta)), 'jerk': ('%d' % (jerk)) }, 'payload_keys': [ 'mode', 'enabled', 'lead', 'alpha', 'beta', 'jerk' ] }
         else:
             if packet_type & 0xC0 == 0xC0: # response packet
                 if packet_class == 1: # SYSTEM
@@ -1021,6 +1435,18 @@ class KGAPI(object):
                     elif packet_command == 7: # kg_rsp_system_set_timer
                         result, = struct.unpack('<H', payload[:2])
                         return { 'type': 'response', 'name': 'kg_rsp_system_set_timer', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 8: # kg_rsp_system_get_recorder
+                        mode, state, trigger, count, post, = struct.unpack('<BBBHH', payload[:7])
+                        return { 'type': 'response', 'name': 'kg_rsp_system_get_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode), 'state': ('%02X' % state), 'trigger': ('%02X' % trigger), 'count': ('%d' % (count)), 'post': ('%d' % (post)) }, 'payload_keys': [ 'mode', 'state', 'trigger', 'count', 'post' ] }
+                    elif packet_command == 9: # kg_rsp_system_set_recorder
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_system_set_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 10: # kg_rsp_system_trigger_recorder
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_system_trigger_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 11: # kg_rsp_system_read_recorder
+                        count, timestamp, = struct.unpack('<HL', payload[:6])
+                        return { 'type': 'response', 'name': 'kg_rsp_system_read_recorder', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': ('%d' % (count)), 'timestamp': ('%d %s' % (timestamp, 'ms')) }, 'payload_keys': [ 'count', 'timestamp' ] }
                 elif packet_class == 2: # BLUETOOTH
                     if packet_command == 1: # kg_rsp_bluetooth_get_mode
                         result, mode, = struct.unpack('<HB', payload[:3])
@@ -1091,6 +1517,39 @@ class KGAPI(object):
                     elif packet_command == 2: # kg_rsp_touch_set_mode
                         result, = struct.unpack('<H', payload[:2])
                         return { 'type': 'response', 'name': 'kg_rsp_touch_set_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 3: # kg_rsp_touch_get_gesture_timing
+                        tap, hold, long_press, multi_tap, = struct.unpack('<HHHH', payload[:8])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_gesture_timing', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'tap': ('%d %s' % (tap, 'ms')), 'hold': ('%d %s' % (hold, 'ms')), 'long_press': ('%d %s' % (long_press, 'ms')), 'multi_tap': ('%d %s' % (multi_tap, 'ms')) }, 'payload_keys': [ 'tap', 'hold', 'long_press', 'multi_tap' ] }
+                    elif packet_command == 4: # kg_rsp_touch_set_gesture_timing
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_set_gesture_timing', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 5: # kg_rsp_touch_get_oversampling
+                        samples, = struct.unpack('<B', payload[:1])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_oversampling', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'samples': ('%d' % (samples)) }, 'payload_keys': [ 'samples' ] }
+                    elif packet_command == 6: # kg_rsp_touch_set_oversampling
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_set_oversampling', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 7: # kg_rsp_touch_get_scan_config
+                        idle_timeout, idle_interval, burst_interval, burst_timeout, = struct.unpack('<HBHH', payload[:7])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_scan_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'idle_timeout': ('%d %s' % (idle_timeout, 'second' if (idle_timeout == 1) else 'seconds')), 'idle_interval': ('%d' % (idle_interval)), 'burst_interval': ('%d %s' % (burst_interval, 'us')), 'burst_timeout': ('%d %s' % (burst_timeout, 'ms')) }, 'payload_keys': [ 'idle_timeout', 'idle_interval', 'burst_interval', 'burst_timeout' ] }
+                    elif packet_command == 8: # kg_rsp_touch_set_scan_config
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_set_scan_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 9: # kg_rsp_touch_get_scan_stats
+                        current, scans, duration, = struct.unpack('<BLL', payload[:9])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_scan_stats', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'current': ('%02X' % current), 'scans': ('%d' % (scans)), 'duration': ('%d %s' % (duration, 'ms')) }, 'payload_keys': [ 'current', 'scans', 'duration' ] }
+                    elif packet_command == 10: # kg_rsp_touch_get_ghost_mode
+                        mode, = struct.unpack('<B', payload[:1])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_ghost_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'mode': ('%02X' % mode) }, 'payload_keys': [ 'mode' ] }
+                    elif packet_command == 11: # kg_rsp_touch_set_ghost_mode
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_set_ghost_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 12: # kg_rsp_touch_get_usage
+                        count, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_get_usage', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': ('%d' % (count)) }, 'payload_keys': [ 'count' ] }
+                    elif packet_command == 13: # kg_rsp_touch_reset_usage
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touch_reset_usage', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
                 elif packet_class == 5: # MOTION
                     if packet_command == 1: # kg_rsp_motion_get_mode
                         mode, = struct.unpack('<B', payload[:1])
@@ -1098,6 +1557,74 @@ class KGAPI(object):
                     elif packet_command == 2: # kg_rsp_motion_set_mode
                         result, = struct.unpack('<H', payload[:2])
                         return { 'type': 'response', 'name': 'kg_rsp_motion_set_mode', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 3: # kg_rsp_motion_get_filter
+                        accel_x, accel_y, accel_z, gyro_x, gyro_y, gyro_z, = struct.unpack('<BBBBBB', payload[:6])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_get_filter', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'accel_x': ('%d' % (accel_x)), 'accel_y': ('%d' % (accel_y)), 'accel_z': ('%d' % (accel_z)), 'gyro_x': ('%d' % (gyro_x)), 'gyro_y': ('%d' % (gyro_y)), 'gyro_z': ('%d' % (gyro_z)) }, 'payload_keys': [ 'accel_x', 'accel_y', 'accel_z', 'gyro_x', 'gyro_y', 'gyro_z' ] }
+                    elif packet_command == 4: # kg_rsp_motion_set_filter
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_set_filter', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 5: # kg_rsp_motion_get_config
+                        rate, dlpf, gyro_range, accel_range, decimation, = struct.unpack('<HBBBB', payload[:6])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_get_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'rate': ('%d %s' % (rate, 'Hz')), 'dlpf': ('%02X' % dlpf), 'gyro_range': ('%02X' % gyro_range), 'accel_range': ('%02X' % accel_range), 'decimation': ('%d' % (decimation)) }, 'payload_keys': [ 'rate', 'dlpf', 'gyro_range', 'accel_range', 'decimation' ] }
+                    elif packet_command == 6: # kg_rsp_motion_set_config
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_set_config', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 7: # kg_rsp_motion_get_bias
+                        x, y, z, still, = struct.unpack('<HHHB', payload[:7])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_get_bias', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'x': ('%04X' % x), 'y': ('%04X' % y), 'z': ('%04X' % z), 'still': ('%s' % ('TRUE' if still else 'FALSE')) }, 'payload_keys': [ 'x', 'y', 'z', 'still' ] }
+                    elif packet_command == 8: # kg_rsp_motion_reset_bias
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_reset_bias', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 9: # kg_rsp_motion_get_batch
+                        batch, current, = struct.unpack('<BB', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_get_batch', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'batch': ('%d' % (batch)), 'current': ('%d' % (current)) }, 'payload_keys': [ 'batch', 'current' ] }
+                    elif packet_command == 10: # kg_rsp_motion_set_batch
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_set_batch', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 11: # kg_rsp_motion_get_gesture
+                        frames, threshold, = struct.unpack('<BH', payload[:3])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_get_gesture', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'frames': ('%d' % (frames)), 'threshold': ('%d' % (threshold)) }, 'payload_keys': [ 'frames', 'threshold' ] }
+                    elif packet_command == 12: # kg_rsp_motion_set_gesture
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_motion_set_gesture', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                elif packet_class == 8: # TOUCHSET
+                    if packet_command == 1: # kg_rsp_touchset_get_info
+                        count, capacity, source, = struct.unpack('<HHB', payload[:5])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_get_info', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'count': ('%d' % (count)), 'capacity': ('%d' % (capacity)), 'source': ('%02X' % source) }, 'payload_keys': [ 'count', 'capacity', 'source' ] }
+                    elif packet_command == 2: # kg_rsp_touchset_clear
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_clear', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 3: # kg_rsp_touchset_add_entry
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_add_entry', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 4: # kg_rsp_touchset_write_begin
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_write_begin', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 5: # kg_rsp_touchset_write_data
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_write_data', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 6: # kg_rsp_touchset_write_end
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_write_end', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 7: # kg_rsp_touchset_erase
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_touchset_erase', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                elif packet_class == 9: # HID
+                    if packet_command == 1: # kg_rsp_hid_get_curve_point
+                        value, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_hid_get_curve_point', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'value': ('%d' % (value)) }, 'payload_keys': [ 'value' ] }
+                    elif packet_command == 2: # kg_rsp_hid_set_curve
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_hid_set_curve', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 3: # kg_rsp_hid_reset_curve
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_hid_reset_curve', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
+                    elif packet_command == 4: # kg_rsp_hid_get_predictor
+                        enabled, lead, alpha, beta, jerk, = struct.unpack('<BBBBB', payload[:5])
+                        return { 'type': 'response', 'name': 'kg_rsp_hid_get_predictor', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'enabled': ('%d' % (enabled)), 'lead': ('%d' % (lead)), 'alpha': ('%d' % (alpha)), 'beta': ('%d' % (beta)), 'jerk': ('%d' % (jerk)) }, 'payload_keys': [ 'enabled', 'lead', 'alpha', 'beta', 'jerk' ] }
+                    elif packet_command == 5: # kg_rsp_hid_set_predictor
+                        result, = struct.unpack('<H', payload[:2])
+                        return { 'type': 'response', 'name': 'kg_rsp_hid_set_predictor', 'length': payload_length, 'class_id': packet_class, 'command_id': packet_command, 'payload': { 'result': ('%04X' % result) }, 'payload_keys': [ 'result' ] }
             if packet_type & 0xC0 == 0x80: # event packet
                 if packet_class == 0: # PROTOCOL
                     if packet_command == 1: # kg_evt_protocol_error
@@ -1122,6 +1649,10 @@ class KGAPI(object):
                     elif packet_command == 6: # kg_evt_system_timer_tick
                         handle, seconds, subticks, = struct.unpack('<BLB', payload[:6])
                         return { 'type': 'event', 'name': 'kg_evt_system_timer_tick', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'handle': ('%d' % (handle)), 'seconds': ('%d' % (seconds)), 'subticks': ('%d' % (subticks)) }, 'payload_keys': [ 'handle', 'seconds', 'subticks' ] }
+                    elif packet_command == 7: # kg_evt_system_recorder_data
+                        offset, records_len, = struct.unpack('<HB', payload[:3])
+                        records_data = [ord(b) for b in payload[3:]]
+                        return { 'type': 'event', 'name': 'kg_evt_system_recorder_data', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'offset': ('%d' % (offset)), 'records': ' '.join(['%02X' % b for b in records_data]) }, 'payload_keys': [ 'offset', 'records' ] }
                 elif packet_class == 2: # BLUETOOTH
                     if packet_command == 1: # kg_evt_bluetooth_mode
                         mode, = struct.unpack('<B', payload[:1])
@@ -1176,6 +1707,17 @@ class KGAPI(object):
                         status_len, = struct.unpack('<B', payload[:1])
                         status_data = [ord(b) for b in payload[1:]]
                         return { 'type': 'event', 'name': 'kg_evt_touch_status', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'status': ' '.join(['%02X' % b for b in status_data]) }, 'payload_keys': [ 'status' ] }
+                    elif packet_command == 3: # kg_evt_touch_gesture
+                        combination, gesture, = struct.unpack('<BB', payload[:2])
+                        return { 'type': 'event', 'name': 'kg_evt_touch_gesture', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'combination': ('%d' % (combination)), 'gesture': ('%02X' % gesture) }, 'payload_keys': [ 'combination', 'gesture' ] }
+                    elif packet_command == 4: # kg_evt_touch_ambiguous
+                        status_len, = struct.unpack('<B', payload[:1])
+                        status_data = [ord(b) for b in payload[1:]]
+                        return { 'type': 'event', 'name': 'kg_evt_touch_ambiguous', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'status': ' '.join(['%02X' % b for b in status_data]) }, 'payload_keys': [ 'status' ] }
+                    elif packet_command == 5: # kg_evt_touch_usage
+                        offset, data_len, = struct.unpack('<HB', payload[:3])
+                        data_data = [ord(b) for b in payload[3:]]
+                        return { 'type': 'event', 'name': 'kg_evt_touch_usage', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'offset': ('%d' % (offset)), 'data': ' '.join(['%02X' % b for b in data_data]) }, 'payload_keys': [ 'offset', 'data' ] }
                 elif packet_class == 5: # MOTION
                     if packet_command == 1: # kg_evt_motion_mode
                         index, mode, = struct.unpack('<BB', payload[:2])
@@ -1187,6 +1729,13 @@ class KGAPI(object):
                     elif packet_command == 3: # kg_evt_motion_state
                         index, state, = struct.unpack('<BB', payload[:2])
                         return { 'type': 'event', 'name': 'kg_evt_motion_state', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'state': ('%02X' % state) }, 'payload_keys': [ 'index', 'state' ] }
+                    elif packet_command == 4: # kg_evt_motion_batch
+                        index, flags, count, time, data_len, = struct.unpack('<BBBHB', payload[:6])
+                        data_data = [ord(b) for b in payload[6:]]
+                        return { 'type': 'event', 'name': 'kg_evt_motion_batch', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'flags': ('%02X' % flags), 'count': ('%d' % (count)), 'time': ('%d' % (time)), 'data': ' '.join(['%02X' % b for b in data_data]) }, 'payload_keys': [ 'index', 'flags', 'count', 'time', 'data' ] }
+                    elif packet_command == 5: # kg_evt_motion_gesture
+                        index, gesture, score, frames, = struct.unpack('<BBHB', payload[:5])
+                        return { 'type': 'event', 'name': 'kg_evt_motion_gesture', 'length': payload_length, 'class_id': packet_class, 'event_id': packet_command, 'payload': { 'index': ('%d' % (index)), 'gesture': ('%d' % (gesture)), 'score': ('%d' % (score)), 'frames': ('%d' % (frames)) }, 'payload_keys': [ 'index', 'gesture', 'score', 'frames' ] }
                 elif packet_class == 0xFF: # LOG
                     if packet_command == 0xFF: # kg_log
                         level, = struct.unpack('<B', self.kgapi_rx_payload[:1])
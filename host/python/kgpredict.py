@@ -0,0 +1,399 @@
+#!/usr/bin/env python
+
+"""
+================================================================================
+Keyglove cursor predictor evaluation tool
+2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+Changelog:
+    2015-07-03 - Initial release
+
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+
+Replays a recorded hand gyro trace through the same fixed-point mouse pipeline
+the Keyglove firmware uses (smoothing filter, response curve, cursor predictor
+and report pacing), delays each report by the host link latency, and compares
+the resulting cursor path against the ideal path: the same measured movement
+shown instantly, with no report pacing or latency. Results are printed with
+the predictor off and on:
+
+    lag         time shift that best lines up the cursor with the ideal path
+    rms         average distance from the ideal path at that shift, in counts
+    overshoot   how far the cursor goes past where it comes to rest after each
+                movement, in counts (mean and worst)
+
+Only the gyro-based mouse modes (1 = tilt velocity, 2 = tilt position) can be
+replayed, since traces hold raw gyro data.
+
+Trace formats:
+
+    CSV text, one sample per line, '#' starts a comment:
+        gx,gy,gz                    # samples at the --rate interval
+        ms,gx,gy,gz                 # samples with millisecond timestamps
+
+    Flight recorder dump (-r), as saved by -d/-o: concatenated 12-byte records
+    from kg_evt_system_recorder_data(). Only hand motion records are used.
+
+Usage:
+    kgpredict.py trace.csv [-m 2] [-l 30] [-a 96] [-b 160] [-j 16] [-L 30]
+    kgpredict.py -r dump.bin
+    kgpredict.py -d [-o dump.bin]           # download flight recorder first
+    kgpredict.py -s                         # built-in synthetic trace
+    kgpredict.py trace.csv -u               # also upload settings for mode
+
+"""
+
+__author__ = "Jeff Rowberg"
+__license__ = "MIT"
+__version__ = "2015-07-03"
+__email__ = "jeff@rowberg.net"
+
+import sys, struct, math, random, argparse
+
+# default cursor response curve (must match hidMouseCurveDefault in support_hid_mouse.cpp)
+CURVE = [ 0, 52, 129, 218, 316, 423, 536, 655, 779, 908, 1042, 1179, 1320, 1465, 1613, 1764, 1919 ]
+CURVE_SHIFT = 5
+REPORT_INTERVAL = 8         # KG_HID_MOUSE_REPORT_INTERVAL
+PREDICT_LEAD_MAX = 256      # KG_HID_MOUSE_PREDICT_LEAD_MAX
+BACKLOG_MAX = 254           # KG_HID_MOUSE_BACKLOG_MAX
+FILTER_SHIFT = 2            # opt_motion_hand_filter[] gyro default
+INVERT = (0, 1)             # opt_hid_mouse_invert_x/y defaults
+
+# flight recorder record format (must match recorder_record_t in support_recorder.h)
+RECORD_SIZE = 12
+RECORD_TYPE_MOTION = 2
+HAND_INDEX = 0
+
+def clamp(value, low, high):
+    return max(low, min(high, value))
+
+def div(a, b):
+    # C integer division truncates toward zero
+    q = abs(a) // abs(b)
+    return q if (a < 0) == (b < 0) else -q
+
+def curve(value):
+    magnitude = abs(value)
+    segment = magnitude >> CURVE_SHIFT
+    if segment >= len(CURVE) - 1:
+        result = CURVE[-1]
+    else:
+        result = CURVE[segment] + (((CURVE[segment + 1] - CURVE[segment]) * (magnitude & ((1 << CURVE_SHIFT) - 1))) >> CURVE_SHIFT)
+    return -result if value < 0 else result
+
+def scale(value, period, rest=None, axis=0):
+    # mirrors hid_mouse_scale(), carrying what the division drops in rest[axis] (1/160 counts)
+    if period == 10: return value
+    total = value * period + (rest[axis] if rest else 0)
+    scaled = div(total, 10)
+    if rest: rest[axis] = total - scaled * 10
+    return clamp(scaled, -32767, 32767)
+
+def queue(acc, deltas):
+    # mirrors hid_mouse_queue(): shorten the whole movement until the tightest axis fits
+    num, den = 1, 1
+    for axis, delta in enumerate(deltas):
+        if delta == 0: continue
+        room = BACKLOG_MAX * 16 + 15 - (acc[axis] if delta > 0 else -acc[axis])
+        if room * den < abs(delta) * num: num, den = room, abs(delta)
+    for axis, delta in enumerate(deltas):
+        acc[axis] += delta if num == den else div(delta * num, den)
+
+def take(acc):
+    counts = clamp(-((-acc) >> 4) if acc < 0 else acc >> 4, -127, 127)
+    return counts, acc - counts * 16
+
+class Track(object):
+    # mirrors hid_mouse_predict() in support_hid_mouse.cpp
+    def __init__(self):
+        self.error, self.velocity, self.offset = 0, 0, 0
+    def predict(self, delta, period, lead, alpha, beta, jerk):
+        residual = clamp(self.error + delta - (self.velocity >> 8), -32767, 32767)
+        self.error = residual - ((residual * alpha) >> 8)
+        self.velocity = clamp(self.velocity + residual * beta, -8388352, 8388352)
+        speed = self.velocity >> 8
+        if (speed ^ delta) < 0: speed = 0
+        elif abs(speed) > abs(delta): speed = delta
+        target = (speed * ((lead << 4) // period)) >> 4
+        target = clamp(clamp(target, -PREDICT_LEAD_MAX * 16, PREDICT_LEAD_MAX * 16) - self.error, -32767, 32767)
+        step = target - self.offset
+        if jerk:
+            limit = scale(jerk * 16, period)
+            back = max(limit, abs(self.offset))
+            step = clamp(step, -back if self.offset > 0 else -limit, back if self.offset < 0 else limit)
+        self.offset += step
+        return clamp(delta + step, -32767, 32767)
+
+def cursor_deltas(gx, gy, gz, mode, velocity, rest, period):
+    dx, dy = curve(gy) - curve(gz), curve(gx)
+    if mode == 1:
+        velocity[0] = clamp(velocity[0] + scale(dx, period, rest, 2), -32767, 32767)
+        velocity[1] = clamp(velocity[1] + scale(dy, period, rest, 3), -32767, 32767)
+        dx, dy = velocity
+    return (-dx if INVERT[0] else dx), (-dy if INVERT[1] else dy)
+
+def replay(samples, mode, predictor, latency):
+    """Return the host cursor path, one (x, y) position per millisecond."""
+    filt, velocity, rest, tracks = [ 0, 0, 0 ], [ 0, 0 ], [ 0, 0, 0, 0 ], [ Track(), Track() ]
+    acc, last_report, reports = [ 0, 0 ], -REPORT_INTERVAL, []
+    end = samples[-1][0] + latency + 200
+    index, previous = 0, samples[0][0] - 10
+    for now in range(samples[0][0], end):
+        fresh = index < len(samples) and samples[index][0] == now
+        if fresh:
+            period = clamp(now - previous, 1, 255)
+            previous = now
+            gv = []
+            for axis in range(3):
+                filt[axis] += ((samples[index][axis + 1] << 8) - filt[axis]) >> FILTER_SHIFT
+                gv.append((filt[axis] + 128) >> 8)
+            index += 1
+            deltas = cursor_deltas(gv[0], gv[1], gv[2], mode, velocity, rest, period)
+            queued = []
+            for axis in range(2):
+                delta = scale(deltas[axis], period, rest, axis)
+                if predictor: delta = tracks[axis].predict(delta, period, *predictor)
+                queued.append(delta)
+            queue(acc, queued)
+        # hid_mouse_sample() reports right away, update_hid_mouse() sends leftovers
+        if (fresh or acc[0] or acc[1]) and now - last_report >= REPORT_INTERVAL:
+            x, acc[0] = take(acc[0])
+            y, acc[1] = take(acc[1])
+            if x or y:
+                last_report = now
+                reports.append((now + latency, x, y))
+    path, position, r = [], [ 0, 0 ], 0
+    for now in range(samples[0][0], end):
+        while r < len(reports) and reports[r][0] <= now:
+            position[0] += reports[r][1]
+            position[1] += reports[r][2]
+            r += 1
+        path.append(tuple(position))
+    return path
+
+def ideal(samples, mode, length):
+    """Return the cursor path the firmware measures, with no report pacing or latency, in counts."""
+    filt, velocity, rest, position, points, previous = [ 0, 0, 0 ], [ 0, 0 ], [ 0, 0, 0, 0 ], [ 0.0, 0.0 ], [], samples[0][0] - 10
+    for sample in samples:
+        period = clamp(sample[0] - previous, 1, 255)
+        gv = []
+        for axis in range(3):
+            filt[axis] += ((sample[axis + 1] << 8) - filt[axis]) >> FILTER_SHIFT
+            gv.append((filt[axis] + 128) >> 8)
+        deltas = cursor_deltas(gv[0], gv[1], gv[2], mode, velocity, rest, period)
+        position[0] += scale(deltas[0], period, rest, 0) / 16.0
+        position[1] += scale(deltas[1], period, rest, 1) / 16.0
+        points.append((previous, sample[0], tuple(position)))
+        previous = sample[0]
+    # each sample's movement happened over the period before it, so spread it out
+    path, last, p = [], (0.0, 0.0), 0
+    for now in range(samples[0][0], samples[0][0] + length):
+        while p < len(points) and points[p][1] <= now:
+            last = points[p][2]
+            p += 1
+        if p < len(points) and points[p][0] < now:
+            f = (now - points[p][0]) / float(points[p][1] - points[p][0])
+            path.append((last[0] + (points[p][2][0] - last[0]) * f, last[1] + (points[p][2][1] - last[1]) * f))
+        else:
+            path.append(last)
+    return path
+
+def rms(path, reference, shift):
+    total, count = 0.0, 0
+    for t in range(len(reference) - shift):
+        total += (path[t + shift][0] - reference[t][0]) ** 2 + (path[t + shift][1] - reference[t][1]) ** 2
+        count += 1
+    return math.sqrt(total / max(count, 1))
+
+def overshoot(path, reference, threshold=0.2, rest=50):
+    """Return how far the cursor goes past the resting position after each movement, in counts."""
+    moves, start, quiet = [], None, 0
+    for t in range(1, len(reference)):
+        speed = abs(reference[t][0] - reference[t - 1][0]) + abs(reference[t][1] - reference[t - 1][1])
+        if speed > threshold:
+            if start == None: start = t
+            quiet = 0
+        elif start != None:
+            quiet += 1
+            if quiet >= rest:
+                moves.append((start, t - quiet))
+                start = None
+    results = []
+    for i, (start, end) in enumerate(moves):
+        # the cursor settles until the next movement starts (or the trace ends)
+        stop = moves[i + 1][0] if i + 1 < len(moves) else len(path)
+        final = reference[stop - 1]
+        dx, dy = final[0] - reference[start][0], final[1] - reference[start][1]
+        length = math.hypot(dx, dy)
+        if length >= 5:
+            results.append(max(0.0, max([ ((p[0] - final[0]) * dx + (p[1] - final[1]) * dy) / length for p in path[start:stop] ])))
+    return results
+
+def evaluate(samples, mode, predictor, latency):
+    reference = ideal(samples, mode, samples[-1][0] - samples[0][0] + latency + 200)
+    path = replay(samples, mode, predictor, latency)
+    errors = [ (rms(path, reference, shift), shift) for shift in range(0, 201) ]
+    best, lag = min(errors)
+    overshoots = overshoot(path, reference)
+    return lag, best, rms(path, reference, 0), overshoots
+
+def load_csv(lines, rate):
+    samples = []
+    for number, line in enumerate(lines, 1):
+        fields = line.split('#', 1)[0].replace(',', ' ').split()
+        if not fields:
+            continue
+        if len(fields) == 3:
+            samples.append((len(samples) * 1000 // rate, int(fields[0]), int(fields[1]), int(fields[2])))
+        elif len(fields) == 4:
+            samples.append(tuple(int(f) for f in fields))
+        else:
+            raise ValueError("line %d: expected 'gx,gy,gz' or 'ms,gx,gy,gz'" % number)
+    return samples
+
+def load_records(data):
+    samples, time, last = [], 0, None
+    for offset in range(0, len(data) - RECORD_SIZE + 1, RECORD_SIZE):
+        stamp, type, aux = struct.unpack('<HBB', data[offset:offset + 4])
+        if type != RECORD_TYPE_MOTION or aux != HAND_INDEX:
+            continue
+        # timestamps are the low 16 bits of millis()
+        time += 0 if last == None else (stamp - last) & 0xFFFF
+        last = stamp
+        gx, gy, gz = struct.unpack('<hhh', data[offset + 4:offset + 10])
+        samples.append((time, gx, gy, gz))
+    return samples
+
+def synthetic(rate, seed=1):
+    # point-and-stop movements: bell-shaped (minimum-jerk) rotation bursts with sensor noise
+    rng, samples, t = random.Random(seed), [], 0
+    period = 1000 // rate
+    for move in range(12):
+        duration, peak = rng.randint(150, 400), [ rng.choice([ -1, 1 ]) * rng.randint(150, 500) for axis in range(3) ]
+        peak[2] = 0
+        for step in range(0, duration + 300, period):
+            s = min(step / float(duration), 1.0)
+            shape = 30.0 * (s ** 2) * ((1 - s) ** 2) / 1.875
+            samples.append((t, int(peak[0] * shape) + rng.randint(-4, 4), int(peak[1] * shape) + rng.randint(-4, 4), rng.randint(-4, 4)))
+            t += period
+    return samples
+
+def download(output=None):
+    import kglib
+    kgapi = kglib.KGAPI()
+    devices = list(kglib.get_devices())
+    if len(devices) == 0:
+        raise kglib.KeygloveError("No Keyglove devices found")
+    keyglove = devices[0]
+    if not keyglove.connect(kgapi):
+        raise kglib.KeygloveError("Could not connect to Keyglove")
+    chunks = {}
+    def on_data(payload):
+        chunks[payload['offset']] = bytearray(payload['records'])
+    kgapi.kg_evt_system_recorder_data += on_data
+    response = keyglove.send_and_return(kgapi.kg_cmd_system_read_recorder(), 2)
+    if response == None:
+        raise kglib.KeygloveError("Flight recorder download failed")
+    count = response['payload']['count']
+    import time
+    t0 = time.time()
+    while sum([ len(c) // RECORD_SIZE for c in chunks.values() ]) < count and time.time() - t0 < 5:
+        time.sleep(0.01)
+    keyglove.disconnect()
+    data = bytes(b''.join([ bytes(chunks[k]) for k in sorted(chunks.keys()) ]))
+    if output:
+        with open(output, 'wb') as f:
+            f.write(data)
+    return data
+
+def upload(mode, predictor, enabled):
+    import kglib
+    kgapi = kglib.KGAPI()
+    devices = list(kglib.get_devices())
+    if len(devices) == 0:
+        raise kglib.KeygloveError("No Keyglove devices found")
+    keyglove = devices[0]
+    if not keyglove.connect(kgapi):
+        raise kglib.KeygloveError("Could not connect to Keyglove")
+    response = keyglove.send_and_return(kgapi.kg_cmd_hid_set_predictor(mode, enabled, *predictor), 2)
+    keyglove.disconnect()
+    if response == None or response['payload'].get('result', 0) != 0:
+        raise kglib.KeygloveError("Predictor upload failed: %s" % response)
+
+def main():
+    parser = argparse.ArgumentParser(description='Evaluate Keyglove cursor predictor settings against a recorded gyro trace')
+    parser.add_argument('trace', nargs='?', help='CSV gyro trace (or flight recorder dump with -r)')
+    parser.add_argument('-r', '--records', action='store_true', help='trace is a flight recorder dump')
+    parser.add_argument('-d', '--download', action='store_true', help='download the flight recorder from the first connected Keyglove')
+    parser.add_argument('-o', '--output', help='save downloaded flight recorder dump to this file')
+    parser.add_argument('-s', '--synthetic', action='store_true', help='use a built-in synthetic point-and-stop trace')
+    parser.add_argument('-R', '--rate', type=int, default=100, help='sample rate in Hz for CSV traces without timestamps')
+    parser.add_argument('-m', '--mode', type=int, choices=[ 1, 2 ], default=2, help='mouse mode (1 = tilt velocity, 2 = tilt position)')
+    parser.add_argument('-L', '--latency', type=int, default=30, help='host link latency to simulate, in ms')
+    parser.add_argument('-l', '--lead', type=int, default=30, help='predictor lead time, in ms')
+    parser.add_argument('-a', '--alpha', type=int, default=96, help='predictor position gain, in 1/256')
+    parser.add_argument('-b', '--beta', type=int, default=160, help='predictor velocity gain, in 1/256')
+    parser.add_argument('-j', '--jerk', type=int, default=16, help='predictor jerk limit (lead growth), in counts per 10ms (0 = no limit)')
+    parser.add_argument('-u', '--upload', action='store_true', help='enable these predictor settings for this mode on the first connected Keyglove')
+    args = parser.parse_args()
+
+    predictor = (args.lead, args.alpha, args.beta, args.jerk)
+    for name, value, low in zip([ 'lead', 'alpha', 'beta', 'jerk' ], predictor, [ 0, 1, 0, 0 ]):
+        if value < low or value > 255:
+            parser.error("%s must be %d to 255" % (name, low))
+
+    try:
+        if args.synthetic:
+            samples = synthetic(args.rate)
+        elif args.download:
+            samples = load_records(download(args.output))
+        elif args.trace and args.records:
+            with open(args.trace, 'rb') as f:
+                samples = load_records(f.read())
+        elif args.trace:
+            with open(args.trace) as f:
+                samples = load_csv(f.readlines(), args.rate)
+        else:
+            parser.error("no trace given (use a trace file, -d or -s)")
+    except ValueError as e:
+        print("%s: %s" % (args.trace, e))
+        sys.exit(1)
+    if len(samples) < 2:
+        print("Trace has no hand gyro samples")
+        sys.exit(1)
+
+    print("Replaying %d samples (%d ms) in mode %d with %d ms link latency" % (len(samples), samples[-1][0] - samples[0][0], args.mode, args.latency))
+    print("%-46s %6s %8s %8s %10s %10s" % ('', 'lag', 'rms', 'rms@0', 'overshoot', 'worst'))
+    for label, settings in [ ('predictor off', None), ('predictor lead %d alpha %d beta %d jerk %d' % predictor, predictor) ]:
+        lag, best, zero, overshoots = evaluate(samples, args.mode, settings, args.latency)
+        mean = sum(overshoots) / len(overshoots) if overshoots else 0.0
+        print("%-46s %4d ms %8.1f %8.1f %10.1f %10.1f" % (label, lag, best, zero, mean, max(overshoots) if overshoots else 0.0))
+
+    if args.upload:
+        upload(args.mode, predictor, 1)
+        print("Predictor settings enabled for mode %d" % args.mode)
+
+if __name__ == '__main__':
+    main()
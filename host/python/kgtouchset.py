@@ -0,0 +1,259 @@
+#!/usr/bin/env python
+
+"""
+================================================================================
+Keyglove touchset layout compiler and uploader
+2015-07-03 by Jeff Rowberg <jeff@rowberg.net>
+
+Changelog:
+    2015-07-03 - Initial release
+
+================================================================================
+Keyglove source code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+================================================================================
+
+Compiles a human-readable touchset layout file into the packed, sorted binary
+format used by the touchset engine in the Keyglove firmware, and optionally
+uploads it to a connected Keyglove for storage in EEPROM.
+
+Layout file format (one rule per line, '#' starts a comment):
+
+    mode 0                          # following rules apply to touch mode 0
+    AY      touch   motion_on   0   # chord, trigger, action, parameter
+    AY      untouch motion_off  0
+    DY      press   key_down    A
+    DY      release key_up      A
+    AY+DY   press   mode_push   1   # chords join up to 4 combinations with '+'
+
+    mode 1
+    GY      release key_press   ENTER
+    AY+DY   release mode_pop
+
+Triggers 'press' and 'release' match the exact set of touched combinations,
+so touching DY while AY is held releases AY and presses AY+DY. Triggers
+'touch' and 'untouch' take a single combination and follow only that one,
+whatever else is touched.
+
+Usage:
+    kgtouchset.py layout.txt [-b t19|t37] [-o layout.bin] [-u]
+
+"""
+
+__author__ = "Jeff Rowberg"
+__license__ = "MIT"
+__version__ = "2015-07-03"
+__email__ = "jeff@rowberg.net"
+
+import sys, time, struct, binascii, argparse
+
+# base combination names, in bit index order (must match KGB_* in board header)
+BOARDS = {
+    't19': [ 'AY', 'BY', 'CY', 'DY', 'EY', 'FY', 'GY', 'HY', 'IY', 'JY', 'KY', 'LY',
+             'Y4', 'Y5', 'Y6', 'Y7', 'Y1', 'A1', 'D1', 'G1', 'J1', 'A8', 'D8', 'G8', 'J8' ],
+    't37': [ 'DM', 'AY', 'BY', 'CY', 'DY', 'EY', 'FY', 'GY', 'HY', 'IY', 'JY', 'KY', 'LY',
+             'MY', 'NY', 'OY', 'PY', 'QY', 'RY', 'SY', 'TY', 'UY', 'VY', 'WY', 'XY',
+             'MZ', 'NZ', 'OZ', 'PZ', 'QZ', 'RZ', 'A1', 'D1', 'G1', 'J1', 'Y1',
+             'A2', 'D2', 'G2', 'J2', 'A3', 'D3', 'G3', 'J3', 'D4', 'Y4', 'Z4', 'Y5', 'Z5',
+             'D6', 'Y6', 'Z6', 'D7', 'G7', 'Y7', 'Z7', 'A8', 'D8', 'G8', 'J8' ],
+}
+
+# action codes (must match touchset_action_t in support_touchset.h)
+ACTIONS = [ 'none', 'key_down', 'key_up', 'key_press', 'modifier_down', 'modifier_up',
+            'modifier_toggle', 'modifier_press', 'mouse_down', 'mouse_up', 'mouse_click',
+            'mouse_on', 'mouse_off', 'mode_set', 'mode_push', 'mode_pop', 'mode_toggle',
+            'blink', 'piezo', 'vibrate', 'motion_on', 'motion_off' ]
+
+TRIGGERS = { 'press': 0, 'release': 1, 'touch': 2, 'untouch': 3 }
+
+# HID keyboard usage codes (see support_hid_keyboard.h)
+KEYS = dict([ (chr(ord('A') + i), 4 + i) for i in range(26) ])
+KEYS.update(dict([ (str((i + 1) % 10), 30 + i) for i in range(10) ]))
+KEYS.update(dict([ ('F%d' % (i + 1), 58 + i) for i in range(12) ]))
+KEYS.update({
+    'ENTER': 40, 'ESC': 41, 'BACKSPACE': 42, 'TAB': 43, 'SPACE': 44, 'MINUS': 45,
+    'EQUAL': 46, 'LEFT_BRACE': 47, 'RIGHT_BRACE': 48, 'BACKSLASH': 49, 'NON_US_NUM': 50,
+    'SEMICOLON': 51, 'QUOTE': 52, 'TILDE': 53, 'COMMA': 54, 'PERIOD': 55, 'SLASH': 56,
+    'CAPS_LOCK': 57, 'PRINTSCREEN': 70, 'SCROLL_LOCK': 71, 'PAUSE': 72, 'INSERT': 73,
+    'HOME': 74, 'PAGE_UP': 75, 'DELETE': 76, 'END': 77, 'PAGE_DOWN': 78, 'RIGHT': 79,
+    'LEFT': 80, 'DOWN': 81, 'UP': 82, 'NUM_LOCK': 83 })
+MODIFIERS = { 'ALT': 0x01, 'SHIFT': 0x02, 'CTRL': 0x04, 'GUI': 0x08 }
+MOUSE_BUTTONS = { 'LEFT': 1, 'RIGHT': 2, 'MIDDLE': 4 }
+MOUSE_ACTIONS = { 'MOVE': 1, 'SCROLL': 2 }
+
+PARAM_NAMES = {
+    'key_down': (KEYS, 'KEY_'), 'key_up': (KEYS, 'KEY_'), 'key_press': (KEYS, 'KEY_'),
+    'modifier_down': (MODIFIERS, 'MODIFIERKEY_'), 'modifier_up': (MODIFIERS, 'MODIFIERKEY_'),
+    'modifier_toggle': (MODIFIERS, 'MODIFIERKEY_'), 'modifier_press': (MODIFIERS, 'MODIFIERKEY_'),
+    'mouse_down': (MOUSE_BUTTONS, 'MOUSE_'), 'mouse_up': (MOUSE_BUTTONS, 'MOUSE_'),
+    'mouse_click': (MOUSE_BUTTONS, 'MOUSE_'),
+    'mouse_on': (MOUSE_ACTIONS, 'MOUSE_ACTION_'), 'mouse_off': (MOUSE_ACTIONS, 'MOUSE_ACTION_'),
+}
+
+# stored format (must match touchset_header_t in support_touchset.h)
+HEADER_MAGIC = 0x544B
+HEADER_VERSION = 0x01
+HEADER_SIZE = 8
+ENTRY_SIZE = 6
+CHORD_MAX = 4
+CHORD_PAD = 0x3F
+EEPROM_SIZE = 4096 - 416   # top 416 bytes hold the gesture templates and gyro bias record
+EEPROM_ENTRIES = (EEPROM_SIZE - HEADER_SIZE) // ENTRY_SIZE
+
+# upload protocol
+SOURCE_EEPROM = 2           # 'source' value from kg_cmd_touchset_get_info() once the stored touchset is active
+RESULT_BUSY = 7             # KGAPI 'busy' result while earlier data is still being written
+BUSY_RETRIES = 200
+BUSY_DELAY = 0.01           # seconds, about three EEPROM byte writes
+
+class LayoutError(Exception):
+    pass
+
+def parse_param(action, text):
+    if text == None:
+        return 0
+    try:
+        value = int(text, 0)
+    except ValueError:
+        names, prefix = PARAM_NAMES.get(action, ({}, ''))
+        name = text.upper()
+        if prefix and name.startswith(prefix): name = name[len(prefix):]
+        if name not in names:
+            raise LayoutError("unknown parameter '%s' for action '%s'" % (text, action))
+        value = names[name]
+    if value < 0 or value > 255:
+        raise LayoutError("parameter '%s' out of range" % text)
+    return value
+
+def pack_chord(indexes):
+    key = 0
+    for i in range(CHORD_MAX):
+        key = (key << 6) | (indexes[i] if i < len(indexes) else CHORD_PAD)
+    return struct.pack('>I', key)[1:]
+
+def compile_layout(lines, board='t19'):
+    combos = BOARDS[board]
+    entries = []
+    mode = 0
+    for number, line in enumerate(lines, 1):
+        tokens = line.split('#', 1)[0].split()
+        if not tokens:
+            continue
+        try:
+            if tokens[0].lower() == 'mode':
+                if len(tokens) != 2: raise LayoutError("expected 'mode <number>'")
+                mode = int(tokens[1], 0)
+                if mode < 0 or mode > 254: raise LayoutError("mode out of range")
+                continue
+            if len(tokens) < 3 or len(tokens) > 4:
+                raise LayoutError("expected '<chord> <trigger> <action> [param]'")
+            names = tokens[0].upper().split('+')
+            if len(names) > CHORD_MAX or len(set(names)) != len(names):
+                raise LayoutError("chord must have 1 to %d different combinations" % CHORD_MAX)
+            for name in names:
+                if name not in combos: raise LayoutError("unknown combination '%s' for board '%s'" % (name, board))
+            trigger = tokens[1].lower()
+            if trigger not in TRIGGERS: raise LayoutError("unknown trigger '%s'" % tokens[1])
+            if TRIGGERS[trigger] >= TRIGGERS['touch'] and len(names) != 1:
+                raise LayoutError("trigger '%s' needs a single combination" % trigger)
+            action = tokens[2].lower()
+            if action not in ACTIONS: raise LayoutError("unknown action '%s'" % tokens[2])
+            param = parse_param(action, tokens[3] if len(tokens) > 3 else None)
+        except LayoutError as e:
+            raise LayoutError("line %d: %s" % (number, e))
+        chord = pack_chord(sorted([ combos.index(name) for name in names ]))
+        action_byte = (TRIGGERS[trigger] << 6) | ACTIONS.index(action)
+        entries.append(struct.pack('<B', mode) + chord + struct.pack('<BB', action_byte, param))
+
+    # stable sort keeps file order for rules with the same mode and chord
+    entries = sorted(entries, key=lambda e: e[:4])
+    if len(entries) > EEPROM_ENTRIES:
+        raise LayoutError("%d entries will not fit in EEPROM (max %d)" % (len(entries), EEPROM_ENTRIES))
+    return b''.join(entries)
+
+def build_image(data):
+    crc = binascii.crc_hqx(data, 0)
+    return struct.pack('<HBBHH', HEADER_MAGIC, HEADER_VERSION, ENTRY_SIZE, len(data) // ENTRY_SIZE, crc) + data
+
+def upload(data, chunk_size=24):
+    import kglib
+    kgapi = kglib.KGAPI()
+    devices = list(kglib.get_devices())
+    if len(devices) == 0:
+        raise kglib.KeygloveError("No Keyglove devices found")
+    keyglove = devices[0]
+    if not keyglove.connect(kgapi):
+        raise kglib.KeygloveError("Could not connect to Keyglove")
+
+    def send(packet):
+        # EEPROM writes happen in the background, so repeat a command while the firmware is busy
+        for attempt in range(BUSY_RETRIES):
+            response = keyglove.send_and_return(packet, 2)
+            if response == None or response['payload'].get('result', 0) != RESULT_BUSY:
+                break
+            time.sleep(BUSY_DELAY)
+        if response == None or response['payload'].get('result', 0) != 0:
+            raise kglib.KeygloveError("Touchset upload failed: %s" % response)
+
+    data_bytes = bytearray(data)
+    crc = binascii.crc_hqx(data, 0)
+    send(kgapi.kg_cmd_touchset_write_begin(len(data_bytes) // ENTRY_SIZE))
+    for offset in range(0, len(data_bytes), chunk_size):
+        send(kgapi.kg_cmd_touchset_write_data(offset, list(data_bytes[offset:offset + chunk_size])))
+    send(kgapi.kg_cmd_touchset_write_end(crc))
+
+    # header is written after 'write_end' returns, so wait until the stored touchset is active
+    for attempt in range(BUSY_RETRIES):
+        response = keyglove.send_and_return(kgapi.kg_cmd_touchset_get_info(), 2)
+        if response != None and response['payload'].get('source', 0) == SOURCE_EEPROM:
+            break
+        time.sleep(BUSY_DELAY)
+    else:
+        raise kglib.KeygloveError("Touchset upload did not become active")
+    keyglove.disconnect()
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile (and optionally upload) a Keyglove touchset layout')
+    parser.add_argument('layout', help='human-readable layout file')
+    parser.add_argument('-b', '--board', choices=sorted(BOARDS.keys()), default='t19', help='board touch sensor configuration')
+    parser.add_argument('-o', '--output', help='write compiled EEPROM image (header + entries) to this file')
+    parser.add_argument('-u', '--upload', action='store_true', help='upload compiled touchset to first connected Keyglove')
+    args = parser.parse_args()
+
+    try:
+        with open(args.layout) as f:
+            data = compile_layout(f.readlines(), args.board)
+    except LayoutError as e:
+        print("%s: %s" % (args.layout, e))
+        sys.exit(1)
+
+    image = build_image(data)
+    print("Compiled %d entries (%d bytes with header, CRC 0x%04X)" % (len(data) // ENTRY_SIZE, len(image), binascii.crc_hqx(data, 0)))
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(image)
+    if args.upload:
+        upload(data)
+        print("Upload complete")
+
+if __name__ == '__main__':
+    main()